@@ -3,32 +3,160 @@
 #include <string>
 #include <thread>
 #include <atomic>
+#include <cstdint>
 #include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "VRProtocol.h"
 
 namespace neural_studio {
 
+    /**
+     * IPCServer - Engine command channel on a Unix domain socket (Linux, epoll)
+     *
+     * One I/O thread serves any number of clients without blocking on any of
+     * them, reading framed messages (VRProtocol::Header + payload). Nothing is
+     * applied on that thread: complete messages are queued, and the engine
+     * thread calls ProcessPending() once per frame to apply everything received
+     * since the previous frame. Replies are queued and written by the I/O thread.
+     *
+     *  - Command: JSON text for the command callback; its result is sent back
+     *    as a Response.
+     *  - CommandBatch: binary records (see VRProtocol.h). Transform updates are
+     *    coalesced per node within a frame (last one wins) and each batch is
+     *    acknowledged with a BatchAck once applied.
+     *  - PreviewFrame: subscribes to the preview ring. Answered directly by
+     *    the I/O thread with PreviewChannelInfo and the memfd (SCM_RIGHTS);
+     *    an empty payload means no preview channel is set.
+     *
+     * Callbacks must be set before Start() and run on the ProcessPending() thread.
+     */
     class IPCServer
     {
           public:
+        struct Config {
+            size_t maxClients = 64;
+            size_t maxPendingReplyBytes = 16 * 1024 * 1024;  // Per client; a client that stops reading is dropped
+        };
+
+        struct Stats {
+            uint64_t clientsAccepted = 0;
+            uint32_t clientsConnected = 0;
+            uint64_t bytesReceived = 0;
+            uint64_t bytesSent = 0;
+            uint64_t jsonCommands = 0;
+            uint64_t batches = 0;
+            uint64_t transformsReceived = 0;
+            uint64_t transformsApplied = 0;  // After per-frame coalescing
+            uint64_t protocolErrors = 0;     // Bad frames (client dropped) or malformed records (skipped)
+            uint64_t frames = 0;             // ProcessPending() calls that applied at least one message
+            uint64_t previewSubscriptions = 0;
+        };
+
+        using CommandCallback = std::function<std::string(const std::string &)>;
+        using TransformCallback = std::function<void(const VRProtocol::TransformCommand &)>;
+
         IPCServer();
+        explicit IPCServer(const Config &config);
         ~IPCServer();
 
-        bool Start(const std::string &socketPath);
+        IPCServer(const IPCServer &) = delete;
+        IPCServer &operator=(const IPCServer &) = delete;
+
+        bool Start(const std::string &socketPath = VRProtocol::SOCKET_PATH);
         void Stop();
+        bool IsRunning() const
+        {
+            return m_running.load(std::memory_order_acquire);
+        }
 
         // Callback for incoming commands (JSON string in, JSON string out response)
-        void SetCommandCallback(std::function<std::string(const std::string &)> cb);
+        void SetCommandCallback(CommandCallback cb);
+        // Callback for SetTransform records, called at most once per node per frame
+        void SetTransformCallback(TransformCallback cb);
+        // Preview ring handed to subscribers (see PreviewChannel.h); the fd is duplicated
+        void SetPreviewChannel(int fd, const VRProtocol::PreviewChannelInfo &info);
+
+        // Engine thread, once per frame: applies every message received since the
+        // last call and queues the replies. Returns the number of messages applied.
+        size_t ProcessPending();
+
+        Stats GetStats() const;
 
           private:
+        struct Client;
+
+        // Framed messages in arrival order, packed into one buffer; swapped whole between threads
+        struct MessageQueue {
+            struct Message {
+                uint64_t clientId;
+                VRProtocol::MessageType type;
+                size_t offset;
+                uint32_t size;
+            };
+            std::vector<Message> messages;
+            std::vector<char> bytes;
+
+            void push(uint64_t clientId, VRProtocol::MessageType type, const void *data, uint32_t size);
+            void clear()
+            {
+                messages.clear();
+                bytes.clear();
+            }
+        };
+
+        struct PendingAck {
+            uint64_t clientId;
+            VRProtocol::BatchAck ack;
+        };
+
         void ServerLoop();
-        void HandleClient(int clientFd);
+        void AcceptClients();
+        void ReadClient(Client &client);
+        void WriteClient(Client &client);
+        void CloseClient(uint64_t clientId);
+        void DeliverReplies();
+        void SendPreviewChannel(Client &client);
+        void Wake();
 
+        void FlushTransforms();
+
+        Config m_config;
         std::string m_socketPath;
-        std::atomic<bool> m_running;
+        std::atomic<bool> m_running {false};
         std::thread m_serverThread;
         int m_serverFd = -1;
+        int m_epollFd = -1;
+        int m_wakeFd = -1;  // eventfd: replies queued or Stop()
+        int m_previewFd = -1;
+        VRProtocol::PreviewChannelInfo m_previewInfo {};
+
+        // I/O thread only
+        std::unordered_map<uint64_t, Client *> m_clients;
+        uint64_t m_nextClientId = 0;
+
+        // I/O thread -> engine thread
+        std::mutex m_inboundMutex;
+        MessageQueue m_inbound;
+        MessageQueue m_processing;  // Engine thread only; swapped with m_inbound each frame
+
+        // Engine thread -> I/O thread
+        std::mutex m_outboundMutex;
+        MessageQueue m_outbound;
+        MessageQueue m_replies;  // Engine thread staging; swapped with m_outbound
+        MessageQueue m_delivering;  // I/O thread only
+
+        // Per-frame coalescing (engine thread only)
+        std::vector<VRProtocol::TransformCommand> m_transforms;
+        std::unordered_map<uint32_t, size_t> m_transformIndex;  // nodeId -> m_transforms
+        std::vector<PendingAck> m_pendingAcks;
+
+        CommandCallback m_commandCallback;
+        TransformCallback m_transformCallback;
 
-        std::function<std::string(const std::string &)> m_commandCallback;
+        mutable std::mutex m_statsMutex;
+        Stats m_stats;
     };
 
 }  // namespace neural_studio
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "VRProtocol.h"
+
+namespace neural_studio {
+
+    /**
+     * PreviewFrameWriter - Engine side of the shared-memory preview ring
+     *
+     * Owns a memfd laid out as described in VRProtocol.h, sealed against resizing
+     * and, where the kernel supports it, against writes by anyone else. Publish()
+     * copies a frame into the next slot at most maxFps times per second, so
+     * preview cost stays off the main output path; IPCServer hands the fd to
+     * every client that subscribes. Single writer (the engine thread).
+     */
+    class PreviewFrameWriter
+    {
+          public:
+        struct Config {
+            uint32_t maxWidth = 1920;
+            uint32_t maxHeight = 1080;
+            uint32_t slotCount = 3;  // Readers have (slotCount - 1) publish intervals to copy a frame
+            double maxFps = 30.0;    // 0 = publish every frame offered
+        };
+
+        PreviewFrameWriter() = default;
+        ~PreviewFrameWriter();
+
+        PreviewFrameWriter(const PreviewFrameWriter &) = delete;
+        PreviewFrameWriter &operator=(const PreviewFrameWriter &) = delete;
+
+        bool Create(const Config &config);
+        void Destroy();
+
+        int Fd() const
+        {
+            return m_fd;
+        }
+        VRProtocol::PreviewChannelInfo Info() const;
+
+        // False while throttled; lets the caller skip a GPU readback entirely
+        bool ShouldPublish() const;
+
+        // Copies a frame (rows of 'stride' bytes, 4 bytes per pixel) into the ring unless throttled
+        // or larger than the ring's maximum size. Returns true if it was published.
+        bool Publish(const void *pixels, uint32_t width, uint32_t height, uint32_t stride,
+                     VRProtocol::PreviewFormat format, uint64_t frameNumber);
+
+        uint64_t PublishedFrames() const;
+
+          private:
+        Config m_config;
+        int m_fd = -1;
+        uint8_t *m_mapping = nullptr;
+        size_t m_mappingSize = 0;
+        int64_t m_lastPublishNs = 0;
+    };
+
+    /**
+     * PreviewFrameReader - UI side of the shared-memory preview ring
+     *
+     * Subscribes over the engine socket, receives the memfd and maps it
+     * read-only. ReadLatest() is lock-free and never blocks the engine: it
+     * copies the newest frame and validates it against the slot's seqlock.
+     */
+    class PreviewFrameReader
+    {
+          public:
+        struct Frame {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t stride = 0;
+            VRProtocol::PreviewFormat format = VRProtocol::PreviewFormat::RGBA8;
+            uint64_t frameNumber = 0;
+            int64_t timestampNs = 0;
+            uint64_t published = 0;       // Ring position (1-based); increases with every publish
+            std::vector<uint8_t> pixels;  // height * stride bytes; capacity is reused between reads
+        };
+
+        PreviewFrameReader() = default;
+        ~PreviewFrameReader();
+
+        PreviewFrameReader(const PreviewFrameReader &) = delete;
+        PreviewFrameReader &operator=(const PreviewFrameReader &) = delete;
+
+        bool Connect(const std::string &socketPath = VRProtocol::SOCKET_PATH);
+        // Maps an fd received by other means (takes ownership)
+        bool Attach(int fd, const VRProtocol::PreviewChannelInfo &info);
+        void Disconnect();
+        bool IsConnected() const
+        {
+            return m_mapping != nullptr;
+        }
+
+        // Frames published so far (0 = none yet); cheap enough to poll every UI frame
+        uint64_t PublishedFrames() const;
+
+        // Copies the newest frame into 'frame' if it is newer than frame.published.
+        // Returns false if there is nothing new or the writer kept lapping the reader.
+        bool ReadLatest(Frame &frame) const;
+
+          private:
+        int m_fd = -1;
+        const uint8_t *m_mapping = nullptr;
+        size_t m_mappingSize = 0;
+    };
+
+}  // namespace neural_studio
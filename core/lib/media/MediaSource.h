@@ -3,11 +3,13 @@
 #include "common/frame.h"
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 // Forward decl for shared media type
 struct mp_media;
 typedef struct mp_media mp_media_t;
+struct obs_source_frame;
 
 namespace neural_studio {
 
@@ -24,15 +26,22 @@ namespace neural_studio {
         // Should be called every frame
         void Update();
 
-        // Returns the current video frame if available
-        // Note: Returns a CPU buffer view (obs_source_frame) usually.
-        // For MVP we might just log or return a blank view if we don't have texture upload yet.
+        // Returns the newest decoded video frame if available, as a CPU buffer
+        // view: handle is plane 0 and user_data the obs_source_frame. The view
+        // borrows the decoder's pooled buffer and stays valid until the next
+        // GetFrame() or Unload().
         bool GetFrame(GPUFrameView &outFrame);
 
           private:
+        static void OnVideoFrame(void *opaque, obs_source_frame *frame);
+
         mp_media_t *media = nullptr;
         std::string currentPath;
 
+        std::mutex frameMutex;
+        obs_source_frame *latestFrame = nullptr;  // Set by the decoder thread
+        obs_source_frame *heldFrame = nullptr;    // Backs the last GetFrame() view
+
         // Internal buffer for RGBA conversion (simple CPU conversion for mvp)
         std::vector<uint8_t> rgbBuffer;
         int width = 0;
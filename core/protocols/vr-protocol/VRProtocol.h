@@ -1,6 +1,7 @@
 #ifndef VR_PROTOCOL_H
 #define VR_PROTOCOL_H
 
+#include <atomic>
 #include <cstdint>
 
 namespace VRProtocol {
@@ -9,14 +10,59 @@ namespace VRProtocol {
         Unknown = 0,
         Command = 1,      // UI -> Backend (e.g. "SetScene")
         Response = 2,     // Backend -> UI (e.g. "OK")
-        Event = 3,        // Backend -> UI (e.g. "SceneChanged")
-        PreviewFrame = 4  // Backend -> UI (Shared Handle)
+        Event = 3,         // Backend -> UI (e.g. "SceneChanged")
+        PreviewFrame = 4,  // UI -> Backend: subscribe; Backend -> UI: PreviewChannelInfo + memfd (SCM_RIGHTS)
+        CommandBatch = 5,  // UI -> Backend, binary: BatchHeader + records (see below)
+        BatchAck = 6       // Backend -> UI, binary: BatchAck, sent once the batch was applied
     };
 
+    // Every message on the socket is a Header followed by payloadSize bytes
     struct Header {
         MessageType type;
         uint32_t payloadSize;
     };
+    static_assert(sizeof(Header) == 8, "Header is part of the wire format");
+
+    //=========================================================================
+    // Binary command batches
+    //
+    // Fixed-layout, little-endian records for high-rate commands (transform
+    // updates from gizmos, trackers, animation scrubbing) that would cost
+    // ~150 bytes and a JSON parse each as Command messages. A batch is
+    // applied on the engine thread at the next frame boundary, in order, and
+    // acknowledged with a BatchAck carrying the same sequence number.
+    //=========================================================================
+
+    enum class CommandOp : uint16_t {
+        SetTransform = 1,  // TransformCommand
+    };
+
+    struct BatchHeader {
+        uint32_t sequence;  // Echoed in the BatchAck
+        uint32_t count;     // Records that follow
+    };
+    static_assert(sizeof(BatchHeader) == 8, "BatchHeader is part of the wire format");
+
+    // Precedes each record; size covers the record body only, so receivers skip unknown ops
+    struct RecordHeader {
+        CommandOp op;
+        uint16_t size;
+    };
+    static_assert(sizeof(RecordHeader) == 4, "RecordHeader is part of the wire format");
+
+    struct TransformCommand {
+        uint32_t nodeId;  // Scene id (as returned by createNode)
+        float position[3];
+        float rotation[4];  // Quaternion x, y, z, w
+        float scale[3];
+    };
+    static_assert(sizeof(TransformCommand) == 44, "TransformCommand is part of the wire format");
+
+    struct BatchAck {
+        uint32_t sequence;
+        uint32_t applied;  // Records applied (unknown or malformed records are skipped)
+    };
+    static_assert(sizeof(BatchAck) == 8, "BatchAck is part of the wire format");
 
     // Command IDs (in JSON payload usually, but defined here for ref)
     constexpr const char *CMD_GET_SCENES = "getScenes";
@@ -26,6 +72,64 @@ namespace VRProtocol {
     constexpr const char *CMD_UPDATE_NODE = "updateNode";
     constexpr const char *CMD_DELETE_NODE = "deleteNode";
 
+    //=========================================================================
+    // Preview frames (shared memory)
+    //
+    // The engine publishes throttled preview frames into a memfd it shares
+    // once per client: the client sends an empty PreviewFrame message and
+    // receives a PreviewFrame carrying PreviewChannelInfo, with the memfd
+    // attached as SCM_RIGHTS ancillary data. It maps the fd read-only.
+    //
+    // Layout: PreviewRingHeader, then slotCount slots of slotStride bytes,
+    // each a PreviewSlotHeader followed by the pixels. The writer fills the
+    // slot after the latest one and then bumps publishedFrames, so frame N
+    // (1-based) lives in slot (N - 1) % slotCount. Each slot is a seqlock:
+    // sequence is odd while the writer is inside it; a reader copies the
+    // pixels and retries if sequence changed meanwhile.
+    //=========================================================================
+
+    constexpr uint32_t PREVIEW_MAGIC = 0x5650524E;  // "NRPV"
+    constexpr uint32_t PREVIEW_VERSION = 1;
+
+    enum class PreviewFormat : uint32_t {
+        RGBA8 = 1,
+        BGRA8 = 2
+    };
+
+    struct PreviewChannelInfo {
+        uint32_t version;
+        uint32_t slotCount;
+        uint64_t mappingSize;  // Bytes to mmap
+    };
+    static_assert(sizeof(PreviewChannelInfo) == 16, "PreviewChannelInfo is part of the wire format");
+
+    struct alignas(64) PreviewRingHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t maxWidth;
+        uint32_t maxHeight;
+        uint32_t reserved;
+        uint64_t slotStride;     // Bytes per slot, header included
+        uint64_t pixelCapacity;  // Bytes of pixels per slot
+        std::atomic<uint64_t> publishedFrames;
+    };
+
+    struct alignas(64) PreviewSlotHeader {
+        std::atomic<uint32_t> sequence;  // Odd while being written
+        uint32_t width;
+        uint32_t height;
+        uint32_t stride;  // Bytes per row
+        PreviewFormat format;
+        uint32_t reserved;
+        uint64_t frameNumber;  // Engine frame the preview was taken from
+        int64_t timestampNs;   // CLOCK_MONOTONIC
+    };
+
+    // Shared between processes, so the atomics must not fall back to a lock
+    static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+                  "Preview ring needs lock-free 32/64-bit atomics");
+
     // Limits
     constexpr uint32_t MAX_PAYLOAD_SIZE = 10 * 1024 * 1024;  // 10MB
     constexpr const char *SOCKET_PATH = "/tmp/vrobs.sock";
@@ -1,23 +1,156 @@
 #include "IDGenerator.h"
+#include <atomic>
+#include <chrono>
 #include <random>
-#include <sstream>
-#include <iomanip>
 #include <stdexcept>
 #include <cctype>
+#include <cstring>
+#include <thread>
 
 namespace NeuralStudio {
 
-std::string IDGenerator::generate(Species species, const std::string &type, const std::string &archetype)
+namespace {
+
+// Byte -> two lowercase hex chars
+constexpr auto kHexPairs = [] {
+	constexpr char digits[] = "0123456789abcdef";
+	std::array<std::array<char, 2>, 256> table{};
+	for (int i = 0; i < 256; ++i) {
+		table[i] = {digits[i >> 4], digits[i & 0xF]};
+	}
+	return table;
+}();
+
+// Hex char -> nibble, -1 if not hex
+constexpr auto kHexValues = [] {
+	std::array<int8_t, 256> table{};
+	for (auto &value : table)
+		value = -1;
+	for (int i = 0; i < 10; ++i)
+		table['0' + i] = static_cast<int8_t>(i);
+	for (int i = 0; i < 6; ++i) {
+		table['a' + i] = static_cast<int8_t>(10 + i);
+		table['A' + i] = static_cast<int8_t>(10 + i);
+	}
+	return table;
+}();
+
+// Byte offsets of the 16 UUID bytes' hex pairs within the 36-char text form (8-4-4-4-12)
+constexpr int kUUIDCharOffsets[16] = {0, 2, 4, 6, 9, 11, 14, 16, 19, 21, 24, 26, 28, 30, 32, 34};
+
+uint64_t splitMix64(uint64_t &state)
+{
+	uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+// xoshiro256**; one instance per thread so generation needs no locking
+class ThreadRandom {
+public:
+	ThreadRandom()
+	{
+		std::random_device device;
+		uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device();
+		seed ^= static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+		seed ^= static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+		for (auto &word : state_)
+			word = splitMix64(seed);
+	}
+
+	uint64_t next()
+	{
+		const uint64_t result = rotl(state_[1] * 5, 7) * 9;
+		const uint64_t t = state_[1] << 17;
+		state_[2] ^= state_[0];
+		state_[3] ^= state_[1];
+		state_[1] ^= state_[2];
+		state_[0] ^= state_[3];
+		state_[2] ^= t;
+		state_[3] = rotl(state_[3], 45);
+		return result;
+	}
+
+private:
+	static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+	uint64_t state_[4];
+};
+
+ThreadRandom &threadRandom()
+{
+	thread_local ThreadRandom random;
+	return random;
+}
+
+// Last V7 (unixMs << 12 | counter) handed out, shared so V7 IDs are monotonic across threads
+std::atomic<uint64_t> g_lastV7Tick{0};
+
+void writePadded(char *out, std::string_view value, size_t length)
+{
+	size_t n = value.size() < length ? value.size() : length;
+	std::memcpy(out, value.data(), n);
+	std::memset(out + n, '0', length - n);
+}
+
+} // namespace
+
+std::string IDGenerator::generate(Species species, std::string_view type, std::string_view archetype,
+				  UUIDVersion version)
+{
+	IDBuffer buffer;
+	generateInto(buffer, species, type, archetype, version);
+	return std::string(buffer.data(), buffer.size());
+}
+
+void IDGenerator::generateInto(IDBuffer &out, Species species, std::string_view type, std::string_view archetype,
+			       UUIDVersion version)
 {
 	validate(type, archetype);
 
-	std::string paddedType = pad(type, 2, '0');
-	std::string paddedArch = pad(archetype, 4, '0');
+	out[0] = static_cast<char>(species);
+	writePadded(out.data() + 1, type, 2);
+	writePadded(out.data() + 3, archetype, 4);
+	out[7] = '-';
+	formatUUID(generateBinary(version), out.data() + 8);
+}
+
+UUID128 IDGenerator::generateBinary(UUIDVersion version)
+{
+	return version == UUIDVersion::V7 ? generateV7() : generateV4();
+}
+
+void IDGenerator::formatUUID(const UUID128 &uuid, char *out)
+{
+	for (int i = 0; i < 16; ++i) {
+		const uint64_t word = i < 8 ? uuid.hi : uuid.lo;
+		const uint8_t byte = static_cast<uint8_t>(word >> (56 - 8 * (i & 7)));
+		std::memcpy(out + kUUIDCharOffsets[i], kHexPairs[byte].data(), 2);
+	}
+	out[8] = out[13] = out[18] = out[23] = '-';
+}
 
-	std::ostringstream oss;
-	oss << static_cast<char>(species) << paddedType << paddedArch << "-" << generateUUID();
+UUID128 IDGenerator::toBinary(std::string_view id)
+{
+	if (id.size() == IDLength && id[7] == '-') {
+		id.remove_prefix(8);
+	}
+	if (id.size() != UUIDLength || id[8] != '-' || id[13] != '-' || id[18] != '-' || id[23] != '-') {
+		return {};
+	}
 
-	return oss.str();
+	UUID128 uuid;
+	for (int i = 0; i < 16; ++i) {
+		const int high = kHexValues[static_cast<uint8_t>(id[kUUIDCharOffsets[i]])];
+		const int low = kHexValues[static_cast<uint8_t>(id[kUUIDCharOffsets[i] + 1])];
+		if (high < 0 || low < 0) {
+			return {};
+		}
+		uint64_t &word = i < 8 ? uuid.hi : uuid.lo;
+		word = (word << 8) | static_cast<uint64_t>((high << 4) | low);
+	}
+	return uuid;
 }
 
 Species IDGenerator::parseSpecies(const std::string &id)
@@ -100,44 +233,38 @@ bool IDGenerator::isSpecies(const std::string &id, Species species)
 
 // Private helpers
 
-std::string IDGenerator::generateUUID()
+UUID128 IDGenerator::generateV4()
 {
-	static std::random_device rd;
-	static std::mt19937 gen(rd());
-	static std::uniform_int_distribution<> dis(0, 15);
-	static std::uniform_int_distribution<> dis2(8, 11);
-
-	std::ostringstream oss;
-	oss << std::hex;
-
-	for (int i = 0; i < 8; ++i)
-		oss << dis(gen);
-	oss << "-";
-	for (int i = 0; i < 4; ++i)
-		oss << dis(gen);
-	oss << "-4"; // Version 4
-	for (int i = 0; i < 3; ++i)
-		oss << dis(gen);
-	oss << "-";
-	oss << dis2(gen); // Variant bits
-	for (int i = 0; i < 3; ++i)
-		oss << dis(gen);
-	oss << "-";
-	for (int i = 0; i < 12; ++i)
-		oss << dis(gen);
-
-	return oss.str();
+	ThreadRandom &random = threadRandom();
+	UUID128 uuid{random.next(), random.next()};
+	uuid.hi = (uuid.hi & ~0xF000ull) | 0x4000ull; // Version 4
+	uuid.lo = (uuid.lo & 0x3FFFFFFFFFFFFFFFull) | 0x8000000000000000ull; // Variant 10
+	return uuid;
 }
 
-std::string IDGenerator::pad(const std::string &str, size_t length, char padChar)
+UUID128 IDGenerator::generateV7()
 {
-	if (str.length() >= length) {
-		return str.substr(0, length);
-	}
-	return str + std::string(length - str.length(), padChar);
+	// RFC 9562 method 1: 48-bit unix ms, then rand_a used as a 12-bit counter within the ms.
+	// Counter overflow borrows from the next ms, so ordering holds even past 4096 IDs/ms.
+	const uint64_t nowMs = static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+			.count());
+
+	uint64_t last = g_lastV7Tick.load(std::memory_order_relaxed);
+	uint64_t tick;
+	do {
+		tick = nowMs << 12;
+		if (tick <= last)
+			tick = last + 1;
+	} while (!g_lastV7Tick.compare_exchange_weak(last, tick, std::memory_order_relaxed));
+
+	UUID128 uuid;
+	uuid.hi = ((tick >> 12) << 16) | 0x7000ull | (tick & 0xFFFull);
+	uuid.lo = (threadRandom().next() & 0x3FFFFFFFFFFFFFFFull) | 0x8000000000000000ull;
+	return uuid;
 }
 
-void IDGenerator::validate(const std::string &type, const std::string &archetype)
+void IDGenerator::validate(std::string_view type, std::string_view archetype)
 {
 	if (type.empty() || type.length() > 2) {
 		throw std::invalid_argument("Type must be 1-2 characters");
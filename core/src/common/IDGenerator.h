@@ -1,6 +1,11 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 
 namespace NeuralStudio {
 
@@ -56,6 +61,27 @@ enum class Species {
 	Extension = '7'
 };
 
+enum class UUIDVersion {
+	V4, // Random
+	V7  // Unix-ms timestamp + monotonic counter; sorts by creation time (DB indexes)
+};
+
+/**
+ * @brief 128-bit binary form of an ID's UUID part
+ *
+ * The UUID alone identifies an ID (the prefix is derived metadata), so this
+ * is the compact key for hashing and maps.
+ */
+struct UUID128 {
+	uint64_t hi{0};
+	uint64_t lo{0};
+
+	bool isNull() const { return hi == 0 && lo == 0; }
+	bool operator==(const UUID128 &other) const { return hi == other.hi && lo == other.lo; }
+	bool operator!=(const UUID128 &other) const { return !(*this == other); }
+	bool operator<(const UUID128 &other) const { return hi != other.hi ? hi < other.hi : lo < other.lo; }
+};
+
 /**
  * @brief Universal ID Generator
  * 
@@ -66,9 +92,17 @@ enum class Species {
  * - Self-documenting (can infer type from ID)
  * - Fast filtering (no database queries needed)
  * - Consistent across entire system
+ *
+ * Thread-safe and allocation-free on the buffer paths: each thread owns its
+ * PRNG state, and IDs are hex-encoded by table straight into a fixed
+ * 44-char buffer. The std::string overloads allocate only the result.
  */
 class IDGenerator {
 public:
+	static constexpr size_t IDLength = 44;
+	static constexpr size_t UUIDLength = 36;
+	using IDBuffer = std::array<char, IDLength>; // Not null-terminated
+
 	/**
      * Generate structured ID
      * @param species High-level category (N, C, P, S, etc.)
@@ -76,7 +110,19 @@ public:
      * @param archetype 4-character archetype code (CLIP, STRM, etc.)
      * @return Structured ID string
      */
-	static std::string generate(Species species, const std::string &type, const std::string &archetype);
+	static std::string generate(Species species, std::string_view type, std::string_view archetype,
+				    UUIDVersion version = UUIDVersion::V4);
+
+	// Same as generate() without allocating; throws std::invalid_argument like generate()
+	static void generateInto(IDBuffer &out, Species species, std::string_view type, std::string_view archetype,
+				 UUIDVersion version = UUIDVersion::V4);
+
+	// Bare UUIDs
+	static UUID128 generateBinary(UUIDVersion version = UUIDVersion::V4);
+	static void formatUUID(const UUID128 &uuid, char *out); // Writes exactly UUIDLength chars
+
+	// Binary UUID of a full ID or a bare UUID string; null UUID128 if malformed
+	static UUID128 toBinary(std::string_view id);
 
 	// Convenience methods
 	static std::string generateNode(const std::string &type, const std::string &archetype)
@@ -118,9 +164,19 @@ public:
 	static bool isEdgeID(const std::string &id) { return isSpecies(id, Species::Edge); }
 
 private:
-	static std::string generateUUID();
-	static std::string pad(const std::string &str, size_t length, char padChar);
-	static void validate(const std::string &type, const std::string &archetype);
+	static UUID128 generateV4();
+	static UUID128 generateV7();
+	static void validate(std::string_view type, std::string_view archetype);
 };
 
 } // namespace NeuralStudio
+
+namespace std {
+template<> struct hash<NeuralStudio::UUID128> {
+	size_t operator()(const NeuralStudio::UUID128 &uuid) const noexcept
+	{
+		// lo is random for both versions; multiply mixes V7's timestamp-heavy hi
+		return static_cast<size_t>(uuid.lo ^ (uuid.hi * 0x9E3779B97F4A7C15ull));
+	}
+};
+} // namespace std
@@ -1,9 +1,76 @@
 #include "IDGenerator.h"
 #include <iostream>
 #include <cassert>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 using namespace NeuralStudio;
 
+namespace {
+
+// The original ostringstream/shared-mt19937 implementation, kept as the benchmark baseline
+std::string legacyGenerateUUID()
+{
+	static std::random_device rd;
+	static std::mt19937 gen(rd());
+	static std::uniform_int_distribution<> dis(0, 15);
+	static std::uniform_int_distribution<> dis2(8, 11);
+
+	std::ostringstream oss;
+	oss << std::hex;
+
+	for (int i = 0; i < 8; ++i)
+		oss << dis(gen);
+	oss << "-";
+	for (int i = 0; i < 4; ++i)
+		oss << dis(gen);
+	oss << "-4";
+	for (int i = 0; i < 3; ++i)
+		oss << dis(gen);
+	oss << "-";
+	oss << dis2(gen);
+	for (int i = 0; i < 3; ++i)
+		oss << dis(gen);
+	oss << "-";
+	for (int i = 0; i < 12; ++i)
+		oss << dis(gen);
+
+	return oss.str();
+}
+
+std::string legacyGenerate(Species species, const std::string &type, const std::string &archetype)
+{
+	std::string paddedType = type + std::string(2 - type.length(), '0');
+	std::string paddedArch = archetype + std::string(4 - archetype.length(), '0');
+
+	std::ostringstream oss;
+	oss << static_cast<char>(species) << paddedType << paddedArch << "-" << legacyGenerateUUID();
+	return oss.str();
+}
+
+// Results of timed loops end up here; a volatile store can't be optimized away
+volatile size_t g_sink = 0;
+
+// IDs/sec for `count` calls of fn; `sink` keeps results observable so the loop isn't elided
+template<typename Fn> double idsPerSecond(int count, Fn &&fn)
+{
+	size_t sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; ++i) {
+		sink += fn();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	g_sink = sink;
+	return count / seconds;
+}
+
+} // namespace
+
 int main()
 {
 	std::cout << "=== Universal ID Generator Test ===" << std::endl;
@@ -60,6 +127,80 @@ int main()
 
 	std::cout << "All validation tests passed!" << std::endl;
 
+	std::cout << "\n=== Binary / UUIDv7 Test ===" << std::endl;
+
+	UUID128 binary = IDGenerator::toBinary(audioClipId);
+	assert(!binary.isNull());
+	assert(binary == IDGenerator::toBinary(uuid));
+	char text[IDGenerator::UUIDLength];
+	IDGenerator::formatUUID(binary, text);
+	assert(std::string(text, sizeof(text)) == uuid);
+	assert(((binary.hi >> 12) & 0xF) == 4);
+	assert(IDGenerator::toBinary("not-a-uuid").isNull());
+
+	IDGenerator::IDBuffer buffer;
+	IDGenerator::generateInto(buffer, Species::Event, "GR", "EVNT", UUIDVersion::V7);
+	std::string eventId(buffer.data(), buffer.size());
+	std::cout << "Graph Event (v7):   " << eventId << std::endl;
+	assert(IDGenerator::isValid(eventId));
+	assert(eventId[8 + 14] == '7');
+
+	// V7 IDs sort by creation order, both as binary and as text
+	UUID128 previous = IDGenerator::generateBinary(UUIDVersion::V7);
+	std::string previousId = IDGenerator::generate(Species::Event, "GR", "EVNT", UUIDVersion::V7);
+	for (int i = 0; i < 100000; ++i) {
+		UUID128 next = IDGenerator::generateBinary(UUIDVersion::V7);
+		assert(previous < next);
+		previous = next;
+	}
+	assert(previousId < IDGenerator::generate(Species::Event, "GR", "EVNT", UUIDVersion::V7));
+
+	// Per-thread generators must not collide
+	constexpr int threadCount = 4;
+	constexpr int perThread = 50000;
+	std::vector<std::vector<UUID128>> generated(threadCount);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t) {
+		threads.emplace_back([&generated, t] {
+			generated[t].reserve(perThread);
+			for (int i = 0; i < perThread; ++i)
+				generated[t].push_back(IDGenerator::generateBinary(i % 2 ? UUIDVersion::V7 : UUIDVersion::V4));
+		});
+	}
+	for (auto &thread : threads)
+		thread.join();
+
+	std::unordered_set<UUID128> unique;
+	for (const auto &ids : generated)
+		unique.insert(ids.begin(), ids.end());
+	assert(unique.size() == static_cast<size_t>(threadCount * perThread));
+	std::cout << "Binary/UUIDv7 tests passed!" << std::endl;
+
+	std::cout << "\n=== Throughput (IDs/sec) ===" << std::endl;
+	constexpr int benchCount = 200000;
+	double legacy = idsPerSecond(benchCount, [] { return legacyGenerate(Species::Node, "AU", "CLIP").size(); });
+	double asString = idsPerSecond(benchCount, [] { return IDGenerator::generateNode("AU", "CLIP").size(); });
+	double intoBuffer = idsPerSecond(benchCount, [&buffer] {
+		IDGenerator::generateInto(buffer, Species::Node, "AU", "CLIP");
+		return static_cast<size_t>(buffer[8]);
+	});
+	double intoBufferV7 = idsPerSecond(benchCount, [&buffer] {
+		IDGenerator::generateInto(buffer, Species::Event, "GR", "EVNT", UUIDVersion::V7);
+		return static_cast<size_t>(buffer[8]);
+	});
+	double binaryV4 = idsPerSecond(benchCount, [] { return static_cast<size_t>(IDGenerator::generateBinary().lo); });
+
+	std::cout << std::fixed << std::setprecision(0);
+	std::cout << "legacy (ostringstream):  " << std::setw(12) << legacy << std::endl;
+	std::cout << "generate (std::string):  " << std::setw(12) << asString << "  x" << std::setprecision(1)
+		  << asString / legacy << std::setprecision(0) << std::endl;
+	std::cout << "generateInto (buffer):   " << std::setw(12) << intoBuffer << "  x" << std::setprecision(1)
+		  << intoBuffer / legacy << std::setprecision(0) << std::endl;
+	std::cout << "generateInto v7:         " << std::setw(12) << intoBufferV7 << "  x" << std::setprecision(1)
+		  << intoBufferV7 / legacy << std::setprecision(0) << std::endl;
+	std::cout << "generateBinary:          " << std::setw(12) << binaryV4 << "  x" << std::setprecision(1)
+		  << binaryV4 / legacy << std::endl;
+
 	std::cout << "\n=== All Tests Passed! ===" << std::endl;
 	return 0;
 }
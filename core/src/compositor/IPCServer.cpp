@@ -0,0 +1,605 @@
+#include "IPCServer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace neural_studio {
+
+namespace {
+
+constexpr uint64_t kListenKey = 0;
+constexpr uint64_t kWakeKey = 1;
+constexpr uint64_t kFirstClientId = 2; // epoll keys below this are the server's own fds
+constexpr size_t kReadChunk = 64 * 1024;
+constexpr int kMaxChunksPerRead = 16; // Bounds one client's turn; epoll reports the rest again
+constexpr int kMaxEvents = 64;
+
+bool isClientMessage(VRProtocol::MessageType type)
+{
+	return type == VRProtocol::MessageType::Command || type == VRProtocol::MessageType::CommandBatch;
+}
+
+} // namespace
+
+struct IPCServer::Client {
+	uint64_t id = 0;
+	int fd = -1;
+	std::vector<char> readBuffer;
+	size_t readOffset = 0; // Start of the first unparsed frame
+	std::vector<char> writeBuffer;
+	size_t writeOffset = 0;
+	std::vector<std::pair<size_t, int>> fdMarkers; // (writeBuffer offset, fd): fd goes out with that byte
+	size_t nextFdMarker = 0;
+	bool wantsWrite = false; // EPOLLOUT registered
+};
+
+void IPCServer::MessageQueue::push(uint64_t clientId, VRProtocol::MessageType type, const void *data, uint32_t size)
+{
+	messages.push_back({clientId, type, bytes.size(), size});
+	const char *begin = static_cast<const char *>(data);
+	bytes.insert(bytes.end(), begin, begin + size);
+}
+
+IPCServer::IPCServer() : IPCServer(Config()) {}
+
+IPCServer::IPCServer(const Config &config) : m_config(config) {}
+
+IPCServer::~IPCServer()
+{
+	Stop();
+}
+
+void IPCServer::SetCommandCallback(CommandCallback cb)
+{
+	m_commandCallback = std::move(cb);
+}
+
+void IPCServer::SetTransformCallback(TransformCallback cb)
+{
+	m_transformCallback = std::move(cb);
+}
+
+void IPCServer::SetPreviewChannel(int fd, const VRProtocol::PreviewChannelInfo &info)
+{
+	if (m_previewFd >= 0)
+		close(m_previewFd);
+	m_previewFd = fd >= 0 ? fcntl(fd, F_DUPFD_CLOEXEC, 0) : -1;
+	m_previewInfo = info;
+}
+
+//=============================================================================
+// Lifecycle
+//=============================================================================
+
+bool IPCServer::Start(const std::string &socketPath)
+{
+	if (m_running.load())
+		return false;
+
+	sockaddr_un addr {};
+	if (socketPath.size() >= sizeof(addr.sun_path)) {
+		std::cerr << "[IPCServer] Socket path too long: " << socketPath << std::endl;
+		return false;
+	}
+	addr.sun_family = AF_UNIX;
+	std::memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+	m_serverFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (m_serverFd < 0) {
+		std::cerr << "[IPCServer] socket() failed: " << std::strerror(errno) << std::endl;
+		return false;
+	}
+
+	unlink(socketPath.c_str()); // Stale socket from a previous run
+	if (bind(m_serverFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+		std::cerr << "[IPCServer] Failed to bind " << socketPath << ": " << std::strerror(errno) << std::endl;
+		close(m_serverFd);
+		m_serverFd = -1;
+		return false;
+	}
+
+	// The socket file exists from here on; Stop() unlinks it on any later failure
+	m_socketPath = socketPath;
+	if (listen(m_serverFd, SOMAXCONN) < 0) {
+		std::cerr << "[IPCServer] Failed to listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+		Stop();
+		return false;
+	}
+
+	m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+	m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (m_epollFd < 0 || m_wakeFd < 0) {
+		std::cerr << "[IPCServer] epoll/eventfd setup failed: " << std::strerror(errno) << std::endl;
+		Stop();
+		return false;
+	}
+
+	epoll_event ev {};
+	ev.events = EPOLLIN;
+	ev.data.u64 = kListenKey;
+	epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_serverFd, &ev);
+	ev.data.u64 = kWakeKey;
+	epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+
+	m_nextClientId = kFirstClientId;
+	m_running.store(true, std::memory_order_release);
+	m_serverThread = std::thread(&IPCServer::ServerLoop, this);
+	return true;
+}
+
+void IPCServer::Stop()
+{
+	if (m_running.exchange(false)) {
+		Wake();
+		m_serverThread.join();
+	}
+
+	for (auto &[id, client] : m_clients) {
+		close(client->fd);
+		delete client;
+	}
+	m_clients.clear();
+
+	for (int *fd : {&m_serverFd, &m_epollFd, &m_wakeFd, &m_previewFd}) {
+		if (*fd >= 0) {
+			close(*fd);
+			*fd = -1;
+		}
+	}
+	if (!m_socketPath.empty()) {
+		unlink(m_socketPath.c_str());
+		m_socketPath.clear();
+	}
+
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	m_stats.clientsConnected = 0;
+}
+
+void IPCServer::Wake()
+{
+	uint64_t one = 1;
+	if (m_wakeFd >= 0) {
+		[[maybe_unused]] ssize_t written = write(m_wakeFd, &one, sizeof(one));
+	}
+}
+
+//=============================================================================
+// I/O Thread
+//=============================================================================
+
+void IPCServer::ServerLoop()
+{
+	epoll_event events[kMaxEvents];
+	while (m_running.load(std::memory_order_acquire)) {
+		int count = epoll_wait(m_epollFd, events, kMaxEvents, -1);
+		if (count < 0) {
+			if (errno == EINTR)
+				continue;
+			std::cerr << "[IPCServer] epoll_wait failed: " << std::strerror(errno) << std::endl;
+			break;
+		}
+
+		for (int i = 0; i < count; ++i) {
+			const uint64_t key = events[i].data.u64;
+			if (key == kListenKey) {
+				AcceptClients();
+				continue;
+			}
+			if (key == kWakeKey) {
+				uint64_t value;
+				[[maybe_unused]] ssize_t drained = read(m_wakeFd, &value, sizeof(value));
+				DeliverReplies();
+				continue;
+			}
+
+			auto it = m_clients.find(key);
+			if (it == m_clients.end())
+				continue; // Closed earlier in this batch of events
+
+			Client &client = *it->second;
+			if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+				CloseClient(key);
+				continue;
+			}
+			if (events[i].events & EPOLLOUT)
+				WriteClient(client);
+			if (m_clients.count(key) && (events[i].events & (EPOLLIN | EPOLLRDHUP)))
+				ReadClient(client);
+		}
+	}
+}
+
+void IPCServer::AcceptClients()
+{
+	for (;;) {
+		int fd = accept4(m_serverFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+				std::cerr << "[IPCServer] accept failed: " << std::strerror(errno) << std::endl;
+			return;
+		}
+		if (m_clients.size() >= m_config.maxClients) {
+			close(fd);
+			continue;
+		}
+
+		auto *client = new Client;
+		client->id = m_nextClientId++;
+		client->fd = fd;
+
+		epoll_event ev {};
+		ev.events = EPOLLIN | EPOLLRDHUP;
+		ev.data.u64 = client->id;
+		if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+			close(fd);
+			delete client;
+			continue;
+		}
+		m_clients.emplace(client->id, client);
+
+		std::lock_guard<std::mutex> lock(m_statsMutex);
+		m_stats.clientsAccepted++;
+		m_stats.clientsConnected = static_cast<uint32_t>(m_clients.size());
+	}
+}
+
+void IPCServer::ReadClient(Client &client)
+{
+	bool closed = false;
+	uint64_t received = 0;
+	for (int chunk = 0; chunk < kMaxChunksPerRead;) {
+		size_t used = client.readBuffer.size();
+		client.readBuffer.resize(used + kReadChunk);
+		ssize_t n = recv(client.fd, client.readBuffer.data() + used, kReadChunk, 0);
+		client.readBuffer.resize(used + (n > 0 ? static_cast<size_t>(n) : 0));
+		if (n > 0) {
+			received += static_cast<uint64_t>(n);
+			chunk++;
+			continue;
+		}
+		if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+			closed = true;
+		if (n < 0 && errno == EINTR)
+			continue;
+		break;
+	}
+
+	// Queue every complete frame under one lock
+	bool protocolError = false;
+	bool previewSubscribe = false;
+	{
+		std::lock_guard<std::mutex> lock(m_inboundMutex);
+		while (client.readBuffer.size() - client.readOffset >= sizeof(VRProtocol::Header)) {
+			VRProtocol::Header header;
+			std::memcpy(&header, client.readBuffer.data() + client.readOffset, sizeof(header));
+			if (header.payloadSize > VRProtocol::MAX_PAYLOAD_SIZE) {
+				protocolError = true;
+				break;
+			}
+			if (client.readBuffer.size() - client.readOffset < sizeof(header) + header.payloadSize)
+				break; // Rest of the payload hasn't arrived yet
+
+			const char *payload = client.readBuffer.data() + client.readOffset + sizeof(header);
+			if (isClientMessage(header.type)) {
+				m_inbound.push(client.id, header.type, payload, header.payloadSize);
+			} else if (header.type == VRProtocol::MessageType::PreviewFrame) {
+				previewSubscribe = true;
+			}
+			client.readOffset += sizeof(header) + header.payloadSize;
+		}
+	}
+
+	// Keep the partial frame (if any) at the front of the buffer
+	if (client.readOffset == client.readBuffer.size()) {
+		client.readBuffer.clear();
+		client.readOffset = 0;
+	} else if (client.readOffset > client.readBuffer.size() / 2) {
+		client.readBuffer.erase(client.readBuffer.begin(), client.readBuffer.begin() + client.readOffset);
+		client.readOffset = 0;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_statsMutex);
+		m_stats.bytesReceived += received;
+		if (protocolError)
+			m_stats.protocolErrors++;
+	}
+	if (closed || protocolError) {
+		CloseClient(client.id);
+		return;
+	}
+	if (previewSubscribe)
+		SendPreviewChannel(client);
+}
+
+void IPCServer::SendPreviewChannel(Client &client)
+{
+	// Needs no engine state, so it doesn't wait for the next frame like other replies
+	const bool available = m_previewFd >= 0;
+	VRProtocol::Header header {VRProtocol::MessageType::PreviewFrame,
+				   available ? static_cast<uint32_t>(sizeof(m_previewInfo)) : 0u};
+	if (available)
+		client.fdMarkers.emplace_back(client.writeBuffer.size(), m_previewFd);
+
+	const char *headerBytes = reinterpret_cast<const char *>(&header);
+	client.writeBuffer.insert(client.writeBuffer.end(), headerBytes, headerBytes + sizeof(header));
+	if (available) {
+		const char *info = reinterpret_cast<const char *>(&m_previewInfo);
+		client.writeBuffer.insert(client.writeBuffer.end(), info, info + sizeof(m_previewInfo));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_statsMutex);
+		m_stats.previewSubscriptions++;
+	}
+	WriteClient(client);
+}
+
+void IPCServer::WriteClient(Client &client)
+{
+	uint64_t sent = 0;
+	bool failed = false;
+	while (client.writeOffset < client.writeBuffer.size()) {
+		// A passed fd rides on the first byte of its message, so never send past the next marker
+		size_t end = client.writeBuffer.size();
+		int passFd = -1;
+		if (client.nextFdMarker < client.fdMarkers.size()) {
+			const auto &[offset, fd] = client.fdMarkers[client.nextFdMarker];
+			if (offset == client.writeOffset) {
+				passFd = fd;
+				if (client.nextFdMarker + 1 < client.fdMarkers.size())
+					end = client.fdMarkers[client.nextFdMarker + 1].first;
+			} else {
+				end = offset;
+			}
+		}
+
+		iovec iov {client.writeBuffer.data() + client.writeOffset, end - client.writeOffset};
+		msghdr msg {};
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+		if (passFd >= 0) {
+			msg.msg_control = control;
+			msg.msg_controllen = sizeof(control);
+			cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+			cmsg->cmsg_level = SOL_SOCKET;
+			cmsg->cmsg_type = SCM_RIGHTS;
+			cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+			std::memcpy(CMSG_DATA(cmsg), &passFd, sizeof(int));
+		}
+
+		ssize_t n = sendmsg(client.fd, &msg, MSG_NOSIGNAL);
+		if (n > 0) {
+			if (passFd >= 0)
+				client.nextFdMarker++;
+			client.writeOffset += static_cast<size_t>(n);
+			sent += static_cast<uint64_t>(n);
+			continue;
+		}
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		failed = true;
+		break;
+	}
+
+	if (client.writeOffset == client.writeBuffer.size()) {
+		client.writeBuffer.clear();
+		client.writeOffset = 0;
+		client.fdMarkers.clear();
+		client.nextFdMarker = 0;
+	}
+
+	// Only ask for EPOLLOUT while something is waiting to be written
+	bool wantsWrite = !client.writeBuffer.empty();
+	if (!failed && wantsWrite != client.wantsWrite) {
+		epoll_event ev {};
+		ev.events = EPOLLIN | EPOLLRDHUP | (wantsWrite ? uint32_t(EPOLLOUT) : 0u);
+		ev.data.u64 = client.id;
+		epoll_ctl(m_epollFd, EPOLL_CTL_MOD, client.fd, &ev);
+		client.wantsWrite = wantsWrite;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_statsMutex);
+		m_stats.bytesSent += sent;
+	}
+	if (failed)
+		CloseClient(client.id);
+}
+
+void IPCServer::CloseClient(uint64_t clientId)
+{
+	auto it = m_clients.find(clientId);
+	if (it == m_clients.end())
+		return;
+
+	epoll_ctl(m_epollFd, EPOLL_CTL_DEL, it->second->fd, nullptr);
+	close(it->second->fd);
+	delete it->second;
+	m_clients.erase(it);
+
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	m_stats.clientsConnected = static_cast<uint32_t>(m_clients.size());
+}
+
+void IPCServer::DeliverReplies()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_outboundMutex);
+		std::swap(m_outbound, m_delivering);
+	}
+
+	std::vector<uint64_t> touched;
+	for (const auto &message : m_delivering.messages) {
+		auto it = m_clients.find(message.clientId);
+		if (it == m_clients.end())
+			continue; // Disconnected before the frame that answered it
+
+		Client &client = *it->second;
+		VRProtocol::Header header {message.type, message.size};
+		const char *headerBytes = reinterpret_cast<const char *>(&header);
+		const char *payload = m_delivering.bytes.data() + message.offset;
+		if (client.writeBuffer.empty())
+			touched.push_back(client.id);
+		client.writeBuffer.insert(client.writeBuffer.end(), headerBytes, headerBytes + sizeof(header));
+		client.writeBuffer.insert(client.writeBuffer.end(), payload, payload + message.size);
+	}
+	m_delivering.clear();
+
+	for (uint64_t clientId : touched) {
+		auto it = m_clients.find(clientId);
+		if (it == m_clients.end())
+			continue;
+		WriteClient(*it->second);
+
+		it = m_clients.find(clientId);
+		if (it != m_clients.end() &&
+		    it->second->writeBuffer.size() - it->second->writeOffset > m_config.maxPendingReplyBytes) {
+			std::cerr << "[IPCServer] Dropping client " << clientId << ": not reading replies" << std::endl;
+			CloseClient(clientId);
+		}
+	}
+}
+
+//=============================================================================
+// Engine Thread
+//=============================================================================
+
+size_t IPCServer::ProcessPending()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_inboundMutex);
+		if (m_inbound.messages.empty())
+			return 0;
+		std::swap(m_inbound, m_processing);
+	}
+
+	uint64_t jsonCommands = 0;
+	uint64_t batches = 0;
+	uint64_t transformsReceived = 0;
+	uint64_t transformsApplied = 0;
+	uint64_t malformed = 0;
+
+	for (const auto &message : m_processing.messages) {
+		const char *payload = m_processing.bytes.data() + message.offset;
+
+		if (message.type == VRProtocol::MessageType::Command) {
+			// Commands see every earlier transform, so apply what was coalesced so far first
+			transformsApplied += m_transforms.size();
+			FlushTransforms();
+
+			std::string reply = m_commandCallback ? m_commandCallback(std::string(payload, message.size)) : std::string();
+			m_replies.push(message.clientId, VRProtocol::MessageType::Response, reply.data(),
+				       static_cast<uint32_t>(reply.size()));
+			jsonCommands++;
+			continue;
+		}
+
+		// CommandBatch: BatchHeader, then RecordHeader + body per record
+		VRProtocol::BatchHeader batch {};
+		if (message.size < sizeof(batch)) {
+			malformed++;
+			continue;
+		}
+		std::memcpy(&batch, payload, sizeof(batch));
+
+		uint32_t applied = 0;
+		size_t offset = sizeof(batch);
+		for (uint32_t r = 0; r < batch.count; ++r) {
+			VRProtocol::RecordHeader record;
+			if (message.size - offset < sizeof(record)) {
+				malformed++;
+				break;
+			}
+			std::memcpy(&record, payload + offset, sizeof(record));
+			offset += sizeof(record);
+			if (message.size - offset < record.size) {
+				malformed++;
+				break;
+			}
+
+			if (record.op == VRProtocol::CommandOp::SetTransform &&
+			    record.size >= sizeof(VRProtocol::TransformCommand)) {
+				VRProtocol::TransformCommand transform;
+				std::memcpy(&transform, payload + offset, sizeof(transform));
+				auto [it, inserted] = m_transformIndex.try_emplace(transform.nodeId, m_transforms.size());
+				if (inserted) {
+					m_transforms.push_back(transform);
+				} else {
+					m_transforms[it->second] = transform; // Superseded within this frame
+				}
+				transformsReceived++;
+				applied++;
+			} else if (record.op == VRProtocol::CommandOp::SetTransform) {
+				malformed++;
+			}
+			offset += record.size;
+		}
+
+		m_pendingAcks.push_back({message.clientId, {batch.sequence, applied}});
+		batches++;
+	}
+
+	transformsApplied += m_transforms.size();
+	FlushTransforms();
+	const size_t processed = m_processing.messages.size();
+	m_processing.clear();
+
+	{
+		std::lock_guard<std::mutex> lock(m_outboundMutex);
+		if (m_outbound.messages.empty()) {
+			std::swap(m_outbound, m_replies);
+		} else {
+			for (const auto &message : m_replies.messages) {
+				m_outbound.push(message.clientId, message.type, m_replies.bytes.data() + message.offset,
+						message.size);
+			}
+		}
+	}
+	m_replies.clear();
+	Wake();
+
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	m_stats.jsonCommands += jsonCommands;
+	m_stats.batches += batches;
+	m_stats.transformsReceived += transformsReceived;
+	m_stats.transformsApplied += transformsApplied;
+	m_stats.protocolErrors += malformed;
+	m_stats.frames++;
+	return processed;
+}
+
+void IPCServer::FlushTransforms()
+{
+	if (m_transformCallback) {
+		for (const auto &transform : m_transforms) {
+			m_transformCallback(transform);
+		}
+	}
+	m_transforms.clear();
+	m_transformIndex.clear();
+
+	// Batches are acknowledged only once everything in them has been applied
+	for (const auto &pending : m_pendingAcks) {
+		m_replies.push(pending.clientId, VRProtocol::MessageType::BatchAck, &pending.ack, sizeof(pending.ack));
+	}
+	m_pendingAcks.clear();
+}
+
+IPCServer::Stats IPCServer::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	return m_stats;
+}
+
+} // namespace neural_studio
@@ -0,0 +1,382 @@
+#include "PreviewChannel.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace neural_studio {
+
+namespace {
+
+// Linux 5.1+; older headers don't have it, older kernels reject it with EINVAL
+#ifndef F_SEAL_FUTURE_WRITE
+#define F_SEAL_FUTURE_WRITE 0x0010
+#endif
+
+constexpr uint32_t kBytesPerPixel = 4;
+constexpr int kMaxReadAttempts = 4;
+
+int64_t monotonicNs()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+size_t alignUp(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+VRProtocol::PreviewRingHeader *ringHeader(uint8_t *mapping)
+{
+	return reinterpret_cast<VRProtocol::PreviewRingHeader *>(mapping);
+}
+
+const VRProtocol::PreviewRingHeader *ringHeader(const uint8_t *mapping)
+{
+	return reinterpret_cast<const VRProtocol::PreviewRingHeader *>(mapping);
+}
+
+size_t slotOffset(const VRProtocol::PreviewRingHeader &ring, uint64_t frame)
+{
+	return sizeof(VRProtocol::PreviewRingHeader) + ((frame - 1) % ring.slotCount) * ring.slotStride;
+}
+
+bool sendAll(int fd, const void *data, size_t size)
+{
+	const char *bytes = static_cast<const char *>(data);
+	while (size > 0) {
+		ssize_t n = send(fd, bytes, size, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		bytes += n;
+		size -= static_cast<size_t>(n);
+	}
+	return true;
+}
+
+} // namespace
+
+//=============================================================================
+// Writer
+//=============================================================================
+
+PreviewFrameWriter::~PreviewFrameWriter()
+{
+	Destroy();
+}
+
+bool PreviewFrameWriter::Create(const Config &config)
+{
+	Destroy();
+	if (config.maxWidth == 0 || config.maxHeight == 0 || config.slotCount < 2)
+		return false;
+
+	m_config = config;
+	const size_t pixelCapacity = size_t(config.maxWidth) * config.maxHeight * kBytesPerPixel;
+	const size_t slotStride = alignUp(sizeof(VRProtocol::PreviewSlotHeader) + pixelCapacity, 4096);
+	m_mappingSize = sizeof(VRProtocol::PreviewRingHeader) + slotStride * config.slotCount;
+
+	m_fd = memfd_create("neural-studio-preview", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	if (m_fd < 0 || ftruncate(m_fd, static_cast<off_t>(m_mappingSize)) < 0) {
+		std::cerr << "[PreviewChannel] memfd setup failed: " << std::strerror(errno) << std::endl;
+		Destroy();
+		return false;
+	}
+	// Readers map the whole size; make sure it can never shrink under them
+	fcntl(m_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW);
+
+	void *mapping = mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+	if (mapping == MAP_FAILED) {
+		std::cerr << "[PreviewChannel] mmap failed: " << std::strerror(errno) << std::endl;
+		Destroy();
+		return false;
+	}
+	m_mapping = static_cast<uint8_t *>(mapping);
+
+	// Our mapping stays writable; nobody holding the fd can get a writable one or write() to it
+	if (fcntl(m_fd, F_ADD_SEALS, F_SEAL_FUTURE_WRITE) < 0) {
+		std::cerr << "[PreviewChannel] Kernel can't seal the preview ring against writes ("
+			  << std::strerror(errno) << "); readers are trusted to map it read-only" << std::endl;
+	}
+	fcntl(m_fd, F_ADD_SEALS, F_SEAL_SEAL);
+
+	// The memfd is zero-filled, so every slot starts at sequence 0 (stable, empty)
+	auto *ring = new (m_mapping) VRProtocol::PreviewRingHeader;
+	ring->magic = VRProtocol::PREVIEW_MAGIC;
+	ring->version = VRProtocol::PREVIEW_VERSION;
+	ring->slotCount = config.slotCount;
+	ring->maxWidth = config.maxWidth;
+	ring->maxHeight = config.maxHeight;
+	ring->reserved = 0;
+	ring->slotStride = slotStride;
+	ring->pixelCapacity = pixelCapacity;
+	ring->publishedFrames.store(0, std::memory_order_release);
+	for (uint32_t i = 0; i < config.slotCount; ++i) {
+		new (m_mapping + slotOffset(*ring, i + 1)) VRProtocol::PreviewSlotHeader {};
+	}
+
+	m_lastPublishNs = 0;
+	return true;
+}
+
+void PreviewFrameWriter::Destroy()
+{
+	if (m_mapping) {
+		munmap(m_mapping, m_mappingSize);
+		m_mapping = nullptr;
+	}
+	if (m_fd >= 0) {
+		close(m_fd);
+		m_fd = -1;
+	}
+	m_mappingSize = 0;
+}
+
+VRProtocol::PreviewChannelInfo PreviewFrameWriter::Info() const
+{
+	return {VRProtocol::PREVIEW_VERSION, m_config.slotCount, static_cast<uint64_t>(m_mappingSize)};
+}
+
+bool PreviewFrameWriter::ShouldPublish() const
+{
+	if (!m_mapping)
+		return false;
+	if (m_config.maxFps <= 0.0 || m_lastPublishNs == 0)
+		return true;
+	return monotonicNs() - m_lastPublishNs >= static_cast<int64_t>(1e9 / m_config.maxFps);
+}
+
+bool PreviewFrameWriter::Publish(const void *pixels, uint32_t width, uint32_t height, uint32_t stride,
+				 VRProtocol::PreviewFormat format, uint64_t frameNumber)
+{
+	if (!pixels || !ShouldPublish())
+		return false;
+
+	auto *ring = ringHeader(m_mapping);
+	const uint32_t rowBytes = width * kBytesPerPixel;
+	if (width == 0 || height == 0 || width > ring->maxWidth || height > ring->maxHeight || stride < rowBytes)
+		return false;
+
+	const uint64_t frame = ring->publishedFrames.load(std::memory_order_relaxed) + 1;
+	uint8_t *slotBase = m_mapping + slotOffset(*ring, frame);
+	auto *slot = reinterpret_cast<VRProtocol::PreviewSlotHeader *>(slotBase);
+	uint8_t *dst = slotBase + sizeof(VRProtocol::PreviewSlotHeader);
+
+	// Seqlock write: odd, then the data, then even again
+	const uint32_t sequence = slot->sequence.load(std::memory_order_relaxed);
+	slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot->width = width;
+	slot->height = height;
+	slot->stride = rowBytes; // Packed rows in the ring
+	slot->format = format;
+	slot->frameNumber = frameNumber;
+	slot->timestampNs = monotonicNs();
+	const auto *src = static_cast<const uint8_t *>(pixels);
+	if (stride == rowBytes) {
+		std::memcpy(dst, src, size_t(rowBytes) * height);
+	} else {
+		for (uint32_t y = 0; y < height; ++y) {
+			std::memcpy(dst + size_t(y) * rowBytes, src + size_t(y) * stride, rowBytes);
+		}
+	}
+
+	slot->sequence.store(sequence + 2, std::memory_order_release);
+	ring->publishedFrames.store(frame, std::memory_order_release);
+	m_lastPublishNs = slot->timestampNs;
+	return true;
+}
+
+uint64_t PreviewFrameWriter::PublishedFrames() const
+{
+	return m_mapping ? ringHeader(m_mapping)->publishedFrames.load(std::memory_order_acquire) : 0;
+}
+
+//=============================================================================
+// Reader
+//=============================================================================
+
+PreviewFrameReader::~PreviewFrameReader()
+{
+	Disconnect();
+}
+
+bool PreviewFrameReader::Connect(const std::string &socketPath)
+{
+	Disconnect();
+
+	sockaddr_un addr {};
+	if (socketPath.size() >= sizeof(addr.sun_path))
+		return false;
+	addr.sun_family = AF_UNIX;
+	std::memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+	int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (sock < 0)
+		return false;
+	if (connect(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+		close(sock);
+		return false;
+	}
+
+	// Dedicated connection: the reply to the subscribe is the only thing it will read
+	VRProtocol::Header request {VRProtocol::MessageType::PreviewFrame, 0};
+	if (!sendAll(sock, &request, sizeof(request))) {
+		close(sock);
+		return false;
+	}
+
+	struct {
+		VRProtocol::Header header;
+		VRProtocol::PreviewChannelInfo info;
+	} reply {};
+	static_assert(sizeof(reply) == sizeof(VRProtocol::Header) + sizeof(VRProtocol::PreviewChannelInfo));
+
+	int receivedFd = -1;
+	size_t received = 0;
+	size_t expected = sizeof(reply.header);
+	char *bytes = reinterpret_cast<char *>(&reply);
+	while (received < expected) {
+		iovec iov {bytes + received, expected - received};
+		alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+		msghdr msg {};
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+
+		ssize_t n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			break;
+		for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+			if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS && receivedFd < 0)
+				std::memcpy(&receivedFd, CMSG_DATA(cmsg), sizeof(int));
+		}
+
+		received += static_cast<size_t>(n);
+		if (received == sizeof(reply.header) && expected == sizeof(reply.header))
+			expected += std::min<size_t>(reply.header.payloadSize, sizeof(reply.info));
+	}
+	close(sock);
+
+	const bool valid = received == expected && reply.header.type == VRProtocol::MessageType::PreviewFrame &&
+			   reply.header.payloadSize == sizeof(reply.info) && receivedFd >= 0;
+	if (!valid) {
+		if (receivedFd >= 0)
+			close(receivedFd);
+		return false; // Engine has no preview channel (or isn't one)
+	}
+	return Attach(receivedFd, reply.info);
+}
+
+bool PreviewFrameReader::Attach(int fd, const VRProtocol::PreviewChannelInfo &info)
+{
+	Disconnect();
+	if (fd < 0)
+		return false;
+
+	m_fd = fd;
+	if (info.version != VRProtocol::PREVIEW_VERSION || info.mappingSize < sizeof(VRProtocol::PreviewRingHeader)) {
+		Disconnect();
+		return false;
+	}
+
+	void *mapping = mmap(nullptr, info.mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED) {
+		Disconnect();
+		return false;
+	}
+	m_mapping = static_cast<const uint8_t *>(mapping);
+	m_mappingSize = info.mappingSize;
+
+	// Don't trust a layout that wouldn't fit the mapping
+	const auto *ring = ringHeader(m_mapping);
+	const bool valid = ring->magic == VRProtocol::PREVIEW_MAGIC && ring->slotCount >= 2 &&
+			   ring->slotStride >= sizeof(VRProtocol::PreviewSlotHeader) + ring->pixelCapacity &&
+			   sizeof(VRProtocol::PreviewRingHeader) + ring->slotStride * ring->slotCount <= m_mappingSize;
+	if (!valid) {
+		Disconnect();
+		return false;
+	}
+	return true;
+}
+
+void PreviewFrameReader::Disconnect()
+{
+	if (m_mapping) {
+		munmap(const_cast<uint8_t *>(m_mapping), m_mappingSize);
+		m_mapping = nullptr;
+	}
+	if (m_fd >= 0) {
+		close(m_fd);
+		m_fd = -1;
+	}
+	m_mappingSize = 0;
+}
+
+uint64_t PreviewFrameReader::PublishedFrames() const
+{
+	return m_mapping ? ringHeader(m_mapping)->publishedFrames.load(std::memory_order_acquire) : 0;
+}
+
+bool PreviewFrameReader::ReadLatest(Frame &frame) const
+{
+	if (!m_mapping)
+		return false;
+
+	const auto *ring = ringHeader(m_mapping);
+	for (int attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+		const uint64_t latest = ring->publishedFrames.load(std::memory_order_acquire);
+		if (latest == 0 || latest <= frame.published)
+			return false;
+
+		const uint8_t *slotBase = m_mapping + slotOffset(*ring, latest);
+		const auto *slot = reinterpret_cast<const VRProtocol::PreviewSlotHeader *>(slotBase);
+		const uint32_t before = slot->sequence.load(std::memory_order_acquire);
+		if (before & 1)
+			continue; // Writer lapped the ring and is inside this slot
+
+		// Copy first, validate after; the values are only used if the sequence held
+		const uint32_t width = slot->width;
+		const uint32_t height = slot->height;
+		const uint32_t stride = slot->stride;
+		const size_t size = size_t(stride) * height;
+		if (size > ring->pixelCapacity)
+			continue;
+		frame.pixels.resize(size);
+		std::memcpy(frame.pixels.data(), slotBase + sizeof(VRProtocol::PreviewSlotHeader), size);
+		const VRProtocol::PreviewFormat format = slot->format;
+		const uint64_t frameNumber = slot->frameNumber;
+		const int64_t timestampNs = slot->timestampNs;
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot->sequence.load(std::memory_order_relaxed) != before)
+			continue;
+
+		frame.width = width;
+		frame.height = height;
+		frame.stride = stride;
+		frame.format = format;
+		frame.frameNumber = frameNumber;
+		frame.timestampNs = timestampNs;
+		frame.published = latest;
+		return true;
+	}
+	return false;
+}
+
+} // namespace neural_studio
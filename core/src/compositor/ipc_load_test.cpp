@@ -0,0 +1,364 @@
+#include "IPCServer.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Load test for the engine command channel: N clients stream transform updates
+// either as binary CommandBatch messages or as one JSON updateNode command each,
+// and measure commands/sec and the send -> applied-and-acknowledged latency.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum class Mode { Binary, Json };
+
+struct LoadOptions {
+	std::string connectPath; // Empty: host a server in-process
+	int clients = 4;
+	int batch = 64;   // Transform updates per batch
+	int window = 4;   // Batches in flight per client
+	double seconds = 3.0;
+	int fps = 90;     // Engine frame rate of the in-process server
+	int nodes = 1000; // Distinct node ids the updates are spread over
+	bool binary = true;
+	bool json = true;
+};
+
+struct ClientResult {
+	uint64_t commands = 0;
+	uint64_t bytesSent = 0;
+	std::vector<double> latenciesMs; // Per batch
+	bool failed = false;
+};
+
+bool sendAll(int fd, const char *data, size_t size)
+{
+	while (size > 0) {
+		ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		data += n;
+		size -= static_cast<size_t>(n);
+	}
+	return true;
+}
+
+bool recvAll(int fd, void *out, size_t size)
+{
+	char *data = static_cast<char *>(out);
+	while (size > 0) {
+		ssize_t n = recv(fd, data, size, 0);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		data += n;
+		size -= static_cast<size_t>(n);
+	}
+	return true;
+}
+
+bool readMessage(int fd, VRProtocol::Header &header, std::vector<char> &payload)
+{
+	if (!recvAll(fd, &header, sizeof(header)) || header.payloadSize > VRProtocol::MAX_PAYLOAD_SIZE)
+		return false;
+	payload.resize(header.payloadSize);
+	return recvAll(fd, payload.data(), payload.size());
+}
+
+int connectTo(const std::string &path)
+{
+	sockaddr_un addr {};
+	if (path.size() >= sizeof(addr.sun_path))
+		return -1;
+	addr.sun_family = AF_UNIX;
+	std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+template<typename T> void append(std::vector<char> &buffer, const T &value)
+{
+	const char *bytes = reinterpret_cast<const char *>(&value);
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+// One batch as it goes on the wire; binary = one CommandBatch, JSON = one Command per update
+void buildBatch(Mode mode, uint32_t sequence, const LoadOptions &options, std::mt19937 &rng, std::vector<char> &out)
+{
+	std::uniform_int_distribution<uint32_t> nodeDist(1, static_cast<uint32_t>(options.nodes));
+	std::uniform_real_distribution<float> posDist(-10.0f, 10.0f);
+	out.clear();
+
+	if (mode == Mode::Binary) {
+		const uint32_t recordSize = sizeof(VRProtocol::RecordHeader) + sizeof(VRProtocol::TransformCommand);
+		append(out, VRProtocol::Header {VRProtocol::MessageType::CommandBatch,
+						static_cast<uint32_t>(sizeof(VRProtocol::BatchHeader) +
+								      recordSize * options.batch)});
+		append(out, VRProtocol::BatchHeader {sequence, static_cast<uint32_t>(options.batch)});
+		for (int i = 0; i < options.batch; ++i) {
+			append(out, VRProtocol::RecordHeader {VRProtocol::CommandOp::SetTransform,
+							      static_cast<uint16_t>(sizeof(VRProtocol::TransformCommand))});
+			VRProtocol::TransformCommand transform {nodeDist(rng),
+								{posDist(rng), posDist(rng), posDist(rng)},
+								{0.0f, 0.0f, 0.0f, 1.0f},
+								{1.0f, 1.0f, 1.0f}};
+			append(out, transform);
+		}
+		return;
+	}
+
+	for (int i = 0; i < options.batch; ++i) {
+		nlohmann::json command = {{"command", "updateNode"},
+					  {"id", std::to_string(nodeDist(rng))},
+					  {"updates",
+					   {{"position", {posDist(rng), posDist(rng), posDist(rng)}},
+					    {"rotation", {0.0f, 0.0f, 0.0f, 1.0f}},
+					    {"scale", {1.0f, 1.0f, 1.0f}}}}};
+		std::string text = command.dump();
+		append(out, VRProtocol::Header {VRProtocol::MessageType::Command, static_cast<uint32_t>(text.size())});
+		out.insert(out.end(), text.begin(), text.end());
+	}
+}
+
+void runClient(Mode mode, const std::string &path, const LoadOptions &options, Clock::time_point deadline,
+	       uint32_t seed, ClientResult &result)
+{
+	int fd = connectTo(path);
+	if (fd < 0) {
+		result.failed = true;
+		return;
+	}
+
+	std::mt19937 rng(seed);
+	std::vector<char> wire;
+	std::vector<char> payload;
+	std::vector<Clock::time_point> sentAt(static_cast<size_t>(options.window));
+	uint32_t nextSequence = 0;
+	uint32_t nextAck = 0; // Batches complete in order on one connection
+	int responsesLeft = options.batch; // JSON: responses outstanding for batch nextAck
+
+	while (true) {
+		// Keep the window full until the deadline, then drain
+		while (nextSequence - nextAck < static_cast<uint32_t>(options.window) && Clock::now() < deadline) {
+			buildBatch(mode, nextSequence, options, rng, wire);
+			sentAt[nextSequence % sentAt.size()] = Clock::now();
+			if (!sendAll(fd, wire.data(), wire.size())) {
+				result.failed = true;
+				close(fd);
+				return;
+			}
+			result.bytesSent += wire.size();
+			nextSequence++;
+		}
+		if (nextAck == nextSequence)
+			break;
+
+		VRProtocol::Header header;
+		if (!readMessage(fd, header, payload)) {
+			result.failed = true;
+			break;
+		}
+
+		bool completed = false;
+		if (mode == Mode::Binary && header.type == VRProtocol::MessageType::BatchAck &&
+		    payload.size() >= sizeof(VRProtocol::BatchAck)) {
+			VRProtocol::BatchAck ack;
+			std::memcpy(&ack, payload.data(), sizeof(ack));
+			completed = ack.sequence == nextAck;
+		} else if (mode == Mode::Json && header.type == VRProtocol::MessageType::Response) {
+			completed = --responsesLeft == 0;
+		}
+		if (!completed)
+			continue;
+
+		auto latency = Clock::now() - sentAt[nextAck % sentAt.size()];
+		result.latenciesMs.push_back(std::chrono::duration<double, std::milli>(latency).count());
+		result.commands += static_cast<uint64_t>(options.batch);
+		responsesLeft = options.batch;
+		nextAck++;
+	}
+	close(fd);
+}
+
+double percentile(std::vector<double> &values, double p)
+{
+	if (values.empty())
+		return 0.0;
+	size_t index = std::min(values.size() - 1, static_cast<size_t>(p * static_cast<double>(values.size())));
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index];
+}
+
+void runMode(Mode mode, const std::string &path, const LoadOptions &options)
+{
+	std::vector<ClientResult> results(static_cast<size_t>(options.clients));
+	std::vector<std::thread> threads;
+	auto start = Clock::now();
+	auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+	for (int c = 0; c < options.clients; ++c) {
+		threads.emplace_back(runClient, mode, std::cref(path), std::cref(options), deadline,
+				     static_cast<uint32_t>(c + 1), std::ref(results[c]));
+	}
+	for (auto &thread : threads)
+		thread.join();
+	double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+	uint64_t commands = 0;
+	uint64_t bytes = 0;
+	int failed = 0;
+	std::vector<double> latencies;
+	for (auto &result : results) {
+		commands += result.commands;
+		bytes += result.bytesSent;
+		failed += result.failed ? 1 : 0;
+		latencies.insert(latencies.end(), result.latenciesMs.begin(), result.latenciesMs.end());
+	}
+
+	double p50 = percentile(latencies, 0.50);
+	double p99 = percentile(latencies, 0.99);
+	double max = latencies.empty() ? 0.0 : *std::max_element(latencies.begin(), latencies.end());
+	std::cout << std::left << std::setw(8) << (mode == Mode::Binary ? "binary" : "json") << std::right
+		  << std::setw(14) << static_cast<uint64_t>(commands / elapsed) << std::setw(12)
+		  << (commands ? bytes / commands : 0) << std::setw(10) << p50 << std::setw(10) << p99 << std::setw(10)
+		  << max << std::setw(10) << latencies.size();
+	if (failed)
+		std::cout << "  (" << failed << " client(s) failed)";
+	std::cout << std::endl;
+}
+
+void printUsage(const char *program)
+{
+	std::cout << "Usage: " << program << " [options]\n"
+		  << "  --connect PATH  load an already running engine (default: host a server in-process)\n"
+		  << "  --mode MODE     binary, json or both (default: both)\n"
+		  << "  --clients N     concurrent connections (default: 4)\n"
+		  << "  --batch N       transform updates per batch (default: 64)\n"
+		  << "  --window N      batches in flight per client (default: 4)\n"
+		  << "  --seconds S     duration per mode (default: 3)\n"
+		  << "  --fps N         in-process engine frame rate (default: 90)\n"
+		  << "  --nodes N       distinct node ids to update (default: 1000)\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	LoadOptions options;
+	for (int i = 1; i < argc; ++i) {
+		const char *arg = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (!std::strcmp(arg, "--connect") && value) {
+			options.connectPath = value;
+		} else if (!std::strcmp(arg, "--mode") && value) {
+			options.binary = !std::strcmp(value, "binary") || !std::strcmp(value, "both");
+			options.json = !std::strcmp(value, "json") || !std::strcmp(value, "both");
+		} else if (!std::strcmp(arg, "--clients") && value) {
+			options.clients = std::max(1, std::atoi(value));
+		} else if (!std::strcmp(arg, "--batch") && value) {
+			options.batch = std::clamp(std::atoi(value), 1, 100000);
+		} else if (!std::strcmp(arg, "--window") && value) {
+			options.window = std::max(1, std::atoi(value));
+		} else if (!std::strcmp(arg, "--seconds") && value) {
+			options.seconds = std::max(0.1, std::atof(value));
+		} else if (!std::strcmp(arg, "--fps") && value) {
+			options.fps = std::max(1, std::atoi(value));
+		} else if (!std::strcmp(arg, "--nodes") && value) {
+			options.nodes = std::max(1, std::atoi(value));
+		} else {
+			printUsage(argv[0]);
+			return !std::strcmp(arg, "--help") ? 0 : 2;
+		}
+		++i;
+	}
+
+	// In-process engine: applies commands once per frame like the compositor loop does
+	neural_studio::IPCServer server;
+	std::atomic<bool> engineRunning {false};
+	std::thread engine;
+	std::vector<VRProtocol::TransformCommand> scene(static_cast<size_t>(options.nodes) + 1);
+	std::string path = options.connectPath;
+
+	if (path.empty()) {
+		path = "/tmp/neural-studio-ipc-load-" + std::to_string(getpid()) + ".sock";
+		server.SetTransformCallback([&](const VRProtocol::TransformCommand &transform) {
+			if (transform.nodeId < scene.size())
+				scene[transform.nodeId] = transform;
+		});
+		server.SetCommandCallback([&](const std::string &message) -> std::string {
+			// Same parse and lookup the compositor's updateNode handler does
+			auto j = nlohmann::json::parse(message, nullptr, false);
+			if (j.is_discarded() || !j.contains("id"))
+				return "{\"status\": \"error\"}";
+			uint32_t nodeId = static_cast<uint32_t>(std::stoul(j["id"].get<std::string>()));
+			if (nodeId < scene.size() && j.contains("updates") && j["updates"].contains("position")) {
+				auto p = j["updates"]["position"];
+				scene[nodeId].position[0] = p[0];
+				scene[nodeId].position[1] = p[1];
+				scene[nodeId].position[2] = p[2];
+			}
+			return "{\"status\": \"ok\"}";
+		});
+		if (!server.Start(path)) {
+			std::cerr << "Failed to start the in-process server on " << path << std::endl;
+			return 1;
+		}
+
+		engineRunning = true;
+		engine = std::thread([&] {
+			const auto frame = std::chrono::nanoseconds(1000000000LL / options.fps);
+			auto next = Clock::now();
+			while (engineRunning.load()) {
+				next += frame;
+				std::this_thread::sleep_until(next);
+				server.ProcessPending();
+			}
+		});
+	}
+
+	std::cout << "=== Engine Command Channel Load Test ===" << std::endl;
+	std::cout << "server: " << (options.connectPath.empty() ? "in-process @ " + std::to_string(options.fps) + " fps" : path)
+		  << ", clients: " << options.clients << ", batch: " << options.batch << ", window: " << options.window
+		  << ", nodes: " << options.nodes << std::endl;
+	std::cout << std::left << std::setw(8) << "mode" << std::right << std::setw(14) << "commands/s" << std::setw(12)
+		  << "bytes/cmd" << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms" << std::setw(10) << "max ms"
+		  << std::setw(10) << "batches" << std::endl;
+	std::cout << std::fixed << std::setprecision(2);
+
+	if (options.binary)
+		runMode(Mode::Binary, path, options);
+	if (options.json)
+		runMode(Mode::Json, path, options);
+
+	if (engine.joinable()) {
+		engineRunning = false;
+		engine.join();
+		auto stats = server.GetStats();
+		std::cout << "server: " << stats.frames << " frames, " << stats.transformsReceived << " transforms -> "
+			  << stats.transformsApplied << " applied after coalescing, " << stats.jsonCommands
+			  << " JSON commands, " << stats.protocolErrors << " protocol errors" << std::endl;
+		server.Stop();
+	}
+	return 0;
+}
@@ -8,6 +8,7 @@
 #include <SceneManager.h>
 #include <nlohmann/json.hpp>
 #include <IPCServer.h>
+#include <PreviewChannel.h>
 #include <memory>
 
 // Factory from libvr
@@ -199,7 +200,26 @@ int main(int argc, char **argv)
 		return "{\"status\": \"ok\", \"echo\": \"accepted\"}";
 	});
 
-	if (!ipcServer.Start("/tmp/vrobs.sock")) {
+	// High-rate transform updates arrive as binary batches keyed by scene id
+	ipcServer.SetTransformCallback([&](const VRProtocol::TransformCommand &cmd) {
+		neural_studio::Transform t;
+		for (int i = 0; i < 3; ++i) {
+			t.position[i] = cmd.position[i];
+			t.scale[i] = cmd.scale[i];
+		}
+		for (int i = 0; i < 4; ++i) {
+			t.rotation[i] = cmd.rotation[i];
+		}
+		sceneManager.SetTransform(cmd.nodeId, t);
+	});
+
+	// Preview frames for the UI go through shared memory, not the socket
+	neural_studio::PreviewFrameWriter previewWriter;
+	if (previewWriter.Create({})) {
+		ipcServer.SetPreviewChannel(previewWriter.Fd(), previewWriter.Info());
+	}
+
+	if (!ipcServer.Start(VRProtocol::SOCKET_PATH)) {
 		std::cerr << "[obs-vr] Failed to start IPC Server." << std::endl;
 		// Warning only
 	}
@@ -208,6 +228,9 @@ int main(int argc, char **argv)
 	std::cout << "[obs-vr] Entering Main Loop..." << std::endl;
 	xrRuntime.RunLoop([&]() {
 		// This callback runs every frame synchronized with VR
+		// 0. Apply UI commands received since the last frame (callbacks run here, on the engine thread)
+		ipcServer.ProcessPending();
+
 		// 1. Acquire Image for View 0 (Left Eye) - MVP: Single resolved image or stereo handling
 		// For MVP, we render mono or assume side-by-side or just View 0.
 		// Let's do View 0.
@@ -224,6 +247,9 @@ int main(int argc, char **argv)
 
 		// MVP: Handle View 1 (Right Eye) by recalling ProcessFrame or doing Stereo logic
 		// For now, we only drive one loop.
+
+		// Preview: check ShouldPublish() before reading the composited frame back, then
+		// previewWriter.Publish(). FrameRouter has no CPU readback yet, so nothing is published.
 	});
 
 	ipcServer.Stop();
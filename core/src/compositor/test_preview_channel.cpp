@@ -0,0 +1,168 @@
+#include "PreviewChannel.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Stress test for the preview ring's seqlock: one writer publishes as fast as it
+// can (frames change size and stride as they go) while several readers copy the
+// newest frame. Every pixel word of a frame carries its frame number, so a copy
+// the writer overwrote halfway shows up as torn if the seqlock let it through.
+
+using namespace neural_studio;
+
+namespace {
+
+constexpr uint32_t kMaxWidth = 320;
+constexpr uint32_t kMaxHeight = 180;
+
+uint32_t widthFor(uint64_t frame)
+{
+	return 16 + static_cast<uint32_t>(frame * 7 % (kMaxWidth - 15));
+}
+
+uint32_t heightFor(uint64_t frame)
+{
+	return 8 + static_cast<uint32_t>(frame * 13 % (kMaxHeight - 7));
+}
+
+struct ReaderResult {
+	uint64_t reads = 0;
+	uint64_t torn = 0;
+	uint64_t outOfOrder = 0;
+	uint64_t badHeader = 0;
+};
+
+ReaderResult readUntil(PreviewFrameReader &reader, const std::atomic<bool> &running)
+{
+	ReaderResult result;
+	PreviewFrameReader::Frame frame;
+	uint64_t lastPublished = 0;
+
+	while (running.load(std::memory_order_relaxed)) {
+		if (!reader.ReadLatest(frame))
+			continue;
+
+		result.reads++;
+		if (frame.published <= lastPublished)
+			result.outOfOrder++;
+		lastPublished = frame.published;
+
+		// The writer publishes frame n as engine frame n
+		if (frame.frameNumber != frame.published || frame.width != widthFor(frame.frameNumber) ||
+		    frame.height != heightFor(frame.frameNumber) || frame.stride != frame.width * 4) {
+			result.badHeader++;
+			continue;
+		}
+
+		const uint32_t expected = static_cast<uint32_t>(frame.frameNumber);
+		const size_t words = frame.pixels.size() / sizeof(uint32_t);
+		for (size_t i = 0; i < words; ++i) {
+			uint32_t word;
+			std::memcpy(&word, frame.pixels.data() + i * sizeof(uint32_t), sizeof(word));
+			if (word != expected) {
+				result.torn++;
+				break;
+			}
+		}
+	}
+	return result;
+}
+
+// With F_SEAL_FUTURE_WRITE in place a reader must not get a writable mapping
+bool checkSeals(int fd, size_t size)
+{
+	const int seals = fcntl(fd, F_GET_SEALS);
+#ifdef F_SEAL_FUTURE_WRITE
+	if (seals < 0 || !(seals & F_SEAL_FUTURE_WRITE)) {
+		std::cout << "Kernel without F_SEAL_FUTURE_WRITE, skipping the write seal check" << std::endl;
+		return true;
+	}
+#else
+	(void)seals;
+	std::cout << "Headers without F_SEAL_FUTURE_WRITE, skipping the write seal check" << std::endl;
+	return true;
+#endif
+
+	void *writable = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (writable != MAP_FAILED) {
+		munmap(writable, size);
+		std::cerr << "FAILED: reader fd could be mapped writable" << std::endl;
+		return false;
+	}
+	std::cout << "Write seal: OK" << std::endl;
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const double seconds = argc > 1 ? std::atof(argv[1]) : 1.0;
+	const int readerCount = argc > 2 ? std::atoi(argv[2]) : 3;
+
+	PreviewFrameWriter writer;
+	PreviewFrameWriter::Config config;
+	config.maxWidth = kMaxWidth;
+	config.maxHeight = kMaxHeight;
+	config.slotCount = 3;
+	config.maxFps = 0.0; // Unthrottled: lap the readers as often as possible
+	if (!writer.Create(config)) {
+		std::cerr << "Could not create the preview ring" << std::endl;
+		return 1;
+	}
+
+	bool ok = checkSeals(writer.Fd(), writer.Info().mappingSize);
+
+	std::vector<PreviewFrameReader> readers(static_cast<size_t>(readerCount));
+	for (auto &reader : readers) {
+		if (!reader.Attach(dup(writer.Fd()), writer.Info())) {
+			std::cerr << "Reader could not attach" << std::endl;
+			return 1;
+		}
+	}
+
+	std::atomic<bool> running {true};
+	std::vector<ReaderResult> results(readers.size());
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < readers.size(); ++i) {
+		threads.emplace_back([&, i] { results[i] = readUntil(readers[i], running); });
+	}
+
+	// Alternate packed and padded source rows to cover both copy paths
+	std::vector<uint32_t> pixels((kMaxWidth + 8) * kMaxHeight);
+	uint64_t published = 0;
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+	while (std::chrono::steady_clock::now() < deadline) {
+		const uint64_t frame = published + 1;
+		const uint32_t width = widthFor(frame);
+		const uint32_t height = heightFor(frame);
+		const uint32_t strideWords = width + (frame % 2 ? 8 : 0);
+		for (uint32_t y = 0; y < height; ++y)
+			std::fill_n(pixels.begin() + size_t(y) * strideWords, width, static_cast<uint32_t>(frame));
+
+		if (writer.Publish(pixels.data(), width, height, strideWords * 4, VRProtocol::PreviewFormat::RGBA8, frame))
+			published++;
+	}
+
+	running.store(false);
+	for (auto &thread : threads)
+		thread.join();
+
+	std::cout << "Published " << published << " frames" << std::endl;
+	for (size_t i = 0; i < results.size(); ++i) {
+		const ReaderResult &r = results[i];
+		std::cout << "Reader " << i << ": " << r.reads << " reads, " << r.torn << " torn, " << r.badHeader
+			  << " bad headers, " << r.outOfOrder << " out of order" << std::endl;
+		ok = ok && r.reads > 0 && r.torn == 0 && r.badHeader == 0 && r.outOfOrder == 0;
+	}
+
+	std::cout << (ok ? "All preview channel tests passed" : "FAILED") << std::endl;
+	return ok ? 0 : 1;
+}
@@ -6,7 +6,7 @@
 namespace NeuralStudio {
 namespace Rendering {
 
-FramebufferManager::FramebufferManager(QRhi *rhi, QObject *parent) : QObject(parent), m_rhi(rhi) {}
+FramebufferManager::FramebufferManager(QRhi *rhi, QObject *parent) : QObject(parent), m_rhi(rhi), m_texturePool(rhi) {}
 
 FramebufferManager::~FramebufferManager()
 {
@@ -14,6 +14,7 @@ FramebufferManager::~FramebufferManager()
 	for (const auto &profile : m_profiles) {
 		releaseFramebuffersForProfile(profile.id);
 	}
+	releaseSharedTargets();
 }
 
 bool FramebufferManager::addProfile(const ProfileConfig &config)
@@ -38,6 +39,7 @@ bool FramebufferManager::addProfile(const ProfileConfig &config)
 	// Create framebuffers if profile is enabled
 	if (config.enabled) {
 		createFramebuffersForProfile(config);
+		updateSharedTargets();
 	}
 
 	qInfo() << "Added VR profile:" << QString::fromStdString(config.name);
@@ -59,6 +61,7 @@ void FramebufferManager::removeProfile(const std::string &profileId)
 	m_profiles.erase(std::remove_if(m_profiles.begin(), m_profiles.end(),
 					[&profileId](const ProfileConfig &p) { return p.id == profileId; }),
 			 m_profiles.end());
+	updateSharedTargets();
 
 	qInfo() << "Removed profile:" << QString::fromStdString(profileId);
 	emit profileRemoved(QString::fromStdString(profileId));
@@ -89,15 +92,16 @@ void FramebufferManager::setProfileEnabled(const std::string &profileId, bool en
 		releaseFramebuffersForProfile(profileId);
 		qInfo() << "Disabled profile:" << QString::fromStdString(profileId);
 	}
+	updateSharedTargets();
 }
 
 FramebufferManager::FramebufferSet *FramebufferManager::getFramebufferSet(const std::string &profileId)
 {
 	auto it = std::find_if(m_framebuffers.begin(), m_framebuffers.end(),
-			       [&profileId](const FramebufferSet &fb) { return fb.profileId == profileId; });
+			       [&profileId](const auto &fb) { return fb->profileId == profileId; });
 
 	if (it != m_framebuffers.end()) {
-		return &(*it);
+		return it->get();
 	}
 
 	return nullptr;
@@ -118,13 +122,49 @@ void FramebufferManager::swapBuffers(const std::string &profileId)
 {
 	auto *fbSet = getFramebufferSet(profileId);
 	if (fbSet) {
-		// Rotate triple buffers
-		fbSet->writeBufferIndex = (fbSet->writeBufferIndex + 1) % fbSet->NumBuffers;
-		fbSet->renderBufferIndex = (fbSet->renderBufferIndex + 1) % fbSet->NumBuffers;
-		fbSet->displayBufferIndex = (fbSet->displayBufferIndex + 1) % fbSet->NumBuffers;
+		fbSet->handoff.publish();
 	}
 }
 
+TripleBuffer::Stats FramebufferManager::getHandoffStats(const std::string &profileId) const
+{
+	auto it = std::find_if(m_framebuffers.begin(), m_framebuffers.end(),
+			       [&profileId](const auto &fb) { return fb->profileId == profileId; });
+
+	return it != m_framebuffers.end() ? (*it)->handoff.stats() : TripleBuffer::Stats();
+}
+
+void FramebufferManager::setSharedRendering(bool enabled)
+{
+	if (m_sharedRendering == enabled) {
+		return;
+	}
+
+	m_sharedRendering = enabled;
+	updateSharedTargets();
+	qInfo() << "Shared eye rendering" << (enabled ? "enabled" : "disabled");
+}
+
+FramebufferManager::SharedEyeTargets *FramebufferManager::getSharedEyeTargets()
+{
+	return m_sharedRendering ? m_sharedTargets.get() : nullptr;
+}
+
+bool FramebufferManager::usesSharedRender(const std::string &profileId) const
+{
+	return m_sharedRendering && m_sharedTargets && m_sharedLayout.findViewport(profileId) != nullptr;
+}
+
+void FramebufferManager::beginFrame()
+{
+	m_texturePool.beginFrame();
+}
+
+void FramebufferManager::endFrame()
+{
+	m_texturePool.endFrame();
+}
+
 bool FramebufferManager::resizeProfile(const std::string &profileId, uint32_t width, uint32_t height)
 {
 	auto it = std::find_if(m_profiles.begin(), m_profiles.end(),
@@ -134,6 +174,8 @@ bool FramebufferManager::resizeProfile(const std::string &profileId, uint32_t wi
 		return false;
 	}
 
+	const TexturePool::TextureDesc oldDesc = eyeBufferDesc(it->eyeWidth, it->eyeHeight);
+
 	// Update resolution
 	it->eyeWidth = width;
 	it->eyeHeight = height;
@@ -142,79 +184,148 @@ bool FramebufferManager::resizeProfile(const std::string &profileId, uint32_t wi
 	if (it->enabled) {
 		releaseFramebuffersForProfile(profileId);
 		createFramebuffersForProfile(*it);
+		updateSharedTargets();
 		emit framebuffersRecreated();
 	}
 
+	// Don't hold the old size until the budget forces it out; profiles still
+	// at that size keep their leased textures
+	m_texturePool.releaseUnused(oldDesc);
+
 	qInfo() << "Resized profile" << QString::fromStdString(profileId) << "to" << width << "x" << height;
 	return true;
 }
 
 void FramebufferManager::createFramebuffersForProfile(const ProfileConfig &config)
 {
-	FramebufferSet fbSet;
+	auto ownedSet = std::make_unique<FramebufferSet>();
+	FramebufferSet &fbSet = *ownedSet;
 	fbSet.profileId = config.id;
 
-	// Create triple-buffered textures for each eye
+	// Triple-buffered eye textures with render targets, reused from the pool when a
+	// profile of the same size was enabled before
+	const TexturePool::TextureDesc desc = eyeBufferDesc(config.eyeWidth, config.eyeHeight);
+	const uint64_t allocationsBefore = m_texturePool.stats().allocations;
+
 	for (int i = 0; i < fbSet.NumBuffers; ++i) {
-		// Left eye texture
-		fbSet.leftEyeTextures[i].reset(
-			m_rhi->newTexture(QRhiTexture::RGBA8, QSize(config.eyeWidth, config.eyeHeight), 1,
-					  QRhiTexture::RenderTarget | QRhiTexture::UsedAsTransferSource));
-
-		if (!fbSet.leftEyeTextures[i]->create()) {
-			qCritical() << "Failed to create left eye texture" << i << "for"
-				    << QString::fromStdString(config.id);
+		fbSet.leftEyeBuffers[i] = m_texturePool.acquire(desc);
+		fbSet.rightEyeBuffers[i] = m_texturePool.acquire(desc);
+
+		if (!fbSet.leftEyeBuffers[i] || !fbSet.rightEyeBuffers[i]) {
+			qCritical() << "Failed to create eye framebuffers" << i << "for" << QString::fromStdString(config.id);
+			for (int j = 0; j <= i; ++j) {
+				m_texturePool.release(fbSet.leftEyeBuffers[j]);
+				m_texturePool.release(fbSet.rightEyeBuffers[j]);
+			}
 			return;
 		}
+	}
 
-		// Right eye texture
-		fbSet.rightEyeTextures[i].reset(
-			m_rhi->newTexture(QRhiTexture::RGBA8, QSize(config.eyeWidth, config.eyeHeight), 1,
-					  QRhiTexture::RenderTarget | QRhiTexture::UsedAsTransferSource));
+	// Add to framebuffer list
+	m_framebuffers.push_back(std::move(ownedSet));
 
-		if (!fbSet.rightEyeTextures[i]->create()) {
-			qCritical() << "Failed to create right eye texture" << i << "for"
-				    << QString::fromStdString(config.id);
-			return;
+	const uint64_t allocated = m_texturePool.stats().allocations - allocationsBefore;
+	qInfo() << "Created triple-buffered framebuffers (3x buffers) for profile" << QString::fromStdString(config.id);
+	qInfo() << "  Total textures:" << (fbSet.NumBuffers * 2) << "(" << fbSet.NumBuffers << "L +" << fbSet.NumBuffers
+		<< "R)," << (fbSet.NumBuffers * 2 - allocated) << "reused from the pool";
+}
+
+void FramebufferManager::updateSharedTargets()
+{
+	std::vector<SharedEyeLayout::ProfileView> views;
+	if (m_sharedRendering) {
+		for (const auto &profile : m_profiles) {
+			if (profile.enabled) {
+				views.push_back({profile.id, profile.eyeWidth, profile.eyeHeight, profile.fovHorizontal,
+						 profile.fovVertical, profile.ipd});
+			}
 		}
+	}
 
-		// Left eye render target
-		fbSet.leftEyeTargets[i].reset(m_rhi->newTextureRenderTarget({fbSet.leftEyeTextures[i].get()}));
-		fbSet.leftEyePasses[i].reset(fbSet.leftEyeTargets[i]->newCompatibleRenderPassDescriptor());
-		fbSet.leftEyeTargets[i]->setRenderPassDescriptor(fbSet.leftEyePasses[i].get());
+	m_sharedLayout = SharedEyeLayout::compute(views);
+	if (!m_sharedLayout.isValid()) {
+		releaseSharedTargets();
+		return;
+	}
 
-		if (!fbSet.leftEyeTargets[i]->create()) {
-			qCritical() << "Failed to create left eye render target" << i << "for"
-				    << QString::fromStdString(config.id);
-			return;
-		}
+	// Profile changes that leave the shared size alone don't touch the shared textures
+	if (m_sharedTargets && m_sharedTargets->width == m_sharedLayout.eyeWidth &&
+	    m_sharedTargets->height == m_sharedLayout.eyeHeight) {
+		return;
+	}
 
-		// Right eye render target
-		fbSet.rightEyeTargets[i].reset(m_rhi->newTextureRenderTarget({fbSet.rightEyeTextures[i].get()}));
-		fbSet.rightEyePasses[i].reset(fbSet.rightEyeTargets[i]->newCompatibleRenderPassDescriptor());
-		fbSet.rightEyeTargets[i]->setRenderPassDescriptor(fbSet.rightEyePasses[i].get());
+	if (m_sharedTargets) {
+		const TexturePool::TextureDesc oldDesc = sharedEyeDesc(m_sharedTargets->width, m_sharedTargets->height);
+		releaseSharedTargets();
+		m_texturePool.releaseUnused(oldDesc);
+	}
+	if (!createSharedTargets(m_sharedLayout.eyeWidth, m_sharedLayout.eyeHeight)) {
+		m_sharedLayout = SharedEyeLayout();
+		return;
+	}
 
-		if (!fbSet.rightEyeTargets[i]->create()) {
-			qCritical() << "Failed to create right eye render target" << i << "for"
-				    << QString::fromStdString(config.id);
-			return;
-		}
+	qInfo() << "Shared eye targets:" << m_sharedLayout.eyeWidth << "x" << m_sharedLayout.eyeHeight << "per eye,"
+		<< m_sharedLayout.fovHorizontal << "°H x" << m_sharedLayout.fovVertical << "°V for"
+		<< m_sharedLayout.viewports.size() << "profiles";
+	qInfo() << "  Pixels rendered per frame:" << m_sharedLayout.sharedPixelsPerFrame() << "(vs"
+		<< m_sharedLayout.separatePixelsPerFrame() << "rendering each profile)";
+	emit framebuffersRecreated();
+}
+
+bool FramebufferManager::createSharedTargets(uint32_t width, uint32_t height)
+{
+	const TexturePool::TextureDesc desc = sharedEyeDesc(width, height);
+
+	auto targets = std::make_unique<SharedEyeTargets>();
+	targets->width = width;
+	targets->height = height;
+	targets->leftEye = m_texturePool.acquire(desc);
+	targets->rightEye = m_texturePool.acquire(desc);
+
+	if (!targets->leftEye || !targets->rightEye) {
+		qCritical() << "Failed to create shared eye targets" << width << "x" << height;
+		m_texturePool.release(targets->leftEye);
+		m_texturePool.release(targets->rightEye);
+		return false;
 	}
 
-	// Add to framebuffer list
-	m_framebuffers.push_back(std::move(fbSet));
+	m_sharedTargets = std::move(targets);
+	return true;
+}
 
-	qInfo() << "Created triple-buffered framebuffers (3x buffers) for profile" << QString::fromStdString(config.id);
-	qInfo() << "  Total textures:" << (fbSet.NumBuffers * 2) << "(" << fbSet.NumBuffers << "L +" << fbSet.NumBuffers
-		<< "R)";
+void FramebufferManager::releaseSharedTargets()
+{
+	if (m_sharedTargets) {
+		m_texturePool.release(m_sharedTargets->leftEye);
+		m_texturePool.release(m_sharedTargets->rightEye);
+		m_sharedTargets.reset();
+	}
+}
+
+TexturePool::TextureDesc FramebufferManager::eyeBufferDesc(uint32_t width, uint32_t height)
+{
+	return {QRhiTexture::RGBA8, width, height, QRhiTexture::RenderTarget | QRhiTexture::UsedAsTransferSource};
+}
+
+TexturePool::TextureDesc FramebufferManager::sharedEyeDesc(uint32_t width, uint32_t height)
+{
+	// Sampled by the per-profile crop/rescale pass
+	return {QRhiTexture::RGBA8, width, height, QRhiTexture::RenderTarget | QRhiTexture::UsedAsTexture};
 }
 
 void FramebufferManager::releaseFramebuffersForProfile(const std::string &profileId)
 {
-	m_framebuffers.erase(
-		std::remove_if(m_framebuffers.begin(), m_framebuffers.end(),
-			       [&profileId](const FramebufferSet &fb) { return fb.profileId == profileId; }),
-		m_framebuffers.end());
+	auto it = std::stable_partition(m_framebuffers.begin(), m_framebuffers.end(),
+					[&profileId](const auto &fb) { return fb->profileId != profileId; });
+
+	// Back to the pool: re-enabling the profile reuses them
+	for (auto released = it; released != m_framebuffers.end(); ++released) {
+		for (int i = 0; i < FramebufferSet::NumBuffers; ++i) {
+			m_texturePool.release((*released)->leftEyeBuffers[i]);
+			m_texturePool.release((*released)->rightEyeBuffers[i]);
+		}
+	}
+	m_framebuffers.erase(it, m_framebuffers.end());
 
 	qDebug() << "Released framebuffers for profile" << QString::fromStdString(profileId);
 }
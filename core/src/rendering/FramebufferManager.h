@@ -11,6 +11,9 @@ class QRhiRenderPassDescriptor;
 #include <vector>
 #include <string>
 #include <array>
+#include "SharedEyeLayout.h"
+#include "TexturePool.h"
+#include "TripleBuffer.h"
 
 namespace NeuralStudio {
     namespace Rendering {
@@ -39,6 +42,7 @@ namespace NeuralStudio {
                 float fovHorizontal = 110.0f;  // degrees
                 float fovVertical = 96.0f;     // degrees
                 float refreshRate = 90.0f;     // Hz
+                float ipd = 63.0f;             // mm
 
                 // Encoding
                 std::string codec = "h265";  // "h265", "av1"
@@ -52,59 +56,62 @@ namespace NeuralStudio {
             struct FramebufferSet {
                 std::string profileId;
 
-                // Triple buffering for smooth VR rendering
-                // Buffer 0: CPU writes (current frame being prepared)
-                // Buffer 1: GPU renders (previous frame being composited)
-                // Buffer 2: Display reads (frame being encoded/streamed)
-                static constexpr int NumBuffers = 3;
+                // Triple buffering between the renderer and the encoder thread:
+                // the renderer draws into the write buffer, the encoder reads the
+                // display buffer, and handoff passes completed frames between them
+                // without locks (see TripleBuffer.h)
+                static constexpr int NumBuffers = TripleBuffer::NumBuffers;
 
-                // Stereo framebuffers (L/R) x 3 buffers
-                std::array<std::unique_ptr<QRhiTexture>, NumBuffers> leftEyeTextures;
-                std::array<std::unique_ptr<QRhiTexture>, NumBuffers> rightEyeTextures;
+                // Stereo framebuffers (L/R) x 3 buffers, leased from the texture pool
+                // (texture + render target + render pass descriptor each)
+                std::array<TexturePool::PooledTexture *, NumBuffers> leftEyeBuffers {};
+                std::array<TexturePool::PooledTexture *, NumBuffers> rightEyeBuffers {};
 
-                // Render targets x 3 buffers
-                std::array<std::unique_ptr<QRhiTextureRenderTarget>, NumBuffers> leftEyeTargets;
-                std::array<std::unique_ptr<QRhiTextureRenderTarget>, NumBuffers> rightEyeTargets;
+                TripleBuffer handoff;
 
-                // Render pass descriptors x 3 buffers
-                std::array<std::unique_ptr<QRhiRenderPassDescriptor>, NumBuffers> leftEyePasses;
-                std::array<std::unique_ptr<QRhiRenderPassDescriptor>, NumBuffers> rightEyePasses;
-
-                // Current buffer indices
-                int writeBufferIndex = 0;    // CPU writes here
-                int renderBufferIndex = 2;   // GPU renders from here
-                int displayBufferIndex = 1;  // Encoder reads from here
-
-                // Get current textures for writing
+                // Get current textures for writing (renderer thread)
                 QRhiTexture *getCurrentLeftTexture()
                 {
-                    return leftEyeTextures[writeBufferIndex].get();
+                    return leftEyeBuffers[handoff.writeIndex()]->texture.get();
                 }
                 QRhiTexture *getCurrentRightTexture()
                 {
-                    return rightEyeTextures[writeBufferIndex].get();
+                    return rightEyeBuffers[handoff.writeIndex()]->texture.get();
                 }
-
-                // Get textures for rendering (previous frame)
-                QRhiTexture *getRenderLeftTexture()
+                QRhiTextureRenderTarget *getCurrentLeftTarget()
                 {
-                    return leftEyeTextures[renderBufferIndex].get();
+                    return leftEyeBuffers[handoff.writeIndex()]->renderTarget.get();
                 }
-                QRhiTexture *getRenderRightTexture()
+                QRhiTextureRenderTarget *getCurrentRightTarget()
                 {
-                    return rightEyeTextures[renderBufferIndex].get();
+                    return rightEyeBuffers[handoff.writeIndex()]->renderTarget.get();
                 }
 
-                // Get textures for display/encoding (oldest frame)
+                // Get textures for display/encoding (encoder thread; newest frame after acquireDisplay())
+                bool acquireDisplay()
+                {
+                    return handoff.acquire();
+                }
                 QRhiTexture *getDisplayLeftTexture()
                 {
-                    return leftEyeTextures[displayBufferIndex].get();
+                    return leftEyeBuffers[handoff.displayIndex()]->texture.get();
                 }
                 QRhiTexture *getDisplayRightTexture()
                 {
-                    return rightEyeTextures[displayBufferIndex].get();
+                    return rightEyeBuffers[handoff.displayIndex()]->texture.get();
                 }
             };
+
+            // Shared render mode: one render per eye at the shared layout's size and FOV,
+            // cropped/rescaled into each profile's current write buffer afterwards
+            struct SharedEyeTargets {
+                uint32_t width = 0;
+                uint32_t height = 0;
+
+                TexturePool::PooledTexture *leftEye = nullptr;
+                TexturePool::PooledTexture *rightEye = nullptr;
+            };
+
             explicit FramebufferManager(QRhi *rhi, QObject *parent = nullptr);
             ~FramebufferManager() override;
 
@@ -125,6 +132,9 @@ namespace NeuralStudio {
 
             /**
      * @brief Get framebuffer set for a profile
+     *
+     * The set stays at the same address until its profile is removed, disabled
+     * or resized, so the encoder thread can hold on to it.
      */
             FramebufferSet *getFramebufferSet(const std::string &profileId);
 
@@ -134,10 +144,65 @@ namespace NeuralStudio {
             std::vector<std::string> getActiveProfiles() const;
 
             /**
-     * @brief Swap buffers for a profile (double buffering)
+     * @brief Publish the frame just rendered for a profile (renderer thread)
+     *
+     * Never blocks; the encoder picks it up with FramebufferSet::acquireDisplay().
      */
             void swapBuffers(const std::string &profileId);
 
+            /**
+     * @brief Frames handed to the encoder, dropped and repeated for a profile
+     */
+            TripleBuffer::Stats getHandoffStats(const std::string &profileId) const;
+
+            /**
+     * @brief Render the scene once per eye for all enabled profiles
+     *
+     * Keeps a single shared eye pair sized by SharedEyeLayout; each profile's
+     * framebuffers then only receive a crop/rescale pass (see getSharedLayout()).
+     * Profiles that can't share (different IPD) still render on their own.
+     * This is the only owner of the shared targets; renderers query them here.
+     */
+            void setSharedRendering(bool enabled);
+            bool isSharedRendering() const
+            {
+                return m_sharedRendering;
+            }
+
+            const SharedEyeLayout &getSharedLayout() const
+            {
+                return m_sharedLayout;
+            }
+
+            /**
+     * @brief Shared eye render targets, or nullptr if shared rendering is off
+     */
+            SharedEyeTargets *getSharedEyeTargets();
+
+            /**
+     * @brief Whether a profile is derived from the shared render this frame
+     */
+            bool usesSharedRender(const std::string &profileId) const;
+
+            /**
+     * @brief Frame boundaries for the texture pool, called by the render loop
+     *
+     * endFrame() frees pooled textures that sat unused for the pool's idle window.
+     */
+            void beginFrame();
+            void endFrame();
+
+            /**
+     * @brief Pool all framebuffers are leased from
+     *
+     * Disabled profiles return their textures here, so re-enabling a profile
+     * reuses them. Textures of a size dropped by resizeProfile() are freed.
+     */
+            TexturePool &getTexturePool()
+            {
+                return m_texturePool;
+            }
+
             /**
      * @brief Resize framebuffers for a profile
      */
@@ -151,10 +216,21 @@ namespace NeuralStudio {
               private:
             void createFramebuffersForProfile(const ProfileConfig &config);
             void releaseFramebuffersForProfile(const std::string &profileId);
+            void updateSharedTargets();
+            bool createSharedTargets(uint32_t width, uint32_t height);
+            void releaseSharedTargets();
+
+            static TexturePool::TextureDesc eyeBufferDesc(uint32_t width, uint32_t height);
+            static TexturePool::TextureDesc sharedEyeDesc(uint32_t width, uint32_t height);
 
             QRhi *m_rhi;
+            TexturePool m_texturePool;
             std::vector<ProfileConfig> m_profiles;
-            std::vector<FramebufferSet> m_framebuffers;
+            std::vector<std::unique_ptr<FramebufferSet>> m_framebuffers;  // Heap-allocated: the handoff is shared across threads
+
+            bool m_sharedRendering = false;
+            SharedEyeLayout m_sharedLayout;
+            std::unique_ptr<SharedEyeTargets> m_sharedTargets;  // Null while not shared
         };
 
     }  // namespace Rendering
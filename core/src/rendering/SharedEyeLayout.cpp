@@ -0,0 +1,97 @@
+#include "SharedEyeLayout.h"
+#include <algorithm>
+#include <cmath>
+
+namespace NeuralStudio {
+namespace Rendering {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Half extent of the image plane at unit distance
+double halfTangent(float fovDegrees)
+{
+	return std::tan(fovDegrees * 0.5 * kPi / 180.0);
+}
+
+} // namespace
+
+const SharedEyeLayout::Viewport *SharedEyeLayout::findViewport(const std::string &profileId) const
+{
+	auto it = std::find_if(viewports.begin(), viewports.end(),
+			       [&profileId](const Viewport &v) { return v.id == profileId; });
+	return it != viewports.end() ? &(*it) : nullptr;
+}
+
+uint64_t SharedEyeLayout::sharedPixelsPerFrame() const
+{
+	return 2ull * eyeWidth * eyeHeight;
+}
+
+uint64_t SharedEyeLayout::separatePixelsPerFrame() const
+{
+	uint64_t pixels = 0;
+	for (const auto &viewport : viewports) {
+		pixels += 2ull * viewport.outputWidth * viewport.outputHeight;
+	}
+	return pixels;
+}
+
+SharedEyeLayout SharedEyeLayout::compute(const std::vector<ProfileView> &profiles, uint32_t maxEyeDimension,
+					 float ipdToleranceMm)
+{
+	SharedEyeLayout layout;
+	if (profiles.empty())
+		return layout;
+
+	layout.ipd = profiles.front().ipd;
+
+	// Widest half-tangent and highest density (pixels per unit tangent) in each direction
+	std::vector<const ProfileView *> shared;
+	double tanX = 0.0, tanY = 0.0;
+	double densityX = 0.0, densityY = 0.0;
+	for (const auto &profile : profiles) {
+		const double tx = halfTangent(profile.fovHorizontal);
+		const double ty = halfTangent(profile.fovVertical);
+		if (std::abs(profile.ipd - layout.ipd) > ipdToleranceMm || !(tx > 0.0) || !(ty > 0.0) ||
+		    profile.eyeWidth == 0 || profile.eyeHeight == 0) {
+			layout.separateProfiles.push_back(profile.id);
+			continue;
+		}
+
+		shared.push_back(&profile);
+		tanX = std::max(tanX, tx);
+		tanY = std::max(tanY, ty);
+		densityX = std::max(densityX, profile.eyeWidth / (2.0 * tx));
+		densityY = std::max(densityY, profile.eyeHeight / (2.0 * ty));
+	}
+	if (shared.empty())
+		return layout;
+
+	const double width = std::ceil(2.0 * tanX * densityX);
+	const double height = std::ceil(2.0 * tanY * densityY);
+	layout.eyeWidth = static_cast<uint32_t>(std::min<double>(width, maxEyeDimension));
+	layout.eyeHeight = static_cast<uint32_t>(std::min<double>(height, maxEyeDimension));
+	layout.fovHorizontal = static_cast<float>(2.0 * std::atan(tanX) * 180.0 / kPi);
+	layout.fovVertical = static_cast<float>(2.0 * std::atan(tanY) * 180.0 / kPi);
+
+	for (const ProfileView *profile : shared) {
+		const double extentX = 0.5 * halfTangent(profile->fovHorizontal) / tanX;
+		const double extentY = 0.5 * halfTangent(profile->fovVertical) / tanY;
+
+		Viewport viewport;
+		viewport.id = profile->id;
+		viewport.u0 = static_cast<float>(0.5 - extentX);
+		viewport.u1 = static_cast<float>(0.5 + extentX);
+		viewport.v0 = static_cast<float>(0.5 - extentY);
+		viewport.v1 = static_cast<float>(0.5 + extentY);
+		viewport.outputWidth = profile->eyeWidth;
+		viewport.outputHeight = profile->eyeHeight;
+		layout.viewports.push_back(viewport);
+	}
+	return layout;
+}
+
+} // namespace Rendering
+} // namespace NeuralStudio
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NeuralStudio {
+    namespace Rendering {
+
+        /**
+ * @brief SharedEyeLayout - Render each eye once for every headset profile
+ *
+ * Headset profiles differ in per-eye resolution and field of view. Rendered
+ * from the same eye position, a rectilinear view with a narrower FOV is
+ * exactly a centered crop of a wider one, so the scene can be rendered once
+ * per eye with the widest FOV at the highest pixel density any profile
+ * needs, and each profile's output derived by a crop + rescale pass.
+ *
+ * Profiles whose IPD differs from the shared one see the scene from another
+ * eye position; they are listed in separateProfiles and rendered on their own.
+ */
+        struct SharedEyeLayout {
+            struct ProfileView {
+                std::string id;
+                uint32_t eyeWidth = 0;
+                uint32_t eyeHeight = 0;
+                float fovHorizontal = 0.0f;  // degrees
+                float fovVertical = 0.0f;    // degrees
+                float ipd = 0.0f;            // mm
+            };
+
+            // Normalized source rectangle in the shared eye texture for one profile
+            struct Viewport {
+                std::string id;
+                float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+                uint32_t outputWidth = 0;  // Profile's per-eye resolution
+                uint32_t outputHeight = 0;
+            };
+
+            // Shared render target, per eye
+            uint32_t eyeWidth = 0;
+            uint32_t eyeHeight = 0;
+            float fovHorizontal = 0.0f;  // degrees
+            float fovVertical = 0.0f;    // degrees
+            float ipd = 0.0f;            // mm
+
+            std::vector<Viewport> viewports;
+            std::vector<std::string> separateProfiles;
+
+            bool isValid() const
+            {
+                return eyeWidth > 0 && eyeHeight > 0 && !viewports.empty();
+            }
+
+            const Viewport *findViewport(const std::string &profileId) const;
+
+            // Pixels rendered per frame (both eyes), shared vs. one render per profile
+            uint64_t sharedPixelsPerFrame() const;
+            uint64_t separatePixelsPerFrame() const;
+
+            /**
+     * @brief Compute the shared layout for a set of profiles
+     *
+     * The first profile's IPD is used for the shared render. Each shared
+     * dimension is capped at maxEyeDimension by lowering the pixel density.
+     */
+            static SharedEyeLayout compute(const std::vector<ProfileView> &profiles, uint32_t maxEyeDimension = 4096,
+                                           float ipdToleranceMm = 0.5f);
+        };
+
+    }  // namespace Rendering
+}  // namespace NeuralStudio
@@ -162,9 +162,22 @@ class QRhiSwapChain : public QRhiResource
     }
 };
 
+class QRhiNullInitParams
+{
+};
+
 class QRhi
 {
       public:
+    enum Implementation {
+        Null,
+        Vulkan,
+        OpenGLES2,
+        D3D11,
+        Metal,
+        D3D12
+    };
+
     static QRhi *create(int backend, void *params, int flags = 0, void *nativeHandles = nullptr)
     {
         return new QRhi();
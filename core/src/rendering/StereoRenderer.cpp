@@ -1,10 +1,19 @@
 #include "StereoRenderer.h"
+#include "FramebufferManager.h"
 #include "ShimQRhi.h"
 #include <QDebug>
+#include <limits>
 
 namespace NeuralStudio {
 namespace Rendering {
 
+namespace {
+
+// Transient read until the end of the frame
+constexpr int kWholeFrame = std::numeric_limits<int>::max();
+
+} // namespace
+
 StereoRenderer::StereoRenderer(VulkanRenderer *renderer, QObject *parent) : QObject(parent), m_renderer(renderer) {}
 
 StereoRenderer::~StereoRenderer() {}
@@ -23,7 +32,7 @@ bool StereoRenderer::initialize(const StereoConfig &config)
 
 	m_config = config;
 
-	// Create per-eye textures
+	// Create per-profile eye buffers
 	createPerEyeFramebuffers();
 
 	// Create SBS splitter pipeline (splits 4K SBS → 2x 2K)
@@ -38,6 +47,7 @@ bool StereoRenderer::initialize(const StereoConfig &config)
 	qInfo() << "  Per-eye:" << m_config.eyeWidth << "x" << m_config.eyeHeight;
 	qInfo() << "  IPD:" << m_config.ipd << "mm";
 	qInfo() << "  Convergence:" << m_config.convergence << "mm (Z=-5m video plane)";
+	qInfo() << "  Profiles:" << m_framebuffers->getActiveProfiles().size();
 
 	return true;
 }
@@ -52,26 +62,27 @@ void StereoRenderer::renderFrame(QRhiTexture *sbsVideoFrame, float deltaTime)
 	if (!rhi)
 		return;
 
-	// Step 1: Split SBS 4K input into L/R 2K textures
-	splitSBSFrame(sbsVideoFrame, m_leftVideoTexture.get(), m_rightVideoTexture.get());
+	beginFrame();
+
+	// Step 1: Split SBS 4K input into L/R 2K textures, read by every profile's composite
+	TexturePool &pool = m_framebuffers->getTexturePool();
+	const TexturePool::TextureDesc videoDesc = intermediateDesc(m_config.eyeWidth, m_config.eyeHeight);
+	TexturePool::PooledTexture *leftVideo = pool.acquireTransient(videoDesc, kWholeFrame);
+	TexturePool::PooledTexture *rightVideo = pool.acquireTransient(videoDesc, kWholeFrame);
+	if (!leftVideo || !rightVideo) {
+		m_framebuffers->endFrame();
+		return;
+	}
+	splitSBSFrame(sbsVideoFrame, leftVideo->texture.get(), rightVideo->texture.get());
 
 	// Step 2: Apply STMap stitching to each eye
 	// TODO: Call STMapLoader and apply fisheye→equirect shader
 	// For now, pass-through (assume video is already equirectangular)
 
-	// Step 3: Render 3D overlays for left eye
-	render3DOverlay(EyeIndex::Left, m_left3DTexture.get());
-
-	// Step 4: Render 3D overlays for right eye (with IPD offset)
-	render3DOverlay(EyeIndex::Right, m_right3DTexture.get());
-
-	// Step 5: Composite video + 3D for each eye
-	// TODO: Blend m_leftVideoTexture + m_left3DTexture → final left output
-	// TODO: Blend m_rightVideoTexture + m_right3DTexture → final right output
-
-	// Step 6: Output to per-headset profile streams
-	// TODO: Encode and stream based on profile configs
+	// Steps 3-6: 3D overlays, composite and output per headset profile
+	renderProfiles(leftVideo->texture.get(), rightVideo->texture.get());
 
+	m_framebuffers->endFrame();
 	emit stereoFrameRendered();
 }
 
@@ -81,28 +92,81 @@ void StereoRenderer::renderFrame(QRhiTexture *leftVideoFrame, QRhiTexture *right
 		return;
 	}
 
+	beginFrame();
+
 	// AV2 multi-stream mode: already have separate L/R textures
 	// Step 1: Apply STMap stitching to each eye
-	// TODO: Apply fisheye→equirect shader to leftVideoFrame → m_leftVideoTexture
-	// TODO: Apply fisheye→equirect shader to rightVideoFrame → m_rightVideoTexture
-
-	// Step 2: Render 3D overlays for left eye
-	render3DOverlay(EyeIndex::Left, m_left3DTexture.get());
-
-	// Step 3: Render 3D overlays for right eye (with IPD offset)
-	render3DOverlay(EyeIndex::Right, m_right3DTexture.get());
+	// TODO: Apply fisheye→equirect shader into transient video textures
+	// For now, pass-through (assume video is already equirectangular)
 
-	// Step 4: Composite video + 3D for each eye
-	// TODO: Blend m_leftVideoTexture + m_left3DTexture → final left output
-	// TODO: Blend m_rightVideoTexture + m_right3DTexture → final right output
+	// Steps 2-5: 3D overlays, composite and output per headset profile
+	renderProfiles(leftVideoFrame, rightVideoFrame);
 
-	// Step 5: Output to per-headset profile streams
-	// TODO: Encode and stream based on profile configs
+	m_framebuffers->endFrame();
 
 	qDebug() << "Dual-stream mode (AV2 multi-stream)";
 	emit stereoFrameRendered();
 }
 
+void StereoRenderer::beginFrame()
+{
+	m_framebuffers->beginFrame();
+	m_pass = 0;
+	m_frameStats = FrameStats();
+}
+
+void StereoRenderer::renderProfiles(QRhiTexture *leftVideo, QRhiTexture *rightVideo)
+{
+	// Shared eye rendering: both eyes once at the shared size and FOV
+	FramebufferManager::SharedEyeTargets *shared = m_framebuffers->getSharedEyeTargets();
+	if (shared) {
+		renderEye(EyeIndex::Left, leftVideo, shared->leftEye);
+		renderEye(EyeIndex::Right, rightVideo, shared->rightEye);
+	}
+
+	for (const std::string &profileId : m_framebuffers->getActiveProfiles()) {
+		FramebufferManager::FramebufferSet *fbSet = m_framebuffers->getFramebufferSet(profileId);
+		if (!fbSet)
+			continue;
+
+		const int write = fbSet->handoff.writeIndex();
+		const SharedEyeLayout::Viewport *viewport = nullptr;
+		if (shared && m_framebuffers->usesSharedRender(profileId))
+			viewport = m_framebuffers->getSharedLayout().findViewport(profileId);
+		if (viewport) {
+			// Crop the profile's FOV out of the shared eyes, rescaled to its resolution
+			deriveEye(shared->leftEye, *viewport, fbSet->leftEyeBuffers[write]);
+			deriveEye(shared->rightEye, *viewport, fbSet->rightEyeBuffers[write]);
+		} else {
+			// Render 3D overlays for each eye (with IPD offset) and composite them
+			// over the video into the profile's write buffers
+			renderEye(EyeIndex::Left, leftVideo, fbSet->leftEyeBuffers[write]);
+			renderEye(EyeIndex::Right, rightVideo, fbSet->rightEyeBuffers[write]);
+		}
+
+		// Output: hand the frame to the profile's encoder
+		m_framebuffers->swapBuffers(profileId);
+	}
+}
+
+void StereoRenderer::renderEye(EyeIndex eye, QRhiTexture *video, TexturePool::PooledTexture *target)
+{
+	TexturePool &pool = m_framebuffers->getTexturePool();
+
+	// The overlay is only read by the composite right after it, so the next eye
+	// of the same size renders into the same texture
+	pool.setPass(++m_pass);
+	TexturePool::PooledTexture *overlay =
+		pool.acquireTransient(intermediateDesc(target->desc.width, target->desc.height), m_pass + 1);
+	if (!overlay)
+		return;
+	render3DOverlay(eye, overlay->texture.get());
+
+	pool.setPass(++m_pass);
+	compositeEye(video, overlay->texture.get(), target->renderTarget.get());
+	m_frameStats.eyeRenders++;
+}
+
 void StereoRenderer::splitSBSFrame(QRhiTexture *sbsInput, QRhiTexture *leftOut, QRhiTexture *rightOut)
 {
 	// SBS split shader:
@@ -139,10 +203,44 @@ void StereoRenderer::render3DOverlay(EyeIndex eye, QRhiTexture *targetTexture)
 		 << "eye, offset=" << eyeOffset << "mm";
 }
 
+void StereoRenderer::compositeEye(QRhiTexture *video, QRhiTexture *overlay, QRhiTextureRenderTarget *target)
+{
+	QRhi *rhi = m_renderer->rhi();
+	if (!rhi || !video || !overlay || !target)
+		return;
+
+	// TODO: Blend video + 3D overlay into target with m_compositePipeline
+}
+
+void StereoRenderer::deriveEye(TexturePool::PooledTexture *sharedEye, const SharedEyeLayout::Viewport &viewport,
+			       TexturePool::PooledTexture *target)
+{
+	QRhi *rhi = m_renderer->rhi();
+	if (!rhi || !sharedEye || !target)
+		return;
+
+	m_framebuffers->getTexturePool().setPass(++m_pass);
+
+	// TODO: Full-screen quad sampling [u0, u1] x [v0, v1] of sharedEye into target's
+	// render target (a plain copy when the viewport already has the target's size)
+	m_frameStats.derivedEyes++;
+}
+
 void StereoRenderer::createPerEyeFramebuffers()
 {
-	// STUBBED: RHI Missing
-	qWarning() << "StereoRenderer::createPerEyeFramebuffers stubbed (RHI missing)";
+	// Eye buffers per profile, leased from the manager's pool; the per-frame
+	// intermediates are transients from the same pool
+	m_framebuffers = std::make_unique<FramebufferManager>(m_renderer->rhi());
+	for (const auto &profile : m_config.profiles) {
+		m_framebuffers->addProfile(profile);
+	}
+	m_framebuffers->setSharedRendering(m_config.sharedEyeRendering);
+}
+
+TexturePool::TextureDesc StereoRenderer::intermediateDesc(uint32_t width, uint32_t height)
+{
+	// Rendered into, then sampled by the composite pass
+	return {QRhiTexture::RGBA8, width, height, QRhiTexture::RenderTarget | QRhiTexture::UsedAsTexture};
 }
 
 void StereoRenderer::createSplitterPipeline()
@@ -7,7 +7,9 @@ class QRhiSwapChain;
 class QRhiRenderTarget;
 class QRhiShaderResourceBindings;
 class QRhiGraphicsPipeline;
+class QRhiTextureRenderTarget;
 #include <QObject>
+#include "FramebufferManager.h"
 #include "VulkanRenderer.h"
 #include <memory>
 
@@ -24,6 +26,16 @@ namespace NeuralStudio {
  * 4. Render 3D objects/effects separately for each eye (with IPD offset)
  * 5. Composite 3D over stitched video for each eye
  * 6. Output per-headset profile streams
+ *
+ * Each frame renders every enabled profile into its current write buffer and
+ * hands it to the profile's encoder. Eye buffers and per-frame intermediates
+ * (split video, 3D overlays) all come from the FramebufferManager's texture
+ * pool; intermediates are transients, so eyes of the same size share one
+ * overlay texture.
+ *
+ * With shared eye rendering on, each eye is rendered once per frame at the
+ * FramebufferManager's shared size and FOV, and every profile that can share
+ * it only gets a crop/rescale pass from it (see SharedEyeLayout).
  */
         class StereoRenderer : public QObject
         {
@@ -54,13 +66,15 @@ namespace NeuralStudio {
                 float ipd = 63.0f;            // Interpupillary distance (mm)
                 float convergence = 5000.0f;  // Convergence plane (mm, Z=-5m for video plane)
 
-                // Output profiles
-                struct ProfileOutput {
-                    uint32_t outputWidth = 1920;
-                    uint32_t outputHeight = 1920;
-                    float fov = 110.0f;
-                };
-                std::vector<ProfileOutput> profiles;  // Quest 3, Index, Vive Pro 2, etc.
+                // Output profiles, one framebuffer set each
+                std::vector<FramebufferManager::ProfileConfig> profiles;  // Quest 3, Index, Vive Pro 2, etc.
+                bool sharedEyeRendering = false;  // Render each eye once for all profiles that can share it
+            };
+
+            // Passes recorded by the latest renderFrame()
+            struct FrameStats {
+                uint32_t eyeRenders = 0;   // 3D overlay + composite, per eye and render
+                uint32_t derivedEyes = 0;  // Crop/rescale from the shared eye into a profile's buffer
             };
 
             explicit StereoRenderer(VulkanRenderer *renderer, QObject *parent = nullptr);
@@ -71,6 +85,22 @@ namespace NeuralStudio {
      */
             bool initialize(const StereoConfig &config);
 
+            /**
+     * @brief Per-profile outputs, created by initialize() from StereoConfig::profiles
+     *
+     * Profiles can be added, toggled and resized here afterwards; renderFrame()
+     * marks the texture pool's frame boundaries.
+     */
+            FramebufferManager *framebuffers() const
+            {
+                return m_framebuffers.get();
+            }
+
+            const FrameStats &lastFrameStats() const
+            {
+                return m_frameStats;
+            }
+
             /**
      * @brief Process a stereo frame (SBS mode)
      * @param sbsVideoFrame 4K SBS input frame (2x 2K L/R)
@@ -106,19 +136,26 @@ namespace NeuralStudio {
             void createCompositePipeline();
             void createPerEyeFramebuffers();
 
+            void beginFrame();
+            void renderProfiles(QRhiTexture *leftVideo, QRhiTexture *rightVideo);
+            void renderEye(EyeIndex eye, QRhiTexture *video, TexturePool::PooledTexture *target);
+            void compositeEye(QRhiTexture *video, QRhiTexture *overlay, QRhiTextureRenderTarget *target);
+            void deriveEye(TexturePool::PooledTexture *sharedEye, const SharedEyeLayout::Viewport &viewport,
+                           TexturePool::PooledTexture *target);
+
+            static TexturePool::TextureDesc intermediateDesc(uint32_t width, uint32_t height);
+
             VulkanRenderer *m_renderer;
+            std::unique_ptr<FramebufferManager> m_framebuffers;
             StereoConfig m_config;
 
+            int m_pass = 0;  // Pass being recorded; transient intermediates stay busy through their reader's pass
+            FrameStats m_frameStats;
+
             // SBS splitter resources
             std::unique_ptr<QRhiShaderResourceBindings> m_splitterBindings;
             std::unique_ptr<QRhiGraphicsPipeline> m_splitterPipeline;
 
-            // Per-eye textures
-            std::unique_ptr<QRhiTexture> m_leftVideoTexture;   // Stitched video (L eye)
-            std::unique_ptr<QRhiTexture> m_rightVideoTexture;  // Stitched video (R eye)
-            std::unique_ptr<QRhiTexture> m_left3DTexture;      // 3D overlays (L eye)
-            std::unique_ptr<QRhiTexture> m_right3DTexture;     // 3D overlays (R eye)
-
             // Composite resources (video + 3D)
             std::unique_ptr<QRhiShaderResourceBindings> m_compositeBindings;
             std::unique_ptr<QRhiGraphicsPipeline> m_compositePipeline;
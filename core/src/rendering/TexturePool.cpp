@@ -0,0 +1,242 @@
+#include "TexturePool.h"
+#include "ShimQRhi.h"
+#include <QDebug>
+#include <algorithm>
+
+namespace NeuralStudio {
+namespace Rendering {
+
+TexturePool::TexturePool(QRhi *rhi) : TexturePool(rhi, Config()) {}
+
+TexturePool::TexturePool(QRhi *rhi, const Config &config) : m_rhi(rhi), m_config(config) {}
+
+TexturePool::~TexturePool()
+{
+	// Render targets reference their textures, so drop them first
+	for (auto &entry : m_textures) {
+		entry->renderTarget.reset();
+		entry->renderPass.reset();
+	}
+	m_textures.clear();
+}
+
+uint64_t TexturePool::bytesFor(const TextureDesc &desc)
+{
+	uint64_t bytesPerPixel = 4;
+	switch (desc.format) {
+	case QRhiTexture::RGBA16F:
+		bytesPerPixel = 8;
+		break;
+	case QRhiTexture::RGBA32F:
+		bytesPerPixel = 16;
+		break;
+	default:
+		break;
+	}
+	return uint64_t(desc.width) * desc.height * bytesPerPixel * std::max(desc.sampleCount, 1);
+}
+
+//=============================================================================
+// Acquire / Release
+//=============================================================================
+
+TexturePool::PooledTexture *TexturePool::acquire(const TextureDesc &desc)
+{
+	PooledTexture *texture = findFree(desc);
+	if (texture) {
+		m_reuses++;
+	} else {
+		texture = allocate(desc);
+		if (!texture) {
+			return nullptr;
+		}
+	}
+
+	texture->leased = true;
+	texture->lastUsedFrame = m_frame;
+	return texture;
+}
+
+void TexturePool::release(PooledTexture *texture)
+{
+	if (!texture) {
+		return;
+	}
+
+	// Stays allocated for the next acquire() of the same key until it idles out
+	texture->leased = false;
+	texture->lastUsedFrame = m_frame;
+}
+
+TexturePool::PooledTexture *TexturePool::acquireTransient(const TextureDesc &desc, int lastPass)
+{
+	PooledTexture *texture = findFree(desc);
+	if (texture) {
+		if (texture->transientFrame == m_frame) {
+			m_transientAliases++; // An earlier intermediate of this frame is done with it
+		}
+		m_reuses++;
+	} else {
+		texture = allocate(desc);
+		if (!texture) {
+			return nullptr;
+		}
+	}
+
+	texture->transientFrame = m_frame;
+	texture->transientLastPass = std::max(lastPass, m_pass);
+	texture->lastUsedFrame = m_frame;
+	return texture;
+}
+
+bool TexturePool::isFree(const PooledTexture &texture) const
+{
+	return !texture.leased && !(texture.transientFrame == m_frame && texture.transientLastPass >= m_pass);
+}
+
+TexturePool::PooledTexture *TexturePool::findFree(const TextureDesc &desc)
+{
+	// Most recently used first: its memory is the most likely to still be resident
+	PooledTexture *best = nullptr;
+	for (auto &entry : m_textures) {
+		if (entry->desc == desc && isFree(*entry) && (!best || entry->lastUsedFrame > best->lastUsedFrame)) {
+			best = entry.get();
+		}
+	}
+	return best;
+}
+
+TexturePool::PooledTexture *TexturePool::allocate(const TextureDesc &desc)
+{
+	if (!m_rhi || desc.width == 0 || desc.height == 0) {
+		return nullptr;
+	}
+
+	const uint64_t bytes = bytesFor(desc);
+	makeRoom(bytes);
+	if (m_allocatedBytes + bytes > m_config.budgetBytes) {
+		m_overBudgetAllocations++;
+		qWarning() << "TexturePool over budget:" << (m_allocatedBytes + bytes) / (1024 * 1024) << "of"
+			   << m_config.budgetBytes / (1024 * 1024) << "MB";
+	}
+
+	auto entry = std::make_unique<PooledTexture>();
+	entry->desc = desc;
+	entry->bytes = bytes;
+	entry->texture.reset(m_rhi->newTexture(static_cast<QRhiTexture::Format>(desc.format),
+					       QSize(int(desc.width), int(desc.height)), desc.sampleCount,
+					       desc.flags));
+	if (!entry->texture->create()) {
+		qCritical() << "TexturePool: failed to create" << desc.width << "x" << desc.height << "texture";
+		return nullptr;
+	}
+
+	if (desc.flags & QRhiTexture::RenderTarget) {
+		entry->renderTarget.reset(m_rhi->newTextureRenderTarget({entry->texture.get()}));
+		entry->renderPass.reset(entry->renderTarget->newCompatibleRenderPassDescriptor());
+		entry->renderTarget->setRenderPassDescriptor(entry->renderPass.get());
+		if (!entry->renderTarget->create()) {
+			qCritical() << "TexturePool: failed to create render target" << desc.width << "x" << desc.height;
+			return nullptr;
+		}
+	}
+
+	m_allocatedBytes += bytes;
+	m_peakAllocatedBytes = std::max(m_peakAllocatedBytes, m_allocatedBytes);
+	m_allocations++;
+	m_textures.push_back(std::move(entry));
+	return m_textures.back().get();
+}
+
+//=============================================================================
+// Frames & Eviction
+//=============================================================================
+
+void TexturePool::beginFrame()
+{
+	m_frame++;
+	m_pass = 0;
+}
+
+void TexturePool::endFrame()
+{
+	for (size_t i = m_textures.size(); i-- > 0;) {
+		const PooledTexture &entry = *m_textures[i];
+		if (isFree(entry) && m_frame - entry.lastUsedFrame >= m_config.idleFramesBeforeEviction) {
+			evict(i);
+		}
+	}
+
+	if (m_allocatedBytes > m_config.budgetBytes) {
+		trim(m_config.budgetBytes);
+	}
+}
+
+void TexturePool::releaseUnused(const TextureDesc &desc)
+{
+	for (size_t i = m_textures.size(); i-- > 0;) {
+		if (m_textures[i]->desc == desc && isFree(*m_textures[i])) {
+			evict(i);
+		}
+	}
+}
+
+void TexturePool::makeRoom(uint64_t bytes)
+{
+	if (m_allocatedBytes + bytes > m_config.budgetBytes) {
+		trim(m_config.budgetBytes > bytes ? m_config.budgetBytes - bytes : 0);
+	}
+}
+
+void TexturePool::trim(uint64_t targetBytes)
+{
+	while (m_allocatedBytes > targetBytes) {
+		size_t oldest = m_textures.size();
+		for (size_t i = 0; i < m_textures.size(); ++i) {
+			if (isFree(*m_textures[i]) &&
+			    (oldest == m_textures.size() || m_textures[i]->lastUsedFrame < m_textures[oldest]->lastUsedFrame)) {
+				oldest = i;
+			}
+		}
+		if (oldest == m_textures.size()) {
+			return; // Everything left is in use
+		}
+		evict(oldest);
+	}
+}
+
+void TexturePool::evict(size_t index)
+{
+	PooledTexture &entry = *m_textures[index];
+	entry.renderTarget.reset();
+	entry.renderPass.reset();
+	entry.texture.reset();
+
+	m_allocatedBytes -= entry.bytes;
+	m_evictions++;
+	m_textures.erase(m_textures.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+TexturePool::Stats TexturePool::stats() const
+{
+	Stats s;
+	s.budgetBytes = m_config.budgetBytes;
+	s.allocatedBytes = m_allocatedBytes;
+	s.peakAllocatedBytes = m_peakAllocatedBytes;
+	s.textures = static_cast<uint32_t>(m_textures.size());
+	for (const auto &entry : m_textures) {
+		if (!isFree(*entry)) {
+			s.inUseBytes += entry->bytes;
+			s.texturesInUse++;
+		}
+	}
+	s.allocations = m_allocations;
+	s.reuses = m_reuses;
+	s.transientAliases = m_transientAliases;
+	s.evictions = m_evictions;
+	s.overBudgetAllocations = m_overBudgetAllocations;
+	return s;
+}
+
+} // namespace Rendering
+} // namespace NeuralStudio
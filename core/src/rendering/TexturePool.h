@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class QRhi;
+class QRhiTexture;
+class QRhiTextureRenderTarget;
+class QRhiRenderPassDescriptor;
+
+namespace NeuralStudio {
+    namespace Rendering {
+
+        /**
+ * @brief TexturePool - Pooled QRhiTexture/render target allocator for the rendering module
+ *
+ * Textures are keyed by (format, size, usage flags, sample count). Released
+ * textures stay in the pool and are handed out again for the same key, so
+ * toggling a profile or switching back to a previous resolution doesn't
+ * reallocate; pool memory is only freed once a texture sat unused for
+ * idleFramesBeforeEviction frames, the budget needs the room, or its key is
+ * dropped with releaseUnused(). The render loop calls beginFrame()/endFrame()
+ * once per frame; idle eviction only happens in endFrame().
+ *
+ * Transient textures live for one frame: acquireTransient() with the last
+ * pass that reads it. Intermediates with the same key whose pass ranges don't
+ * overlap share one texture, so a frame's chain of passes needs as many
+ * textures as it has intermediates alive at once, not one per pass.
+ *
+ * Render thread only.
+ */
+        class TexturePool
+        {
+              public:
+            struct TextureDesc {
+                int format = 0;  // QRhiTexture::Format
+                uint32_t width = 0;
+                uint32_t height = 0;
+                int flags = 0;  // QRhiTexture::Flags; RenderTarget also gets a render target + pass descriptor
+                int sampleCount = 1;
+
+                bool operator==(const TextureDesc &other) const
+                {
+                    return format == other.format && width == other.width && height == other.height &&
+                           flags == other.flags && sampleCount == other.sampleCount;
+                }
+            };
+
+            struct PooledTexture {
+                TextureDesc desc;
+                uint64_t bytes = 0;
+                std::unique_ptr<QRhiTexture> texture;
+                std::unique_ptr<QRhiTextureRenderTarget> renderTarget;  // nullptr unless desc.flags has RenderTarget
+                std::unique_ptr<QRhiRenderPassDescriptor> renderPass;
+
+                // Pool bookkeeping
+                bool leased = false;          // Held by acquire() until release()
+                uint64_t transientFrame = 0;  // Frame of the latest acquireTransient() (0 = never)
+                int transientLastPass = -1;   // Busy up to and including this pass in transientFrame
+                uint64_t lastUsedFrame = 0;
+            };
+
+            struct Config {
+                uint64_t budgetBytes = 2ull * 1024 * 1024 * 1024;
+                uint32_t idleFramesBeforeEviction = 300;  // ~3 s at 90 Hz
+            };
+
+            struct Stats {
+                uint64_t budgetBytes = 0;
+                uint64_t allocatedBytes = 0;  // Everything the pool holds
+                uint64_t inUseBytes = 0;      // Leased + transient in the current frame
+                uint64_t peakAllocatedBytes = 0;
+                uint32_t textures = 0;
+                uint32_t texturesInUse = 0;
+                uint64_t allocations = 0;           // Textures created
+                uint64_t reuses = 0;                // Requests served from the pool
+                uint64_t transientAliases = 0;      // Transient requests that reused a texture from earlier in the same frame
+                uint64_t evictions = 0;
+                uint64_t overBudgetAllocations = 0;  // Allocations made although nothing could be evicted to stay in budget
+            };
+
+            explicit TexturePool(QRhi *rhi);
+            TexturePool(QRhi *rhi, const Config &config);
+            ~TexturePool();
+
+            TexturePool(const TexturePool &) = delete;
+            TexturePool &operator=(const TexturePool &) = delete;
+
+            /**
+     * @brief Lease a texture until release(); nullptr if it couldn't be created
+     */
+            PooledTexture *acquire(const TextureDesc &desc);
+            void release(PooledTexture *texture);
+
+            /**
+     * @brief Texture for the current frame, busy from the current pass through lastPass
+     */
+            PooledTexture *acquireTransient(const TextureDesc &desc, int lastPass);
+
+            // Frame and pass boundaries; transients become free again at the next beginFrame(),
+            // endFrame() evicts textures idle for idleFramesBeforeEviction frames
+            void beginFrame();
+            void setPass(int pass)
+            {
+                m_pass = pass;
+            }
+            void endFrame();
+
+            /**
+     * @brief Free every texture with this key that isn't in use, e.g. a size nothing uses anymore
+     */
+            void releaseUnused(const TextureDesc &desc);
+
+            /**
+     * @brief Free unused textures, least recently used first, until allocated bytes <= targetBytes
+     */
+            void trim(uint64_t targetBytes);
+
+            Stats stats() const;
+            static uint64_t bytesFor(const TextureDesc &desc);
+
+              private:
+            bool isFree(const PooledTexture &texture) const;
+            PooledTexture *findFree(const TextureDesc &desc);
+            PooledTexture *allocate(const TextureDesc &desc);
+            void makeRoom(uint64_t bytes);
+            void evict(size_t index);
+
+            QRhi *m_rhi;
+            Config m_config;
+            std::vector<std::unique_ptr<PooledTexture>> m_textures;  // Entries keep their address for their lifetime
+
+            uint64_t m_frame = 1;
+            int m_pass = 0;
+
+            uint64_t m_allocatedBytes = 0;
+            uint64_t m_peakAllocatedBytes = 0;
+            uint64_t m_allocations = 0;
+            uint64_t m_reuses = 0;
+            uint64_t m_transientAliases = 0;
+            uint64_t m_evictions = 0;
+            uint64_t m_overBudgetAllocations = 0;
+        };
+
+    }  // namespace Rendering
+}  // namespace NeuralStudio
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace NeuralStudio {
+    namespace Rendering {
+
+        /**
+ * @brief TripleBuffer - Lock-free single-producer/single-consumer buffer handoff
+ *
+ * Hands buffer indices (0..2) from a producer (renderer) to a consumer
+ * (encoder) without either ever waiting. The producer owns one buffer, the
+ * consumer owns another, and the third sits in between holding the newest
+ * completed frame. Both sides exchange their buffer with the middle one
+ * through a single atomic word: bits 0-1 hold the middle index, bit 2 marks
+ * it as fresh (published but not yet picked up).
+ *
+ * If the producer publishes twice before the consumer picks up, the older
+ * frame is dropped; if the consumer asks with nothing new, it keeps (and
+ * repeats) its current frame. Both cases are counted.
+ */
+        class TripleBuffer
+        {
+              public:
+            static constexpr int NumBuffers = 3;
+
+            struct Stats {
+                uint64_t published = 0;
+                uint64_t consumed = 0;
+                uint64_t dropped = 0;     // Published frames overwritten before the consumer saw them
+                uint64_t duplicated = 0;  // Consumer acquires that found no new frame
+            };
+
+            // Producer side: buffer to render into
+            int writeIndex() const
+            {
+                return m_writeIndex;
+            }
+
+            // Producer side: hand the write buffer over as the newest frame and take the middle one back
+            void publish()
+            {
+                const uint8_t previous = m_middle.exchange(uint8_t(m_writeIndex | FreshBit), std::memory_order_acq_rel);
+                m_writeIndex = previous & IndexMask;
+                m_published.fetch_add(1, std::memory_order_relaxed);
+                if (previous & FreshBit) {
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            // Consumer side: switch to the newest frame if there is one. Returns false (and keeps
+            // displayIndex()) if nothing was published since the last acquire.
+            bool acquire()
+            {
+                if (!(m_middle.load(std::memory_order_relaxed) & FreshBit)) {
+                    m_duplicated.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                // Only the consumer clears the fresh bit, so it is still set here
+                const uint8_t previous = m_middle.exchange(uint8_t(m_displayIndex), std::memory_order_acq_rel);
+                m_displayIndex = previous & IndexMask;
+                m_consumed.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            // Consumer side: buffer to encode/display
+            int displayIndex() const
+            {
+                return m_displayIndex;
+            }
+
+            Stats stats() const
+            {
+                Stats s;
+                s.published = m_published.load(std::memory_order_relaxed);
+                s.consumed = m_consumed.load(std::memory_order_relaxed);
+                s.dropped = m_dropped.load(std::memory_order_relaxed);
+                s.duplicated = m_duplicated.load(std::memory_order_relaxed);
+                return s;
+            }
+
+              private:
+            static constexpr uint8_t IndexMask = 0x3;
+            static constexpr uint8_t FreshBit = 0x4;
+
+            // Producer and consumer state on separate cache lines from the shared word
+            alignas(64) int m_writeIndex = 0;
+            alignas(64) int m_displayIndex = 1;
+            alignas(64) std::atomic<uint8_t> m_middle {2};
+
+            std::atomic<uint64_t> m_published {0};
+            std::atomic<uint64_t> m_dropped {0};
+            alignas(64) std::atomic<uint64_t> m_consumed {0};
+            std::atomic<uint64_t> m_duplicated {0};
+        };
+
+    }  // namespace Rendering
+}  // namespace NeuralStudio
@@ -23,6 +23,19 @@ bool VulkanRenderer::initialize(QWindow *window)
 
 	m_window = window;
 
+	if (!window) {
+		// Headless: Null backend, resources are created but nothing is drawn
+		QRhiNullInitParams params;
+		m_rhi.reset(QRhi::create(QRhi::Null, &params));
+		if (!m_rhi) {
+			qCritical() << "Failed to create headless QRhi";
+			return false;
+		}
+		m_initialized = true;
+		qInfo() << "VulkanRenderer initialized headless (Null backend)";
+		return true;
+	}
+
 	// STUBBED: QRhi is missing
 	qWarning() << "VulkanRenderer Stubbed: QRhi missing";
 	m_initialized = true;
@@ -54,7 +54,8 @@ namespace NeuralStudio {
 
             /**
      * @brief Initialize the Vulkan rendering context
-     * @param window Native window handle for swap chain
+     * @param window Native window handle for swap chain; nullptr for a headless
+     *               renderer on the Null QRhi backend (no swap chain, nothing drawn)
      * @return true if initialization succeeded
      */
             bool initialize(QWindow *window);
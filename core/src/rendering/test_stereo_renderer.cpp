@@ -0,0 +1,145 @@
+#include "StereoRenderer.h"
+#include "FramebufferManager.h"
+#include "VulkanRenderer.h"
+#include "ShimQRhi.h"
+#include <cassert>
+#include <iostream>
+
+// Drives frames through a headless StereoRenderer and checks its texture pool:
+// eyes of the same size share one overlay per frame, and a disabled profile's
+// eye buffers and overlays are freed once they idle out. With shared eye
+// rendering, each eye renders once per frame however many profiles share it.
+
+using namespace NeuralStudio::Rendering;
+
+namespace {
+
+FramebufferManager::ProfileConfig makeProfile(const std::string &id, uint32_t eyeWidth, uint32_t eyeHeight,
+					      float fovH = 110.0f, float fovV = 96.0f, float ipd = 63.0f)
+{
+	FramebufferManager::ProfileConfig profile;
+	profile.id = id;
+	profile.name = id;
+	profile.eyeWidth = eyeWidth;
+	profile.eyeHeight = eyeHeight;
+	profile.fovHorizontal = fovH;
+	profile.fovVertical = fovV;
+	profile.ipd = ipd;
+	return profile;
+}
+
+void renderFrames(StereoRenderer &renderer, QRhiTexture *sbs, uint32_t frames)
+{
+	for (uint32_t i = 0; i < frames; ++i)
+		renderer.renderFrame(sbs, 1.0f / 90.0f);
+}
+
+void testFrames()
+{
+	VulkanRenderer vulkan;
+	assert(vulkan.initialize(nullptr));
+	assert(vulkan.rhi());
+
+	StereoRenderer::StereoConfig config;
+	config.profiles = {makeProfile("quest3", 2064, 2208), makeProfile("index", 1440, 1600)};
+	StereoRenderer renderer(&vulkan);
+	assert(renderer.initialize(config));
+
+	FramebufferManager *framebuffers = renderer.framebuffers();
+	assert(framebuffers && framebuffers->getActiveProfiles().size() == 2);
+	TexturePool &pool = framebuffers->getTexturePool();
+
+	std::unique_ptr<QRhiTexture> sbs(vulkan.rhi()->newTexture(QRhiTexture::RGBA8, QSize(3840, 2160)));
+	renderFrames(renderer, sbs.get(), 2);
+
+	// 2 profiles x 3 buffers x 2 eyes, the split L/R video and one overlay per profile size:
+	// each right eye renders into the overlay its left eye's composite is done with
+	TexturePool::Stats stats = pool.stats();
+	assert(stats.textures == 12 + 2 + 2);
+	assert(stats.allocations == 16);
+	assert(stats.transientAliases == 2 * 2);
+	assert(framebuffers->getHandoffStats("quest3").published == 2);
+	assert(framebuffers->getHandoffStats("index").published == 2);
+	std::cout << "Overlay aliasing: OK" << std::endl;
+
+	// Disabled: its eye buffers go back to the pool and its overlay size stops being requested
+	framebuffers->setProfileEnabled("index", false);
+	const uint32_t idleFrames = TexturePool::Config().idleFramesBeforeEviction;
+	renderFrames(renderer, sbs.get(), idleFrames - 1);
+	stats = pool.stats();
+	assert(stats.textures == 16);
+	assert(stats.evictions == 0);
+
+	renderFrames(renderer, sbs.get(), 1);
+	stats = pool.stats();
+	assert(stats.textures == 6 + 2 + 1);
+	assert(stats.evictions == 6 + 1);
+	assert(stats.allocations == 16);
+	assert(stats.allocatedBytes == 7 * TexturePool::bytesFor({QRhiTexture::RGBA8, 2064, 2208}) +
+					       2 * TexturePool::bytesFor({QRhiTexture::RGBA8, 1920, 2160}));
+	assert(framebuffers->getHandoffStats("quest3").published == 2 + idleFrames);
+	std::cout << "Idle eviction through frames: OK" << std::endl;
+
+	// Dual-stream frames render straight from the inputs, no split textures
+	std::unique_ptr<QRhiTexture> left(vulkan.rhi()->newTexture(QRhiTexture::RGBA8, QSize(1920, 2160)));
+	std::unique_ptr<QRhiTexture> right(vulkan.rhi()->newTexture(QRhiTexture::RGBA8, QSize(1920, 2160)));
+	for (uint32_t i = 0; i < idleFrames; ++i)
+		renderer.renderFrame(left.get(), right.get(), 1.0f / 90.0f);
+	stats = pool.stats();
+	assert(stats.textures == 6 + 1);
+	assert(stats.allocations == 16);
+	assert(framebuffers->getHandoffStats("quest3").published == 2 + 2 * idleFrames);
+	(void)stats;
+	std::cout << "Dual-stream frames: OK" << std::endl;
+}
+
+void testSharedEyes()
+{
+	VulkanRenderer vulkan;
+	assert(vulkan.initialize(nullptr));
+
+	// Two profiles share the render; the third sees the scene from another eye position
+	StereoRenderer::StereoConfig config;
+	config.profiles = {makeProfile("quest3", 2064, 2208, 110.0f, 96.0f),
+			   makeProfile("index", 1440, 1600, 108.0f, 104.0f),
+			   makeProfile("vive_pro_2", 2448, 2448, 120.0f, 116.0f, 68.0f)};
+	config.sharedEyeRendering = true;
+	StereoRenderer renderer(&vulkan);
+	assert(renderer.initialize(config));
+
+	FramebufferManager *framebuffers = renderer.framebuffers();
+	assert(framebuffers->getSharedEyeTargets());
+	assert(framebuffers->usesSharedRender("quest3") && framebuffers->usesSharedRender("index"));
+	assert(!framebuffers->usesSharedRender("vive_pro_2"));
+
+	std::unique_ptr<QRhiTexture> sbs(vulkan.rhi()->newTexture(QRhiTexture::RGBA8, QSize(3840, 2160)));
+	for (int frame = 1; frame <= 3; ++frame) {
+		renderer.renderFrame(sbs.get(), 1.0f / 90.0f);
+		const StereoRenderer::FrameStats &stats = renderer.lastFrameStats();
+		assert(stats.eyeRenders == 2 + 2); // Shared pair + vive_pro_2 on its own
+		assert(stats.derivedEyes == 2 * 2);
+		(void)stats;
+		for (const std::string &profile : framebuffers->getActiveProfiles())
+			assert(framebuffers->getHandoffStats(profile).published == uint64_t(frame));
+	}
+	std::cout << "Shared eyes rendered once per frame: OK" << std::endl;
+
+	// Off again: one render per profile and eye, nothing derived
+	framebuffers->setSharedRendering(false);
+	assert(!framebuffers->getSharedEyeTargets());
+	renderer.renderFrame(sbs.get(), 1.0f / 90.0f);
+	assert(renderer.lastFrameStats().eyeRenders == 3 * 2);
+	assert(renderer.lastFrameStats().derivedEyes == 0);
+	std::cout << "Separate eye renders: OK" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+	testFrames();
+	testSharedEyes();
+
+	std::cout << "All stereo renderer tests passed" << std::endl;
+	return 0;
+}
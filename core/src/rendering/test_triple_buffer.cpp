@@ -0,0 +1,155 @@
+#include "TripleBuffer.h"
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace NeuralStudio::Rendering;
+
+namespace {
+
+// Stand-in for a framebuffer: every word carries the frame number, so a frame
+// the producer is still writing while the consumer reads it shows up as torn
+struct FakeFrame {
+	uint64_t frameNumber = 0;
+	std::vector<uint64_t> pixels = std::vector<uint64_t>(4096);
+};
+
+struct Result {
+	uint64_t produced = 0;
+	uint64_t seen = 0;
+	uint64_t torn = 0;
+	uint64_t outOfOrder = 0;
+	TripleBuffer::Stats stats;
+};
+
+// Producer and consumer spin for 'duration'; the optional pauses model a
+// renderer that outpaces the encoder or the other way round
+Result hammer(std::chrono::milliseconds duration, int producerPauseUs, int consumerPauseUs)
+{
+	TripleBuffer handoff;
+	std::array<FakeFrame, TripleBuffer::NumBuffers> frames;
+	std::atomic<bool> running {true};
+	Result result;
+
+	std::thread producer([&] {
+		uint64_t frameNumber = 0;
+		while (running.load(std::memory_order_relaxed)) {
+			FakeFrame &frame = frames[handoff.writeIndex()];
+			++frameNumber;
+			frame.frameNumber = frameNumber;
+			std::fill(frame.pixels.begin(), frame.pixels.end(), frameNumber);
+			handoff.publish();
+			if (producerPauseUs)
+				std::this_thread::sleep_for(std::chrono::microseconds(producerPauseUs));
+		}
+		result.produced = frameNumber;
+	});
+
+	std::thread consumer([&] {
+		uint64_t last = 0;
+		while (running.load(std::memory_order_relaxed)) {
+			if (handoff.acquire()) {
+				const FakeFrame &frame = frames[handoff.displayIndex()];
+				for (uint64_t word : frame.pixels) {
+					if (word != frame.frameNumber) {
+						result.torn++;
+						break;
+					}
+				}
+				if (frame.frameNumber <= last)
+					result.outOfOrder++;
+				last = frame.frameNumber;
+				result.seen++;
+			}
+			if (consumerPauseUs)
+				std::this_thread::sleep_for(std::chrono::microseconds(consumerPauseUs));
+		}
+	});
+
+	std::this_thread::sleep_for(duration);
+	running.store(false);
+	producer.join();
+	consumer.join();
+
+	result.stats = handoff.stats();
+	return result;
+}
+
+void report(const char *name, const Result &r)
+{
+	std::cout << name << ": produced " << r.produced << ", consumed " << r.stats.consumed << ", dropped "
+		  << r.stats.dropped << ", duplicated " << r.stats.duplicated << ", torn " << r.torn
+		  << ", out of order " << r.outOfOrder << std::endl;
+}
+
+void check(const Result &r)
+{
+	assert(r.torn == 0);
+	assert(r.outOfOrder == 0);
+	assert(r.seen == r.stats.consumed);
+	assert(r.stats.published == r.produced);
+	// Every published frame was either consumed, dropped, or is still waiting in the middle buffer
+	assert(r.stats.consumed + r.stats.dropped == r.produced || r.stats.consumed + r.stats.dropped + 1 == r.produced);
+	(void)r;
+}
+
+void testSingleThreaded()
+{
+	TripleBuffer handoff;
+	assert(!handoff.acquire()); // Nothing published yet
+	assert(handoff.stats().duplicated == 1);
+
+	const int first = handoff.writeIndex();
+	handoff.publish();
+	assert(handoff.writeIndex() != first);
+	assert(handoff.acquire());
+	assert(handoff.displayIndex() == first);
+
+	// Two publishes before an acquire: the consumer gets the second, the first is dropped
+	const int dropped = handoff.writeIndex();
+	handoff.publish();
+	const int newest = handoff.writeIndex();
+	handoff.publish();
+	assert(handoff.writeIndex() == dropped); // The overwritten buffer comes straight back to the producer
+	assert(handoff.acquire());
+	assert(handoff.displayIndex() == newest);
+
+	const TripleBuffer::Stats stats = handoff.stats();
+	assert(stats.published == 3);
+	assert(stats.consumed == 2);
+	assert(stats.dropped == 1);
+	(void)stats;
+	(void)first;
+	(void)newest;
+	std::cout << "Single-threaded handoff: OK" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+	testSingleThreaded();
+
+	const auto duration = std::chrono::milliseconds(500);
+	Result unthrottled = hammer(duration, 0, 0);
+	report("Unthrottled", unthrottled);
+	check(unthrottled);
+
+	Result fastRenderer = hammer(duration, 0, 200);
+	report("Renderer faster than encoder", fastRenderer);
+	check(fastRenderer);
+	assert(fastRenderer.stats.dropped > 0);
+
+	Result fastEncoder = hammer(duration, 200, 0);
+	report("Encoder faster than renderer", fastEncoder);
+	check(fastEncoder);
+	assert(fastEncoder.stats.duplicated > 0);
+
+	std::cout << "All triple buffer tests passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,403 @@
+#include "AsyncNodeExecutor.h"
+#include "ExecutionProfiler.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
+
+namespace NeuralStudio {
+namespace SceneGraph {
+
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+	return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+bool isReady(const std::future<void> &future)
+{
+	return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+} // namespace
+
+// One request: a snapshot of the connected inputs and, once done, the outputs
+struct AsyncJob {
+	struct Input {
+		uint32_t slot = 0; // Local slot (input index)
+		PinValue value;
+		PinStamp stamp;
+	};
+
+	uint64_t frameNumber = 0;
+	std::chrono::steady_clock::time_point dispatchedAt;
+	std::chrono::steady_clock::time_point completedAt;
+	std::vector<Input> inputs;
+	ExecutionContext ctx;
+	ExecutionResult result;
+	std::vector<PinValue> outputs;
+	std::promise<void> done;
+	std::future<void> future;
+};
+
+struct AsyncNodeState {
+	std::shared_ptr<IExecutableNode> node;
+	std::string nodeId;
+	uint32_t inputCount = 0;
+	uint32_t outputCount = 0;
+	uint64_t profileKey = 0;
+	std::unique_ptr<PinSlotBuffer> workBuffer; // The node's own pins while attached
+	std::atomic<size_t> maxInFlight {2};
+
+	// Strand, shared with the worker draining it
+	std::mutex strandMutex;
+	std::deque<std::shared_ptr<AsyncJob>> queue;
+	bool running = false;
+
+	// Frame-loop side
+	std::deque<std::shared_ptr<AsyncJob>> pending; // Dispatched, not yet published (FIFO)
+	std::vector<PinValue> lastOutputs;
+	PinStamp lastStamp;
+	std::chrono::steady_clock::time_point lastDispatchedAt;
+	bool hasResult = false;
+};
+
+AsyncNodeExecutor::AsyncNodeExecutor() : AsyncNodeExecutor(Config()) {}
+
+AsyncNodeExecutor::AsyncNodeExecutor(const Config &config) : m_config(config) {}
+
+AsyncNodeExecutor::~AsyncNodeExecutor()
+{
+	detachAll();
+}
+
+void AsyncNodeExecutor::setConfig(const Config &config)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_config = config;
+	for (auto &[_, state] : m_states) {
+		if (m_maxInFlight.find(state->nodeId) == m_maxInFlight.end())
+			state->maxInFlight.store(std::max<size_t>(config.maxInFlight, 1), std::memory_order_relaxed);
+	}
+}
+
+AsyncNodeExecutor::Config AsyncNodeExecutor::getConfig() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_config;
+}
+
+void AsyncNodeExecutor::setMaxInFlight(const std::string &nodeId, size_t maxInFlight)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_maxInFlight[nodeId] = std::max<size_t>(maxInFlight, 1);
+	for (auto &[_, state] : m_states) {
+		if (state->nodeId == nodeId)
+			state->maxInFlight.store(m_maxInFlight[nodeId], std::memory_order_relaxed);
+	}
+}
+
+//=============================================================================
+// Attachment
+//=============================================================================
+
+AsyncNodeState *AsyncNodeExecutor::attach(const std::shared_ptr<IExecutableNode> &node)
+{
+	auto it = m_states.find(node.get());
+	if (it != m_states.end())
+		return it->second.get();
+
+	// Removed and re-added while requests were still pending: revive
+	for (auto retired = m_retired.begin(); retired != m_retired.end(); ++retired) {
+		if ((*retired)->node == node) {
+			auto state = *retired;
+			m_retired.erase(retired);
+			m_states[node.get()] = state;
+			return state.get();
+		}
+	}
+
+	auto state = std::make_shared<AsyncNodeState>();
+	state->node = node;
+	state->nodeId = node->getNodeId();
+	state->profileKey = ExecutionProfiler::nodeKey(state->nodeId);
+	state->inputCount = static_cast<uint32_t>(node->getInputPins().size());
+	state->outputCount = static_cast<uint32_t>(node->getOutputPins().size());
+	state->workBuffer = std::make_unique<PinSlotBuffer>(state->inputCount + state->outputCount);
+	if (!node->bindPinSlots(state->workBuffer.get(), 0)) {
+		return nullptr; // String-keyed pins cannot be isolated from the frame loop
+	}
+
+	// Whatever the node already produced becomes the first published result
+	state->lastOutputs.resize(state->outputCount);
+	for (uint32_t i = 0; i < state->outputCount; ++i) {
+		state->lastOutputs[i] = state->workBuffer->at(state->inputCount + i);
+	}
+	state->hasResult = true;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto limit = m_maxInFlight.find(state->nodeId);
+		state->maxInFlight.store(limit != m_maxInFlight.end() ? limit->second
+								      : std::max<size_t>(m_config.maxInFlight, 1),
+					 std::memory_order_relaxed);
+		if (!m_workers) {
+			TaskScheduler::Config workers;
+			workers.workerCount = std::max<size_t>(m_config.workerCount, 1);
+			m_workers = std::make_unique<TaskScheduler>(workers);
+		}
+	}
+
+	m_states[node.get()] = state;
+	return state.get();
+}
+
+void AsyncNodeExecutor::retainOnly(const std::set<IExecutableNode *> &live)
+{
+	for (auto it = m_states.begin(); it != m_states.end();) {
+		if (live.count(it->first)) {
+			++it;
+			continue;
+		}
+		m_retired.push_back(std::move(it->second));
+		it = m_states.erase(it);
+	}
+	collectRetired();
+}
+
+void AsyncNodeExecutor::detachNow(IExecutableNode *node)
+{
+	auto it = m_states.find(node);
+	if (it == m_states.end())
+		return;
+
+	auto state = std::move(it->second);
+	m_states.erase(it);
+	for (auto &job : state->pending) {
+		job->future.wait();
+	}
+	detach(*state);
+}
+
+void AsyncNodeExecutor::detachAll()
+{
+	// Requests reference the nodes' work buffers; let them finish first
+	if (m_workers) {
+		m_workers->wait(m_group);
+	}
+	for (auto &[_, state] : m_states) {
+		detach(*state);
+	}
+	for (auto &state : m_retired) {
+		detach(*state);
+	}
+	m_states.clear();
+	m_retired.clear();
+}
+
+void AsyncNodeExecutor::collectRetired()
+{
+	for (auto it = m_retired.begin(); it != m_retired.end();) {
+		bool idle = true;
+		for (auto &job : (*it)->pending) {
+			idle = idle && isReady(job->future);
+		}
+		if (!idle) {
+			++it;
+			continue;
+		}
+		detach(**it);
+		it = m_retired.erase(it);
+	}
+}
+
+void AsyncNodeExecutor::detach(AsyncNodeState &state)
+{
+	state.pending.clear();
+	state.node->bindPinSlots(nullptr, 0);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stats.erase(state.nodeId);
+}
+
+void AsyncNodeExecutor::restoreOutputs(AsyncNodeState &state, PinSlotBuffer &mailbox, uint32_t slotBase)
+{
+	if (!state.hasResult)
+		return;
+
+	for (uint32_t i = 0; i < state.outputCount && i < state.lastOutputs.size(); ++i) {
+		mailbox.at(slotBase + state.inputCount + i) = state.lastOutputs[i];
+		mailbox.stampAt(slotBase + state.inputCount + i) = state.lastStamp;
+	}
+}
+
+//=============================================================================
+// Frame-Loop Servicing
+//=============================================================================
+
+bool AsyncNodeExecutor::hasPending(const AsyncNodeState &state) const
+{
+	return !state.pending.empty();
+}
+
+AsyncNodeExecutor::ServiceResult AsyncNodeExecutor::service(AsyncNodeState &state, PinSlotBuffer &mailbox,
+							    uint32_t slotBase,
+							    const std::vector<uint32_t> &connectedInputs,
+							    bool dispatch, const ExecutionContext &ctx)
+{
+	ServiceResult outcome;
+	AsyncNodeStats delta;
+	std::vector<double> latencies;
+
+	// Publish completed requests in order; the newest successful one wins
+	while (!state.pending.empty() && isReady(state.pending.front()->future)) {
+		std::shared_ptr<AsyncJob> job = std::move(state.pending.front());
+		state.pending.pop_front();
+		latencies.push_back(elapsedMs(job->dispatchedAt, job->completedAt));
+
+		if (job->result.status != ExecutionResult::Status::Success) {
+			delta.failed++;
+			outcome.failed = true;
+			outcome.errorMessage = job->result.errorMessage;
+			continue;
+		}
+
+		delta.completed++;
+		state.lastStamp.frameNumber = job->frameNumber;
+		state.lastStamp.producedAtNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+						       job->completedAt.time_since_epoch())
+						       .count();
+		state.lastDispatchedAt = job->dispatchedAt;
+		state.lastOutputs = std::move(job->outputs);
+		state.hasResult = true;
+		outcome.published = true;
+	}
+	if (outcome.published) {
+		restoreOutputs(state, mailbox, slotBase);
+	}
+
+	if (dispatch) {
+		if (state.pending.size() >= state.maxInFlight.load(std::memory_order_relaxed)) {
+			delta.dropped++; // Backpressure: keep showing the last result
+		} else {
+			auto job = std::make_shared<AsyncJob>();
+			job->frameNumber = ctx.frameNumber;
+			job->dispatchedAt = std::chrono::steady_clock::now();
+			job->ctx = ctx;
+			job->inputs.reserve(connectedInputs.size());
+			for (uint32_t input : connectedInputs) {
+				job->inputs.push_back({input, mailbox.at(slotBase + input), mailbox.stampAt(slotBase + input)});
+			}
+			job->future = job->done.get_future();
+			state.pending.push_back(job);
+
+			bool startStrand = false;
+			{
+				std::lock_guard<std::mutex> lock(state.strandMutex);
+				state.queue.push_back(std::move(job));
+				startStrand = !state.running;
+				state.running = true;
+			}
+			if (startStrand) {
+				// The strand keeps the state alive even if the node is detached meanwhile
+				std::shared_ptr<AsyncNodeState> shared = m_states.at(state.node.get());
+				m_workers->submit(m_group, [this, shared]() { runStrand(shared); });
+			}
+
+			delta.dispatched++;
+			outcome.dispatched = true;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	AsyncNodeStats &stats = m_stats[state.nodeId];
+	stats.dispatched += delta.dispatched;
+	stats.completed += delta.completed;
+	stats.failed += delta.failed;
+	stats.dropped += delta.dropped;
+	stats.inFlight = static_cast<uint32_t>(state.pending.size());
+	for (double latency : latencies) {
+		stats.lastLatencyMs = latency;
+		stats.maxLatencyMs = std::max(stats.maxLatencyMs, latency);
+		stats.avgLatencyMs = stats.avgLatencyMs == 0.0 ? latency : stats.avgLatencyMs * 0.9 + latency * 0.1;
+	}
+	if (state.hasResult) {
+		stats.resultFrame = state.lastStamp.frameNumber;
+		stats.stalenessFrames = ctx.frameNumber >= state.lastStamp.frameNumber
+						? ctx.frameNumber - state.lastStamp.frameNumber
+						: 0;
+		stats.stalenessMs = state.lastStamp.producedAtNs
+					    ? elapsedMs(state.lastDispatchedAt, std::chrono::steady_clock::now())
+					    : 0.0;
+	}
+	return outcome;
+}
+
+void AsyncNodeExecutor::runStrand(const std::shared_ptr<AsyncNodeState> &state)
+{
+	PinSlotBuffer &work = *state->workBuffer;
+	for (;;) {
+		std::shared_ptr<AsyncJob> job;
+		{
+			std::lock_guard<std::mutex> lock(state->strandMutex);
+			if (state->queue.empty()) {
+				state->running = false;
+				return;
+			}
+			job = std::move(state->queue.front());
+			state->queue.pop_front();
+		}
+
+		for (auto &input : job->inputs) {
+			work.at(input.slot) = std::move(input.value);
+			work.stampAt(input.slot) = input.stamp;
+		}
+
+		ExecutionProfiler *profiler = job->ctx.profiler;
+		int64_t start = profiler ? ExecutionProfiler::now() : 0;
+		try {
+			job->result = state->node->process(job->ctx);
+		} catch (const std::exception &e) {
+			// Nobody is on this thread's stack to catch it; report through the result
+			job->result = ExecutionResult::failure(e.what());
+		} catch (...) {
+			// Anything else still has to complete the job, or its waiter never wakes
+			job->result = ExecutionResult::failure("unknown exception");
+		}
+		if (profiler) {
+			int64_t dispatched = std::chrono::duration_cast<std::chrono::nanoseconds>(
+						     job->dispatchedAt.time_since_epoch())
+						     .count();
+			profiler->recordSpan(ProfileEventKind::AsyncRequest, state->profileKey, job->frameNumber, start,
+					     dispatched);
+		}
+
+		job->outputs.resize(state->outputCount);
+		for (uint32_t i = 0; i < state->outputCount; ++i) {
+			job->outputs[i] = work.at(state->inputCount + i);
+		}
+		job->completedAt = std::chrono::steady_clock::now();
+		job->done.set_value();
+	}
+}
+
+//=============================================================================
+// Statistics
+//=============================================================================
+
+AsyncNodeStats AsyncNodeExecutor::getStats(const std::string &nodeId) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_stats.find(nodeId);
+	return it != m_stats.end() ? it->second : AsyncNodeStats();
+}
+
+std::map<std::string, AsyncNodeStats> AsyncNodeExecutor::getAllStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+} // namespace SceneGraph
+} // namespace NeuralStudio
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "IExecutableNode.h"
+#include "PinSlots.h"
+#include "TaskScheduler.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace NeuralStudio {
+    namespace SceneGraph {
+
+        struct AsyncNodeState;
+
+        // Per-node pipelining statistics
+        struct AsyncNodeStats {
+            uint64_t dispatched = 0;
+            uint64_t completed = 0;
+            uint64_t failed = 0;
+            uint64_t dropped = 0;  // Frames skipped because maxInFlight requests were pending
+            uint32_t inFlight = 0;
+            uint64_t resultFrame = 0;      // Frame whose inputs produced the published outputs
+            uint64_t stalenessFrames = 0;  // Current frame - resultFrame
+            double stalenessMs = 0.0;      // Age of the published outputs' inputs
+            double lastLatencyMs = 0.0;    // Dispatch -> completion
+            double avgLatencyMs = 0.0;     // Exponential moving average
+            double maxLatencyMs = 0.0;
+        };
+
+        /**
+ * @brief Runs supportsAsync() nodes off the frame loop, pipelined across frames.
+ *
+ * Each attached node is bound to a private work buffer and executes on a
+ * per-node strand (requests of one node run in order, never concurrently).
+ * The graph keeps the node's regular pin slots as a mailbox: every frame it
+ * publishes the most recent completed result there (stamped with the frame
+ * it was computed for) and, if fewer than maxInFlight requests are pending,
+ * dispatches a new request with a snapshot of the connected inputs.
+ *
+ * All methods except the stats getters are called from the frame loop.
+ */
+        class AsyncNodeExecutor
+        {
+              public:
+            struct Config {
+                size_t workerCount = 2;  // Dedicated threads, separate from the frame's worker pool
+                size_t maxInFlight = 2;  // Default per node; pending requests incl. the running one
+            };
+
+            // Outcome of servicing a node for one frame
+            struct ServiceResult {
+                bool published = false;   // New outputs written to the mailbox
+                bool dispatched = false;  // Inputs captured for a new request
+                bool failed = false;      // A completed request failed
+                std::string errorMessage;
+            };
+
+            AsyncNodeExecutor();
+            explicit AsyncNodeExecutor(const Config &config);
+            ~AsyncNodeExecutor();  // Waits for pending requests
+
+            AsyncNodeExecutor(const AsyncNodeExecutor &) = delete;
+            AsyncNodeExecutor &operator=(const AsyncNodeExecutor &) = delete;
+
+            // The worker count only applies before the first node attaches
+            void setConfig(const Config &config);
+            Config getConfig() const;
+            void setMaxInFlight(const std::string &nodeId, size_t maxInFlight);
+
+            // Returns the node's state, attaching it on first use. nullptr if the
+            // node cannot run isolated (it does not support pin slots).
+            AsyncNodeState *attach(const std::shared_ptr<IExecutableNode> &node);
+            // Detaches nodes not in 'live' once their pending requests have finished
+            void retainOnly(const std::set<IExecutableNode *> &live);
+            // Wait for pending requests and unbind (the node leaves async mode)
+            void detachNow(IExecutableNode *node);
+            void detachAll();
+            bool isAttached(IExecutableNode *node) const
+            {
+                return m_states.count(node) != 0;
+            }
+            // Copies the last published outputs into a (new) mailbox
+            void restoreOutputs(AsyncNodeState &state, PinSlotBuffer &mailbox, uint32_t slotBase);
+
+            ServiceResult service(AsyncNodeState &state, PinSlotBuffer &mailbox, uint32_t slotBase,
+                                  const std::vector<uint32_t> &connectedInputs, bool dispatch,
+                                  const ExecutionContext &ctx);
+            bool hasPending(const AsyncNodeState &state) const;
+
+            // Thread-safe
+            AsyncNodeStats getStats(const std::string &nodeId) const;
+            std::map<std::string, AsyncNodeStats> getAllStats() const;
+
+              private:
+            void runStrand(const std::shared_ptr<AsyncNodeState> &state);
+            void collectRetired();
+            void detach(AsyncNodeState &state);
+
+            Config m_config;
+            std::map<IExecutableNode *, std::shared_ptr<AsyncNodeState>> m_states;
+            std::vector<std::shared_ptr<AsyncNodeState>> m_retired;  // Detached, requests still pending
+
+            // Shared with other threads (config, per-node limits, stats)
+            std::map<std::string, size_t> m_maxInFlight;
+            std::map<std::string, AsyncNodeStats> m_stats;
+            mutable std::mutex m_mutex;
+
+            TaskGroup m_group;
+            std::unique_ptr<TaskScheduler> m_workers;  // Started when the first node attaches
+        };
+
+    }  // namespace SceneGraph
+}  // namespace NeuralStudio
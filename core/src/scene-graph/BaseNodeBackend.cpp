@@ -15,21 +15,23 @@ BaseNodeBackend::BaseNodeBackend(const std::string &nodeId, const std::string &n
 
 void BaseNodeBackend::setPinData(const std::string &pinId, const std::any &data)
 {
-	m_pinData[pinId] = data;
+	m_pins.set(pinId, data);
 }
 
 std::any BaseNodeBackend::getPinData(const std::string &pinId) const
 {
-	auto it = m_pinData.find(pinId);
-	if (it != m_pinData.end()) {
-		return it->second;
-	}
-	return std::any();
+	return m_pins.get(pinId);
 }
 
 bool BaseNodeBackend::hasPinData(const std::string &pinId) const
 {
-	return m_pinData.find(pinId) != m_pinData.end();
+	return m_pins.has(pinId);
+}
+
+bool BaseNodeBackend::bindPinSlots(PinSlotBuffer *buffer, uint32_t baseSlot)
+{
+	m_pins.bind(buffer, baseSlot, m_inputs, m_outputs);
+	return buffer != nullptr;
 }
 
 void BaseNodeBackend::addInput(const std::string &pinId, const std::string &name, const DataType &type)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "IExecutableNode.h"
+#include "PinSlots.h"
 
 namespace NeuralStudio {
     namespace SceneGraph {
@@ -43,6 +44,7 @@ namespace NeuralStudio {
             void setPinData(const std::string &pinId, const std::any &data) override;
             std::any getPinData(const std::string &pinId) const override;
             bool hasPinData(const std::string &pinId) const override;
+            bool bindPinSlots(PinSlotBuffer *buffer, uint32_t baseSlot) override;
 
               protected:
             // Helper methods for derived classes
@@ -57,31 +59,43 @@ namespace NeuralStudio {
             // Convenient data accessors
             template<typename T> T *getInputData(const std::string &pinId)
             {
-                if (hasPinData(pinId)) {
-                    try {
-                        return std::any_cast<T>(&m_pinData[pinId]);
-                    } catch (...) {
-                        return nullptr;
-                    }
-                }
-                return nullptr;
+                PinValue *value = m_pins.find(pinId);
+                return value ? value->getIf<T>() : nullptr;
             }
 
             template<typename T> T getInputData(const std::string &pinId, const T &defaultValue)
             {
-                if (hasPinData(pinId)) {
-                    try {
-                        return std::any_cast<T>(m_pinData[pinId]);
-                    } catch (...) {
-                        return defaultValue;
-                    }
-                }
-                return defaultValue;
+                T *value = getInputData<T>(pinId);
+                return value ? *value : defaultValue;
             }
 
             template<typename T> void setOutputData(const std::string &pinId, const T &data)
             {
-                m_pinData[pinId] = data;
+                m_pins.value(pinId).set(data);
+            }
+
+            // Shared payloads (video frames, audio buffers, meshes): publish with
+            // setOutputData(pinId, FrameHandle<T>), read without copying the payload.
+            template<typename T> FrameHandle<T> getInputHandle(const std::string &pinId) const
+            {
+                const PinValue *value = m_pins.find(pinId);
+                return value ? value->getHandle<T>() : FrameHandle<T>();
+            }
+
+            // Where an input came from when its producer runs pipelined (see PinStamp)
+            PinStamp getInputStamp(const std::string &pinId) const
+            {
+                return m_pins.stamp(pinId);
+            }
+
+            // Index-based accessors (hot path): index into getInputPins()/getOutputPins()
+            PinValue &inputValue(size_t inputIndex)
+            {
+                return m_pins.valueAt(inputIndex, m_inputs[inputIndex].pinId);
+            }
+            PinValue &outputValue(size_t outputIndex)
+            {
+                return m_pins.valueAt(m_inputs.size() + outputIndex, m_outputs[outputIndex].pinId);
             }
 
               private:
@@ -92,7 +106,7 @@ namespace NeuralStudio {
             std::vector<PinDescriptor> m_inputs;
             std::vector<PinDescriptor> m_outputs;
 
-            std::map<std::string, std::any> m_pinData;
+            PinStorage m_pins;
         };
 
     }  // namespace SceneGraph
@@ -0,0 +1,327 @@
+#include "ExecutionProfiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace NeuralStudio {
+namespace SceneGraph {
+
+namespace {
+
+const char *kindName(ProfileEventKind kind)
+{
+	switch (kind) {
+	case ProfileEventKind::Frame:
+		return "frame";
+	case ProfileEventKind::Node:
+		return "node";
+	case ProfileEventKind::AsyncService:
+		return "async-service";
+	case ProfileEventKind::AsyncRequest:
+		return "async-request";
+	}
+	return "node";
+}
+
+const char *cacheName(ProfileCacheStatus status)
+{
+	switch (status) {
+	case ProfileCacheStatus::NotCached:
+		return "none";
+	case ProfileCacheStatus::Hit:
+		return "hit";
+	case ProfileCacheStatus::Miss:
+		return "miss";
+	case ProfileCacheStatus::Uncacheable:
+		return "uncacheable";
+	}
+	return "none";
+}
+
+std::string escapeJson(const std::string &text)
+{
+	std::string escaped;
+	escaped.reserve(text.size());
+	for (char c : text) {
+		switch (c) {
+		case '"':
+			escaped += "\\\"";
+			break;
+		case '\\':
+			escaped += "\\\\";
+			break;
+		case '\n':
+			escaped += "\\n";
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				char buffer[8];
+				std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+				escaped += buffer;
+			} else {
+				escaped += c;
+			}
+		}
+	}
+	return escaped;
+}
+
+double percentile(const std::vector<uint32_t> &sorted, double fraction)
+{
+	if (sorted.empty())
+		return 0.0;
+	size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+	return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1] / 1e6;
+}
+
+uint32_t clampNs(int64_t ns)
+{
+	return static_cast<uint32_t>(std::clamp<int64_t>(ns, 0, UINT32_MAX));
+}
+
+} // namespace
+
+ExecutionProfiler::ExecutionProfiler(size_t capacity)
+{
+	size_t size = 1;
+	while (size < std::max<size_t>(capacity, 2))
+		size <<= 1;
+	m_slots = std::make_unique<Slot[]>(size);
+	m_mask = size - 1;
+}
+
+int64_t ExecutionProfiler::now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+uint32_t ExecutionProfiler::currentThreadId()
+{
+	static std::atomic<uint32_t> nextId {1};
+	thread_local uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+	return id;
+}
+
+uint64_t ExecutionProfiler::nodeKey(const std::string &nodeId)
+{
+	uint64_t key = std::hash<std::string> {}(nodeId);
+	return key ? key : 1; // 0 is reserved for frame events
+}
+
+//=============================================================================
+// Recording
+//=============================================================================
+
+void ExecutionProfiler::record(const ProfileEvent &event)
+{
+	uint64_t ticket = m_head.fetch_add(1, std::memory_order_relaxed);
+	Slot &slot = m_slots[ticket & m_mask];
+
+	// Seqlock: odd while writing. Two writers only share a slot if the ring
+	// wraps during a single write, in which case the reader may see either.
+	slot.sequence.store(2 * ticket + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot.words[0].store(event.nodeKey, std::memory_order_relaxed);
+	slot.words[1].store(static_cast<uint64_t>(event.startNs), std::memory_order_relaxed);
+	slot.words[2].store(event.durationNs | (static_cast<uint64_t>(event.queueWaitNs) << 32),
+			    std::memory_order_relaxed);
+	slot.words[3].store(event.frameNumber, std::memory_order_relaxed);
+	slot.words[4].store(event.threadId | (static_cast<uint64_t>(event.kind) << 32) |
+				    (static_cast<uint64_t>(event.cache) << 40),
+			    std::memory_order_relaxed);
+
+	slot.sequence.store(2 * ticket + 2, std::memory_order_release);
+}
+
+void ExecutionProfiler::recordSpan(ProfileEventKind kind, uint64_t nodeKey, uint64_t frameNumber, int64_t startNs,
+				   int64_t readyNs, ProfileCacheStatus cache)
+{
+	ProfileEvent event;
+	event.nodeKey = nodeKey;
+	event.startNs = startNs;
+	event.durationNs = clampNs(now() - startNs);
+	event.queueWaitNs = readyNs ? clampNs(startNs - readyNs) : 0;
+	event.frameNumber = frameNumber;
+	event.threadId = currentThreadId();
+	event.kind = kind;
+	event.cache = cache;
+	record(event);
+}
+
+void ExecutionProfiler::registerNode(uint64_t key, const std::string &nodeId)
+{
+	std::lock_guard<std::mutex> lock(m_namesMutex);
+	m_names[key] = nodeId;
+}
+
+//=============================================================================
+// Reading
+//=============================================================================
+
+std::vector<ProfileEvent> ExecutionProfiler::snapshot() const
+{
+	uint64_t head = m_head.load(std::memory_order_acquire);
+	uint64_t begin = std::max(m_tail.load(std::memory_order_relaxed), head > m_mask ? head - m_mask - 1 : 0);
+
+	std::vector<ProfileEvent> events;
+	events.reserve(head - begin);
+	for (uint64_t ticket = begin; ticket < head; ++ticket) {
+		const Slot &slot = m_slots[ticket & m_mask];
+		uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+		if (sequence != 2 * ticket + 2)
+			continue; // Still being written, or already overwritten
+
+		uint64_t words[kWords];
+		for (size_t i = 0; i < kWords; ++i) {
+			words[i] = slot.words[i].load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+			continue;
+
+		ProfileEvent event;
+		event.nodeKey = words[0];
+		event.startNs = static_cast<int64_t>(words[1]);
+		event.durationNs = static_cast<uint32_t>(words[2]);
+		event.queueWaitNs = static_cast<uint32_t>(words[2] >> 32);
+		event.frameNumber = words[3];
+		event.threadId = static_cast<uint32_t>(words[4]);
+		event.kind = static_cast<ProfileEventKind>((words[4] >> 32) & 0xff);
+		event.cache = static_cast<ProfileCacheStatus>((words[4] >> 40) & 0xff);
+		events.push_back(event);
+	}
+	return events;
+}
+
+std::string ExecutionProfiler::nameOf(uint64_t key, const std::unordered_map<uint64_t, std::string> &names) const
+{
+	if (key == 0)
+		return "frame";
+	auto it = names.find(key);
+	if (it != names.end())
+		return it->second;
+
+	char buffer[24];
+	std::snprintf(buffer, sizeof(buffer), "node-%016llx", static_cast<unsigned long long>(key));
+	return buffer;
+}
+
+std::map<std::string, NodeProfileStats> ExecutionProfiler::getNodeStats() const
+{
+	struct Samples {
+		std::vector<uint32_t> durations;
+		std::vector<uint32_t> queueWaits;
+		uint32_t hits = 0;
+		uint32_t misses = 0;
+	};
+
+	// Pipelined nodes are reported by their worker-side request time
+	std::unordered_map<uint64_t, Samples> byNode;
+	for (const auto &event : snapshot()) {
+		if (event.kind == ProfileEventKind::AsyncService)
+			continue;
+
+		Samples &samples = byNode[event.nodeKey];
+		samples.durations.push_back(event.durationNs);
+		samples.queueWaits.push_back(event.queueWaitNs);
+		samples.hits += event.cache == ProfileCacheStatus::Hit;
+		samples.misses += event.cache == ProfileCacheStatus::Miss;
+	}
+
+	std::unordered_map<uint64_t, std::string> names;
+	{
+		std::lock_guard<std::mutex> lock(m_namesMutex);
+		names = m_names;
+	}
+
+	std::map<std::string, NodeProfileStats> result;
+	for (auto &[key, samples] : byNode) {
+		std::sort(samples.durations.begin(), samples.durations.end());
+		std::sort(samples.queueWaits.begin(), samples.queueWaits.end());
+
+		NodeProfileStats &stats = result[nameOf(key, names)];
+		stats.samples = static_cast<uint32_t>(samples.durations.size());
+		stats.p50Ms = percentile(samples.durations, 0.50);
+		stats.p99Ms = percentile(samples.durations, 0.99);
+		stats.maxMs = samples.durations.back() / 1e6;
+		stats.p99QueueWaitMs = percentile(samples.queueWaits, 0.99);
+		stats.cacheHits = samples.hits;
+		stats.cacheMisses = samples.misses;
+	}
+	return result;
+}
+
+std::string ExecutionProfiler::exportChromeTrace() const
+{
+	std::vector<ProfileEvent> events = snapshot();
+	std::unordered_map<uint64_t, std::string> names;
+	{
+		std::lock_guard<std::mutex> lock(m_namesMutex);
+		names = m_names;
+	}
+
+	int64_t origin = 0;
+	if (!events.empty()) {
+		origin = std::min_element(events.begin(), events.end(), [](const auto &a, const auto &b) {
+				 return a.startNs < b.startNs;
+			 })->startNs;
+	}
+
+	// Complete ("X") events, timestamps in microseconds
+	std::ostringstream json;
+	json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	char buffer[96];
+	bool first = true;
+	for (const auto &event : events) {
+		if (!first)
+			json << ',';
+		first = false;
+
+		std::snprintf(buffer, sizeof(buffer), "\"ts\":%.3f,\"dur\":%.3f", (event.startNs - origin) / 1e3,
+			      event.durationNs / 1e3);
+		json << "{\"name\":\"" << escapeJson(nameOf(event.nodeKey, names)) << "\",\"cat\":\""
+		     << kindName(event.kind) << "\",\"ph\":\"X\"," << buffer << ",\"pid\":1,\"tid\":" << event.threadId
+		     << ",\"args\":{\"frame\":" << event.frameNumber;
+		if (event.kind != ProfileEventKind::Frame) {
+			std::snprintf(buffer, sizeof(buffer), "%.3f", event.queueWaitNs / 1e3);
+			json << ",\"queueWaitUs\":" << buffer << ",\"cache\":\"" << cacheName(event.cache) << '"';
+		}
+		json << "}}";
+	}
+	json << "]}";
+	return json.str();
+}
+
+bool ExecutionProfiler::writeChromeTrace(const std::string &path) const
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+		return false;
+	file << exportChromeTrace();
+	return static_cast<bool>(file);
+}
+
+void ExecutionProfiler::clear()
+{
+	m_tail.store(m_head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+//=============================================================================
+// ProfileFrameScope
+//=============================================================================
+
+ProfileFrameScope::~ProfileFrameScope()
+{
+	if (m_profiler) {
+		m_profiler->recordSpan(ProfileEventKind::Frame, 0, m_frameNumber, m_start);
+	}
+}
+
+} // namespace SceneGraph
+} // namespace NeuralStudio
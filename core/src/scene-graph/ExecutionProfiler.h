@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NeuralStudio {
+    namespace SceneGraph {
+
+        //=============================================================================
+        // Profile Events
+        //=============================================================================
+
+        enum class ProfileEventKind : uint8_t {
+            Frame,         // One execute()/executeParallel() call
+            Node,          // Synchronous node evaluation (process() or cache restore)
+            AsyncService,  // Frame-loop side of a pipelined node (publish + dispatch)
+            AsyncRequest   // A pipelined node's process() on the async workers
+        };
+
+        enum class ProfileCacheStatus : uint8_t {
+            NotCached,  // Caching disabled or not applicable to the node
+            Hit,
+            Miss,
+            Uncacheable  // An input had no hasher
+        };
+
+        struct ProfileEvent {
+            uint64_t nodeKey = 0;  // ExecutionProfiler::nodeKey(nodeId); 0 for frame events
+            int64_t startNs = 0;   // steady_clock
+            uint32_t durationNs = 0;
+            uint32_t queueWaitNs = 0;  // Ready (or dispatched) -> started
+            uint64_t frameNumber = 0;
+            uint32_t threadId = 0;  // ExecutionProfiler::currentThreadId()
+            ProfileEventKind kind = ProfileEventKind::Node;
+            ProfileCacheStatus cache = ProfileCacheStatus::NotCached;
+        };
+
+        // Rolling statistics over the events still in the ring
+        struct NodeProfileStats {
+            uint32_t samples = 0;
+            double p50Ms = 0.0;
+            double p99Ms = 0.0;
+            double maxMs = 0.0;
+            double p99QueueWaitMs = 0.0;
+            uint32_t cacheHits = 0;
+            uint32_t cacheMisses = 0;
+        };
+
+        //=============================================================================
+        // Execution Profiler
+        //=============================================================================
+
+        /**
+ * @brief Per-node timing recorder for the scene graph.
+ *
+ * Enabled by pointing ExecutionContext::profiler at an instance; with a null
+ * pointer the graph pays one branch per node. record() is lock-free and may
+ * be called from any thread: events go into a fixed ring (oldest overwritten)
+ * whose slots are published with a per-slot sequence number, so readers can
+ * snapshot while frames are running.
+ *
+ * The profiler must outlive frames that reference it, including requests
+ * still pending on the async executor.
+ */
+        class ExecutionProfiler
+        {
+              public:
+            explicit ExecutionProfiler(size_t capacity = 1 << 16);  // Rounded up to a power of two
+
+            ExecutionProfiler(const ExecutionProfiler &) = delete;
+            ExecutionProfiler &operator=(const ExecutionProfiler &) = delete;
+
+            static int64_t now();
+            static uint32_t currentThreadId();  // Small stable id per thread
+            static uint64_t nodeKey(const std::string &nodeId);
+
+            // Hot path (lock-free)
+            void record(const ProfileEvent &event);
+            // Event ending now on the calling thread; readyNs = 0 means no queue wait
+            void recordSpan(ProfileEventKind kind, uint64_t nodeKey, uint64_t frameNumber, int64_t startNs,
+                            int64_t readyNs = 0, ProfileCacheStatus cache = ProfileCacheStatus::NotCached);
+
+            // Names for export; registered once per schedule
+            void registerNode(uint64_t key, const std::string &nodeId);
+
+            // Reader side
+            std::vector<ProfileEvent> snapshot() const;  // Oldest first
+            std::map<std::string, NodeProfileStats> getNodeStats() const;
+            std::string exportChromeTrace() const;  // trace_event JSON (chrome://tracing, Perfetto)
+            bool writeChromeTrace(const std::string &path) const;
+            void clear();
+
+            uint64_t getRecordedCount() const
+            {
+                return m_head.load(std::memory_order_relaxed);
+            }
+            size_t getCapacity() const
+            {
+                return m_mask + 1;
+            }
+
+              private:
+            static constexpr size_t kWords = 5;
+
+            struct Slot {
+                std::atomic<uint64_t> sequence {0};  // 2 * ticket + 2 once written, odd while writing
+                std::atomic<uint64_t> words[kWords];
+            };
+
+            std::string nameOf(uint64_t key, const std::unordered_map<uint64_t, std::string> &names) const;
+
+            std::unique_ptr<Slot[]> m_slots;
+            size_t m_mask = 0;
+            std::atomic<uint64_t> m_head {0};
+            std::atomic<uint64_t> m_tail {0};  // clear() moves this forward
+
+            std::unordered_map<uint64_t, std::string> m_names;
+            mutable std::mutex m_namesMutex;
+        };
+
+        /**
+ * @brief Records a Frame event for its scope. Does nothing without a profiler.
+ */
+        class ProfileFrameScope
+        {
+              public:
+            ProfileFrameScope(ExecutionProfiler *profiler, uint64_t frameNumber) :
+                m_profiler(profiler), m_frameNumber(frameNumber), m_start(profiler ? ExecutionProfiler::now() : 0)
+            {
+            }
+            ~ProfileFrameScope();
+
+            ProfileFrameScope(const ProfileFrameScope &) = delete;
+            ProfileFrameScope &operator=(const ProfileFrameScope &) = delete;
+
+              private:
+            ExecutionProfiler *m_profiler;
+            uint64_t m_frameNumber;
+            int64_t m_start;
+        };
+
+    }  // namespace SceneGraph
+}  // namespace NeuralStudio
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace NeuralStudio {
+    namespace SceneGraph {
+
+        //=============================================================================
+        // Frame Handle
+        //=============================================================================
+
+        /**
+ * @brief Reference-counted, immutable handle to a heavy pin payload.
+ *
+ * Producers build the payload once and publish it through an output pin;
+ * every connection that fans it out only bumps the reference count.
+ * The payload is const, so consumers that need to modify it must copy.
+ */
+        template<typename T> class FrameHandle
+        {
+              public:
+            using ValueType = T;
+
+            FrameHandle() = default;
+            explicit FrameHandle(std::shared_ptr<const T> data) : m_data(std::move(data)) {}
+
+            template<typename... Args> static FrameHandle make(Args &&...args)
+            {
+                return FrameHandle(std::make_shared<const T>(std::forward<Args>(args)...));
+            }
+
+            const T *get() const
+            {
+                return m_data.get();
+            }
+            const T &operator*() const
+            {
+                return *m_data;
+            }
+            const T *operator->() const
+            {
+                return m_data.get();
+            }
+            explicit operator bool() const
+            {
+                return static_cast<bool>(m_data);
+            }
+            long useCount() const
+            {
+                return m_data.use_count();
+            }
+            const std::shared_ptr<const T> &shared() const
+            {
+                return m_data;
+            }
+
+            bool operator==(const FrameHandle &other) const
+            {
+                return m_data == other.m_data;
+            }
+
+              private:
+            std::shared_ptr<const T> m_data;
+        };
+
+        template<typename T> struct IsFrameHandle : std::false_type {};
+        template<typename T> struct IsFrameHandle<FrameHandle<T>> : std::true_type {};
+
+        //=============================================================================
+        // Standard Payloads
+        //=============================================================================
+
+        // CPU-side video frame (DataType::Video). gpuHandle optionally points at
+        // an uploaded texture owned by the renderer.
+        struct VideoFrameData {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t stride = 0;       // Bytes per row of plane 0
+            uint32_t pixelFormat = 0;  // Producer-defined (e.g. video_format)
+            int64_t pts = 0;           // Presentation timestamp (ns)
+            std::vector<uint8_t> pixels;
+            void *gpuHandle = nullptr;
+
+            // Decoder-owned planes when pixels is empty (e.g. VideoNode). They
+            // stay valid while the handle lives; the buffer goes back to the
+            // decoder when the last handle is dropped.
+            const uint8_t *planes[4] = {};
+            uint32_t linesizes[4] = {};
+        };
+
+        // Interleaved float audio (DataType::Audio)
+        struct AudioBufferData {
+            uint32_t sampleRate = 48000;
+            uint32_t channels = 2;
+            uint32_t frames = 0;
+            int64_t pts = 0;  // ns
+            std::vector<float> samples;
+        };
+
+        // Indexed triangle mesh (DataType::Mesh)
+        struct MeshData {
+            std::vector<float> positions;  // xyz
+            std::vector<float> normals;    // xyz
+            std::vector<float> uvs;        // uv
+            std::vector<uint32_t> indices;
+        };
+
+        using VideoFrameHandle = FrameHandle<VideoFrameData>;
+        using AudioBufferHandle = FrameHandle<AudioBufferData>;
+        using MeshHandle = FrameHandle<MeshData>;
+
+    }  // namespace SceneGraph
+}  // namespace NeuralStudio
@@ -0,0 +1,111 @@
+#include "GraphRunner.h"
+#include <chrono>
+
+namespace NeuralStudio {
+namespace SceneGraph {
+
+GraphRunner::GraphRunner(std::shared_ptr<NodeExecutionGraph> graph) : m_graph(std::move(graph)) {}
+
+GraphRunner::~GraphRunner()
+{
+	stop();
+}
+
+void GraphRunner::start(const ExecutionContext &context, const Config &config)
+{
+	if (!m_graph || m_thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_stopMutex);
+		m_stopRequested = false;
+	}
+	m_running.store(true, std::memory_order_release);
+	m_thread = std::thread(&GraphRunner::run, this, context, config);
+}
+
+void GraphRunner::stop()
+{
+	if (!m_thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_stopMutex);
+		m_stopRequested = true;
+	}
+	m_stopCondition.notify_all();
+	m_thread.join();
+	m_running.store(false, std::memory_order_release);
+
+	// Edits posted after the last frame started
+	applyEdits();
+}
+
+void GraphRunner::post(std::function<void()> edit)
+{
+	if (!m_thread.joinable()) {
+		edit();
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_editMutex);
+	m_edits.push_back(std::move(edit));
+}
+
+void GraphRunner::applyEdits()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_editMutex);
+		if (m_edits.empty())
+			return;
+		m_applying.swap(m_edits);
+	}
+
+	// Outside the lock: an edit may take a while (e.g. closing a player)
+	for (auto &edit : m_applying)
+		edit();
+	m_applying.clear();
+}
+
+void GraphRunner::run(ExecutionContext context, Config config)
+{
+	using Clock = std::chrono::steady_clock;
+	const auto interval = config.targetFps > 0.0
+				      ? std::chrono::duration_cast<Clock::duration>(
+						std::chrono::duration<double>(1.0 / config.targetFps))
+				      : Clock::duration::zero();
+
+	auto previous = Clock::now();
+	auto deadline = previous;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(m_stopMutex);
+			if (m_stopCondition.wait_until(lock, deadline, [this] { return m_stopRequested; }))
+				break;
+		}
+
+		auto start = Clock::now();
+		deadline = start + interval;
+
+		applyEdits();
+
+		// Nothing compiled yet: poll at the frame rate until the editor publishes
+		if (!m_graph->getSnapshot())
+			continue;
+
+		context.deltaTime = std::chrono::duration<double>(start - previous).count();
+		context.timeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(start - previous).count();
+		previous = start;
+
+		bool ok = config.parallel ? m_graph->executeParallel(context) : m_graph->execute(context);
+		if (!ok)
+			m_failedFrames.fetch_add(1, std::memory_order_relaxed);
+		m_lastFrameMs.store(std::chrono::duration<double, std::milli>(Clock::now() - start).count(),
+				    std::memory_order_relaxed);
+		m_frameCount.fetch_add(1, std::memory_order_relaxed);
+		context.frameNumber++;
+	}
+}
+
+} // namespace SceneGraph
+} // namespace NeuralStudio
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "NodeExecutionGraph.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NeuralStudio {
+    namespace SceneGraph {
+
+        //=============================================================================
+        // Graph Runner
+        //=============================================================================
+
+        /**
+ * @brief Runs a NodeExecutionGraph's frames on a dedicated engine thread.
+ *
+ * The thread only executes the latest published snapshot, so the owner keeps
+ * editing and compiling the graph from its own thread (e.g. the Qt UI) while
+ * frames run at the target rate. Edits become visible at the first frame
+ * after the next successful compile().
+ *
+ * The snapshot only covers topology. Node state (paths, parameters, dirty
+ * flags) is read by process() on the engine thread, so changes to it go
+ * through post() and are applied between frames.
+ */
+        class GraphRunner
+        {
+              public:
+            struct Config {
+                double targetFps = 90.0;  // 0 = run frames back to back
+                bool parallel = true;     // executeParallel() instead of execute()
+            };
+
+            explicit GraphRunner(std::shared_ptr<NodeExecutionGraph> graph);
+            ~GraphRunner();
+
+            GraphRunner(const GraphRunner &) = delete;
+            GraphRunner &operator=(const GraphRunner &) = delete;
+
+            // Every frame starts from a copy of context (renderer, profiler, ...);
+            // frameNumber, deltaTime and timeNs are filled in by the runner.
+            void start(const ExecutionContext &context, const Config &config);
+            void start(const ExecutionContext &context)
+            {
+                start(context, Config());
+            }
+            void stop();  // Waits for the frame in flight, then applies pending edits
+
+            // Runs edit on the engine thread before the next frame, or right
+            // away while stopped. Call from the thread that owns start()/stop().
+            void post(std::function<void()> edit);
+            bool isRunning() const
+            {
+                return m_running.load(std::memory_order_acquire);
+            }
+
+            // Stats (any thread)
+            uint64_t getFrameCount() const
+            {
+                return m_frameCount.load(std::memory_order_relaxed);
+            }
+            uint64_t getFailedFrameCount() const
+            {
+                return m_failedFrames.load(std::memory_order_relaxed);
+            }
+            double getLastFrameMs() const
+            {
+                return m_lastFrameMs.load(std::memory_order_relaxed);
+            }
+
+              private:
+            void run(ExecutionContext context, Config config);
+            void applyEdits();
+
+            std::shared_ptr<NodeExecutionGraph> m_graph;
+            std::thread m_thread;
+            std::atomic<bool> m_running {false};
+            std::mutex m_stopMutex;
+            std::condition_variable m_stopCondition;
+            bool m_stopRequested = false;
+
+            std::mutex m_editMutex;
+            std::vector<std::function<void()>> m_edits;
+            std::vector<std::function<void()>> m_applying;  // Engine thread only
+
+            std::atomic<uint64_t> m_frameCount {0};
+            std::atomic<uint64_t> m_failedFrames {0};
+            std::atomic<double> m_lastFrameMs {0.0};
+        };
+
+    }  // namespace SceneGraph
+}  // namespace NeuralStudio
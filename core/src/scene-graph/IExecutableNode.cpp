@@ -1,5 +1,4 @@
 #include "IExecutableNode.h"
-#include <algorithm>
 
 namespace NeuralStudio {
 namespace SceneGraph {
@@ -46,45 +45,5 @@ bool DataType::canConvertTo(const DataType &other) const
 	return false;
 }
 
-//=============================================================================
-// Node Factory Implementation
-//=============================================================================
-
-std::map<std::string, NodeFactory::NodeCreator> &NodeFactory::getRegistry()
-{
-	static std::map<std::string, NodeCreator> registry;
-	return registry;
-}
-
-void NodeFactory::registerNodeType(const std::string &typeName, NodeCreator creator)
-{
-	getRegistry()[typeName] = creator;
-}
-
-std::shared_ptr<IExecutableNode> NodeFactory::create(const std::string &typeName, const std::string &nodeId)
-{
-	auto &registry = getRegistry();
-	auto it = registry.find(typeName);
-	if (it != registry.end()) {
-		return it->second(nodeId);
-	}
-	return nullptr;
-}
-
-std::vector<std::string> NodeFactory::getRegisteredTypes()
-{
-	std::vector<std::string> types;
-	for (const auto &[name, _] : getRegistry()) {
-		types.push_back(name);
-	}
-	std::sort(types.begin(), types.end());
-	return types;
-}
-
-bool NodeFactory::isTypeRegistered(const std::string &typeName)
-{
-	return getRegistry().find(typeName) != getRegistry().end();
-}
-
 } // namespace SceneGraph
 } // namespace NeuralStudio
@@ -12,6 +12,7 @@ namespace NeuralStudio {
 
         // Forward declarations
         class IExecutableNode;
+        class PinSlotBuffer;
         struct ExecutionContext;
         struct ExecutionResult;
 
@@ -151,6 +152,8 @@ namespace NeuralStudio {
             bool supportsCaching = true;
             bool supportsRealtime = true;
             bool supportsOffline = true;
+            bool timeVarying = false;  // Output changes every frame without input changes (live/playback sources)
+            bool isSink = false;       // Graph output (headset, virtual cam, encoder); drives demand-driven evaluation
 
             // Resources
             uint64_t estimatedMemoryMB = 0;
@@ -178,6 +181,7 @@ namespace NeuralStudio {
 
         // Forward declarations
         class IExecutableNode;
+        class ExecutionProfiler;
         struct ExecutionContext;
         struct ExecutionResult;
 
@@ -189,6 +193,8 @@ namespace NeuralStudio {
             void *presentationTarget = nullptr;
             double deltaTime = 0.0;
             uint64_t frameNumber = 0;
+            int64_t timeNs = 0;  // Graph clock: deltaTime summed over the frames run so far
+            ExecutionProfiler *profiler = nullptr;  // Non-null enables per-node timing
 
             // Shared data pool (for inter-node communication)
             std::map<std::string, std::any> sharedData;
@@ -283,11 +289,30 @@ namespace NeuralStudio {
             {
                 return getMetadata().supportsGPU;
             }
+            virtual bool isTimeVarying() const
+            {
+                return getMetadata().timeVarying;
+            }
+            // Sinks may report inactive (e.g. no headset attached) to stop pulling their
+            // upstream; call NodeExecutionGraph::markDirty() when this changes.
+            virtual bool isActiveSink() const
+            {
+                return getMetadata().isSink;
+            }
 
             // Pin data access (implemented by base class)
             virtual void setPinData(const std::string &pinId, const std::any &data) = 0;
             virtual std::any getPinData(const std::string &pinId) const = 0;
             virtual bool hasPinData(const std::string &pinId) const = 0;
+
+            // Compiled pin slots: called by NodeExecutionGraph::compile() to move this
+            // node's pins into the graph's contiguous slot buffer (inputs first, then
+            // outputs, starting at baseSlot). buffer == nullptr unbinds. Returns false
+            // if the node only supports the string-keyed API above.
+            virtual bool bindPinSlots(PinSlotBuffer *buffer, uint32_t baseSlot)
+            {
+                return false;
+            }
         };
 
         // Network Node Interface
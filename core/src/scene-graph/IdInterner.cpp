@@ -0,0 +1,91 @@
+#include "IdInterner.h"
+#include <mutex>
+#include <stdexcept>
+
+namespace NeuralStudio {
+namespace SceneGraph {
+
+namespace {
+const std::string kEmptyId;
+}
+
+IdInterner &IdInterner::global()
+{
+	static IdInterner interner;
+	return interner;
+}
+
+IdInterner::IdInterner() : m_blocks(std::make_unique<std::atomic<std::string *>[]>(kMaxBlocks))
+{
+	// Block 0 holds the empty id in slot 0
+	m_blocks[0].store(new std::string[kBlockSize], std::memory_order_release);
+}
+
+IdInterner::~IdInterner()
+{
+	for (uint32_t i = 0; i < kMaxBlocks; ++i) {
+		delete[] m_blocks[i].load(std::memory_order_relaxed);
+	}
+}
+
+InternedId IdInterner::intern(std::string_view id)
+{
+	if (id.empty())
+		return InternedId();
+
+	{
+		std::shared_lock<std::shared_mutex> lock(m_mutex);
+		auto it = m_index.find(id);
+		if (it != m_index.end())
+			return InternedId {it->second};
+	}
+
+	std::unique_lock<std::shared_mutex> lock(m_mutex);
+	auto it = m_index.find(id); // Another thread may have added it in between
+	if (it != m_index.end())
+		return InternedId {it->second};
+
+	const uint32_t handle = m_count.load(std::memory_order_relaxed);
+	const uint32_t blockIndex = handle >> kBlockBits;
+	if (blockIndex >= kMaxBlocks)
+		throw std::length_error("IdInterner: id table is full");
+
+	std::string *block = m_blocks[blockIndex].load(std::memory_order_relaxed);
+	if (!block) {
+		block = new std::string[kBlockSize];
+		m_blocks[blockIndex].store(block, std::memory_order_release);
+	}
+
+	std::string &slot = block[handle & (kBlockSize - 1)];
+	slot.assign(id);
+	m_index.emplace(std::string_view(slot), handle);
+	m_count.store(handle + 1, std::memory_order_release); // Publishes the slot to resolve()
+	return InternedId {handle};
+}
+
+InternedId IdInterner::find(std::string_view id) const
+{
+	if (id.empty())
+		return InternedId();
+
+	std::shared_lock<std::shared_mutex> lock(m_mutex);
+	auto it = m_index.find(id);
+	return it != m_index.end() ? InternedId {it->second} : InternedId();
+}
+
+const std::string &IdInterner::resolve(InternedId handle) const
+{
+	if (handle.value >= m_count.load(std::memory_order_acquire))
+		return kEmptyId;
+
+	const std::string *block = m_blocks[handle.value >> kBlockBits].load(std::memory_order_acquire);
+	return block[handle.value & (kBlockSize - 1)];
+}
+
+size_t IdInterner::size() const
+{
+	return m_count.load(std::memory_order_acquire) - 1;
+}
+
+} // namespace SceneGraph
+} // namespace NeuralStudio
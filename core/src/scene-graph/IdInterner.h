@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace NeuralStudio {
+    namespace SceneGraph {
+
+        //=============================================================================
+        // Interned IDs
+        //=============================================================================
+
+        /**
+ * @brief Dense 32-bit handle for an interned node or pin id.
+ *
+ * Handles compare and hash as plain integers. Value 0 is the empty id;
+ * handles are never reused, so a handle stays valid (and keeps naming the
+ * same string) for the life of the process.
+ */
+        struct InternedId {
+            uint32_t value = 0;
+
+            constexpr bool isValid() const
+            {
+                return value != 0;
+            }
+            constexpr bool operator==(const InternedId &other) const
+            {
+                return value == other.value;
+            }
+            constexpr bool operator!=(const InternedId &other) const
+            {
+                return value != other.value;
+            }
+            constexpr bool operator<(const InternedId &other) const
+            {
+                return value < other.value;
+            }
+        };
+
+        using NodeHandle = InternedId;
+        using PinHandle = InternedId;
+
+        /**
+ * @brief Process-wide string <-> handle table for node and pin ids.
+ *
+ * intern() is the only call that takes a lock (shared for ids already
+ * known, exclusive to add one). resolve() is lock-free: strings live in
+ * fixed-size blocks that are never moved or freed, so a reference it
+ * returns stays valid for the life of the process.
+ *
+ * Strings are converted at the UI / IPC / serialization boundary; the
+ * graph, its caches and connections work on handles only.
+ */
+        class IdInterner
+        {
+              public:
+            static IdInterner &global();
+
+            IdInterner();
+            ~IdInterner();
+
+            IdInterner(const IdInterner &) = delete;
+            IdInterner &operator=(const IdInterner &) = delete;
+
+            // Returns the existing handle or assigns the next one. "" interns to the empty handle.
+            InternedId intern(std::string_view id);
+            // Empty handle if the id was never interned (lookups of unknown ids don't grow the table)
+            InternedId find(std::string_view id) const;
+            // "" for the empty handle or one this table never issued
+            const std::string &resolve(InternedId handle) const;
+
+            size_t size() const;  // Interned ids, excluding the empty one
+
+              private:
+            static constexpr uint32_t kBlockBits = 12;  // 4096 ids per block
+            static constexpr uint32_t kBlockSize = 1u << kBlockBits;
+            static constexpr uint32_t kMaxBlocks = 4096;  // ~16.7M ids
+
+            mutable std::shared_mutex m_mutex;
+            std::unordered_map<std::string_view, uint32_t> m_index;  // Views into the blocks below
+            std::unique_ptr<std::atomic<std::string *>[]> m_blocks;
+            std::atomic<uint32_t> m_count {1};  // Handle 0 is the empty id
+        };
+
+        inline InternedId internId(std::string_view id)
+        {
+            return IdInterner::global().intern(id);
+        }
+
+        inline InternedId findId(std::string_view id)
+        {
+            return IdInterner::global().find(id);
+        }
+
+        inline const std::string &idString(InternedId handle)
+        {
+            return IdInterner::global().resolve(handle);
+        }
+
+    }  // namespace SceneGraph
+}  // namespace NeuralStudio
+
+namespace std {
+    template<> struct hash<NeuralStudio::SceneGraph::InternedId> {
+        size_t operator()(const NeuralStudio::SceneGraph::InternedId &id) const noexcept
+        {
+            return std::hash<uint32_t> {}(id.value);
+        }
+    };
+}  // namespace std
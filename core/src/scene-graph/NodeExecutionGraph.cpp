@@ -2,14 +2,29 @@
 #include <algorithm>
 #include <iostream>
 #include <future>
+#include <unordered_set>
 
 namespace NeuralStudio {
 namespace SceneGraph {
 
+struct NodeExecutionGraph::FrameCounters {
+	std::atomic<uint32_t> evaluated {0};
+	std::atomic<uint32_t> skippedClean {0};
+	std::atomic<uint32_t> skippedInactive {0};
+};
+
 NodeExecutionGraph::NodeExecutionGraph() {}
 
 NodeExecutionGraph::~NodeExecutionGraph()
 {
+	// Join workers before the nodes they may reference go away
+	m_scheduler.reset();
+	m_asyncExecutor.detachAll();
+	if (m_activeSchedule) {
+		unbindPinSlots(*m_activeSchedule); // Nodes may outlive the graph
+	}
+	m_activeSchedule.reset();
+	m_publishedSchedule.store(nullptr);
 	m_nodes.clear();
 }
 
@@ -22,22 +37,57 @@ void NodeExecutionGraph::addNode(std::shared_ptr<IExecutableNode> node)
 	if (!node)
 		return;
 
-	std::string nodeId = node->getNodeId();
+	NodeHandle nodeId = internId(node->getNodeId());
 	m_nodes[nodeId] = node;
 	m_isCompiled = false; // Graph changed, need recompilation
+
+	// A new node has no edges yet, so appending it keeps the order valid
+	if (m_order.find(nodeId) == m_order.end()) {
+		m_order[nodeId] = m_nextOrder;
+		m_ordered[m_nextOrder] = nodeId;
+		m_nextOrder++;
+	}
 }
 
 void NodeExecutionGraph::removeNode(const std::string &nodeId)
+{
+	NodeHandle handle = findId(nodeId);
+	if (handle.isValid())
+		removeNode(handle);
+}
+
+void NodeExecutionGraph::removeNode(NodeHandle nodeId)
 {
 	// Remove all connections involving this node
 	disconnectAllPins(nodeId);
 
-	// Remove the node
+	// Removing a node (and its edges) never invalidates the topological order.
+	// Its pin slots are released when the next schedule is activated; until
+	// then the running schedule keeps it alive.
+	auto order = m_order.find(nodeId);
+	if (order != m_order.end()) {
+		m_ordered.erase(order->second);
+		m_order.erase(order);
+	}
+	m_successors.erase(nodeId);
+	m_predecessors.erase(nodeId);
+
+	// Remove the node (a node re-added under this id must not hit its entries).
+	// A frame still running the old snapshot may store new entries for it, so
+	// the invalidation is repeated at the next frame boundary.
 	m_nodes.erase(nodeId);
+	m_cache.invalidateNode(nodeId);
+	markDirty(nodeId);
 	m_isCompiled = false;
 }
 
 std::shared_ptr<IExecutableNode> NodeExecutionGraph::getNode(const std::string &nodeId) const
+{
+	NodeHandle handle = findId(nodeId);
+	return handle.isValid() ? getNode(handle) : nullptr;
+}
+
+std::shared_ptr<IExecutableNode> NodeExecutionGraph::getNode(NodeHandle nodeId) const
 {
 	auto it = m_nodes.find(nodeId);
 	return (it != m_nodes.end()) ? it->second : nullptr;
@@ -51,6 +101,18 @@ size_t NodeExecutionGraph::getNodeCount() const
 std::vector<std::string> NodeExecutionGraph::getNodeIds() const
 {
 	std::vector<std::string> ids;
+	ids.reserve(m_nodes.size());
+	for (const auto &[id, _] : m_nodes) {
+		ids.push_back(idString(id));
+	}
+	std::sort(ids.begin(), ids.end());
+	return ids;
+}
+
+std::vector<NodeHandle> NodeExecutionGraph::getNodeHandles() const
+{
+	std::vector<NodeHandle> ids;
+	ids.reserve(m_nodes.size());
 	for (const auto &[id, _] : m_nodes) {
 		ids.push_back(id);
 	}
@@ -63,6 +125,18 @@ std::vector<std::string> NodeExecutionGraph::getNodeIds() const
 
 bool NodeExecutionGraph::connectPins(const std::string &sourceNodeId, const std::string &sourcePinId,
 				     const std::string &targetNodeId, const std::string &targetPinId)
+{
+	// Nodes must already be in the graph (and so interned); pin ids are interned here
+	NodeHandle source = findId(sourceNodeId);
+	NodeHandle target = findId(targetNodeId);
+	if (!source.isValid() || !target.isValid()) {
+		return false;
+	}
+	return connectPins(source, internId(sourcePinId), target, internId(targetPinId));
+}
+
+bool NodeExecutionGraph::connectPins(NodeHandle sourceNodeId, PinHandle sourcePinId, NodeHandle targetNodeId,
+				     PinHandle targetPinId)
 {
 	// Validate nodes exist
 	if (!getNode(sourceNodeId) || !getNode(targetNodeId)) {
@@ -71,7 +145,7 @@ bool NodeExecutionGraph::connectPins(const std::string &sourceNodeId, const std:
 
 	// Check for duplicate connection
 	for (const auto &conn : m_connections) {
-		if (conn.targetNodeId == targetNodeId && conn.targetPinId == targetPinId) {
+		if (conn.targetNode == targetNodeId && conn.targetPin == targetPinId) {
 			// Input already connected, disconnect first
 			disconnectPins(targetNodeId, targetPinId);
 			break;
@@ -80,12 +154,14 @@ bool NodeExecutionGraph::connectPins(const std::string &sourceNodeId, const std:
 
 	// Add connection
 	PinConnection connection;
-	connection.sourceNodeId = sourceNodeId;
-	connection.sourcePinId = sourcePinId;
-	connection.targetNodeId = targetNodeId;
-	connection.targetPinId = targetPinId;
+	connection.sourceNode = sourceNodeId;
+	connection.sourcePin = sourcePinId;
+	connection.targetNode = targetNodeId;
+	connection.targetPin = targetPinId;
 
 	m_connections.push_back(connection);
+	m_unvalidated.push_back(connection);
+	addAdjacency(connection);
 	m_isCompiled = false; // Graph changed
 
 	return true;
@@ -93,23 +169,45 @@ bool NodeExecutionGraph::connectPins(const std::string &sourceNodeId, const std:
 
 void NodeExecutionGraph::disconnectPins(const std::string &targetNodeId, const std::string &targetPinId)
 {
-	m_connections.erase(std::remove_if(m_connections.begin(), m_connections.end(),
-					   [&](const PinConnection &conn) {
-						   return conn.targetNodeId == targetNodeId &&
-							  conn.targetPinId == targetPinId;
-					   }),
-			    m_connections.end());
+	NodeHandle node = findId(targetNodeId);
+	PinHandle pin = findId(targetPinId);
+	if (node.isValid() && pin.isValid())
+		disconnectPins(node, pin);
+}
 
-	m_isCompiled = false;
+void NodeExecutionGraph::disconnectPins(NodeHandle targetNodeId, PinHandle targetPinId)
+{
+	removeConnectionsIf([&](const PinConnection &conn) {
+		return conn.targetNode == targetNodeId && conn.targetPin == targetPinId;
+	});
 }
 
 void NodeExecutionGraph::disconnectAllPins(const std::string &nodeId)
 {
-	m_connections.erase(std::remove_if(m_connections.begin(), m_connections.end(),
-					   [&](const PinConnection &conn) {
-						   return conn.sourceNodeId == nodeId || conn.targetNodeId == nodeId;
-					   }),
+	NodeHandle handle = findId(nodeId);
+	if (handle.isValid())
+		disconnectAllPins(handle);
+}
+
+void NodeExecutionGraph::disconnectAllPins(NodeHandle nodeId)
+{
+	removeConnectionsIf([&](const PinConnection &conn) {
+		return conn.sourceNode == nodeId || conn.targetNode == nodeId;
+	});
+}
+
+template<typename Predicate> void NodeExecutionGraph::removeConnectionsIf(Predicate predicate)
+{
+	for (const auto &conn : m_connections) {
+		if (predicate(conn)) {
+			removeAdjacency(conn);
+		}
+	}
+
+	m_connections.erase(std::remove_if(m_connections.begin(), m_connections.end(), predicate),
 			    m_connections.end());
+	m_unvalidated.erase(std::remove_if(m_unvalidated.begin(), m_unvalidated.end(), predicate),
+			    m_unvalidated.end());
 
 	m_isCompiled = false;
 }
@@ -119,28 +217,150 @@ std::vector<PinConnection> NodeExecutionGraph::getConnections() const
 	return m_connections;
 }
 
-std::vector<PinConnection> NodeExecutionGraph::getInputConnections(const std::string &nodeId) const
+std::vector<PinConnection> NodeExecutionGraph::getInputConnections(NodeHandle nodeId) const
 {
 	std::vector<PinConnection> inputs;
 	for (const auto &conn : m_connections) {
-		if (conn.targetNodeId == nodeId) {
+		if (conn.targetNode == nodeId) {
 			inputs.push_back(conn);
 		}
 	}
 	return inputs;
 }
 
-std::vector<PinConnection> NodeExecutionGraph::getOutputConnections(const std::string &nodeId) const
+std::vector<PinConnection> NodeExecutionGraph::getOutputConnections(NodeHandle nodeId) const
 {
 	std::vector<PinConnection> outputs;
 	for (const auto &conn : m_connections) {
-		if (conn.sourceNodeId == nodeId) {
+		if (conn.sourceNode == nodeId) {
 			outputs.push_back(conn);
 		}
 	}
 	return outputs;
 }
 
+//=============================================================================
+// Incremental Topological Order (Pearce-Kelly)
+//=============================================================================
+
+void NodeExecutionGraph::addAdjacency(const PinConnection &connection)
+{
+	int &count = m_successors[connection.sourceNode][connection.targetNode];
+	m_predecessors[connection.targetNode][connection.sourceNode]++;
+
+	// Only the first edge between a pair of nodes can change the order
+	if (++count == 1 && m_orderValid) {
+		insertEdgeOrder(connection.sourceNode, connection.targetNode);
+	}
+}
+
+void NodeExecutionGraph::removeAdjacency(const PinConnection &connection)
+{
+	auto decrement = [](Adjacency &adjacency, NodeHandle from, NodeHandle to) {
+		auto outer = adjacency.find(from);
+		if (outer == adjacency.end())
+			return;
+		auto inner = outer->second.find(to);
+		if (inner != outer->second.end() && --inner->second <= 0) {
+			outer->second.erase(inner);
+		}
+	};
+
+	decrement(m_successors, connection.sourceNode, connection.targetNode);
+	decrement(m_predecessors, connection.targetNode, connection.sourceNode);
+}
+
+void NodeExecutionGraph::resetTopologicalOrder()
+{
+	m_order.clear();
+	m_ordered.clear();
+	m_nextOrder = 0;
+	for (NodeHandle nodeId : m_executionOrder) {
+		m_order[nodeId] = m_nextOrder;
+		m_ordered[m_nextOrder] = nodeId;
+		m_nextOrder++;
+	}
+}
+
+void NodeExecutionGraph::insertEdgeOrder(NodeHandle sourceNodeId, NodeHandle targetNodeId)
+{
+	if (sourceNodeId == targetNodeId) {
+		m_orderValid = false; // Self-loop; the next compile() reports the cycle
+		return;
+	}
+
+	const int64_t lowerBound = m_order[targetNodeId];
+	const int64_t upperBound = m_order[sourceNodeId];
+	if (lowerBound > upperBound) {
+		return; // Already ordered source before target
+	}
+
+	// Forward search from the target, limited to the affected region
+	std::vector<NodeHandle> forward;
+	std::unordered_set<NodeHandle> visited;
+	std::vector<NodeHandle> stack = {targetNodeId};
+	while (!stack.empty()) {
+		NodeHandle nodeId = stack.back();
+		stack.pop_back();
+		if (!visited.insert(nodeId).second)
+			continue;
+		forward.push_back(nodeId);
+
+		for (const auto &[successor, _] : m_successors[nodeId]) {
+			if (successor == sourceNodeId) {
+				m_orderValid = false; // Cycle; the next compile() reports it
+				return;
+			}
+			if (m_order[successor] < upperBound && !visited.count(successor)) {
+				stack.push_back(successor);
+			}
+		}
+	}
+
+	// Backward search from the source, limited to the affected region
+	std::vector<NodeHandle> backward;
+	stack = {sourceNodeId};
+	while (!stack.empty()) {
+		NodeHandle nodeId = stack.back();
+		stack.pop_back();
+		if (!visited.insert(nodeId).second)
+			continue;
+		backward.push_back(nodeId);
+
+		for (const auto &[predecessor, _] : m_predecessors[nodeId]) {
+			if (m_order[predecessor] > lowerBound && !visited.count(predecessor)) {
+				stack.push_back(predecessor);
+			}
+		}
+	}
+
+	// Reassign the freed positions: everything reaching the source first,
+	// then everything reachable from the target, each keeping relative order.
+	auto byOrder = [this](NodeHandle a, NodeHandle b) { return m_order[a] < m_order[b]; };
+	std::sort(backward.begin(), backward.end(), byOrder);
+	std::sort(forward.begin(), forward.end(), byOrder);
+
+	std::vector<int64_t> positions;
+	positions.reserve(backward.size() + forward.size());
+	for (NodeHandle nodeId : backward)
+		positions.push_back(m_order[nodeId]);
+	for (NodeHandle nodeId : forward)
+		positions.push_back(m_order[nodeId]);
+	std::sort(positions.begin(), positions.end());
+
+	for (int64_t position : positions)
+		m_ordered.erase(position);
+
+	size_t next = 0;
+	for (const auto *group : {&backward, &forward}) {
+		for (NodeHandle nodeId : *group) {
+			m_order[nodeId] = positions[next];
+			m_ordered[positions[next]] = nodeId;
+			next++;
+		}
+	}
+}
+
 //=============================================================================
 // Compilation (Topological Sort + Validation)
 //=============================================================================
@@ -148,34 +368,72 @@ std::vector<PinConnection> NodeExecutionGraph::getOutputConnections(const std::s
 bool NodeExecutionGraph::compile()
 {
 	m_validationErrors.clear();
-	m_executionOrder.clear();
-	m_hasCycle = false;
 
-	// Step 1: Validate connections
-	if (!validateConnections()) {
-		m_isCompiled = false;
-		return false;
-	}
+	if (m_orderValid) {
+		// Incremental: the order is maintained on every edit, so only the
+		// connections added since the last compile need validating.
+		bool valid = true;
+		for (const auto &conn : m_unvalidated) {
+			if (!validatePinTypes(conn)) {
+				valid = false;
+				addValidationError(conn);
+			}
+		}
+		if (!valid) {
+			m_isCompiled = false;
+			return false;
+		}
 
-	// Step 2: Detect cycles
-	if (detectCycles()) {
-		m_hasCycle = true;
-		m_isCompiled = false;
+		m_executionOrder.clear();
+		m_executionOrder.reserve(m_ordered.size());
+		for (const auto &[_, nodeId] : m_ordered) {
+			m_executionOrder.push_back(nodeId);
+		}
+	} else {
+		m_executionOrder.clear();
+		m_hasCycle = false;
+
+		// Step 1: Validate connections
+		if (!validateConnections()) {
+			m_isCompiled = false;
+			return false;
+		}
 
-		ValidationError error;
-		error.type = ValidationError::Type::CycleDetected;
-		error.message = "Cycle detected in node graph. Execution order cannot be determined.";
-		m_validationErrors.push_back(error);
+		// Step 2: Detect cycles
+		if (detectCycles()) {
+			m_hasCycle = true;
+			m_isCompiled = false;
 
-		return false;
+			ValidationError error;
+			error.type = ValidationError::Type::CycleDetected;
+			error.message = "Cycle detected in node graph. Execution order cannot be determined.";
+			m_validationErrors.push_back(error);
+
+			return false;
+		}
+
+		// Step 3: Topological sort
+		if (!topologicalSort()) {
+			m_isCompiled = false;
+			return false;
+		}
+
+		resetTopologicalOrder();
+		m_orderValid = true;
 	}
+	m_unvalidated.clear();
+	m_hasCycle = false;
 
-	// Step 3: Topological sort
-	if (!topologicalSort()) {
+	// Step 4: Build the schedule and hand it to the frame loop
+	auto schedule = buildSchedule();
+	if (!schedule) {
 		m_isCompiled = false;
 		return false;
 	}
 
+	m_scheduleGeneration++;
+	m_publishedSchedule.store(std::move(schedule), std::memory_order_release);
+
 	m_isCompiled = true;
 	return true;
 }
@@ -185,35 +443,40 @@ bool NodeExecutionGraph::topologicalSort()
 	// Kahn's algorithm for topological sort
 
 	// Step 1: Compute in-degrees for all nodes
-	std::map<std::string, int> inDegree;
+	std::unordered_map<NodeHandle, int> inDegree;
 	for (const auto &[nodeId, _] : m_nodes) {
 		inDegree[nodeId] = 0;
 	}
 
 	for (const auto &conn : m_connections) {
-		inDegree[conn.targetNodeId]++;
+		inDegree[conn.targetNode]++;
 	}
 
-	// Step 2: Queue all nodes with in-degree 0
-	std::queue<std::string> queue;
+	// Step 2: Queue all nodes with in-degree 0, in interning order so independent nodes keep a stable order
+	std::vector<NodeHandle> roots;
 	for (const auto &[nodeId, degree] : inDegree) {
 		if (degree == 0) {
-			queue.push(nodeId);
+			roots.push_back(nodeId);
 		}
 	}
+	std::sort(roots.begin(), roots.end());
+	std::queue<NodeHandle> queue;
+	for (NodeHandle nodeId : roots) {
+		queue.push(nodeId);
+	}
 
 	// Step 3: Process queue
 	m_executionOrder.clear();
 	while (!queue.empty()) {
-		std::string nodeId = queue.front();
+		NodeHandle nodeId = queue.front();
 		queue.pop();
 		m_executionOrder.push_back(nodeId);
 
 		// Reduce in-degree of dependent nodes
 		auto outgoingConnections = getOutputConnections(nodeId);
 		for (const auto &conn : outgoingConnections) {
-			if (--inDegree[conn.targetNodeId] == 0) {
-				queue.push(conn.targetNodeId);
+			if (--inDegree[conn.targetNode] == 0) {
+				queue.push(conn.targetNode);
 			}
 		}
 	}
@@ -229,23 +492,23 @@ bool NodeExecutionGraph::topologicalSort()
 bool NodeExecutionGraph::detectCycles()
 {
 	// DFS-based cycle detection
-	std::set<std::string> visited;
-	std::set<std::string> recursionStack;
+	std::unordered_set<NodeHandle> visited;
+	std::unordered_set<NodeHandle> recursionStack;
 
-	std::function<bool(const std::string &)> dfs = [&](const std::string &nodeId) -> bool {
+	std::function<bool(NodeHandle)> dfs = [&](NodeHandle nodeId) -> bool {
 		visited.insert(nodeId);
 		recursionStack.insert(nodeId);
 
 		// Visit all outgoing connections
 		auto outgoing = getOutputConnections(nodeId);
 		for (const auto &conn : outgoing) {
-			if (recursionStack.find(conn.targetNodeId) != recursionStack.end()) {
+			if (recursionStack.find(conn.targetNode) != recursionStack.end()) {
 				// Back edge found - cycle detected
 				return true;
 			}
 
-			if (visited.find(conn.targetNodeId) == visited.end()) {
-				if (dfs(conn.targetNodeId)) {
+			if (visited.find(conn.targetNode) == visited.end()) {
+				if (dfs(conn.targetNode)) {
 					return true;
 				}
 			}
@@ -274,23 +537,27 @@ bool NodeExecutionGraph::validateConnections()
 	for (const auto &conn : m_connections) {
 		if (!validatePinTypes(conn)) {
 			valid = false;
-
-			ValidationError error;
-			error.type = ValidationError::Type::TypeMismatch;
-			error.message = "Type mismatch between " + conn.sourceNodeId + "." + conn.sourcePinId +
-					" and " + conn.targetNodeId + "." + conn.targetPinId;
-			error.affectedNodes = {conn.sourceNodeId, conn.targetNodeId};
-			m_validationErrors.push_back(error);
+			addValidationError(conn);
 		}
 	}
 
 	return valid;
 }
 
+void NodeExecutionGraph::addValidationError(const PinConnection &conn)
+{
+	ValidationError error;
+	error.type = ValidationError::Type::TypeMismatch;
+	error.message = "Type mismatch between " + conn.sourceNodeId() + "." + conn.sourcePinId() + " and " +
+			conn.targetNodeId() + "." + conn.targetPinId();
+	error.affectedNodes = {conn.sourceNodeId(), conn.targetNodeId()};
+	m_validationErrors.push_back(error);
+}
+
 bool NodeExecutionGraph::validatePinTypes(const PinConnection &connection)
 {
-	auto sourceNode = getNode(connection.sourceNodeId);
-	auto targetNode = getNode(connection.targetNodeId);
+	auto sourceNode = getNode(connection.sourceNode);
+	auto targetNode = getNode(connection.targetNode);
 
 	if (!sourceNode || !targetNode) {
 		return false;
@@ -304,14 +571,14 @@ bool NodeExecutionGraph::validatePinTypes(const PinConnection &connection)
 	const PinDescriptor *targetPin = nullptr;
 
 	for (const auto &pin : sourceOutputs) {
-		if (pin.pinId == connection.sourcePinId) {
+		if (pin.pinId == connection.sourcePinId()) {
 			sourcePin = &pin;
 			break;
 		}
 	}
 
 	for (const auto &pin : targetInputs) {
-		if (pin.pinId == connection.targetPinId) {
+		if (pin.pinId == connection.targetPinId()) {
 			targetPin = &pin;
 			break;
 		}
@@ -325,83 +592,379 @@ bool NodeExecutionGraph::validatePinTypes(const PinConnection &connection)
 	return sourcePin->dataType.isCompatibleWith(targetPin->dataType);
 }
 
+//=============================================================================
+// Schedule Building
+//=============================================================================
+
+std::shared_ptr<CompiledSchedule> NodeExecutionGraph::buildSchedule()
+{
+	auto snapshot = std::make_shared<GraphSnapshot>();
+	snapshot->generation = m_scheduleGeneration + 1;
+	snapshot->executionOrder = m_executionOrder;
+	snapshot->nodes.reserve(m_executionOrder.size());
+	snapshot->connections = m_connections;
+	snapshot->pinSlots = m_pinSlotsEnabled;
+	snapshot->asyncExecution = m_asyncEnabled;
+
+	auto schedule = std::make_shared<CompiledSchedule>();
+	schedule->nodes.reserve(m_executionOrder.size());
+
+	auto &indexOf = snapshot->index;
+	indexOf.reserve(m_executionOrder.size());
+	uint32_t slotCount = 0;
+	for (NodeHandle nodeId : m_executionOrder) {
+		auto node = getNode(nodeId);
+		if (!node)
+			return nullptr;
+
+		indexOf[nodeId] = static_cast<uint32_t>(schedule->nodes.size());
+
+		CompiledNode compiled;
+		compiled.nodeId = nodeId;
+		compiled.node = node.get();
+		compiled.inputCount = static_cast<uint32_t>(node->getInputPins().size());
+		compiled.outputCount = static_cast<uint32_t>(node->getOutputPins().size());
+		compiled.slotBase = slotCount;
+		// Tentative: activateSchedule() clears this for nodes that refuse to bind
+		compiled.slotsBound = m_pinSlotsEnabled;
+		compiled.timeVarying = node->isTimeVarying();
+		compiled.profileKey = ExecutionProfiler::nodeKey(idString(nodeId));
+		slotCount += compiled.inputCount + compiled.outputCount;
+
+		schedule->nodes.push_back(std::move(compiled));
+		snapshot->nodes.push_back(std::move(node));
+	}
+
+	if (m_pinSlotsEnabled) {
+		schedule->pinSlots = std::make_unique<PinSlotBuffer>(slotCount);
+	}
+
+	std::vector<std::vector<CompiledEdge>> outgoing(schedule->nodes.size());
+	for (size_t i = 0; i < m_connections.size(); ++i) {
+		const auto &conn = m_connections[i];
+		auto source = indexOf.find(conn.sourceNode);
+		auto target = indexOf.find(conn.targetNode);
+		if (source == indexOf.end() || target == indexOf.end())
+			return nullptr;
+
+		CompiledNode &sourceNode = schedule->nodes[source->second];
+		CompiledNode &targetNode = schedule->nodes[target->second];
+
+		CompiledEdge edge;
+		edge.source = sourceNode.node;
+		edge.target = targetNode.node;
+		edge.sourceSlot = findOutputSlot(sourceNode, conn.sourcePin);
+		edge.targetSlot = findInputSlot(targetNode, conn.targetPin);
+		edge.sourceIndex = source->second;
+		edge.targetIndex = target->second;
+		edge.connectionIndex = i;
+		outgoing[source->second].push_back(edge);
+
+		// Several pins between the same pair of nodes still count as one dependency
+		auto &successors = sourceNode.successors;
+		if (std::find(successors.begin(), successors.end(), target->second) == successors.end()) {
+			successors.push_back(target->second);
+			targetNode.predecessorCount++;
+		}
+	}
+
+	// Flatten into one contiguous array grouped by source node
+	auto &edges = schedule->edges;
+	edges.reserve(m_connections.size());
+	for (size_t n = 0; n < schedule->nodes.size(); ++n) {
+		schedule->nodes[n].firstOutEdge = static_cast<uint32_t>(edges.size());
+		schedule->nodes[n].outEdgeCount = static_cast<uint32_t>(outgoing[n].size());
+		edges.insert(edges.end(), outgoing[n].begin(), outgoing[n].end());
+	}
+	for (size_t e = 0; e < edges.size(); ++e) {
+		CompiledNode &target = schedule->nodes[edges[e].targetIndex];
+		target.inputEdges.push_back(static_cast<uint32_t>(e));
+		if (edges[e].targetSlot != kInvalidPinSlot) {
+			target.connectedInputs.push_back(edges[e].targetSlot - target.slotBase);
+		}
+	}
+
+	schedule->pendingPredecessors = std::make_unique<std::atomic<uint32_t>[]>(schedule->nodes.size());
+
+	// Connections may have changed anywhere, so a new schedule starts fully dirty
+	schedule->dirty = std::make_unique<std::atomic<uint8_t>[]>(schedule->nodes.size());
+	for (size_t i = 0; i < schedule->nodes.size(); ++i) {
+		schedule->dirty[i].store(1, std::memory_order_relaxed);
+	}
+	schedule->snapshot = std::move(snapshot);
+	return schedule;
+}
+
+std::shared_ptr<const GraphSnapshot> NodeExecutionGraph::getSnapshot() const
+{
+	auto schedule = m_publishedSchedule.load(std::memory_order_acquire);
+	if (!schedule)
+		return nullptr;
+	return schedule->snapshot;
+}
+
+std::shared_ptr<CompiledSchedule> NodeExecutionGraph::acquireSchedule()
+{
+	// Frame boundary: switch to the most recently published schedule, if any.
+	// The caller holds the returned reference for the whole frame.
+	auto published = m_publishedSchedule.load(std::memory_order_acquire);
+	if (published && published != m_activeSchedule) {
+		activateSchedule(published);
+	}
+	return m_activeSchedule;
+}
+
+void NodeExecutionGraph::activateSchedule(const std::shared_ptr<CompiledSchedule> &schedule)
+{
+	// Bind into the new buffer while the previous schedule still owns the old
+	// one, so nodes migrate their current pin values across the swap.
+	const GraphSnapshot &snapshot = *schedule->snapshot;
+	std::set<IExecutableNode *> retained;
+	std::set<IExecutableNode *> pipelined;
+	for (size_t i = 0; i < schedule->nodes.size(); ++i) {
+		CompiledNode &compiled = schedule->nodes[i];
+		retained.insert(compiled.node);
+
+		// Pipelined nodes stay bound to their own work buffer; their range in
+		// this schedule's buffer is the mailbox the frame loop reads and writes.
+		if (schedule->pinSlots && snapshot.asyncExecution && compiled.node->supportsAsync()) {
+			compiled.async = m_asyncExecutor.attach(snapshot.nodes[i]);
+		}
+		if (compiled.async) {
+			compiled.slotsBound = true;
+			m_asyncExecutor.restoreOutputs(*compiled.async, *schedule->pinSlots, compiled.slotBase);
+			pipelined.insert(compiled.node);
+			continue;
+		}
+
+		m_asyncExecutor.detachNow(compiled.node); // No-op unless it just left async mode
+		compiled.slotsBound = compiled.node->bindPinSlots(schedule->pinSlots.get(), compiled.slotBase) &&
+				      schedule->pinSlots;
+	}
+	m_asyncExecutor.retainOnly(pipelined);
+
+	// An end that stayed on the string-keyed API goes through the slow path
+	for (auto &edge : schedule->edges) {
+		if (!schedule->nodes[edge.sourceIndex].slotsBound)
+			edge.sourceSlot = kInvalidPinSlot;
+		if (!schedule->nodes[edge.targetIndex].slotsBound)
+			edge.targetSlot = kInvalidPinSlot;
+	}
+
+	// Nodes that left the graph hand their values back before their slots go
+	// away. Pipelined ones are unbound by the executor once their requests finish.
+	if (m_activeSchedule) {
+		for (const auto &compiled : m_activeSchedule->nodes) {
+			if (!retained.count(compiled.node) && !compiled.async) {
+				compiled.node->bindPinSlots(nullptr, 0);
+			}
+		}
+	}
+
+	m_activeSchedule = schedule;
+	m_activeGeneration.store(snapshot.generation, std::memory_order_release);
+}
+
+void NodeExecutionGraph::unbindPinSlots(CompiledSchedule &schedule)
+{
+	for (auto &compiled : schedule.nodes) {
+		compiled.node->bindPinSlots(nullptr, 0);
+		compiled.slotsBound = false;
+	}
+}
+
+uint32_t NodeExecutionGraph::findOutputSlot(const CompiledNode &compiled, PinHandle pinHandle) const
+{
+	if (!compiled.slotsBound)
+		return kInvalidPinSlot;
+
+	const std::string &pinId = idString(pinHandle);
+	const auto &pins = compiled.node->getOutputPins();
+	for (size_t i = 0; i < pins.size(); ++i) {
+		if (pins[i].pinId == pinId)
+			return compiled.slotBase + compiled.inputCount + static_cast<uint32_t>(i);
+	}
+	return kInvalidPinSlot;
+}
+
+uint32_t NodeExecutionGraph::findInputSlot(const CompiledNode &compiled, PinHandle pinHandle) const
+{
+	if (!compiled.slotsBound)
+		return kInvalidPinSlot;
+
+	const std::string &pinId = idString(pinHandle);
+	const auto &pins = compiled.node->getInputPins();
+	for (size_t i = 0; i < pins.size(); ++i) {
+		if (pins[i].pinId == pinId)
+			return compiled.slotBase + static_cast<uint32_t>(i);
+	}
+	return kInvalidPinSlot;
+}
+
 //=============================================================================
 // Execution
 //=============================================================================
 
 bool NodeExecutionGraph::execute(ExecutionContext &ctx)
 {
-	if (!m_isCompiled) {
+	std::shared_ptr<CompiledSchedule> schedule = acquireSchedule();
+	if (!schedule) {
 		return false;
 	}
+	ProfileFrameScope frameScope(ctx.profiler, ctx.frameNumber);
+	beginFrame(*schedule, ctx);
+	FrameCounters counters;
 
 	// Execute nodes in topological order
-	for (const auto &nodeId : m_executionOrder) {
-		if (!executeNode(nodeId, ctx)) {
-			// Handle error
-			if (m_errorHandler) {
-				ExecutionResult result = ExecutionResult::failure("Node execution failed");
-				m_errorHandler(result, nodeId);
-			}
+	for (uint32_t i = 0; i < schedule->nodes.size(); ++i) {
+		const CompiledNode &compiled = schedule->nodes[i];
+		if (!shouldEvaluate(*schedule, i, counters)) {
+			continue; // Outputs from the last evaluation are still in place downstream
+		}
+
+		if (!evaluateNode(*schedule, i, ctx)) {
+			reportError(compiled.nodeId);
 
-			if (!m_fallbackMode) {
+			if (!m_fallbackMode.load(std::memory_order_relaxed)) {
+				publishStats(ctx.frameNumber, counters);
 				return false; // Stop execution on error
 			}
 			// Continue with fallback mode
 		}
 
 		// Propagate data to connected nodes
-		propagateData();
+		propagateFrom(*schedule, compiled);
 	}
 
+	publishStats(ctx.frameNumber, counters);
 	return true;
 }
 
-bool NodeExecutionGraph::executeNode(const std::string &nodeId, ExecutionContext &ctx)
+bool NodeExecutionGraph::evaluateNode(CompiledSchedule &schedule, uint32_t index, ExecutionContext &ctx,
+				      int64_t readyNs)
+{
+	const CompiledNode &compiled = schedule.nodes[index];
+	ExecutionProfiler *profiler = ctx.profiler;
+	int64_t start = profiler ? ExecutionProfiler::now() : 0;
+
+	if (!compiled.async) {
+		ProfileCacheStatus cacheStatus = ProfileCacheStatus::NotCached;
+		bool ok = executeNode(schedule, compiled, ctx, cacheStatus);
+		if (profiler) {
+			profiler->recordSpan(ProfileEventKind::Node, compiled.profileKey, ctx.frameNumber, start, readyNs,
+					     cacheStatus);
+		}
+		if (!ok)
+			return false;
+		schedule.dirty[index].store(0, std::memory_order_relaxed);
+		markSuccessorsDirty(schedule, compiled);
+		return true;
+	}
+
+	// Pipelined: publish whatever finished, then request a new evaluation if
+	// the inputs changed. Downstream only becomes dirty once a result lands.
+	bool dispatch = m_evaluationMode.load(std::memory_order_relaxed) == EvaluationMode::Full ||
+			compiled.timeVarying || schedule.dirty[index].load(std::memory_order_relaxed);
+	auto serviced = m_asyncExecutor.service(*compiled.async, *schedule.pinSlots, compiled.slotBase,
+						compiled.connectedInputs, dispatch, ctx);
+	if (profiler) {
+		profiler->recordSpan(ProfileEventKind::AsyncService, compiled.profileKey, ctx.frameNumber, start, readyNs);
+	}
+	if (serviced.dispatched) {
+		schedule.dirty[index].store(0, std::memory_order_relaxed);
+	}
+	if (serviced.published) {
+		markSuccessorsDirty(schedule, compiled);
+	}
+	return !serviced.failed;
+}
+
+bool NodeExecutionGraph::executeNode(CompiledSchedule &schedule, const CompiledNode &compiled, ExecutionContext &ctx,
+				     ProfileCacheStatus &cacheStatus)
 {
-	auto node = getNode(nodeId);
+	IExecutableNode *node = compiled.node;
 	if (!node) {
 		return false;
 	}
 
-	// Check cache (if caching enabled and node supports it)
-	if (m_cachingEnabled && node->supportsCaching()) {
-		size_t inputHash = computeInputHash(nodeId);
-		CacheEntry entry;
-		if (tryGetFromCache(nodeId, inputHash, entry)) {
-			// Use cached data
-			for (const auto &[pinId, data] : entry.outputData) {
-				node->setPinData(pinId, data);
-			}
+	// Check cache (if caching enabled and node supports it). Time-varying
+	// nodes produce new output from the same inputs, so they never hit.
+	bool useCache = m_cachingEnabled.load(std::memory_order_relaxed) && !compiled.timeVarying && node->supportsCaching();
+	uint64_t inputHash = 0;
+	std::vector<std::shared_ptr<const void>> inputRefs;
+	if (useCache) {
+		useCache = computeInputHash(schedule, compiled, inputHash, inputRefs);
+		if (!useCache) {
+			m_cache.recordUncacheable(compiled.nodeId);
+			cacheStatus = ProfileCacheStatus::Uncacheable;
+		} else if (restoreFromCache(schedule, compiled, inputHash)) {
+			cacheStatus = ProfileCacheStatus::Hit;
 			return true;
+		} else {
+			cacheStatus = ProfileCacheStatus::Miss;
 		}
 	}
 
 	// Execute node
+	auto start = std::chrono::steady_clock::now();
 	ExecutionResult result = node->process(ctx);
 
 	// Update cache
-	if (result.status == ExecutionResult::Status::Success && m_cachingEnabled) {
-		size_t inputHash = computeInputHash(nodeId);
-		updateCache(nodeId, inputHash);
+	if (result.status == ExecutionResult::Status::Success && useCache) {
+		updateCache(schedule, compiled, inputHash, std::move(inputRefs), std::chrono::steady_clock::now() - start);
 	}
 
 	return result.status == ExecutionResult::Status::Success;
 }
 
-void NodeExecutionGraph::propagateData()
+void NodeExecutionGraph::propagateData(CompiledSchedule &schedule)
 {
 	// Transfer data from output pins to input pins via connections
-	for (const auto &conn : m_connections) {
-		auto sourceNode = getNode(conn.sourceNodeId);
-		auto targetNode = getNode(conn.targetNodeId);
+	for (const auto &edge : schedule.edges) {
+		transferEdge(schedule, edge);
+	}
+}
 
-		if (sourceNode && targetNode) {
-			if (sourceNode->hasPinData(conn.sourcePinId)) {
-				std::any data = sourceNode->getPinData(conn.sourcePinId);
-				targetNode->setPinData(conn.targetPinId, data);
-			}
+void NodeExecutionGraph::propagateFrom(CompiledSchedule &schedule, const CompiledNode &compiled)
+{
+	const CompiledEdge *edge = schedule.edges.data() + compiled.firstOutEdge;
+	const CompiledEdge *end = edge + compiled.outEdgeCount;
+	for (; edge != end; ++edge) {
+		transferEdge(schedule, *edge);
+	}
+}
+
+void NodeExecutionGraph::transferEdge(CompiledSchedule &schedule, const CompiledEdge &edge)
+{
+	PinSlotBuffer *slots = schedule.pinSlots.get();
+	if (edge.sourceSlot != kInvalidPinSlot && edge.targetSlot != kInvalidPinSlot) {
+		// Inline primitives are copied; FrameHandle payloads only gain a reference
+		const PinValue &value = slots->at(edge.sourceSlot);
+		if (!value.empty()) {
+			slots->at(edge.targetSlot) = value;
+			slots->stampAt(edge.targetSlot) = slots->stampAt(edge.sourceSlot);
 		}
+		return;
+	}
+
+	// Slow path: at least one end only speaks the string-keyed API. The bound
+	// end still goes through its slot (a pipelined node's pins are busy).
+	const auto &conn = schedule.snapshot->connections[edge.connectionIndex];
+	if (edge.sourceSlot != kInvalidPinSlot) {
+		const PinValue &value = slots->at(edge.sourceSlot);
+		if (!value.empty()) {
+			edge.target->setPinData(conn.targetPinId(), value.toAny());
+		}
+		return;
+	}
+	if (!edge.source->hasPinData(conn.sourcePinId())) {
+		return;
+	}
+	if (edge.targetSlot != kInvalidPinSlot) {
+		slots->at(edge.targetSlot) = PinValue::fromAny(edge.source->getPinData(conn.sourcePinId()));
+		slots->stampAt(edge.targetSlot) = PinStamp();
+	} else {
+		edge.target->setPinData(conn.targetPinId(), edge.source->getPinData(conn.sourcePinId()));
 	}
 }
 
@@ -409,52 +972,150 @@ void NodeExecutionGraph::propagateData()
 // Parallel Execution
 //=============================================================================
 
-std::vector<std::vector<std::string>> NodeExecutionGraph::computeExecutionLevels()
+std::vector<std::vector<uint32_t>> NodeExecutionGraph::computeExecutionLevels(const CompiledSchedule &schedule)
 {
-	std::vector<std::vector<std::string>> levels;
-	std::map<std::string, int> nodeLevel;
+	std::vector<std::vector<uint32_t>> levels;
+	std::vector<int> nodeLevel(schedule.nodes.size(), 0);
 
 	// Compute level for each node (max distance from source nodes)
-	for (const auto &nodeId : m_executionOrder) {
+	int maxLevel = 0;
+	for (size_t i = 0; i < schedule.nodes.size(); ++i) {
 		int maxPredecessorLevel = -1;
 
-		auto incoming = getInputConnections(nodeId);
-		for (const auto &conn : incoming) {
-			maxPredecessorLevel = std::max(maxPredecessorLevel, nodeLevel[conn.sourceNodeId]);
+		for (uint32_t edgeIndex : schedule.nodes[i].inputEdges) {
+			maxPredecessorLevel = std::max(maxPredecessorLevel, nodeLevel[schedule.edges[edgeIndex].sourceIndex]);
 		}
 
-		nodeLevel[nodeId] = maxPredecessorLevel + 1;
+		nodeLevel[i] = maxPredecessorLevel + 1;
+		maxLevel = std::max(maxLevel, nodeLevel[i]);
 	}
 
 	// Group nodes by level
-	int maxLevel = 0;
-	for (const auto &[_, level] : nodeLevel) {
-		maxLevel = std::max(maxLevel, level);
+	levels.resize(schedule.nodes.empty() ? 0 : maxLevel + 1);
+	for (size_t i = 0; i < schedule.nodes.size(); ++i) {
+		levels[nodeLevel[i]].push_back(static_cast<uint32_t>(i));
 	}
 
-	levels.resize(maxLevel + 1);
-	for (const auto &[nodeId, level] : nodeLevel) {
-		levels[level].push_back(nodeId);
+	return levels;
+}
+
+void NodeExecutionGraph::setSchedulerConfig(const TaskScheduler::Config &config)
+{
+	// The pool may be running a frame; getScheduler() swaps it between frames
+	std::lock_guard<std::mutex> lock(m_schedulerMutex);
+	m_schedulerConfig = config;
+	m_schedulerConfigChanged = true;
+}
+
+TaskScheduler &NodeExecutionGraph::getScheduler()
+{
+	std::lock_guard<std::mutex> lock(m_schedulerMutex);
+	if (!m_scheduler || m_schedulerConfigChanged) {
+		m_scheduler.reset(); // Joins the old workers first
+		m_scheduler = std::make_unique<TaskScheduler>(m_schedulerConfig);
+		m_schedulerConfigChanged = false;
 	}
+	return *m_scheduler;
+}
 
-	return levels;
+void NodeExecutionGraph::gatherInputs(CompiledSchedule &schedule, const CompiledNode &compiled)
+{
+	// Pull-based: only the thread about to run this node writes its inputs,
+	// and every source has already finished, so no locking is needed.
+	for (uint32_t edgeIndex : compiled.inputEdges) {
+		transferEdge(schedule, schedule.edges[edgeIndex]);
+	}
 }
 
 bool NodeExecutionGraph::executeParallel(ExecutionContext &ctx)
 {
-	if (!m_isCompiled) {
+	std::shared_ptr<CompiledSchedule> schedule = acquireSchedule();
+	if (!schedule) {
 		return false;
 	}
+	ProfileFrameScope frameScope(ctx.profiler, ctx.frameNumber);
+	beginFrame(*schedule, ctx);
+
+	if (m_parallelMode.load(std::memory_order_relaxed) == ParallelMode::LevelSynchronous) {
+		return executeLevelSynchronous(*schedule, ctx);
+	}
+	return executeDependencyDriven(*schedule, ctx);
+}
+
+bool NodeExecutionGraph::executeDependencyDriven(CompiledSchedule &schedule, ExecutionContext &ctx)
+{
+	const size_t nodeCount = schedule.nodes.size();
+	if (nodeCount == 0) {
+		publishStats(ctx.frameNumber, FrameCounters());
+		return true;
+	}
+
+	for (size_t i = 0; i < nodeCount; ++i) {
+		schedule.pendingPredecessors[i].store(schedule.nodes[i].predecessorCount, std::memory_order_relaxed);
+	}
 
-	auto levels = computeExecutionLevels();
+	TaskScheduler &scheduler = getScheduler();
+	TaskGroup group;
+	FrameCounters counters;
+	std::atomic<bool> failed {false};
+	const bool fallbackMode = m_fallbackMode.load(std::memory_order_relaxed); // One value for the whole frame
+
+	// Ready times are only taken while profiling (queue wait = ready -> started)
+	ExecutionProfiler *profiler = ctx.profiler;
+	std::function<void(uint32_t, int64_t)> runNode = [&](uint32_t index, int64_t readyNs) {
+		const CompiledNode &compiled = schedule.nodes[index];
+
+		// After a failure (without fallback) downstream nodes are skipped but
+		// still released so the frame drains. Clean or inactive nodes are
+		// released the same way.
+		if ((fallbackMode || !failed.load(std::memory_order_acquire)) &&
+		    shouldEvaluate(schedule, index, counters)) {
+			gatherInputs(schedule, compiled);
+			// Dirty bits are ordered before the successors start by the release below
+			if (!evaluateNode(schedule, index, ctx, readyNs)) {
+				failed.store(true, std::memory_order_release);
+				reportError(compiled.nodeId);
+			}
+		}
+
+		for (uint32_t successor : compiled.successors) {
+			if (schedule.pendingPredecessors[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				int64_t ready = profiler ? ExecutionProfiler::now() : 0;
+				scheduler.submit(group, [&runNode, successor, ready]() { runNode(successor, ready); });
+			}
+		}
+	};
+
+	for (uint32_t i = 0; i < nodeCount; ++i) {
+		if (schedule.nodes[i].predecessorCount == 0) {
+			int64_t ready = profiler ? ExecutionProfiler::now() : 0;
+			scheduler.submit(group, [&runNode, i, ready]() { runNode(i, ready); });
+		}
+	}
+
+	scheduler.wait(group);
+	publishStats(ctx.frameNumber, counters);
+
+	return fallbackMode || !failed.load(std::memory_order_acquire);
+}
+
+bool NodeExecutionGraph::executeLevelSynchronous(CompiledSchedule &schedule, ExecutionContext &ctx)
+{
+	auto levels = computeExecutionLevels(schedule);
+	FrameCounters counters;
 
 	// Execute each level in parallel
 	for (const auto &level : levels) {
 		std::vector<std::future<bool>> futures;
 
-		for (const auto &nodeId : level) {
-			futures.push_back(std::async(std::launch::async,
-						     [this, nodeId, &ctx]() { return executeNode(nodeId, ctx); }));
+		for (uint32_t index : level) {
+			if (!shouldEvaluate(schedule, index, counters))
+				continue;
+
+			int64_t ready = ctx.profiler ? ExecutionProfiler::now() : 0;
+			futures.push_back(std::async(std::launch::async, [this, &schedule, index, &ctx, ready]() {
+				return evaluateNode(schedule, index, ctx, ready);
+			}));
 		}
 
 		// Wait for all nodes in this level to complete
@@ -465,17 +1126,160 @@ bool NodeExecutionGraph::executeParallel(ExecutionContext &ctx)
 			}
 		}
 
-		if (!levelSuccess && !m_fallbackMode) {
+		if (!levelSuccess && !m_fallbackMode.load(std::memory_order_relaxed)) {
+			publishStats(ctx.frameNumber, counters);
 			return false;
 		}
 
 		// Propagate data after level completion
-		propagateData();
+		propagateData(schedule);
+	}
+
+	publishStats(ctx.frameNumber, counters);
+	return true;
+}
+
+//=============================================================================
+// Demand-Driven Evaluation
+//=============================================================================
+
+void NodeExecutionGraph::setEvaluationMode(EvaluationMode mode)
+{
+	if (m_evaluationMode.exchange(mode) != mode) {
+		// Bits were not maintained in Full mode; start from a clean slate
+		m_pendingAllDirty.store(true, std::memory_order_release);
 	}
+}
+
+void NodeExecutionGraph::markDirty(const std::string &nodeId)
+{
+	// Never interned = not in the graph or the cache
+	NodeHandle handle = findId(nodeId);
+	if (handle.isValid())
+		markDirty(handle);
+}
 
+void NodeExecutionGraph::markDirty(NodeHandle nodeId)
+{
+	std::lock_guard<std::mutex> lock(m_dirtyMutex);
+	m_pendingDirty.push_back(nodeId);
+	m_hasPendingDirty.store(true, std::memory_order_release);
+}
+
+void NodeExecutionGraph::markAllDirty()
+{
+	m_pendingAllDirty.store(true, std::memory_order_release);
+}
+
+EvaluationStats NodeExecutionGraph::getLastFrameStats() const
+{
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	return m_lastFrameStats;
+}
+
+void NodeExecutionGraph::beginFrame(CompiledSchedule &schedule, const ExecutionContext &ctx)
+{
+	if (ctx.profiler && schedule.profilerNames != ctx.profiler) {
+		for (const auto &compiled : schedule.nodes) {
+			ctx.profiler->registerNode(compiled.profileKey, idString(compiled.nodeId));
+		}
+		schedule.profilerNames = ctx.profiler;
+	}
+
+	if (m_pendingAllDirty.exchange(false, std::memory_order_acq_rel)) {
+		for (size_t i = 0; i < schedule.nodes.size(); ++i) {
+			schedule.dirty[i].store(1, std::memory_order_relaxed);
+		}
+		schedule.demandValid = false;
+	}
+
+	if (m_hasPendingDirty.load(std::memory_order_acquire)) {
+		std::vector<NodeHandle> pending;
+		{
+			std::lock_guard<std::mutex> lock(m_dirtyMutex);
+			pending.swap(m_pendingDirty);
+			m_hasPendingDirty.store(false, std::memory_order_relaxed);
+		}
+
+		for (NodeHandle nodeId : pending) {
+			auto it = schedule.snapshot->index.find(nodeId);
+			if (it != schedule.snapshot->index.end()) {
+				schedule.dirty[it->second].store(1, std::memory_order_relaxed);
+			}
+			m_cache.invalidateNode(nodeId); // Changed outside its inputs (e.g. a property)
+		}
+		schedule.demandValid = false; // The change may have (de)activated a sink
+	}
+
+	if (m_evaluationMode.load(std::memory_order_relaxed) == EvaluationMode::Demand && !schedule.demandValid) {
+		computeDemand(schedule);
+	}
+}
+
+void NodeExecutionGraph::computeDemand(CompiledSchedule &schedule)
+{
+	// Walk backwards from the sinks; reverse execution order visits every
+	// successor before its predecessors.
+	schedule.demanded.assign(schedule.nodes.size(), 0);
+	for (size_t i = schedule.nodes.size(); i-- > 0;) {
+		const CompiledNode &compiled = schedule.nodes[i];
+		if (!schedule.demanded[i] && !compiled.node->isActiveSink())
+			continue;
+
+		schedule.demanded[i] = 1;
+		for (uint32_t edgeIndex : compiled.inputEdges) {
+			schedule.demanded[schedule.edges[edgeIndex].sourceIndex] = 1;
+		}
+	}
+	schedule.demandValid = true;
+}
+
+bool NodeExecutionGraph::shouldEvaluate(const CompiledSchedule &schedule, uint32_t index,
+					FrameCounters &counters) const
+{
+	if (m_evaluationMode.load(std::memory_order_relaxed) == EvaluationMode::Demand) {
+		if (!schedule.demanded[index]) {
+			counters.skippedInactive.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		const CompiledNode &compiled = schedule.nodes[index];
+		bool pending = compiled.async && m_asyncExecutor.hasPending(*compiled.async); // Has results to publish
+		if (!compiled.timeVarying && !schedule.dirty[index].load(std::memory_order_relaxed) && !pending) {
+			counters.skippedClean.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+	}
+
+	counters.evaluated.fetch_add(1, std::memory_order_relaxed);
 	return true;
 }
 
+void NodeExecutionGraph::markSuccessorsDirty(CompiledSchedule &schedule, const CompiledNode &compiled)
+{
+	for (uint32_t successor : compiled.successors) {
+		schedule.dirty[successor].store(1, std::memory_order_relaxed);
+	}
+}
+
+void NodeExecutionGraph::publishStats(uint64_t frameNumber, const FrameCounters &counters)
+{
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	m_lastFrameStats.frameNumber = frameNumber;
+	m_lastFrameStats.evaluated = counters.evaluated.load(std::memory_order_relaxed);
+	m_lastFrameStats.skippedClean = counters.skippedClean.load(std::memory_order_relaxed);
+	m_lastFrameStats.skippedInactive = counters.skippedInactive.load(std::memory_order_relaxed);
+}
+
+void NodeExecutionGraph::reportError(NodeHandle nodeId)
+{
+	// Serialized: parallel frames report from worker threads, and the editor may
+	// replace the handler while a frame runs
+	std::lock_guard<std::mutex> lock(m_errorMutex);
+	if (m_errorHandler) {
+		m_errorHandler(ExecutionResult::failure("Node execution failed"), idString(nodeId));
+	}
+}
+
 //=============================================================================
 // Caching
 //=============================================================================
@@ -487,83 +1291,88 @@ void NodeExecutionGraph::clearCache()
 
 void NodeExecutionGraph::clearCacheForNode(const std::string &nodeId)
 {
-	m_cache.erase(nodeId);
+	NodeHandle handle = findId(nodeId);
+	if (handle.isValid())
+		clearCacheForNode(handle);
 }
 
-size_t NodeExecutionGraph::computeInputHash(const std::string &nodeId) const
+void NodeExecutionGraph::clearCacheForNode(NodeHandle nodeId)
 {
-	size_t hash = 0;
-	auto node = getNode(nodeId);
-	if (node) {
-		for (const auto &pin : node->getInputPins()) {
-			if (!node->hasPinData(pin.pinId))
-				continue;
+	m_cache.invalidateNode(nodeId);
+}
 
-			auto data = node->getPinData(pin.pinId);
-			size_t valueHash = 0;
-
-			// Hash based on type
-			try {
-				if (data.type() == typeid(float)) {
-					valueHash = std::hash<float>{}(std::any_cast<float>(data));
-				} else if (data.type() == typeid(int)) {
-					valueHash = std::hash<int>{}(std::any_cast<int>(data));
-				} else if (data.type() == typeid(bool)) {
-					valueHash = std::hash<bool>{}(std::any_cast<bool>(data));
-				} else if (data.type() == typeid(std::string)) {
-					valueHash = std::hash<std::string>{}(std::any_cast<std::string>(data));
-				} else if (data.type() == typeid(void *)) {
-					valueHash = std::hash<void *>{}(std::any_cast<void *>(data));
-				} else if (data.type() == typeid(std::shared_ptr<void>)) {
-					valueHash = std::hash<std::shared_ptr<void>>{}(
-						std::any_cast<std::shared_ptr<void>>(data));
-				} else {
-					// Fallback: hash the type info name as a placeholder
-					// (Weak, but better than nothing for unknown types)
-					valueHash = std::hash<std::string>{}(data.type().name());
-				}
-			} catch (...) {
-				// Ignore casting errors
-			}
+bool NodeExecutionGraph::computeInputHash(const CompiledSchedule &schedule, const CompiledNode &compiled,
+					  uint64_t &hash, std::vector<std::shared_ptr<const void>> &inputRefs) const
+{
+	IExecutableNode *node = compiled.node;
+	const auto &pins = node->getInputPins();
+
+	hash = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < pins.size(); ++i) {
+		PinValue boxed;
+		const PinValue *value = &boxed;
+		if (compiled.slotsBound) {
+			value = &schedule.pinSlots->at(compiled.slotBase + static_cast<uint32_t>(i));
+		} else if (node->hasPinData(pins[i].pinId)) {
+			boxed = PinValue::fromAny(node->getPinData(pins[i].pinId));
+		}
 
-			// Combine hashes (FNV-1a style)
-			hash ^= std::hash<std::string>{}(pin.pinId);
-			hash *= 0x100000001b3;
-			hash ^= valueHash;
-			hash *= 0x100000001b3;
+		uint64_t valueHash = 0;
+		if (!PinHasherRegistry::hash(pins[i].dataType, *value, valueHash)) {
+			return false; // No hasher: recompute rather than risk a false hit
+		}
+		if (value->handleRef()) {
+			inputRefs.push_back(value->handleRef());
 		}
+
+		// Combine hashes (FNV-1a style), position-dependent
+		hash ^= i;
+		hash *= 0x100000001b3;
+		hash ^= valueHash;
+		hash *= 0x100000001b3;
 	}
-	return hash;
+	return true;
 }
 
-bool NodeExecutionGraph::tryGetFromCache(const std::string &nodeId, size_t inputHash, CacheEntry &entry)
+bool NodeExecutionGraph::restoreFromCache(CompiledSchedule &schedule, const CompiledNode &compiled, uint64_t inputHash)
 {
-	auto it = m_cache.find(nodeId);
-	if (it != m_cache.end() && it->second.inputHash == inputHash) {
-		entry = it->second;
-		return true;
+	std::vector<PinValue> values;
+	if (!m_cache.lookup(compiled.nodeId, inputHash, values)) {
+		return false;
+	}
+
+	const auto &pins = compiled.node->getOutputPins();
+	for (size_t i = 0; i < values.size() && i < pins.size(); ++i) {
+		if (values[i].empty())
+			continue;
+
+		if (compiled.slotsBound) {
+			schedule.pinSlots->at(compiled.slotBase + compiled.inputCount + static_cast<uint32_t>(i)) =
+				std::move(values[i]);
+		} else {
+			compiled.node->setPinData(pins[i].pinId, values[i].toAny());
+		}
 	}
-	return false;
+	return true;
 }
 
-void NodeExecutionGraph::updateCache(const std::string &nodeId, size_t inputHash)
+void NodeExecutionGraph::updateCache(CompiledSchedule &schedule, const CompiledNode &compiled, uint64_t inputHash,
+				     std::vector<std::shared_ptr<const void>> inputRefs, std::chrono::nanoseconds cost)
 {
-	auto node = getNode(nodeId);
-	if (!node)
-		return;
-
-	CacheEntry entry;
-	entry.inputHash = inputHash;
-	entry.timestamp = std::chrono::steady_clock::now();
+	IExecutableNode *node = compiled.node;
 
 	// Store output data
-	for (const auto &pin : node->getOutputPins()) {
-		if (node->hasPinData(pin.pinId)) {
-			entry.outputData[pin.pinId] = node->getPinData(pin.pinId);
+	const auto &pins = node->getOutputPins();
+	std::vector<PinValue> outputs(pins.size());
+	for (size_t i = 0; i < pins.size(); ++i) {
+		if (compiled.slotsBound) {
+			outputs[i] = schedule.pinSlots->at(compiled.slotBase + compiled.inputCount + static_cast<uint32_t>(i));
+		} else if (node->hasPinData(pins[i].pinId)) {
+			outputs[i] = PinValue::fromAny(node->getPinData(pins[i].pinId));
 		}
 	}
 
-	m_cache[nodeId] = entry;
+	m_cache.store(compiled.nodeId, inputHash, std::move(outputs), std::move(inputRefs), cost);
 }
 
 //=============================================================================
@@ -572,7 +1381,8 @@ void NodeExecutionGraph::updateCache(const std::string &nodeId, size_t inputHash
 
 void NodeExecutionGraph::setErrorHandler(std::function<void(const ExecutionResult &, const std::string &)> handler)
 {
-	m_errorHandler = handler;
+	std::lock_guard<std::mutex> lock(m_errorMutex);
+	m_errorHandler = std::move(handler);
 }
 
 } // namespace SceneGraph
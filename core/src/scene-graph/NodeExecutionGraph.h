@@ -1,9 +1,18 @@
 #pragma once
 
 #include "IExecutableNode.h"
+#include "PinSlots.h"
+#include "NodeOutputCache.h"
+#include "AsyncNodeExecutor.h"
+#include "ExecutionProfiler.h"
+#include "TaskScheduler.h"
+#include "IdInterner.h"
+#include <atomic>
 #include <queue>
 #include <set>
 #include <chrono>
+#include <mutex>
+#include <unordered_map>
 
 namespace NeuralStudio {
     namespace SceneGraph {
@@ -13,18 +22,38 @@ namespace NeuralStudio {
         //=============================================================================
 
         struct PinConnection {
-            std::string sourceNodeId;
-            std::string sourcePinId;
-            std::string targetNodeId;
-            std::string targetPinId;
+            NodeHandle sourceNode;
+            PinHandle sourcePin;
+            NodeHandle targetNode;
+            PinHandle targetPin;
 
             bool operator==(const PinConnection &other) const
             {
-                return sourceNodeId == other.sourceNodeId && sourcePinId == other.sourcePinId &&
-                       targetNodeId == other.targetNodeId && targetPinId == other.targetPinId;
+                return sourceNode == other.sourceNode && sourcePin == other.sourcePin &&
+                       targetNode == other.targetNode && targetPin == other.targetPin;
+            }
+
+            // String ids (UI / serialization boundary)
+            const std::string &sourceNodeId() const
+            {
+                return idString(sourceNode);
+            }
+            const std::string &sourcePinId() const
+            {
+                return idString(sourcePin);
+            }
+            const std::string &targetNodeId() const
+            {
+                return idString(targetNode);
+            }
+            const std::string &targetPinId() const
+            {
+                return idString(targetPin);
             }
         };
 
+        static_assert(sizeof(PinConnection) == 16, "PinConnection should stay four 32-bit handles");
+
         //=============================================================================
         // Validation Error
         //=============================================================================
@@ -44,20 +73,123 @@ namespace NeuralStudio {
         };
 
         //=============================================================================
-        // Cache Entry
+        // Compiled Schedule
         //=============================================================================
 
-        struct CacheEntry {
-            std::map<std::string, std::any> outputData;
+        constexpr uint32_t kInvalidPinSlot = UINT32_MAX;
+
+        // Resolved connection, grouped by source node in the schedule's edge array
+        struct CompiledEdge {
+            IExecutableNode *source = nullptr;
+            IExecutableNode *target = nullptr;
+            uint32_t sourceSlot = kInvalidPinSlot;  // Pin slots (invalid for an end that is not bound)
+            uint32_t targetSlot = kInvalidPinSlot;
+            uint32_t sourceIndex = 0;    // Upstream compiled node
+            uint32_t targetIndex = 0;    // Downstream compiled node
+            size_t connectionIndex = 0;  // Pin handles for the string-keyed slow path
+        };
+
+        /**
+ * @brief Per-node dependency record built by compile().
+ *
+ * Indices refer to the owning CompiledSchedule's node array (execution
+ * order) and edge array.
+ */
+        struct CompiledNode {
+            NodeHandle nodeId;
+            IExecutableNode *node = nullptr;
+            uint32_t firstOutEdge = 0;  // Range of this node's outgoing edges
+            uint32_t outEdgeCount = 0;
+            uint32_t slotBase = 0;  // First pin slot (inputs, then outputs)
+            uint32_t inputCount = 0;
+            uint32_t outputCount = 0;
+            bool slotsBound = false;           // False = node uses the string-keyed pin API
+            std::vector<uint32_t> inputEdges;  // Indices into the edge array
+            std::vector<uint32_t> successors;  // Unique downstream nodes
+            uint32_t predecessorCount = 0;     // Unique upstream nodes
+            bool timeVarying = false;          // IExecutableNode::isTimeVarying(), sampled at compile
+            std::vector<uint32_t> connectedInputs;  // Local input slots fed by an edge
+            AsyncNodeState *async = nullptr;        // Pipelined: the slots above are its mailbox
+            uint64_t profileKey = 0;                // ExecutionProfiler::nodeKey(nodeId)
+        };
+
+        /**
+ * @brief Immutable view of the graph as of one successful compile().
+ *
+ * Never modified after publication, so any thread may hold and read one
+ * (e.g. the editor inspecting what the engine is running) while the graph
+ * itself is being edited. It retains every node it references.
+ */
+        struct GraphSnapshot {
+            uint64_t generation = 0;
+            std::vector<NodeHandle> executionOrder;
+            std::vector<std::shared_ptr<IExecutableNode>> nodes;  // Execution order
+            std::unordered_map<NodeHandle, uint32_t> index;       // nodeId -> position in nodes
+            std::vector<PinConnection> connections;  // CompiledEdge::connectionIndex refers to these
+            bool pinSlots = true;                    // Settings sampled at compile
+            bool asyncExecution = true;
+        };
+
+        /**
+ * @brief Self-contained execution plan produced by compile().
+ *
+ * Edits never touch a published schedule: compile() builds a new one around
+ * an immutable GraphSnapshot and publishes it with an atomic shared_ptr
+ * swap (RCU). The frame loop switches to it at the next frame boundary and
+ * owns its runtime state from then on; the previous schedule is reclaimed
+ * once no frame or reader references it.
+ */
+        struct CompiledSchedule {
+            std::shared_ptr<const GraphSnapshot> snapshot;
+            std::vector<CompiledNode> nodes;  // Execution order
+            std::vector<CompiledEdge> edges;  // CSR adjacency, indexed by CompiledNode::firstOutEdge
+            std::unique_ptr<PinSlotBuffer> pinSlots;  // nullptr = pin slots disabled
+            std::unique_ptr<std::atomic<uint32_t>[]> pendingPredecessors;
+
+            // Demand-driven evaluation (frame-loop side)
+            std::unique_ptr<std::atomic<uint8_t>[]> dirty;  // Set until the node is evaluated again
+            std::vector<uint8_t> demanded;                  // Upstream of an active sink
+            bool demandValid = false;
+
+            ExecutionProfiler *profilerNames = nullptr;  // Profiler the node names were registered with
+        };
+
+        enum class ParallelMode {
+            DependencyDriven,  // Persistent work-stealing pool, node runs when its predecessors finish
+            LevelSynchronous   // One std::async per node, barrier between levels (legacy)
+        };
+
+        enum class EvaluationMode {
+            Full,   // Every node runs every frame
+            Demand  // Only dirty nodes feeding an active sink run
+        };
+
+        // Per-frame evaluation counters (last completed frame)
+        struct EvaluationStats {
             uint64_t frameNumber = 0;
-            std::chrono::steady_clock::time_point timestamp;
-            size_t inputHash = 0;
+            uint32_t evaluated = 0;
+            uint32_t skippedClean = 0;     // Demanded, but nothing upstream changed
+            uint32_t skippedInactive = 0;  // Not feeding any active sink
         };
 
         //=============================================================================
         // Node Execution Graph
         //=============================================================================
 
+        /**
+ * @brief Mutable node graph (the builder) plus the executor of its snapshots.
+ *
+ * Nodes, connections, caches and schedules are keyed by interned handles
+ * (IdInterner.h). The string overloads below are the UI / serialization
+ * boundary: lookups by a string that was never interned simply miss.
+ *
+ * Threading: edits, compile() and settings belong to one editing thread
+ * (e.g. the Qt UI). execute()/executeParallel() belong to one frame thread
+ * (e.g. the engine), which only ever reads the latest published snapshot, so
+ * the two never share mutable state. Settings are atomics applied at the
+ * next frame; markDirty(), getSnapshot() and the stats getters are safe
+ * from any thread.
+ */
         class NodeExecutionGraph
         {
               public:
@@ -67,33 +199,88 @@ namespace NeuralStudio {
             // Node management
             void addNode(std::shared_ptr<IExecutableNode> node);
             void removeNode(const std::string &nodeId);
+            void removeNode(NodeHandle nodeId);
             std::shared_ptr<IExecutableNode> getNode(const std::string &nodeId) const;
+            std::shared_ptr<IExecutableNode> getNode(NodeHandle nodeId) const;
             size_t getNodeCount() const;
-            std::vector<std::string> getNodeIds() const;
+            std::vector<std::string> getNodeIds() const;  // Sorted
+            std::vector<NodeHandle> getNodeHandles() const;
 
             // Pin connections
             bool connectPins(const std::string &sourceNodeId, const std::string &sourcePinId,
                              const std::string &targetNodeId, const std::string &targetPinId);
+            bool connectPins(NodeHandle sourceNodeId, PinHandle sourcePinId, NodeHandle targetNodeId,
+                             PinHandle targetPinId);
             void disconnectPins(const std::string &targetNodeId, const std::string &targetPinId);
+            void disconnectPins(NodeHandle targetNodeId, PinHandle targetPinId);
             void disconnectAllPins(const std::string &nodeId);
+            void disconnectAllPins(NodeHandle nodeId);
 
             std::vector<PinConnection> getConnections() const;
-            std::vector<PinConnection> getInputConnections(const std::string &nodeId) const;
-            std::vector<PinConnection> getOutputConnections(const std::string &nodeId) const;
+            std::vector<PinConnection> getInputConnections(NodeHandle nodeId) const;
+            std::vector<PinConnection> getOutputConnections(NodeHandle nodeId) const;
 
-            // Compilation (topological sort + validation)
+            // Compilation (topological sort + validation). After the first full
+            // compile, edits keep the topological order up to date incrementally
+            // and compile() only validates the connections added since.
             bool compile();
             bool isCompiled() const
             {
                 return m_isCompiled;
             }
+            // Forces the next compile() to re-sort and re-validate everything
+            void invalidateCompilation()
+            {
+                m_orderValid = false;
+                m_isCompiled = false;
+            }
+            // Schedules published by compile(); the frame loop runs the latest one it has picked up
+            uint64_t getScheduleGeneration() const
+            {
+                return m_scheduleGeneration;
+            }
+            // Latest published snapshot (nullptr before the first compile). Lock-free,
+            // callable from any thread; holding it keeps its nodes alive.
+            std::shared_ptr<const GraphSnapshot> getSnapshot() const;
+            // Generation of the snapshot the frame loop is running (0 = none yet)
+            uint64_t getActiveGeneration() const
+            {
+                return m_activeGeneration.load(std::memory_order_acquire);
+            }
 
-            // Execution
+            // Execution. Set ctx.profiler to record per-node timings for the frame.
             bool execute(ExecutionContext &ctx);
             bool executeParallel(ExecutionContext &ctx);  // Parallel execution
 
+            // Parallel scheduling
+            void setParallelMode(ParallelMode mode)
+            {
+                m_parallelMode.store(mode, std::memory_order_relaxed);
+            }
+            ParallelMode getParallelMode() const
+            {
+                return m_parallelMode.load(std::memory_order_relaxed);
+            }
+            // Replaces the worker pool; takes effect on the next executeParallel()
+            void setSchedulerConfig(const TaskScheduler::Config &config);
+            TaskScheduler &getScheduler();
+
+            // Demand-driven evaluation. In Demand mode a node runs only if it is
+            // dirty (or time-varying) and feeds an active sink; evaluating it marks
+            // its successors dirty. Nodes changed outside the graph (properties,
+            // unconnected inputs, sink activation) must be flagged with markDirty().
+            void setEvaluationMode(EvaluationMode mode);
+            EvaluationMode getEvaluationMode() const
+            {
+                return m_evaluationMode;
+            }
+            void markDirty(const std::string &nodeId);  // Thread-safe, applied at the next frame
+            void markDirty(NodeHandle nodeId);
+            void markAllDirty();
+            EvaluationStats getLastFrameStats() const;
+
             // Query
-            const std::vector<std::string> &getExecutionOrder() const
+            const std::vector<NodeHandle> &getExecutionOrder() const
             {
                 return m_executionOrder;
             }
@@ -106,19 +293,61 @@ namespace NeuralStudio {
                 return m_validationErrors;
             }
 
-            // Caching
+            // Caching (nodes reporting supportsCaching() and not time-varying)
             void enableCaching(bool enable)
             {
-                m_cachingEnabled = enable;
+                m_cachingEnabled.store(enable, std::memory_order_relaxed);
             }
             void clearCache();
             void clearCacheForNode(const std::string &nodeId);
+            void clearCacheForNode(NodeHandle nodeId);
+            NodeOutputCache &getCache()
+            {
+                return m_cache;
+            }
+            const NodeOutputCache &getCache() const
+            {
+                return m_cache;
+            }
+
+            // Pipelined execution of supportsAsync() nodes (requires pin slots; sampled
+            // into the snapshot, so it takes effect on the next compile()). Such a node runs off the frame loop and
+            // downstream nodes see its latest completed result, stamped with the
+            // frame it was computed for (see getInputStamp()).
+            void enableAsyncExecution(bool enable)
+            {
+                m_asyncEnabled = enable;
+                m_isCompiled = false;
+            }
+            bool asyncExecutionEnabled() const
+            {
+                return m_asyncEnabled;
+            }
+            AsyncNodeExecutor &getAsyncExecutor()
+            {
+                return m_asyncExecutor;
+            }
+            const AsyncNodeExecutor &getAsyncExecutor() const
+            {
+                return m_asyncExecutor;
+            }
+
+            // Compiled pin slots (takes effect on the next compile())
+            void enablePinSlots(bool enable)
+            {
+                m_pinSlotsEnabled = enable;
+                m_isCompiled = false;
+            }
+            bool pinSlotsEnabled() const
+            {
+                return m_pinSlotsEnabled;
+            }
 
             // Error handling
             void setErrorHandler(std::function<void(const ExecutionResult &, const std::string &nodeId)> handler);
             void setEnableFallbackMode(bool enable)
             {
-                m_fallbackMode = enable;
+                m_fallbackMode.store(enable, std::memory_order_relaxed);
             }
 
               private:
@@ -127,36 +356,111 @@ namespace NeuralStudio {
             bool detectCycles();
             bool validateConnections();
             bool validatePinTypes(const PinConnection &connection);
+            void addValidationError(const PinConnection &connection);
+
+            // Incremental topological order (Pearce-Kelly)
+            void resetTopologicalOrder();
+            void insertEdgeOrder(NodeHandle sourceNodeId, NodeHandle targetNodeId);
+            void addAdjacency(const PinConnection &connection);
+            void removeAdjacency(const PinConnection &connection);
+            template<typename Predicate> void removeConnectionsIf(Predicate predicate);
+
+            // Schedule building / hand-over
+            std::shared_ptr<CompiledSchedule> buildSchedule();
+            std::shared_ptr<CompiledSchedule> acquireSchedule();
+            void activateSchedule(const std::shared_ptr<CompiledSchedule> &schedule);
+            void unbindPinSlots(CompiledSchedule &schedule);
+            uint32_t findOutputSlot(const CompiledNode &compiled, PinHandle pinId) const;
+            uint32_t findInputSlot(const CompiledNode &compiled, PinHandle pinId) const;
 
             // Execution helpers
-            bool executeNode(const std::string &nodeId, ExecutionContext &ctx);
-            void propagateData();
+            bool evaluateNode(CompiledSchedule &schedule, uint32_t index, ExecutionContext &ctx, int64_t readyNs = 0);
+            bool executeNode(CompiledSchedule &schedule, const CompiledNode &compiled, ExecutionContext &ctx,
+                             ProfileCacheStatus &cacheStatus);
+            void propagateData(CompiledSchedule &schedule);
+            void propagateFrom(CompiledSchedule &schedule, const CompiledNode &compiled);
+            void transferEdge(CompiledSchedule &schedule, const CompiledEdge &edge);
 
             // Caching helpers
-            size_t computeInputHash(const std::string &nodeId) const;
-            bool tryGetFromCache(const std::string &nodeId, size_t inputHash, CacheEntry &entry);
-            void updateCache(const std::string &nodeId, size_t inputHash);
+            bool computeInputHash(const CompiledSchedule &schedule, const CompiledNode &compiled, uint64_t &hash,
+                                  std::vector<std::shared_ptr<const void>> &inputRefs) const;
+            bool restoreFromCache(CompiledSchedule &schedule, const CompiledNode &compiled, uint64_t inputHash);
+            void updateCache(CompiledSchedule &schedule, const CompiledNode &compiled, uint64_t inputHash,
+                             std::vector<std::shared_ptr<const void>> inputRefs, std::chrono::nanoseconds cost);
 
             // Parallel execution helpers
-            std::vector<std::vector<std::string>> computeExecutionLevels();
+            std::vector<std::vector<uint32_t>> computeExecutionLevels(const CompiledSchedule &schedule);
+            bool executeDependencyDriven(CompiledSchedule &schedule, ExecutionContext &ctx);
+            bool executeLevelSynchronous(CompiledSchedule &schedule, ExecutionContext &ctx);
+            void gatherInputs(CompiledSchedule &schedule, const CompiledNode &compiled);
+
+            // Demand-driven evaluation helpers
+            struct FrameCounters;
+            void beginFrame(CompiledSchedule &schedule, const ExecutionContext &ctx);
+            void computeDemand(CompiledSchedule &schedule);
+            bool shouldEvaluate(const CompiledSchedule &schedule, uint32_t index, FrameCounters &counters) const;
+            void markSuccessorsDirty(CompiledSchedule &schedule, const CompiledNode &compiled);
+            void publishStats(uint64_t frameNumber, const FrameCounters &counters);
+            void reportError(NodeHandle nodeId);
 
             // Data
-            std::map<std::string, std::shared_ptr<IExecutableNode>> m_nodes;
+            std::unordered_map<NodeHandle, std::shared_ptr<IExecutableNode>> m_nodes;
             std::vector<PinConnection> m_connections;
 
             // Execution state
-            std::vector<std::string> m_executionOrder;
+            std::vector<NodeHandle> m_executionOrder;
             bool m_isCompiled = false;
             bool m_hasCycle = false;
             std::vector<ValidationError> m_validationErrors;
 
+            // Incremental compilation state (edit side)
+            bool m_orderValid = false;                  // m_order reflects every edge
+            std::unordered_map<NodeHandle, int64_t> m_order;  // nodeId -> topological position
+            std::map<int64_t, NodeHandle> m_ordered;          // position -> nodeId
+            int64_t m_nextOrder = 0;
+            using Adjacency = std::unordered_map<NodeHandle, std::unordered_map<NodeHandle, int>>;
+            Adjacency m_successors;  // Edge multiplicity per node pair
+            Adjacency m_predecessors;
+            std::vector<PinConnection> m_unvalidated;  // Added since the last successful validation
+
+            // Schedule hand-over (RCU): compile() replaces the published schedule,
+            // the frame loop activates it at its next frame boundary
+            std::atomic<std::shared_ptr<CompiledSchedule>> m_publishedSchedule;
+            std::shared_ptr<CompiledSchedule> m_activeSchedule;  // Frame-loop side only
+            uint64_t m_scheduleGeneration = 0;
+            std::atomic<uint64_t> m_activeGeneration {0};
+
+            // Parallel execution
+            std::atomic<ParallelMode> m_parallelMode {ParallelMode::DependencyDriven};
+            std::mutex m_schedulerMutex;
+            TaskScheduler::Config m_schedulerConfig;
+            bool m_schedulerConfigChanged = false;
+            std::unique_ptr<TaskScheduler> m_scheduler;  // Frame-loop side only
+
+            // Pin slots
+            bool m_pinSlotsEnabled = true;
+
+            // Demand-driven evaluation
+            std::atomic<EvaluationMode> m_evaluationMode {EvaluationMode::Full};
+            std::mutex m_dirtyMutex;
+            std::vector<NodeHandle> m_pendingDirty;  // markDirty() calls since the last frame
+            std::atomic<bool> m_hasPendingDirty {false};
+            std::atomic<bool> m_pendingAllDirty {false};
+            EvaluationStats m_lastFrameStats;
+            mutable std::mutex m_statsMutex;
+
             // Caching
-            bool m_cachingEnabled = true;
-            std::map<std::string, CacheEntry> m_cache;
+            std::atomic<bool> m_cachingEnabled {true};
+            NodeOutputCache m_cache;
+
+            // Pipelined nodes
+            bool m_asyncEnabled = true;
+            AsyncNodeExecutor m_asyncExecutor;
 
             // Error handling
-            bool m_fallbackMode = false;
+            std::atomic<bool> m_fallbackMode {false};
             std::function<void(const ExecutionResult &, const std::string &)> m_errorHandler;
+            std::mutex m_errorMutex;
         };
 
     }  // namespace SceneGraph
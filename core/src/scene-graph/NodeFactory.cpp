@@ -35,5 +35,10 @@ std::vector<std::string> NodeFactory::getRegisteredTypes()
 	return types;
 }
 
+bool NodeFactory::isTypeRegistered(const std::string &typeName)
+{
+	return getRegistry().count(typeName) != 0;
+}
+
 } // namespace SceneGraph
 } // namespace NeuralStudio
@@ -46,6 +46,8 @@ namespace NeuralStudio {
      */
             static std::vector<std::string> getRegisteredTypes();
 
+            static bool isTypeRegistered(const std::string &typeName);
+
               private:
             static std::map<std::string, NodeCreator> &getRegistry();
         };
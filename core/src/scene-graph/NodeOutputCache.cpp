@@ -0,0 +1,448 @@
+#include "NodeOutputCache.h"
+#include <algorithm>
+#include <shared_mutex>
+
+namespace NeuralStudio {
+namespace SceneGraph {
+
+namespace {
+
+uint64_t mix(uint64_t value)
+{
+	// splitmix64 finalizer
+	value += 0x9e3779b97f4a7c15ull;
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+	return value ^ (value >> 31);
+}
+
+uint64_t combine(uint64_t seed, uint64_t value)
+{
+	return mix(seed ^ (mix(value) + (seed << 6) + (seed >> 2)));
+}
+
+uint64_t hashBytes(const void *data, size_t size)
+{
+	// FNV-1a
+	const auto *bytes = static_cast<const uint8_t *>(data);
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+template<typename T> uint64_t hashPod(const T &value)
+{
+	return hashBytes(&value, sizeof(T));
+}
+
+} // namespace
+
+//=============================================================================
+// PinHasherRegistry
+//=============================================================================
+
+struct PinHasherRegistry::Registry {
+	std::shared_mutex hashersMutex;
+	std::map<std::string, PinHasher> dataTypeHashers;
+	std::unordered_map<std::type_index, AnyHasher> typeHashers;
+
+	struct Generation {
+		uint64_t value = 0;
+		bool tracked = false;  // Bumped since the resource was created
+	};
+	std::mutex generationsMutex;
+	std::unordered_map<const void *, Generation> generations;
+
+	Registry()
+	{
+		auto integral = [](auto tag) {
+			using T = decltype(tag);
+			return [](const std::any &value, uint64_t &hash) {
+				hash = mix(static_cast<uint64_t>(*std::any_cast<T>(&value)));
+				return true;
+			};
+		};
+		typeHashers[typeid(int)] = integral(int());
+		typeHashers[typeid(int64_t)] = integral(int64_t());
+		typeHashers[typeid(uint32_t)] = integral(uint32_t());
+		typeHashers[typeid(uint64_t)] = integral(uint64_t());
+		typeHashers[typeid(double)] = [](const std::any &value, uint64_t &hash) {
+			hash = hashPod(*std::any_cast<double>(&value));
+			return true;
+		};
+		typeHashers[typeid(std::string)] = [](const std::any &value, uint64_t &hash) {
+			const auto &str = *std::any_cast<std::string>(&value);
+			hash = hashBytes(str.data(), str.size());
+			return true;
+		};
+		// Opaque handles (e.g. renderer objects) are treated as resources
+		typeHashers[typeid(void *)] = [](const std::any &value, uint64_t &hash) {
+			return hashResource(*std::any_cast<void *>(&value), hash);
+		};
+	}
+};
+
+PinHasherRegistry::Registry &PinHasherRegistry::getRegistry()
+{
+	// Function-local static: registrations may run during static initialization
+	static Registry registry;
+	return registry;
+}
+
+void PinHasherRegistry::registerDataTypeHasher(const std::string &typeName, PinHasher hasher)
+{
+	auto &registry = getRegistry();
+	std::unique_lock<std::shared_mutex> lock(registry.hashersMutex);
+	registry.dataTypeHashers[typeName] = std::move(hasher);
+}
+
+void PinHasherRegistry::registerTypeHasher(std::type_index type, AnyHasher hasher)
+{
+	auto &registry = getRegistry();
+	std::unique_lock<std::shared_mutex> lock(registry.hashersMutex);
+	registry.typeHashers[type] = std::move(hasher);
+}
+
+bool PinHasherRegistry::hash(const DataType &type, const PinValue &value, uint64_t &hash)
+{
+	auto &registry = getRegistry();
+	std::shared_lock<std::shared_mutex> lock(registry.hashersMutex);
+
+	if (!registry.dataTypeHashers.empty()) {
+		auto it = registry.dataTypeHashers.find(type.typeName);
+		if (it != registry.dataTypeHashers.end()) {
+			return it->second(value, hash);
+		}
+	}
+
+	switch (value.kind()) {
+	case PinValueKind::Empty:
+		hash = 0;
+		return true;
+	case PinValueKind::Scalar:
+		hash = hashPod(*value.getIf<float>());
+		return true;
+	case PinValueKind::Boolean:
+		hash = *value.getIf<bool>() ? 1 : 2;
+		return true;
+	case PinValueKind::Vector3:
+		hash = hashPod(*value.getIf<PinVector3>());
+		return true;
+	case PinValueKind::Color:
+		hash = hashPod(*value.getIf<PinColor>());
+		return true;
+	case PinValueKind::Transform:
+		hash = hashPod(*value.getIf<PinTransform>());
+		return true;
+	case PinValueKind::Handle:
+		// Payloads are immutable, so identity is content. The cache keeps the
+		// payload alive to stop the address being reused.
+		hash = combine(value.handleType()->hash_code(),
+			       static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value.handleRef().get())));
+		return true;
+	case PinValueKind::Any:
+		break;
+	}
+
+	const std::any *boxed = value.anyValue();
+	auto it = registry.typeHashers.find(std::type_index(boxed->type()));
+	if (it == registry.typeHashers.end()) {
+		return false;
+	}
+	if (!it->second(*boxed, hash)) {
+		return false;
+	}
+	hash = combine(boxed->type().hash_code(), hash);
+	return true;
+}
+
+void PinHasherRegistry::bumpGeneration(const void *resource)
+{
+	auto &registry = getRegistry();
+	std::lock_guard<std::mutex> lock(registry.generationsMutex);
+	auto &generation = registry.generations[resource];
+	generation.value++;
+	generation.tracked = true;
+}
+
+void PinHasherRegistry::releaseResource(const void *resource)
+{
+	// A new resource at the same address must not match the old one's entries,
+	// and stays uncacheable until its own writer bumps it
+	auto &registry = getRegistry();
+	std::lock_guard<std::mutex> lock(registry.generationsMutex);
+	auto &generation = registry.generations[resource];
+	generation.value++;
+	generation.tracked = false;
+}
+
+uint64_t PinHasherRegistry::getGeneration(const void *resource)
+{
+	auto &registry = getRegistry();
+	std::lock_guard<std::mutex> lock(registry.generationsMutex);
+	auto it = registry.generations.find(resource);
+	return it != registry.generations.end() ? it->second.value : 0;
+}
+
+bool PinHasherRegistry::hashResource(const void *resource, uint64_t &hash)
+{
+	auto &registry = getRegistry();
+	std::lock_guard<std::mutex> lock(registry.generationsMutex);
+	auto it = registry.generations.find(resource);
+	if (it == registry.generations.end() || !it->second.tracked) {
+		return false; // Written behind the graph's back for all we know
+	}
+	hash = combine(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(resource)), it->second.value);
+	return true;
+}
+
+//=============================================================================
+// NodeOutputCache
+//=============================================================================
+
+void NodeOutputCache::setConfig(const Config &config)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_config = config;
+
+	// Shrink to the new budget
+	while (m_bytesUsed > m_config.byteBudget && !m_evictionQueue.empty()) {
+		evict(m_evictionQueue.begin()->second);
+	}
+}
+
+NodeOutputCache::Config NodeOutputCache::getConfig() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_config;
+}
+
+uint64_t NodeOutputCache::makeKey(NodeHandle nodeId, uint64_t inputHash) const
+{
+	return combine(nodeId.value, inputHash);
+}
+
+double NodeOutputCache::priorityFor(const Entry &entry)
+{
+	if (m_config.policy == CacheEvictionPolicy::LRU) {
+		return static_cast<double>(++m_tick);
+	}
+	// GreedyDual-Size: value per byte, aged by the inflation clock
+	return m_inflation + entry.cost / static_cast<double>(entry.bytes + 1);
+}
+
+void NodeOutputCache::touch(uint64_t key, Entry &entry)
+{
+	m_evictionQueue.erase({entry.priority, key});
+	entry.priority = priorityFor(entry);
+	m_evictionQueue.insert({entry.priority, key});
+}
+
+void NodeOutputCache::evict(uint64_t key)
+{
+	auto it = m_entries.find(key);
+	if (it == m_entries.end())
+		return;
+
+	if (m_config.policy == CacheEvictionPolicy::CostAware) {
+		m_inflation = std::max(m_inflation, it->second.priority);
+	}
+	m_stats[it->second.nodeId].evictions++;
+	erase(key);
+}
+
+void NodeOutputCache::erase(uint64_t key)
+{
+	auto it = m_entries.find(key);
+	if (it == m_entries.end())
+		return;
+
+	Entry &entry = it->second;
+	m_evictionQueue.erase({entry.priority, key});
+
+	NodeCacheStats &stats = m_stats[entry.nodeId];
+	stats.bytes -= entry.bytes;
+	stats.entries--;
+	m_bytesUsed -= entry.bytes;
+
+	auto &keys = m_nodeEntries[entry.nodeId];
+	keys.erase(std::remove(keys.begin(), keys.end(), key), keys.end());
+	if (keys.empty())
+		m_nodeEntries.erase(entry.nodeId);
+
+	m_entries.erase(it);
+}
+
+void NodeOutputCache::evictForNode(NodeHandle nodeId)
+{
+	auto it = m_nodeEntries.find(nodeId);
+	if (it == m_nodeEntries.end())
+		return;
+
+	uint64_t victim = it->second.front();
+	for (uint64_t key : it->second) {
+		if (m_entries[key].priority < m_entries[victim].priority)
+			victim = key;
+	}
+	evict(victim);
+}
+
+bool NodeOutputCache::lookup(NodeHandle nodeId, uint64_t inputHash, std::vector<PinValue> &outputs)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	NodeCacheStats &stats = m_stats[nodeId];
+
+	uint64_t key = makeKey(nodeId, inputHash);
+	auto it = m_entries.find(key);
+	if (it == m_entries.end() || it->second.nodeId != nodeId || it->second.inputHash != inputHash) {
+		stats.misses++;
+		return false;
+	}
+
+	stats.hits++;
+	touch(key, it->second);
+	outputs = it->second.outputs;
+	return true;
+}
+
+void NodeOutputCache::store(NodeHandle nodeId, uint64_t inputHash, std::vector<PinValue> outputs,
+			    std::vector<std::shared_ptr<const void>> inputRefs, std::chrono::nanoseconds cost)
+{
+	Entry entry;
+	entry.nodeId = nodeId;
+	entry.inputHash = inputHash;
+	entry.cost = std::chrono::duration<double, std::micro>(cost).count();
+	for (const auto &value : outputs)
+		entry.bytes += estimateBytes(value);
+	entry.bytes += inputRefs.size() * sizeof(std::shared_ptr<const void>);
+	entry.outputs = std::move(outputs);
+	entry.inputRefs = std::move(inputRefs);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (entry.bytes > m_config.byteBudget || m_config.maxEntriesPerNode == 0)
+		return;
+
+	uint64_t key = makeKey(nodeId, inputHash);
+	erase(key); // Replaces an existing entry (or a colliding one)
+
+	auto nodeEntries = m_nodeEntries.find(nodeId);
+	if (nodeEntries != m_nodeEntries.end() && nodeEntries->second.size() >= m_config.maxEntriesPerNode) {
+		evictForNode(nodeId);
+	}
+	while (m_bytesUsed + entry.bytes > m_config.byteBudget && !m_evictionQueue.empty()) {
+		evict(m_evictionQueue.begin()->second);
+	}
+
+	NodeCacheStats &stats = m_stats[nodeId];
+	stats.insertions++;
+	stats.bytes += entry.bytes;
+	stats.entries++;
+	m_bytesUsed += entry.bytes;
+	m_nodeEntries[nodeId].push_back(key);
+
+	entry.priority = priorityFor(entry);
+	m_evictionQueue.insert({entry.priority, key});
+	m_entries.emplace(key, std::move(entry));
+}
+
+void NodeOutputCache::recordUncacheable(NodeHandle nodeId)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stats[nodeId].uncacheable++;
+}
+
+void NodeOutputCache::invalidateNode(NodeHandle nodeId)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_nodeEntries.find(nodeId);
+	if (it == m_nodeEntries.end())
+		return;
+
+	for (uint64_t key : std::vector<uint64_t>(it->second)) {
+		erase(key);
+	}
+}
+
+void NodeOutputCache::clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_entries.clear();
+	m_evictionQueue.clear();
+	m_nodeEntries.clear();
+	for (auto &[_, stats] : m_stats) {
+		stats.bytes = 0;
+		stats.entries = 0;
+	}
+	m_bytesUsed = 0;
+	m_inflation = 0.0;
+}
+
+NodeCacheStats NodeOutputCache::getStats(NodeHandle nodeId) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_stats.find(nodeId);
+	return it != m_stats.end() ? it->second : NodeCacheStats();
+}
+
+NodeCacheStats NodeOutputCache::getStats(const std::string &nodeId) const
+{
+	NodeHandle handle = findId(nodeId);
+	return handle.isValid() ? getStats(handle) : NodeCacheStats();
+}
+
+NodeCacheStats NodeOutputCache::getTotalStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	NodeCacheStats total;
+	for (const auto &[_, stats] : m_stats) {
+		total.hits += stats.hits;
+		total.misses += stats.misses;
+		total.evictions += stats.evictions;
+		total.insertions += stats.insertions;
+		total.uncacheable += stats.uncacheable;
+		total.bytes += stats.bytes;
+		total.entries += stats.entries;
+	}
+	return total;
+}
+
+std::map<std::string, NodeCacheStats> NodeOutputCache::getAllStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::map<std::string, NodeCacheStats> stats;
+	for (const auto &[nodeId, nodeStats] : m_stats) {
+		stats.emplace(idString(nodeId), nodeStats);
+	}
+	return stats;
+}
+
+size_t NodeOutputCache::getBytesUsed() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_bytesUsed;
+}
+
+size_t NodeOutputCache::estimateBytes(const PinValue &value)
+{
+	size_t bytes = sizeof(PinValue);
+	if (const std::type_info *type = value.handleType()) {
+		if (*type == typeid(VideoFrameData)) {
+			bytes += value.getHandle<VideoFrameData>()->pixels.size();
+		} else if (*type == typeid(AudioBufferData)) {
+			bytes += value.getHandle<AudioBufferData>()->samples.size() * sizeof(float);
+		} else if (*type == typeid(MeshData)) {
+			const MeshData &mesh = *value.getHandle<MeshData>();
+			bytes += (mesh.positions.size() + mesh.normals.size() + mesh.uvs.size()) * sizeof(float) +
+				 mesh.indices.size() * sizeof(uint32_t);
+		}
+	} else if (const auto *str = value.getIf<std::string>()) {
+		bytes += str->size();
+	}
+	return bytes;
+}
+
+} // namespace SceneGraph
+} // namespace NeuralStudio
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "IExecutableNode.h"
+#include "IdInterner.h"
+#include "PinSlots.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace NeuralStudio {
+    namespace SceneGraph {
+
+        //=============================================================================
+        // Pin Hashing
+        //=============================================================================
+
+        /**
+ * @brief Registry of value hashers used to content-address node inputs.
+ *
+ * Inline primitives and FrameHandle payloads are hashed natively. Boxed
+ * values are hashed by their C++ type; a hasher registered for a
+ * DataType name (e.g. "Tensor") takes precedence for pins of that type.
+ * Values without a hasher make the node uncacheable for that frame rather
+ * than risk a false hit.
+ *
+ * GPU resources (textures, buffers) are mutable behind a stable pointer,
+ * so they are hashed as (address, generation). Whoever writes into a
+ * resource calls bumpGeneration() afterwards, and releaseResource() before
+ * destroying it (see RTXUpscaleNode). A resource nobody has bumped yet, or
+ * one released since, has an untracked writer and makes its consumers
+ * uncacheable.
+ */
+        class PinHasherRegistry
+        {
+              public:
+            // Returns false if the value cannot be hashed
+            using PinHasher = std::function<bool(const PinValue &value, uint64_t &hash)>;
+            using AnyHasher = std::function<bool(const std::any &value, uint64_t &hash)>;
+
+            static void registerDataTypeHasher(const std::string &typeName, PinHasher hasher);
+            static void registerTypeHasher(std::type_index type, AnyHasher hasher);
+
+            template<typename T> static void registerType(std::function<uint64_t(const T &)> hasher)
+            {
+                registerTypeHasher(typeid(T), [hasher](const std::any &value, uint64_t &hash) {
+                    hash = hasher(*std::any_cast<T>(&value));
+                    return true;
+                });
+            }
+
+            // Pins carrying T* are hashed as (address, generation)
+            template<typename T> static void registerResourceType()
+            {
+                registerTypeHasher(typeid(T *), [](const std::any &value, uint64_t &hash) {
+                    return hashResource(*std::any_cast<T *>(&value), hash);
+                });
+            }
+
+            static bool hash(const DataType &type, const PinValue &value, uint64_t &hash);
+
+            // Resource generations
+            static void bumpGeneration(const void *resource);   // Also marks the resource as tracked
+            static void releaseResource(const void *resource);  // Forget a destroyed resource
+            static uint64_t getGeneration(const void *resource);
+            static bool hashResource(const void *resource, uint64_t &hash);  // False until first bumped
+
+              private:
+            struct Registry;
+            static Registry &getRegistry();
+        };
+
+        /**
+ * @brief Helper for static registration of GPU resource pin types.
+ */
+        template<typename T> class PinResourceRegistrar
+        {
+              public:
+            PinResourceRegistrar()
+            {
+                PinHasherRegistry::registerResourceType<T>();
+            }
+        };
+
+        //=============================================================================
+        // Node Output Cache
+        //=============================================================================
+
+        enum class CacheEvictionPolicy {
+            LRU,       // Least recently used first
+            CostAware  // GreedyDual-Size: cheap-to-recompute, large entries go first
+        };
+
+        struct NodeCacheStats {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            uint64_t insertions = 0;
+            uint64_t uncacheable = 0;  // Frames with an input that had no hasher
+            size_t bytes = 0;
+            size_t entries = 0;
+        };
+
+        /**
+ * @brief Content-addressed cache of node outputs, keyed by (node, input hash).
+ *
+ * Entries keep their inputs' FrameHandle payloads alive, so a payload
+ * address in the key cannot be reused for different content while the
+ * entry exists. Thread-safe; nodes of one frame may hit it concurrently.
+ */
+        class NodeOutputCache
+        {
+              public:
+            struct Config {
+                size_t byteBudget = 512ull * 1024 * 1024;
+                size_t maxEntriesPerNode = 4;  // Bounds churn for nodes whose inputs change every frame
+                CacheEvictionPolicy policy = CacheEvictionPolicy::CostAware;
+            };
+
+            NodeOutputCache() = default;
+            explicit NodeOutputCache(const Config &config) : m_config(config) {}
+
+            NodeOutputCache(const NodeOutputCache &) = delete;
+            NodeOutputCache &operator=(const NodeOutputCache &) = delete;
+
+            void setConfig(const Config &config);
+            Config getConfig() const;
+
+            // Copies the cached outputs into 'outputs' on a hit
+            bool lookup(NodeHandle nodeId, uint64_t inputHash, std::vector<PinValue> &outputs);
+            void store(NodeHandle nodeId, uint64_t inputHash, std::vector<PinValue> outputs,
+                       std::vector<std::shared_ptr<const void>> inputRefs, std::chrono::nanoseconds cost);
+            void recordUncacheable(NodeHandle nodeId);
+
+            void invalidateNode(NodeHandle nodeId);
+            void clear();
+
+            NodeCacheStats getStats(NodeHandle nodeId) const;
+            NodeCacheStats getStats(const std::string &nodeId) const;
+            NodeCacheStats getTotalStats() const;
+            std::map<std::string, NodeCacheStats> getAllStats() const;  // Keyed by string id
+            size_t getBytesUsed() const;
+
+            // Approximate memory held by a value (payload bytes for known FrameHandle types)
+            static size_t estimateBytes(const PinValue &value);
+
+              private:
+            struct Entry {
+                NodeHandle nodeId;
+                uint64_t inputHash = 0;
+                std::vector<PinValue> outputs;
+                std::vector<std::shared_ptr<const void>> inputRefs;
+                size_t bytes = 0;
+                double cost = 0.0;  // Recompute time (us)
+                double priority = 0.0;
+            };
+
+            uint64_t makeKey(NodeHandle nodeId, uint64_t inputHash) const;
+            double priorityFor(const Entry &entry);
+            void touch(uint64_t key, Entry &entry);
+            void evict(uint64_t key);  // Budget pressure: counted and ages the clock
+            void erase(uint64_t key);  // Invalidation or replacement
+            void evictForNode(NodeHandle nodeId);
+
+            Config m_config;
+            std::unordered_map<uint64_t, Entry> m_entries;
+            std::set<std::pair<double, uint64_t>> m_evictionQueue;  // (priority, key), lowest evicted first
+            std::unordered_map<NodeHandle, std::vector<uint64_t>> m_nodeEntries;
+            std::unordered_map<NodeHandle, NodeCacheStats> m_stats;
+            size_t m_bytesUsed = 0;
+            double m_inflation = 0.0;  // GreedyDual-Size clock
+            uint64_t m_tick = 0;       // LRU clock
+            mutable std::mutex m_mutex;
+        };
+
+    }  // namespace SceneGraph
+}  // namespace NeuralStudio
+
+/**
+ * @brief Macro to register a GPU resource type whose pins are hashed by generation.
+ *
+ * Usage: REGISTER_PIN_RESOURCE_TYPE(QRhiTexture)
+ * Place it in a .cpp file that passes such pointers through pins.
+ */
+#define REGISTER_PIN_RESOURCE_TYPE(ResourceType)                                    \
+	namespace                                                                   \
+	{                                                                           \
+	NeuralStudio::SceneGraph::PinResourceRegistrar<ResourceType> resourceRegistrar_##ResourceType; \
+	}
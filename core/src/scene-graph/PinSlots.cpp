@@ -0,0 +1,172 @@
+#include "PinSlots.h"
+
+namespace NeuralStudio {
+namespace SceneGraph {
+
+//=============================================================================
+// PinValue
+//=============================================================================
+
+PinValue PinValue::fromAny(const std::any &data)
+{
+	PinValue value;
+	if (!data.has_value())
+		return value;
+
+	const std::type_info &type = data.type();
+	if (type == typeid(float)) {
+		value.set(std::any_cast<float>(data));
+	} else if (type == typeid(bool)) {
+		value.set(std::any_cast<bool>(data));
+	} else if (type == typeid(PinVector3)) {
+		value.set(std::any_cast<const PinVector3 &>(data));
+	} else if (type == typeid(PinColor)) {
+		value.set(std::any_cast<const PinColor &>(data));
+	} else if (type == typeid(PinTransform)) {
+		value.set(std::any_cast<const PinTransform &>(data));
+	} else if (type == typeid(VideoFrameHandle)) {
+		value.set(std::any_cast<const VideoFrameHandle &>(data));
+	} else if (type == typeid(AudioBufferHandle)) {
+		value.set(std::any_cast<const AudioBufferHandle &>(data));
+	} else if (type == typeid(MeshHandle)) {
+		value.set(std::any_cast<const MeshHandle &>(data));
+	} else {
+		// Other FrameHandle<T> types stay boxed; getHandle<T>() still finds them
+		value.m_kind = PinValueKind::Any;
+		value.m_any = data;
+	}
+	return value;
+}
+
+std::any PinValue::toAny() const
+{
+	switch (m_kind) {
+	case PinValueKind::Scalar:
+		return m_inline.scalar;
+	case PinValueKind::Boolean:
+		return m_inline.boolean;
+	case PinValueKind::Vector3:
+		return m_inline.vector3;
+	case PinValueKind::Color:
+		return m_inline.color;
+	case PinValueKind::Transform:
+		return m_inline.transform;
+	case PinValueKind::Handle:
+		return m_handleToAny(m_handle);
+	case PinValueKind::Any:
+		return m_any;
+	case PinValueKind::Empty:
+		break;
+	}
+	return std::any();
+}
+
+//=============================================================================
+// PinStorage
+//=============================================================================
+
+void PinStorage::bind(PinSlotBuffer *buffer, uint32_t baseSlot, const std::vector<PinDescriptor> &inputs,
+		      const std::vector<PinDescriptor> &outputs)
+{
+	std::vector<std::string> slotPins;
+	slotPins.reserve(inputs.size() + outputs.size());
+	for (const auto &pin : inputs)
+		slotPins.push_back(pin.pinId);
+	for (const auto &pin : outputs)
+		slotPins.push_back(pin.pinId);
+
+	// Move current values out of the old slots so nothing is lost across a recompile
+	if (m_buffer) {
+		for (size_t i = 0; i < m_slotPins.size(); ++i) {
+			PinValue &slot = m_buffer->at(m_baseSlot + static_cast<uint32_t>(i));
+			if (!slot.empty())
+				m_unbound[m_slotPins[i]] = std::move(slot);
+			slot.reset();
+		}
+	}
+
+	m_buffer = buffer;
+	m_baseSlot = baseSlot;
+	m_slotPins = std::move(slotPins);
+
+	if (!m_buffer) {
+		m_slotPins.clear();
+		return;
+	}
+
+	for (size_t i = 0; i < m_slotPins.size(); ++i) {
+		auto it = m_unbound.find(m_slotPins[i]);
+		if (it == m_unbound.end())
+			continue;
+		m_buffer->at(m_baseSlot + static_cast<uint32_t>(i)) = std::move(it->second);
+		m_unbound.erase(it);
+	}
+}
+
+int PinStorage::slotOf(const std::string &pinId) const
+{
+	// Nodes have a handful of pins; a linear scan beats hashing here
+	for (size_t i = 0; i < m_slotPins.size(); ++i) {
+		if (m_slotPins[i] == pinId)
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+PinValue *PinStorage::find(const std::string &pinId)
+{
+	return const_cast<PinValue *>(static_cast<const PinStorage *>(this)->find(pinId));
+}
+
+const PinValue *PinStorage::find(const std::string &pinId) const
+{
+	if (m_buffer) {
+		int slot = slotOf(pinId);
+		if (slot >= 0) {
+			const PinValue &value = m_buffer->at(m_baseSlot + static_cast<uint32_t>(slot));
+			return value.empty() ? nullptr : &value;
+		}
+	}
+
+	auto it = m_unbound.find(pinId);
+	return (it != m_unbound.end() && !it->second.empty()) ? &it->second : nullptr;
+}
+
+PinValue &PinStorage::value(const std::string &pinId)
+{
+	if (m_buffer) {
+		int slot = slotOf(pinId);
+		if (slot >= 0)
+			return m_buffer->at(m_baseSlot + static_cast<uint32_t>(slot));
+	}
+	return m_unbound[pinId];
+}
+
+PinStamp PinStorage::stamp(const std::string &pinId) const
+{
+	if (m_buffer) {
+		int slot = slotOf(pinId);
+		if (slot >= 0)
+			return m_buffer->stampAt(m_baseSlot + static_cast<uint32_t>(slot));
+	}
+	return PinStamp();
+}
+
+void PinStorage::set(const std::string &pinId, const std::any &data)
+{
+	value(pinId) = PinValue::fromAny(data);
+}
+
+std::any PinStorage::get(const std::string &pinId) const
+{
+	const PinValue *value = find(pinId);
+	return value ? value->toAny() : std::any();
+}
+
+bool PinStorage::has(const std::string &pinId) const
+{
+	return find(pinId) != nullptr;
+}
+
+} // namespace SceneGraph
+} // namespace NeuralStudio
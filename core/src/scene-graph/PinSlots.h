@@ -0,0 +1,298 @@
+#pragma once
+
+#include "IExecutableNode.h"
+#include "FrameHandle.h"
+#include <any>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+namespace NeuralStudio {
+    namespace SceneGraph {
+
+        //=============================================================================
+        // Inline Primitive Pin Types
+        //=============================================================================
+
+        // Value types matching DataType::Vector3(), Color() and Transform().
+        // Nodes that write these (instead of ad-hoc structs) get inline slot storage.
+        struct PinVector3 {
+            float x = 0.0f;
+            float y = 0.0f;
+            float z = 0.0f;
+
+            bool operator==(const PinVector3 &other) const = default;
+        };
+
+        struct PinColor {
+            float r = 0.0f;
+            float g = 0.0f;
+            float b = 0.0f;
+            float a = 1.0f;
+
+            bool operator==(const PinColor &other) const = default;
+        };
+
+        struct PinTransform {
+            // Column-major 4x4 matrix
+            std::array<float, 16> m = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+            bool operator==(const PinTransform &other) const = default;
+        };
+
+        enum class PinValueKind : uint8_t {
+            Empty,
+            Scalar,     // float
+            Boolean,    // bool
+            Vector3,    // PinVector3
+            Color,      // PinColor
+            Transform,  // PinTransform
+            Handle,     // FrameHandle<T>: shared immutable payload, copies are a refcount bump
+            Any         // Everything else (textures, strings...) via std::any
+        };
+
+        //=============================================================================
+        // Pin Value
+        //=============================================================================
+
+        /**
+ * @brief One pin's value. Primitives live inline, other types in a std::any.
+ *
+ * Copying a primitive PinValue is a small memcpy with no allocation or
+ * type-erased dispatch, and copying a FrameHandle only bumps its reference
+ * count, which is what keeps per-frame propagation cheap.
+ */
+        class PinValue
+        {
+              public:
+            PinValue() = default;
+
+            static PinValue fromAny(const std::any &data);
+            std::any toAny() const;
+
+            PinValueKind kind() const
+            {
+                return m_kind;
+            }
+            bool empty() const
+            {
+                return m_kind == PinValueKind::Empty;
+            }
+            void reset()
+            {
+                m_kind = PinValueKind::Empty;
+                m_any.reset();
+                m_handle.reset();
+            }
+
+            template<typename T> void set(const T &value)
+            {
+                using U = std::decay_t<T>;
+                m_any.reset();
+                m_handle.reset();
+                if constexpr (IsFrameHandle<U>::value) {
+                    m_kind = PinValueKind::Handle;
+                    m_handle = value.shared();
+                    m_handleType = &typeid(typename U::ValueType);
+                    m_handleToAny = [](const std::shared_ptr<const void> &handle) -> std::any {
+                        return U(std::static_pointer_cast<const typename U::ValueType>(handle));
+                    };
+                } else if constexpr (std::is_same_v<U, float>) {
+                    m_kind = PinValueKind::Scalar;
+                    m_inline.scalar = value;
+                } else if constexpr (std::is_same_v<U, bool>) {
+                    m_kind = PinValueKind::Boolean;
+                    m_inline.boolean = value;
+                } else if constexpr (std::is_same_v<U, PinVector3>) {
+                    m_kind = PinValueKind::Vector3;
+                    m_inline.vector3 = value;
+                } else if constexpr (std::is_same_v<U, PinColor>) {
+                    m_kind = PinValueKind::Color;
+                    m_inline.color = value;
+                } else if constexpr (std::is_same_v<U, PinTransform>) {
+                    m_kind = PinValueKind::Transform;
+                    m_inline.transform = value;
+                } else if constexpr (std::is_same_v<U, std::any>) {
+                    *this = fromAny(value);
+                } else {
+                    m_kind = PinValueKind::Any;
+                    m_any = value;
+                }
+            }
+
+            // Returns nullptr if the stored value is not a T
+            template<typename T> const T *getIf() const
+            {
+                if constexpr (std::is_same_v<T, float>) {
+                    return m_kind == PinValueKind::Scalar ? &m_inline.scalar : nullptr;
+                } else if constexpr (std::is_same_v<T, bool>) {
+                    return m_kind == PinValueKind::Boolean ? &m_inline.boolean : nullptr;
+                } else if constexpr (std::is_same_v<T, PinVector3>) {
+                    return m_kind == PinValueKind::Vector3 ? &m_inline.vector3 : nullptr;
+                } else if constexpr (std::is_same_v<T, PinColor>) {
+                    return m_kind == PinValueKind::Color ? &m_inline.color : nullptr;
+                } else if constexpr (std::is_same_v<T, PinTransform>) {
+                    return m_kind == PinValueKind::Transform ? &m_inline.transform : nullptr;
+                } else {
+                    return m_kind == PinValueKind::Any ? std::any_cast<T>(&m_any) : nullptr;
+                }
+            }
+
+            template<typename T> T *getIf()
+            {
+                return const_cast<T *>(static_cast<const PinValue *>(this)->getIf<T>());
+            }
+
+            // Returns an empty handle if the stored value is not a FrameHandle<T>
+            template<typename T> FrameHandle<T> getHandle() const
+            {
+                if (m_kind == PinValueKind::Handle && *m_handleType == typeid(T)) {
+                    return FrameHandle<T>(std::static_pointer_cast<const T>(m_handle));
+                }
+                if (m_kind == PinValueKind::Any) {
+                    if (const auto *handle = std::any_cast<FrameHandle<T>>(&m_any))
+                        return *handle;
+                }
+                return FrameHandle<T>();
+            }
+
+            // Raw access for hashing/caching: the boxed value (Any kind) and the shared
+            // payload with its element type (Handle kind); nullptr otherwise.
+            const std::any *anyValue() const
+            {
+                return m_kind == PinValueKind::Any ? &m_any : nullptr;
+            }
+            const std::shared_ptr<const void> &handleRef() const
+            {
+                return m_handle;
+            }
+            const std::type_info *handleType() const
+            {
+                return m_kind == PinValueKind::Handle ? m_handleType : nullptr;
+            }
+
+              private:
+            union InlineStorage {
+                float scalar;
+                bool boolean;
+                PinVector3 vector3;
+                PinColor color;
+                PinTransform transform;
+
+                InlineStorage() : scalar(0.0f) {}
+            };
+
+            PinValueKind m_kind = PinValueKind::Empty;
+            InlineStorage m_inline;
+            std::any m_any;
+
+            // Handle kind: type-erased payload plus what is needed to rebuild the FrameHandle<T>
+            std::shared_ptr<const void> m_handle;
+            const std::type_info *m_handleType = nullptr;
+            std::any (*m_handleToAny)(const std::shared_ptr<const void> &) = nullptr;
+        };
+
+        // Provenance of a pin value. Only pipelined (async) outputs are stamped;
+        // a zero stamp means the value was produced in the current frame.
+        struct PinStamp {
+            uint64_t frameNumber = 0;  // Frame whose inputs produced the value
+            int64_t producedAtNs = 0;  // steady_clock time the value became available
+        };
+
+        //=============================================================================
+        // Pin Slot Buffer
+        //=============================================================================
+
+        /**
+ * @brief Contiguous per-graph pin storage, laid out by NodeExecutionGraph::compile().
+ *
+ * Each bound node owns a dense range starting at its base slot: its input
+ * pins first (in getInputPins() order), then its output pins.
+ */
+        class PinSlotBuffer
+        {
+              public:
+            explicit PinSlotBuffer(size_t slotCount) : m_slots(slotCount), m_stamps(slotCount) {}
+
+            PinValue &at(uint32_t slot)
+            {
+                return m_slots[slot];
+            }
+            const PinValue &at(uint32_t slot) const
+            {
+                return m_slots[slot];
+            }
+            size_t size() const
+            {
+                return m_slots.size();
+            }
+
+            PinStamp &stampAt(uint32_t slot)
+            {
+                return m_stamps[slot];
+            }
+            const PinStamp &stampAt(uint32_t slot) const
+            {
+                return m_stamps[slot];
+            }
+
+              private:
+            std::vector<PinValue> m_slots;
+            std::vector<PinStamp> m_stamps;
+        };
+
+        //=============================================================================
+        // Pin Storage (node-side)
+        //=============================================================================
+
+        /**
+ * @brief Node-side pin store shared by BaseNodeBackend and AINodeBase.
+ *
+ * When bound to a PinSlotBuffer, declared pins resolve to graph slots;
+ * otherwise (or for undeclared pin ids) values live in a local map.
+ * The string-keyed accessors are the slow-path adapter for the
+ * IExecutableNode::setPinData/getPinData API.
+ */
+        class PinStorage
+        {
+              public:
+            // Rebinds to a new buffer (nullptr = unbind), migrating current values
+            void bind(PinSlotBuffer *buffer, uint32_t baseSlot, const std::vector<PinDescriptor> &inputs,
+                      const std::vector<PinDescriptor> &outputs);
+            bool isBound() const
+            {
+                return m_buffer != nullptr;
+            }
+
+            // String-keyed access (slow path)
+            void set(const std::string &pinId, const std::any &data);
+            std::any get(const std::string &pinId) const;
+            bool has(const std::string &pinId) const;
+
+            PinValue *find(const std::string &pinId);
+            const PinValue *find(const std::string &pinId) const;
+            PinValue &value(const std::string &pinId);  // Creates an empty value if missing
+            PinStamp stamp(const std::string &pinId) const;  // Zero stamp when unbound
+
+            // Slot-ordered access (inputs first, then outputs). Falls back to the
+            // pin id when unbound.
+            PinValue &valueAt(size_t localSlot, const std::string &pinId)
+            {
+                return m_buffer ? m_buffer->at(m_baseSlot + static_cast<uint32_t>(localSlot)) : m_unbound[pinId];
+            }
+
+              private:
+            int slotOf(const std::string &pinId) const;
+
+            PinSlotBuffer *m_buffer = nullptr;
+            uint32_t m_baseSlot = 0;
+            std::vector<std::string> m_slotPins;  // Pin id per local slot
+            std::map<std::string, PinValue> m_unbound;
+        };
+
+    }  // namespace SceneGraph
+}  // namespace NeuralStudio
@@ -12,6 +12,9 @@ namespace SceneGraph {
 SceneGraphManager::SceneGraphManager()
 {
 	m_nodeGraph = std::make_unique<NodeExecutionGraph>();
+
+	// Only evaluate what feeds an active output; markDirty() reports outside changes
+	m_nodeGraph->setEvaluationMode(EvaluationMode::Demand);
 }
 
 SceneGraphManager::~SceneGraphManager()
@@ -55,6 +58,7 @@ void SceneGraphManager::update(double deltaTime)
 
 	// Update Context
 	m_executionContext.deltaTime = deltaTime;
+	m_executionContext.timeNs += static_cast<int64_t>(deltaTime * 1e9);
 	m_executionContext.frameNumber++;
 
 	// Execute Graph
@@ -111,7 +115,7 @@ bool SceneGraphManager::deleteNode(const std::string &id)
 	m_nodeGraph->removeNode(id);
 
 	// 2. Cleanup Scene resources if tracked
-	// auto it = m_nodeToSceneId.find(id);
+	// auto it = m_nodeToSceneId.find(findId(id));
 	// if (it != m_nodeToSceneId.end()) {
 	//     m_sceneManager->RemoveNode(it->second);
 	//     m_nodeToSceneId.erase(it);
@@ -130,7 +134,9 @@ bool SceneGraphManager::connectNodes(const std::string &srcId, const std::string
 
 void SceneGraphManager::markDirty(const std::string &nodeId)
 {
-	// Signal graph to re-evaluate or invalidate cache
+	// Re-evaluated (with everything downstream of it) on the next update()
+	if (m_nodeGraph)
+		m_nodeGraph->markDirty(nodeId);
 }
 
 } // namespace SceneGraph
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include "NodeExecutionGraph.h"
 
 // Forward Declarations
@@ -53,7 +54,7 @@ namespace NeuralStudio {
                               const std::string &dstPin);
 
             // Synchronization
-            void markDirty(const std::string &nodeId);  // Flag for update
+            void markDirty(const std::string &nodeId);  // Flag for update (property or input changed outside the graph)
 
               private:
             // Core Subsystems
@@ -65,9 +66,9 @@ namespace NeuralStudio {
             ExecutionContext m_executionContext;
 
             // Mapping
-            // Blueprint ID (String) -> Scene ID (uint32_t)
-            std::map<std::string, uint32_t> m_nodeToSceneId;
-            std::map<uint32_t, std::string> m_sceneToNodeId;
+            // Blueprint ID (interned) -> Scene ID (uint32_t)
+            std::unordered_map<NodeHandle, uint32_t> m_nodeToSceneId;
+            std::unordered_map<uint32_t, NodeHandle> m_sceneToNodeId;
         };
 
     }  // namespace SceneGraph
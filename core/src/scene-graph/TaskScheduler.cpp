@@ -0,0 +1,239 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace NeuralStudio {
+namespace SceneGraph {
+
+namespace {
+// Identifies the worker the current thread belongs to (if any), so that
+// submissions from inside a task land on the submitting worker's own deque.
+thread_local const TaskScheduler *t_currentScheduler = nullptr;
+thread_local size_t t_currentWorker = 0;
+
+constexpr int kSpinBeforeSleep = 64;
+} // namespace
+
+TaskScheduler::TaskScheduler() : TaskScheduler(Config()) {}
+
+TaskScheduler::TaskScheduler(const Config &config) : m_config(config)
+{
+	size_t workerCount = m_config.workerCount;
+	if (workerCount == 0) {
+		unsigned int hw = std::thread::hardware_concurrency();
+		workerCount = hw > 1 ? hw - 1 : 0;
+	}
+	m_config.workerCount = workerCount;
+
+	// Always keep at least one queue so a worker-less scheduler still works
+	// (the thread calling wait() then runs everything).
+	size_t queueCount = std::max<size_t>(workerCount, 1);
+	m_queues.reserve(queueCount);
+	for (size_t i = 0; i < queueCount; ++i) {
+		m_queues.push_back(std::make_unique<WorkerQueue>());
+	}
+
+	m_workers.reserve(workerCount);
+	for (size_t i = 0; i < workerCount; ++i) {
+		m_workers.emplace_back([this, i]() { workerLoop(i); });
+	}
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_stopping.store(true, std::memory_order_release);
+	}
+	m_sleepCondition.notify_all();
+
+	for (auto &worker : m_workers) {
+		if (worker.joinable())
+			worker.join();
+	}
+}
+
+//=============================================================================
+// Submission
+//=============================================================================
+
+void TaskScheduler::submit(TaskGroup &group, Task task)
+{
+	group.m_pending.fetch_add(1, std::memory_order_relaxed);
+
+	size_t queueIndex;
+	if (t_currentScheduler == this) {
+		queueIndex = t_currentWorker;
+	} else {
+		queueIndex = m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+	}
+
+	{
+		auto &queue = *m_queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(QueuedTask{std::move(task), &group});
+	}
+	m_queuedTasks.fetch_add(1, std::memory_order_release);
+
+	// Touch the sleep mutex so a worker between its predicate check and
+	// its wait cannot miss this notification.
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+	m_sleepCondition.notify_one();
+}
+
+void TaskScheduler::wait(TaskGroup &group)
+{
+	const bool isWorker = t_currentScheduler == this;
+	QueuedTask task;
+
+	while (!group.isDone()) {
+		bool found = isWorker ? popLocal(t_currentWorker, task) : false;
+		if (!found) {
+			found = steal(isWorker ? t_currentWorker : m_queues.size(), task);
+		}
+
+		if (found) {
+			runTask(task);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(group.m_errorMutex);
+		error = std::exchange(group.m_error, nullptr);
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+//=============================================================================
+// Workers
+//=============================================================================
+
+void TaskScheduler::workerLoop(size_t workerIndex)
+{
+	t_currentScheduler = this;
+	t_currentWorker = workerIndex;
+	applyAffinity(workerIndex);
+
+	QueuedTask task;
+	int idleSpins = 0;
+
+	while (!m_stopping.load(std::memory_order_acquire)) {
+		if (popLocal(workerIndex, task) || steal(workerIndex, task)) {
+			runTask(task);
+			idleSpins = 0;
+			continue;
+		}
+
+		if (++idleSpins < kSpinBeforeSleep) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_sleepCondition.wait(lock, [this]() {
+			return m_stopping.load(std::memory_order_acquire) ||
+			       m_queuedTasks.load(std::memory_order_acquire) > 0;
+		});
+		idleSpins = 0;
+	}
+
+	t_currentScheduler = nullptr;
+}
+
+bool TaskScheduler::popLocal(size_t workerIndex, QueuedTask &out)
+{
+	auto &queue = *m_queues[workerIndex];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.tasks.empty())
+		return false;
+
+	// LIFO for the owner: the most recently released successor is likely
+	// to consume data that is still hot in this core's cache.
+	out = std::move(queue.tasks.back());
+	queue.tasks.pop_back();
+	m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+bool TaskScheduler::steal(size_t thiefIndex, QueuedTask &out)
+{
+	const size_t queueCount = m_queues.size();
+	for (size_t offset = 1; offset <= queueCount; ++offset) {
+		size_t victim = (thiefIndex + offset) % queueCount;
+		if (victim == thiefIndex)
+			continue;
+
+		auto &queue = *m_queues[victim];
+		std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+		if (!lock.owns_lock() || queue.tasks.empty())
+			continue;
+
+		// FIFO for thieves: take the oldest work, leave the owner its hot tail
+		out = std::move(queue.tasks.front());
+		queue.tasks.pop_front();
+		m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+void TaskScheduler::runTask(QueuedTask &task)
+{
+	// Counts the task as done however it exits, or wait() would spin forever
+	struct Completion {
+		QueuedTask &task;
+		~Completion()
+		{
+			TaskGroup *group = task.group;
+			task.task = nullptr;
+			group->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+		}
+	} completion {task};
+
+	try {
+		task.task();
+	} catch (...) {
+		// Workers have nobody to throw to; the waiter rethrows it
+		std::lock_guard<std::mutex> lock(task.group->m_errorMutex);
+		if (!task.group->m_error) {
+			task.group->m_error = std::current_exception();
+		}
+	}
+}
+
+void TaskScheduler::applyAffinity(size_t workerIndex)
+{
+	if (workerIndex >= m_config.coreAffinity.size())
+		return;
+
+	int core = m_config.coreAffinity[workerIndex];
+	if (core < 0)
+		return;
+
+#ifdef __linux__
+	if (core >= CPU_SETSIZE)
+		return; // Beyond what cpu_set_t can describe; run unpinned
+
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	CPU_SET(core, &cpuset);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#else
+	(void)core; // Affinity is advisory; unsupported platforms run unpinned
+#endif
+}
+
+} // namespace SceneGraph
+} // namespace NeuralStudio
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NeuralStudio {
+    namespace SceneGraph {
+
+        //=============================================================================
+        // Task Group
+        //=============================================================================
+
+        /**
+ * @brief Tracks the tasks submitted for one unit of work (e.g. one graph frame).
+ *
+ * TaskScheduler::wait() returns once every task submitted against the group
+ * (including tasks submitted from inside other tasks of the group) has run.
+ * A task that throws still counts as run; the first exception is kept and
+ * rethrown by wait().
+ */
+        class TaskGroup
+        {
+              public:
+            bool isDone() const
+            {
+                return m_pending.load(std::memory_order_acquire) == 0;
+            }
+
+              private:
+            friend class TaskScheduler;
+            std::atomic<size_t> m_pending {0};
+
+            std::mutex m_errorMutex;
+            std::exception_ptr m_error;  // First exception thrown by a task
+        };
+
+        //=============================================================================
+        // Task Scheduler
+        //=============================================================================
+
+        /**
+ * @brief Persistent work-stealing thread pool.
+ *
+ * Each worker owns a deque: it pushes and pops its own work LIFO (cache-warm
+ * continuation of the node it just finished) and steals FIFO from the other
+ * workers when its deque runs dry. Threads are created once and live as long
+ * as the scheduler, so per-frame execution never spawns OS threads.
+ */
+        class TaskScheduler
+        {
+              public:
+            using Task = std::function<void()>;
+
+            struct Config {
+                // 0 = std::thread::hardware_concurrency() - 1 (the caller of wait() also runs tasks)
+                size_t workerCount = 0;
+                // Optional CPU core per worker (index i pins worker i). Empty = no pinning;
+                // negative or out-of-range (>= CPU_SETSIZE) entries leave that worker unpinned.
+                std::vector<int> coreAffinity;
+            };
+
+            TaskScheduler();
+            explicit TaskScheduler(const Config &config);
+            ~TaskScheduler();
+
+            TaskScheduler(const TaskScheduler &) = delete;
+            TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+            // Submit a task. From a worker thread the task goes to that worker's
+            // own deque, otherwise it is distributed round-robin.
+            void submit(TaskGroup &group, Task task);
+
+            // Block until all tasks of the group have completed. The calling
+            // thread executes queued tasks while it waits. Rethrows the first
+            // exception a task of the group threw, once all of them are done.
+            void wait(TaskGroup &group);
+
+            size_t getWorkerCount() const
+            {
+                return m_workers.size();
+            }
+            const Config &getConfig() const
+            {
+                return m_config;
+            }
+
+              private:
+            struct QueuedTask {
+                Task task;
+                TaskGroup *group = nullptr;
+            };
+
+            struct WorkerQueue {
+                std::mutex mutex;
+                std::deque<QueuedTask> tasks;
+            };
+
+            void workerLoop(size_t workerIndex);
+            bool popLocal(size_t workerIndex, QueuedTask &out);
+            bool steal(size_t thiefIndex, QueuedTask &out);
+            void runTask(QueuedTask &task);
+            void applyAffinity(size_t workerIndex);
+
+            Config m_config;
+            std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+            std::vector<std::thread> m_workers;
+
+            std::atomic<size_t> m_queuedTasks {0};
+            std::atomic<size_t> m_nextQueue {0};
+            std::atomic<bool> m_stopping {false};
+
+            std::mutex m_sleepMutex;
+            std::condition_variable m_sleepCondition;
+        };
+
+    }  // namespace SceneGraph
+}  // namespace NeuralStudio
@@ -0,0 +1,500 @@
+#include "NodeExecutionGraph.h"
+#include "BaseNodeBackend.h"
+#include "NodeFactory.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <type_traits>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace NeuralStudio::SceneGraph;
+
+namespace {
+
+//=============================================================================
+// Synthetic nodes
+//=============================================================================
+
+// Shared by every bench node; set before the graph is built
+struct BenchNodeConfig {
+	std::chrono::microseconds cost {0};
+	size_t payloadBytes = 0;
+	uint32_t distinctInputs = 4; // Sources cycle through this many payloads
+};
+BenchNodeConfig g_config;
+
+std::atomic<int64_t> g_liveBytes {0};
+std::atomic<int64_t> g_peakLiveBytes {0};
+
+// Pin payload: a value plus a block of bytes standing in for a frame or buffer
+struct BenchPayload {
+	explicit BenchPayload(float v) : value(v), bytes(g_config.payloadBytes, static_cast<uint8_t>(v))
+	{
+		int64_t live = g_liveBytes.fetch_add(static_cast<int64_t>(bytes.size())) + bytes.size();
+		int64_t peak = g_peakLiveBytes.load();
+		while (live > peak && !g_peakLiveBytes.compare_exchange_weak(peak, live)) {
+		}
+	}
+	~BenchPayload() { g_liveBytes.fetch_sub(static_cast<int64_t>(bytes.size())); }
+
+	float value;
+	std::vector<uint8_t> bytes;
+};
+using BenchHandle = FrameHandle<BenchPayload>;
+
+DataType benchType()
+{
+	return DataType(DataCategory::Composite, "BenchPayload");
+}
+
+class BenchNodeBase : public BaseNodeBackend {
+public:
+	BenchNodeBase(const std::string &id, const std::string &type) : BaseNodeBackend(id, type) {}
+
+protected:
+	float inputValue(const std::string &pinId)
+	{
+		BenchHandle handle = getInputHandle<BenchPayload>(pinId);
+		return handle ? handle->value : 0.0f;
+	}
+
+	// Burns the configured cost, touching the payload so it is not optimized away
+	float burn(float value)
+	{
+		auto end = std::chrono::steady_clock::now() + g_config.cost;
+		while (std::chrono::steady_clock::now() < end) {
+			value = value * 0.5f + 1.0f;
+		}
+		return value;
+	}
+};
+
+// Publishes one of g_config.distinctInputs prebuilt payloads, chosen by frame
+class BenchSourceNode : public BenchNodeBase {
+public:
+	explicit BenchSourceNode(const std::string &id) : BenchNodeBase(id, "BenchSource")
+	{
+		addOutput("out", "Out", benchType());
+		for (uint32_t i = 0; i < std::max<uint32_t>(g_config.distinctInputs, 1); ++i) {
+			m_payloads.push_back(BenchHandle::make(static_cast<float>(i)));
+		}
+	}
+
+	bool isTimeVarying() const override { return true; }
+
+	ExecutionResult process(ExecutionContext &ctx) override
+	{
+		setOutputData("out", m_payloads[ctx.frameNumber % m_payloads.size()]);
+		return ExecutionResult::success();
+	}
+
+private:
+	std::vector<BenchHandle> m_payloads;
+};
+
+class BenchUnaryNode : public BenchNodeBase {
+public:
+	explicit BenchUnaryNode(const std::string &id) : BenchNodeBase(id, "BenchUnary")
+	{
+		addInput("in", "In", benchType());
+		addOutput("out", "Out", benchType());
+	}
+
+	ExecutionResult process(ExecutionContext &) override
+	{
+		setOutputData("out", BenchHandle::make(burn(inputValue("in") + 1.0f)));
+		return ExecutionResult::success();
+	}
+};
+
+class BenchBinaryNode : public BenchNodeBase {
+public:
+	explicit BenchBinaryNode(const std::string &id) : BenchNodeBase(id, "BenchBinary")
+	{
+		addInput("in_a", "In A", benchType());
+		addInput("in_b", "In B", benchType());
+		addOutput("out", "Out", benchType());
+	}
+
+	ExecutionResult process(ExecutionContext &) override
+	{
+		setOutputData("out", BenchHandle::make(burn(inputValue("in_a") + inputValue("in_b"))));
+		return ExecutionResult::success();
+	}
+};
+
+} // namespace
+
+REGISTER_NODE_TYPE(BenchSourceNode, "BenchSource")
+REGISTER_NODE_TYPE(BenchUnaryNode, "BenchUnary")
+REGISTER_NODE_TYPE(BenchBinaryNode, "BenchBinary")
+
+namespace {
+
+//=============================================================================
+// Graph shapes
+//=============================================================================
+
+class GraphBuilder {
+public:
+	explicit GraphBuilder(NodeExecutionGraph &graph) : m_graph(graph) {}
+
+	std::string add(const std::string &type)
+	{
+		std::string id = "n" + std::to_string(m_count++);
+		auto node = NodeFactory::create(type, id);
+		if (!node) {
+			std::cerr << "Node type not registered: " << type << std::endl;
+			std::exit(1);
+		}
+		m_graph.addNode(node);
+		return id;
+	}
+
+	void connect(const std::string &source, const std::string &target, const char *pin)
+	{
+		if (!m_graph.connectPins(source, "out", target, pin)) {
+			std::cerr << "Failed to connect " << source << " -> " << target << "." << pin << std::endl;
+			std::exit(1);
+		}
+	}
+
+	int count() const { return m_count; }
+
+private:
+	NodeExecutionGraph &m_graph;
+	int m_count = 0;
+};
+
+// source -> unary -> unary -> ...
+void buildChain(GraphBuilder &builder, int nodeCount, std::mt19937 &)
+{
+	std::string previous = builder.add("BenchSource");
+	while (builder.count() < nodeCount) {
+		std::string id = builder.add("BenchUnary");
+		builder.connect(previous, id, "in");
+		previous = id;
+	}
+}
+
+// One source feeding every other node
+void buildFanOut(GraphBuilder &builder, int nodeCount, std::mt19937 &)
+{
+	std::string source = builder.add("BenchSource");
+	while (builder.count() < nodeCount) {
+		builder.connect(source, builder.add("BenchUnary"), "in");
+	}
+}
+
+// Stacked diamonds: top -> (left, right) -> bottom, bottom is the next top
+void buildDiamonds(GraphBuilder &builder, int nodeCount, std::mt19937 &)
+{
+	std::string top = builder.add("BenchSource");
+	while (builder.count() + 3 <= nodeCount) {
+		std::string left = builder.add("BenchUnary");
+		std::string right = builder.add("BenchUnary");
+		std::string bottom = builder.add("BenchBinary");
+		builder.connect(top, left, "in");
+		builder.connect(top, right, "in");
+		builder.connect(left, bottom, "in_a");
+		builder.connect(right, bottom, "in_b");
+		top = bottom;
+	}
+	while (builder.count() < nodeCount) {
+		std::string id = builder.add("BenchUnary");
+		builder.connect(top, id, "in");
+		top = id;
+	}
+}
+
+// Every node reads one or two random earlier nodes; ~1% extra sources
+void buildRandom(GraphBuilder &builder, int nodeCount, std::mt19937 &rng)
+{
+	std::vector<std::string> ids {builder.add("BenchSource")};
+	std::uniform_real_distribution<double> chance(0.0, 1.0);
+	while (builder.count() < nodeCount) {
+		if (chance(rng) < 0.01) {
+			ids.push_back(builder.add("BenchSource"));
+			continue;
+		}
+		std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+		std::string id = builder.add("BenchBinary");
+		builder.connect(ids[pick(rng)], id, "in_a");
+		if (chance(rng) < 0.5) {
+			builder.connect(ids[pick(rng)], id, "in_b");
+		}
+		ids.push_back(id);
+	}
+}
+
+using ShapeBuilder = void (*)(GraphBuilder &, int, std::mt19937 &);
+
+struct Shape {
+	const char *name;
+	ShapeBuilder build;
+};
+
+const Shape kShapes[] = {
+	{"chain", buildChain},
+	{"fanout", buildFanOut},
+	{"diamond", buildDiamonds},
+	{"random", buildRandom},
+};
+
+//=============================================================================
+// Measurement
+//=============================================================================
+
+struct BenchOptions {
+	std::vector<std::string> shapes {"chain", "fanout", "diamond", "random"};
+	std::vector<int> sizes {10, 100, 1000, 10000};
+	int frames = 200;
+	int64_t maxEvaluations = 500000; // Caps frames for the large graphs
+	int workers = 0;                  // 0 = hardware_concurrency - 1
+	unsigned seed = 1;
+	bool csv = false;
+};
+
+struct BenchResult {
+	std::string shape;
+	int nodes = 0;
+	size_t edges = 0;
+	int frames = 0;
+	double buildMs = 0.0;
+	double compileMs = 0.0;
+	double recompileMs = 0.0; // Incremental compile after one added edge
+	double serialUs = 0.0;    // Per frame
+	double parallelUs = 0.0;
+	double cachedUs = 0.0; // Serial, caching on
+	double cacheHitRate = 0.0;
+	size_t cacheBytes = 0;
+	int64_t peakPayloadBytes = 0;
+	bool ok = true;
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename Execute> double timeFrames(int frames, bool &ok, Execute execute)
+{
+	ExecutionContext ctx;
+	for (int f = 0; f < 3; ++f) {
+		ctx.frameNumber = f;
+		ok = execute(ctx) && ok; // Warm-up
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (int f = 0; f < frames; ++f) {
+		ctx.frameNumber = f;
+		ok = execute(ctx) && ok;
+	}
+	return elapsedMs(start) * 1000.0 / frames;
+}
+
+BenchResult runBench(const Shape &shape, int nodeCount, const BenchOptions &options)
+{
+	BenchResult result;
+	result.shape = shape.name;
+	result.frames = static_cast<int>(std::clamp<int64_t>(options.maxEvaluations / nodeCount, 5, options.frames));
+	g_peakLiveBytes.store(g_liveBytes.load());
+
+	NodeExecutionGraph graph;
+	TaskScheduler::Config schedulerConfig;
+	schedulerConfig.workerCount = static_cast<size_t>(options.workers);
+	graph.setSchedulerConfig(schedulerConfig);
+	graph.enableCaching(false);
+
+	std::mt19937 rng(options.seed);
+	auto start = std::chrono::steady_clock::now();
+	GraphBuilder builder(graph);
+	shape.build(builder, nodeCount, rng);
+	result.buildMs = elapsedMs(start);
+	result.nodes = builder.count();
+	result.edges = graph.getConnections().size();
+
+	start = std::chrono::steady_clock::now();
+	if (!graph.compile()) {
+		std::cerr << shape.name << "/" << nodeCount << ": graph failed to compile" << std::endl;
+		result.ok = false;
+		return result;
+	}
+	result.compileMs = elapsedMs(start);
+
+	// Edit + recompile: a fresh sink reading the first node
+	std::string sink = builder.add("BenchUnary");
+	builder.connect("n0", sink, "in");
+	start = std::chrono::steady_clock::now();
+	result.ok = graph.compile();
+	result.recompileMs = elapsedMs(start);
+
+	result.serialUs = timeFrames(result.frames, result.ok, [&](ExecutionContext &ctx) { return graph.execute(ctx); });
+	result.parallelUs =
+		timeFrames(result.frames, result.ok, [&](ExecutionContext &ctx) { return graph.executeParallel(ctx); });
+
+	// Sources cycle through distinctInputs payloads, so everything downstream
+	// can be served from the cache once each variant has been seen
+	graph.enableCaching(true);
+	graph.clearCache();
+	result.cachedUs = timeFrames(result.frames, result.ok, [&](ExecutionContext &ctx) { return graph.execute(ctx); });
+	NodeCacheStats stats = graph.getCache().getTotalStats();
+	uint64_t lookups = stats.hits + stats.misses;
+	result.cacheHitRate = lookups ? static_cast<double>(stats.hits) / lookups : 0.0;
+	result.cacheBytes = graph.getCache().getBytesUsed();
+	result.peakPayloadBytes = g_peakLiveBytes.load();
+
+	if (!result.ok) {
+		std::cerr << shape.name << "/" << nodeCount << ": execution failed" << std::endl;
+	}
+	return result;
+}
+
+// Peak resident set of the process in KiB (0 where unsupported)
+long peakRssKb()
+{
+#if defined(__linux__)
+	struct rusage usage;
+	return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+#elif defined(__APPLE__)
+	struct rusage usage;
+	return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss / 1024 : 0;
+#else
+	return 0;
+#endif
+}
+
+void printResult(const BenchResult &r, bool csv)
+{
+	if (csv) {
+		std::cout << r.shape << ',' << r.nodes << ',' << r.edges << ',' << r.frames << ',' << r.buildMs << ','
+			  << r.compileMs << ',' << r.recompileMs << ',' << r.serialUs << ',' << r.parallelUs << ','
+			  << r.cachedUs << ',' << r.cacheHitRate << ',' << r.cacheBytes << ',' << r.peakPayloadBytes
+			  << ',' << peakRssKb() << ',' << (r.ok ? "ok" : "FAILED") << std::endl;
+		return;
+	}
+
+	std::cout << std::left << std::setw(8) << r.shape << std::right << std::setw(7) << r.nodes << std::setw(8)
+		  << r.edges << std::setw(6) << r.frames << std::setw(10) << r.compileMs << std::setw(10)
+		  << r.recompileMs << std::setw(12) << r.serialUs << std::setw(12) << r.parallelUs << std::setw(8)
+		  << (r.parallelUs > 0.0 ? r.serialUs / r.parallelUs : 0.0) << std::setw(12) << r.cachedUs
+		  << std::setw(7) << r.cacheHitRate * 100.0 << '%' << std::setw(10) << r.cacheBytes / 1024
+		  << std::setw(10) << r.peakPayloadBytes / 1024 << std::setw(10) << peakRssKb()
+		  << (r.ok ? "" : "  FAILED") << std::endl;
+}
+
+template<typename T> std::vector<T> parseList(const char *text)
+{
+	std::vector<T> values;
+	std::stringstream stream(text);
+	std::string item;
+	while (std::getline(stream, item, ',')) {
+		if (item.empty())
+			continue;
+		if constexpr (std::is_same_v<T, int>) {
+			values.push_back(std::atoi(item.c_str()));
+		} else {
+			values.push_back(item);
+		}
+	}
+	return values;
+}
+
+void printUsage(const char *program)
+{
+	std::cout << "Usage: " << program << " [options]\n"
+		  << "  --shapes LIST      chain,fanout,diamond,random (default: all)\n"
+		  << "  --sizes LIST       node counts (default: 10,100,1000,10000)\n"
+		  << "  --frames N         frames per measurement, capped for large graphs (default: 200)\n"
+		  << "  --cost-us N        busy time per node evaluation (default: 0)\n"
+		  << "  --payload-bytes N  bytes per output payload (default: 0)\n"
+		  << "  --distinct N       distinct source payloads, drives cache reuse (default: 4)\n"
+		  << "  --workers N        parallel workers, 0 = hardware_concurrency - 1 (default: 0)\n"
+		  << "  --seed N           random DAG seed (default: 1)\n"
+		  << "  --csv              machine-readable output\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	BenchOptions options;
+	for (int i = 1; i < argc; ++i) {
+		const char *arg = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+		bool takesValue = true;
+
+		if (!std::strcmp(arg, "--shapes") && value) {
+			options.shapes = parseList<std::string>(value);
+		} else if (!std::strcmp(arg, "--sizes") && value) {
+			options.sizes = parseList<int>(value);
+		} else if (!std::strcmp(arg, "--frames") && value) {
+			options.frames = std::max(1, std::atoi(value));
+		} else if (!std::strcmp(arg, "--cost-us") && value) {
+			g_config.cost = std::chrono::microseconds(std::atoi(value));
+		} else if (!std::strcmp(arg, "--payload-bytes") && value) {
+			g_config.payloadBytes = static_cast<size_t>(std::atoll(value));
+		} else if (!std::strcmp(arg, "--distinct") && value) {
+			g_config.distinctInputs = static_cast<uint32_t>(std::max(1, std::atoi(value)));
+		} else if (!std::strcmp(arg, "--workers") && value) {
+			options.workers = std::max(0, std::atoi(value));
+		} else if (!std::strcmp(arg, "--seed") && value) {
+			options.seed = static_cast<unsigned>(std::atoi(value));
+		} else if (!std::strcmp(arg, "--csv")) {
+			options.csv = true;
+			takesValue = false;
+		} else {
+			printUsage(argv[0]);
+			return !std::strcmp(arg, "--help") ? 0 : 2;
+		}
+		i += takesValue ? 1 : 0;
+	}
+
+	if (options.csv) {
+		std::cout << "shape,nodes,edges,frames,build_ms,compile_ms,recompile_ms,serial_us,parallel_us,cached_us,"
+			     "cache_hit_rate,cache_bytes,peak_payload_bytes,peak_rss_kb,status"
+			  << std::endl;
+	} else {
+		std::cout << "=== NodeExecutionGraph Benchmark ===" << std::endl;
+		std::cout << "cost/node: " << g_config.cost.count() << "us, payload: " << g_config.payloadBytes
+			  << " bytes, distinct source payloads: " << g_config.distinctInputs << std::endl;
+		std::cout << std::left << std::setw(8) << "shape" << std::right << std::setw(7) << "nodes"
+			  << std::setw(8) << "edges" << std::setw(6) << "frm" << std::setw(10) << "compile" << std::setw(10)
+			  << "recomp" << std::setw(12) << "serial" << std::setw(12) << "parallel" << std::setw(8)
+			  << "x" << std::setw(12) << "cached" << std::setw(8) << "hit" << std::setw(10) << "cacheKiB"
+			  << std::setw(10) << "payKiB" << std::setw(10) << "rssKiB" << std::endl;
+		std::cout << std::left << std::setw(8) << "" << std::right << std::setw(31) << "(ms)" << std::setw(10)
+			  << "(ms)" << std::setw(12) << "(us/frame)" << std::setw(12) << "(us/frame)" << std::setw(8) << ""
+			  << std::setw(12) << "(us/frame)" << std::endl;
+		std::cout << std::fixed << std::setprecision(2);
+	}
+
+	bool ok = true;
+	for (const std::string &name : options.shapes) {
+		const Shape *shape = nullptr;
+		for (const Shape &candidate : kShapes) {
+			if (name == candidate.name)
+				shape = &candidate;
+		}
+		if (!shape) {
+			std::cerr << "Unknown shape: " << name << std::endl;
+			return 2;
+		}
+
+		for (int size : options.sizes) {
+			BenchResult result = runBench(*shape, std::max(size, 2), options);
+			printResult(result, options.csv);
+			ok = ok && result.ok;
+		}
+	}
+	return ok ? 0 : 1;
+}
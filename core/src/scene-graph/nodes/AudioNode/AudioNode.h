@@ -15,6 +15,12 @@ namespace NeuralStudio {
             // Execution
             ExecutionResult process(ExecutionContext &context) override;
 
+            // Produces a new frame every tick
+            bool isTimeVarying() const override
+            {
+                return true;
+            }
+
             // Properties
             void setAudioPath(const std::string &path);
             std::string getAudioPath() const;
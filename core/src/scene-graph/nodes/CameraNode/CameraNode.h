@@ -15,6 +15,12 @@ namespace NeuralStudio {
             bool initialize(const NodeConfig &config) override;
             ExecutionResult process(ExecutionContext &ctx) override;
 
+            // Produces a new frame every tick
+            bool isTimeVarying() const override
+            {
+                return true;
+            }
+
             // Camera specific properties
             void setDeviceId(const std::string &deviceId);
             std::string getDeviceId() const;
@@ -17,6 +17,7 @@ HeadsetOutputNode::HeadsetOutputNode(const std::string &nodeId) : BaseNodeBacken
 	meta.supportsGPU = true;
 	meta.computeRequirement = ComputeRequirement::High;
 	meta.estimatedMemoryMB = 200;
+	meta.isSink = true;
 	setMetadata(meta);
 
 	// Define pins
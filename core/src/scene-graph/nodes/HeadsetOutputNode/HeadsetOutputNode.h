@@ -21,6 +21,12 @@ namespace NeuralStudio {
             ExecutionResult process(ExecutionContext &ctx) override;
             void cleanup() override;
 
+            // Pulls its upstream only while initialized
+            bool isActiveSink() const override
+            {
+                return m_initialized;
+            }
+
               private:
             VirtualCamManager *m_virtualCamManager = nullptr;
             std::string m_profileId;  // Which headset profile to output to
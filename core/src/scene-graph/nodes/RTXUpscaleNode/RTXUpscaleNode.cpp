@@ -4,6 +4,8 @@
 
 #include "RTXUpscaleNode.h"
 #include "NodeFactory.h"
+#include "NodeOutputCache.h"
+#include "VulkanRenderer.h"
 
 namespace NeuralStudio {
 namespace SceneGraph {
@@ -22,6 +24,9 @@ RTXUpscaleNode::RTXUpscaleNode(const std::string &nodeId) : BaseNodeBackend(node
 	meta.supportsCPU = false;
 	meta.computeRequirement = ComputeRequirement::VeryHigh;
 	meta.estimatedMemoryMB = 500;
+	// The output texture is rewritten in place, so a cached result for older inputs
+	// would point at newer contents. Consumers still cache on its generation.
+	meta.supportsCaching = false;
 	setMetadata(meta);
 
 	// Define pins
@@ -35,6 +40,11 @@ RTXUpscaleNode::RTXUpscaleNode(const std::string &nodeId) : BaseNodeBackend(node
 	m_scaleFactor = Rendering::RTXUpscaler::ScaleFactor::Scale_2x;
 }
 
+RTXUpscaleNode::~RTXUpscaleNode()
+{
+	releaseOutputTexture();
+}
+
 bool RTXUpscaleNode::initialize(const NodeConfig &config)
 {
 	// Check if RTX upscaling is available
@@ -86,44 +96,79 @@ ExecutionResult RTXUpscaleNode::process(ExecutionContext &ctx)
 
 	// Create upscaler if needed (lazy initialization)
 	if (!m_upscaler && ctx.renderer) {
-		m_upscaler = std::make_unique<Rendering::RTXUpscaler>(
-			static_cast<Rendering::VulkanRenderer *>(ctx.renderer));
+		auto *renderer = static_cast<Rendering::VulkanRenderer *>(ctx.renderer);
+		m_upscaler = std::make_unique<Rendering::RTXUpscaler>(renderer);
 
 		// Initialize with texture dimensions
 		QSize inputSize = (*inputTexture)->pixelSize();
 		// Initialize with proper signature
 		if (!m_upscaler->initialize(inputSize.width(), inputSize.height(), m_scaleFactor, m_qualityMode)) {
+			m_upscaler.reset();
 			return ExecutionResult::failure("Failed to initialize RTX upscaler");
 		}
+		if (!createOutputTexture(renderer, *inputTexture)) {
+			m_upscaler.reset();
+			return ExecutionResult::failure("Failed to create upscale output texture");
+		}
 	}
 
 	if (!m_upscaler) {
 		return ExecutionResult::failure("No renderer available for RTX upscaling");
 	}
 
-	// Create output texture (TODO: get from texture pool)
-	// For now, assume output texture is created externally
-	QRhiTexture *outputTexture = nullptr; // TODO: Create output texture
-
 	// Perform upscaling
-	if (!m_upscaler->upscale(*inputTexture, outputTexture)) {
+	if (!m_upscaler->upscale(*inputTexture, m_outputTexture.get())) {
 		return ExecutionResult::failure("RTX upscaling failed");
 	}
+	// Contents changed behind the same pointer; invalidates downstream cache keys
+	PinHasherRegistry::bumpGeneration(m_outputTexture.get());
 
 	// Set output
-	setOutputData("output", outputTexture);
+	setOutputData("output", m_outputTexture.get());
 
 	return ExecutionResult::success();
 }
 
 void RTXUpscaleNode::cleanup()
 {
+	releaseOutputTexture();
 	m_upscaler.reset();
 	m_initialized = false;
 }
 
+bool RTXUpscaleNode::createOutputTexture(Rendering::VulkanRenderer *renderer, QRhiTexture *input)
+{
+	QRhi *rhi = renderer->rhi();
+	if (!rhi) {
+		return false;
+	}
+
+	uint32_t inWidth, inHeight, outWidth, outHeight;
+	m_upscaler->getResolution(inWidth, inHeight, outWidth, outHeight);
+	m_outputTexture.reset(rhi->newTexture(input->format(), QSize(int(outWidth), int(outHeight)), 1,
+					      QRhiTexture::UsedWithLoadStore));
+	if (!m_outputTexture->create()) {
+		m_outputTexture.reset();
+		return false;
+	}
+	return true;
+}
+
+void RTXUpscaleNode::releaseOutputTexture()
+{
+	if (!m_outputTexture) {
+		return;
+	}
+	// A texture created later at the same address must not hit cache entries keyed on this one
+	PinHasherRegistry::releaseResource(m_outputTexture.get());
+	m_outputTexture.reset();
+}
+
 // Register the node type
 REGISTER_NODE_TYPE(RTXUpscaleNode, "RTXUpscale")
 
+// Texture pins are cached by (address, generation) once their writer bumps them
+REGISTER_PIN_RESOURCE_TYPE(QRhiTexture)
+
 } // namespace SceneGraph
 } // namespace NeuralStudio
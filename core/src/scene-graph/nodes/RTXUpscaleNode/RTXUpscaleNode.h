@@ -2,6 +2,9 @@
 
 #include "BaseNodeBackend.h"
 #include "RTXUpscaler.h"
+#include <memory>
+
+class QRhiTexture;
 
 namespace NeuralStudio {
     namespace SceneGraph {
@@ -16,7 +19,7 @@ namespace NeuralStudio {
         {
               public:
             RTXUpscaleNode(const std::string &nodeId);
-            ~RTXUpscaleNode() override = default;
+            ~RTXUpscaleNode() override;
 
             bool initialize(const NodeConfig &config) override;
             ExecutionResult process(ExecutionContext &ctx) override;
@@ -28,7 +31,12 @@ namespace NeuralStudio {
             }
 
               private:
+            bool createOutputTexture(Rendering::VulkanRenderer *renderer, QRhiTexture *input);
+            void releaseOutputTexture();
+
             std::unique_ptr<Rendering::RTXUpscaler> m_upscaler;
+            // Written in place every frame; bumped after each write, released before it is destroyed
+            std::unique_ptr<QRhiTexture> m_outputTexture;
             Rendering::RTXUpscaler::QualityMode m_qualityMode;
             Rendering::RTXUpscaler::ScaleFactor m_scaleFactor;
             bool m_initialized = false;
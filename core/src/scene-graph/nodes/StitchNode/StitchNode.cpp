@@ -1,5 +1,6 @@
 #include "StitchNode.h"
 #include "NodeFactory.h"
+#include "NodeOutputCache.h"
 
 namespace NeuralStudio {
 namespace SceneGraph {
@@ -47,7 +48,8 @@ ExecutionResult StitchNode::process(ExecutionContext &ctx)
 		return ExecutionResult::failure("No input texture");
 	}
 
-	// Pass through
+	// Pass through. Nothing is written, so the texture keeps the generation its
+	// writer gave it; a stitch pass rendering into a texture bumps it after.
 	QRhiTexture *outputTexture = *inputTexture;
 
 	// Set output
@@ -65,5 +67,8 @@ void StitchNode::cleanup()
 
 REGISTER_NODE_TYPE(StitchNode, "Stitch")
 
+// Texture pins are cached by (address, generation) once their writer bumps them
+REGISTER_PIN_RESOURCE_TYPE(QRhiTexture)
+
 } // namespace SceneGraph
 } // namespace NeuralStudio
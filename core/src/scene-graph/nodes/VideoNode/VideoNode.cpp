@@ -1,9 +1,80 @@
 #include "VideoNode.h"
+#include <cstdint>
 #include <iostream>
 
+#ifdef NEURAL_STUDIO_USE_MEDIA_PLAYBACK
+extern "C" {
+#include <media-io/audio-io.h>
+#include <media-playback/media-playback.h>
+}
+#endif
+
 namespace NeuralStudio {
 namespace SceneGraph {
 
+namespace {
+#ifdef NEURAL_STUDIO_USE_MEDIA_PLAYBACK
+// Decoded frames waiting for their presentation time. Frames come in
+// kDecodeAheadFrames early, the rest absorbs graph frame jitter.
+constexpr size_t kMaxQueuedFrames = 8;
+constexpr size_t kMaxQueuedAudio = 32;
+constexpr int kDecodeAheadFrames = 2;
+
+// Queue this far off the graph clock means the decoder timeline jumped
+// (reconnect, restart): re-anchor instead of waiting or dropping everything
+constexpr int64_t kResyncNs = 1000000000;
+
+std::shared_ptr<mp_decode_service> sharedDecodeService()
+{
+	static std::mutex mutex;
+	static std::weak_ptr<mp_decode_service> shared;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	std::shared_ptr<mp_decode_service> service = shared.lock();
+	if (!service) {
+		service = std::shared_ptr<mp_decode_service>(mp_decode_service_create(0), mp_decode_service_destroy);
+		shared = service;
+	}
+	return service;
+}
+
+template<typename T, typename Convert>
+void interleaveSamples(const obs_source_audio *audio, uint32_t channels, float *out, Convert convert)
+{
+	const bool planar = is_audio_planar(audio->format);
+	for (uint32_t ch = 0; ch < channels; ch++) {
+		const T *src = reinterpret_cast<const T *>(audio->data[planar ? ch : 0]);
+		for (uint32_t i = 0; i < audio->frames; i++)
+			out[i * channels + ch] = convert(planar ? src[i] : src[i * channels + ch]);
+	}
+}
+
+bool toInterleavedFloat(const obs_source_audio *audio, uint32_t channels, float *out)
+{
+	switch (audio->format) {
+	case AUDIO_FORMAT_U8BIT:
+	case AUDIO_FORMAT_U8BIT_PLANAR:
+		interleaveSamples<uint8_t>(audio, channels, out, [](uint8_t v) { return (v - 128) / 128.0f; });
+		return true;
+	case AUDIO_FORMAT_16BIT:
+	case AUDIO_FORMAT_16BIT_PLANAR:
+		interleaveSamples<int16_t>(audio, channels, out, [](int16_t v) { return v / 32768.0f; });
+		return true;
+	case AUDIO_FORMAT_32BIT:
+	case AUDIO_FORMAT_32BIT_PLANAR:
+		interleaveSamples<int32_t>(audio, channels, out, [](int32_t v) { return v / 2147483648.0f; });
+		return true;
+	case AUDIO_FORMAT_FLOAT:
+	case AUDIO_FORMAT_FLOAT_PLANAR:
+		interleaveSamples<float>(audio, channels, out, [](float v) { return v; });
+		return true;
+	default:
+		return false;
+	}
+}
+#endif
+} // namespace
+
 VideoNode::VideoNode(const std::string &id) : BaseNodeBackend(id, "VideoNode")
 {
 	// Define Outputs - video is a visual source
@@ -13,25 +84,201 @@ VideoNode::VideoNode(const std::string &id) : BaseNodeBackend(id, "VideoNode")
 
 VideoNode::~VideoNode()
 {
-	// Cleanup video player resources
+	closePlayer();
 }
 
 ExecutionResult VideoNode::process(ExecutionContext &context)
 {
-	if (m_dirty && !m_videoPath.empty()) {
-		// Load/initialize video player
-		std::cout << "VideoNode: Loading " << m_videoPath << std::endl;
+	if (m_dirty) {
+		closePlayer();
 		m_dirty = false;
+		if (!m_videoPath.empty() && !openPlayer())
+			return ExecutionResult::failure("VideoNode: Could not open " + m_videoPath);
 	}
 
-	// Decode current frame and output texture + audio
-	if (m_videoPlayerId > 0) {
-		// setOutputData("visual_out", currentFrameTexture);
-		// setOutputData("audio_out", currentAudioBuffer);
+	if (!m_player)
+		return ExecutionResult::success();
+
+#ifdef NEURAL_STUDIO_USE_MEDIA_PLAYBACK
+	const int64_t now = context.timeNs;
+	obs_source_frame *due = nullptr;
+	int64_t duePts = 0;
+	std::shared_ptr<AudioBufferData> audio;
+
+	{
+		std::lock_guard<std::mutex> lock(m_queueMutex);
+
+		// The first decoded frame plays at the graph time it is first seen
+		if (!m_anchored && (!m_frames.empty() || !m_audio.empty())) {
+			m_mediaOrigin = !m_frames.empty() ? m_frames.front().pts : m_audio.front().pts;
+			m_graphOrigin = now;
+			m_anchored = true;
+		}
+
+		int64_t target = m_mediaOrigin + (now - m_graphOrigin);
+		if (!m_frames.empty() &&
+		    (m_frames.front().pts > target + kResyncNs || m_frames.back().pts < target - kResyncNs)) {
+			m_mediaOrigin = target = m_frames.front().pts;
+			m_graphOrigin = now;
+		}
+
+		// Latest frame due at the graph time; earlier ones were never shown
+		while (!m_frames.empty() && m_frames.front().pts <= target) {
+			if (due)
+				mp_frame_release(due);
+			due = m_frames.front().frame;
+			duePts = m_frames.front().pts;
+			m_frames.pop_front();
+		}
+
+		// All audio due since the last tick, as one buffer
+		while (!m_audio.empty() && m_audio.front().pts <= target) {
+			QueuedAudio &segment = m_audio.front();
+			if (!audio) {
+				audio = std::make_shared<AudioBufferData>();
+				audio->sampleRate = segment.sampleRate;
+				audio->channels = segment.channels;
+				audio->pts = m_graphOrigin + (segment.pts - m_mediaOrigin);
+			}
+			if (segment.channels == audio->channels) {
+				audio->samples.insert(audio->samples.end(), segment.samples.begin(), segment.samples.end());
+				audio->frames += segment.frames;
+			}
+			m_audio.pop_front();
+		}
+	}
+
+	if (due) {
+		auto *data = new VideoFrameData();
+		data->width = due->width;
+		data->height = due->height;
+		data->stride = due->linesize[0];
+		data->pixelFormat = static_cast<uint32_t>(due->format);
+		data->pts = m_graphOrigin + (duePts - m_mediaOrigin);
+		for (size_t i = 0; i < 4; i++) {
+			data->planes[i] = due->data[i];
+			data->linesizes[i] = due->linesize[i];
+		}
+
+		// Downstream may hold the frame past this tick: the pool buffer is
+		// released by whoever drops the last handle
+		m_currentFrame = VideoFrameHandle(std::shared_ptr<const VideoFrameData>(data, [due](const VideoFrameData *d) {
+			delete d;
+			mp_frame_release(due);
+		}));
 	}
+
+	// Repeat the frame on screen until the next one is due
+	if (m_currentFrame)
+		setOutputData("visual_out", m_currentFrame);
+	setOutputData("audio_out", AudioBufferHandle(std::move(audio)));
+#else
+	(void)context;
+#endif
 	return ExecutionResult::success();
 }
 
+bool VideoNode::openPlayer()
+{
+#ifdef NEURAL_STUDIO_USE_MEDIA_PLAYBACK
+	m_decodeService = sharedDecodeService();
+
+	mp_media_info info = {};
+	info.opaque = this;
+	info.v_cb = onVideo;
+	info.a_cb = onAudio;
+	info.path = m_videoPath.c_str();
+	info.speed = 100;
+	info.force_range = VIDEO_RANGE_DEFAULT;
+	info.is_local_file = m_videoPath.find("://") == std::string::npos;
+	info.pooled_frames = true;
+	info.decode_service = m_decodeService.get();
+	info.decode_ahead = kDecodeAheadFrames;
+
+	m_player = media_playback_create(&info);
+	if (!m_player) {
+		m_decodeService.reset();
+		return false;
+	}
+
+	std::cout << "VideoNode: Playing " << m_videoPath << std::endl;
+	media_playback_play(m_player, m_loop, false);
+	return true;
+#else
+	std::cerr << "VideoNode: Built without media playback, cannot play " << m_videoPath << std::endl;
+	return false;
+#endif
+}
+
+void VideoNode::closePlayer()
+{
+#ifdef NEURAL_STUDIO_USE_MEDIA_PLAYBACK
+	// Stops the callbacks before the queues go
+	if (m_player) {
+		media_playback_destroy(m_player);
+		m_player = nullptr;
+	}
+	m_decodeService.reset();
+#endif
+	clearQueues();
+	m_currentFrame = VideoFrameHandle();
+	m_anchored = false;
+}
+
+void VideoNode::clearQueues()
+{
+	std::lock_guard<std::mutex> lock(m_queueMutex);
+#ifdef NEURAL_STUDIO_USE_MEDIA_PLAYBACK
+	for (const QueuedFrame &queued : m_frames)
+		mp_frame_release(queued.frame);
+#endif
+	m_frames.clear();
+	m_audio.clear();
+}
+
+void VideoNode::onVideo(void *opaque, obs_source_frame *frame)
+{
+#ifdef NEURAL_STUDIO_USE_MEDIA_PLAYBACK
+	auto *node = static_cast<VideoNode *>(opaque);
+
+	mp_frame_addref(frame);
+
+	std::lock_guard<std::mutex> lock(node->m_queueMutex);
+	if (node->m_frames.size() >= kMaxQueuedFrames) {
+		mp_frame_release(node->m_frames.front().frame);
+		node->m_frames.pop_front();
+	}
+	node->m_frames.push_back({static_cast<int64_t>(frame->timestamp), frame});
+#else
+	(void)opaque;
+	(void)frame;
+#endif
+}
+
+void VideoNode::onAudio(void *opaque, obs_source_audio *audio)
+{
+#ifdef NEURAL_STUDIO_USE_MEDIA_PLAYBACK
+	auto *node = static_cast<VideoNode *>(opaque);
+
+	QueuedAudio segment;
+	segment.pts = static_cast<int64_t>(audio->timestamp);
+	segment.sampleRate = audio->samples_per_sec;
+	segment.channels = get_audio_channels(audio->speakers);
+	segment.frames = audio->frames;
+	segment.samples.resize(static_cast<size_t>(segment.frames) * segment.channels);
+	if (!segment.channels || !toInterleavedFloat(audio, segment.channels, segment.samples.data()))
+		return;
+
+	std::lock_guard<std::mutex> lock(node->m_queueMutex);
+	if (node->m_audio.size() >= kMaxQueuedAudio)
+		node->m_audio.pop_front();
+	node->m_audio.push_back(std::move(segment));
+#else
+	(void)opaque;
+	(void)audio;
+#endif
+}
+
 void VideoNode::setVideoPath(const std::string &path)
 {
 	if (m_videoPath != path) {
@@ -48,6 +295,10 @@ std::string VideoNode::getVideoPath() const
 void VideoNode::setLoop(bool loop)
 {
 	m_loop = loop;
+#ifdef NEURAL_STUDIO_USE_MEDIA_PLAYBACK
+	if (m_player)
+		media_playback_set_looping(m_player, loop);
+#endif
 }
 
 bool VideoNode::getLoop() const
@@ -1,11 +1,30 @@
 #pragma once
 
 #include "BaseNodeBackend.h"
+#include "FrameHandle.h"
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+struct media_playback;
+struct mp_decode_service;
+struct obs_source_frame;
+struct obs_source_audio;
 
 namespace NeuralStudio {
     namespace SceneGraph {
 
+        /**
+ * @brief Plays a media file into the graph through media-playback.
+ *
+ * Decoded frames are queued with their presentation timestamps and process()
+ * publishes the frame due at ExecutionContext::timeNs, not the latest one
+ * decoded. Published frames borrow the decoder's pooled buffers; a buffer
+ * is recycled once the output pin and every downstream holder let go of it.
+ * All VideoNodes decode on one shared decode service.
+ */
         class VideoNode : public BaseNodeBackend
         {
               public:
@@ -15,6 +34,12 @@ namespace NeuralStudio {
             // Execution
             ExecutionResult process(ExecutionContext &context) override;
 
+            // Produces a new frame every tick
+            bool isTimeVarying() const override
+            {
+                return true;
+            }
+
             // Properties
             void setVideoPath(const std::string &path);
             std::string getVideoPath() const;
@@ -23,11 +48,45 @@ namespace NeuralStudio {
             bool getLoop() const;
 
               private:
+            struct QueuedFrame {
+                int64_t pts;              // Media clock (ns), as stamped by the decoder
+                obs_source_frame *frame;  // Pool buffer, one reference held
+            };
+
+            struct QueuedAudio {
+                int64_t pts;  // Media clock (ns)
+                uint32_t sampleRate;
+                uint32_t channels;
+                uint32_t frames;
+                std::vector<float> samples;  // Interleaved
+            };
+
+            bool openPlayer();
+            void closePlayer();
+            void clearQueues();
+
+            // Decoder thread
+            static void onVideo(void *opaque, obs_source_frame *frame);
+            static void onAudio(void *opaque, obs_source_audio *audio);
+
             std::string m_videoPath;
             bool m_loop = true;
             bool m_dirty = false;
+
             // Video decoder/player state
-            uint32_t m_videoPlayerId = 0;
+            std::shared_ptr<mp_decode_service> m_decodeService;
+            media_playback *m_player = nullptr;
+
+            std::mutex m_queueMutex;
+            std::deque<QueuedFrame> m_frames;  // Presentation order
+            std::deque<QueuedAudio> m_audio;
+
+            // Media time mediaOrigin plays at graph time graphOrigin
+            bool m_anchored = false;
+            int64_t m_mediaOrigin = 0;
+            int64_t m_graphOrigin = 0;
+
+            VideoFrameHandle m_currentFrame;
         };
 
     }  // namespace SceneGraph
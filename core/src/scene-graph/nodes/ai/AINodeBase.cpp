@@ -19,21 +19,23 @@ std::string AINodeBase::getModelPath() const
 
 void AINodeBase::setPinData(const std::string &pinId, const std::any &data)
 {
-	m_pinData[pinId] = data;
+	m_pins.set(pinId, data);
 }
 
 std::any AINodeBase::getPinData(const std::string &pinId) const
 {
-	auto it = m_pinData.find(pinId);
-	if (it != m_pinData.end()) {
-		return it->second;
-	}
-	return {};
+	return m_pins.get(pinId);
 }
 
 bool AINodeBase::hasPinData(const std::string &pinId) const
 {
-	return m_pinData.find(pinId) != m_pinData.end();
+	return m_pins.has(pinId);
+}
+
+bool AINodeBase::bindPinSlots(PinSlotBuffer *buffer, uint32_t baseSlot)
+{
+	m_pins.bind(buffer, baseSlot, getInputPins(), getOutputPins());
+	return buffer != nullptr;
 }
 
 ExecutionResult AINodeBase::modelError(const std::string &message)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../IExecutableNode.h"
+#include "../../PinSlots.h"
 #include <string>
 #include <vector>
 #include <future>
@@ -33,12 +34,19 @@ namespace NeuralStudio {
             void setPinData(const std::string &pinId, const std::any &data) override;
             std::any getPinData(const std::string &pinId) const override;
             bool hasPinData(const std::string &pinId) const override;
+            bool bindPinSlots(PinSlotBuffer *buffer, uint32_t baseSlot) override;
 
               protected:
             std::string m_nodeId;
             std::string m_typeName;
             NodeMetadata m_metadata;
-            std::map<std::string, std::any> m_pinData;
+            PinStorage m_pins;
+
+            // Staleness of an input produced by another pipelined node
+            PinStamp getInputStamp(const std::string &pinId) const
+            {
+                return m_pins.stamp(pinId);
+            }
 
             // Helper to report model loading errors
             ExecutionResult modelError(const std::string &message);
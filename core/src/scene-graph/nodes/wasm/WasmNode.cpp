@@ -17,8 +17,8 @@ WasmNode::WasmNode(const std::string &nodeId)
 	  m_wasmPath("")
 {
 	// Define standard pins for a generic processor
-	m_pinData["input"] = std::any();
-	m_pinData["output"] = std::any();
+	m_pins.set("input", std::any());
+	m_pins.set("output", std::any());
 }
 
 WasmNode::~WasmNode() = default;
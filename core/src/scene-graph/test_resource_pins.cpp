@@ -0,0 +1,184 @@
+#include "NodeExecutionGraph.h"
+#include "BaseNodeBackend.h"
+#include "NodeOutputCache.h"
+#include <iostream>
+#include <new>
+#include <string>
+
+// Resource pins are cached on (address, generation). Checks that a consumer
+// hits the cache only while its writer's texture is unchanged, and that a
+// texture released and recreated at the same address never hits entries
+// keyed on the old one.
+
+using namespace NeuralStudio::SceneGraph;
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool condition, const std::string &what)
+{
+	if (!condition) {
+		std::cerr << "FAILED: " << what << std::endl;
+		++g_failures;
+	}
+}
+
+// Stand-in for a GPU texture: mutable contents behind a stable pointer
+struct FakeTexture {
+	int contents = 0;
+};
+
+PinResourceRegistrar<FakeTexture> g_registerFakeTexture;
+
+// Owns one texture at a fixed address, like a node reusing its output texture
+class WriterNode : public BaseNodeBackend {
+public:
+	enum class Action { None, Write, WriteUntracked, Recreate };
+
+	WriterNode() : BaseNodeBackend("writer", "TestWriter")
+	{
+		addOutput("out", "Out", DataType::Texture2D());
+		m_texture = new (&m_storage) FakeTexture;
+	}
+
+	~WriterNode() override { release(); }
+
+	bool isTimeVarying() const override { return true; }
+
+	ExecutionResult process(ExecutionContext &) override
+	{
+		switch (action) {
+		case Action::None:
+			break;
+		case Action::Write:
+			m_texture->contents++;
+			PinHasherRegistry::bumpGeneration(m_texture);
+			break;
+		case Action::WriteUntracked:
+			m_texture->contents++;
+			break;
+		case Action::Recreate:
+			// Destroyed and allocated again at the same address; written without a bump
+			release();
+			m_texture = new (&m_storage) FakeTexture;
+			m_texture->contents = 100;
+			break;
+		}
+		setOutputData("out", m_texture);
+		return ExecutionResult::success();
+	}
+
+	FakeTexture *texture() const { return m_texture; }
+
+	Action action = Action::None;
+
+private:
+	void release()
+	{
+		if (!m_texture)
+			return;
+		PinHasherRegistry::releaseResource(m_texture);
+		m_texture->~FakeTexture();
+		m_texture = nullptr;
+	}
+
+	alignas(FakeTexture) unsigned char m_storage[sizeof(FakeTexture)];
+	FakeTexture *m_texture = nullptr;
+};
+
+// Cacheable; counts how often it actually runs and what it read
+class ConsumerNode : public BaseNodeBackend {
+public:
+	ConsumerNode() : BaseNodeBackend("consumer", "TestConsumer")
+	{
+		addInput("in", "In", DataType::Texture2D());
+		addOutput("out", "Out", DataType::Scalar());
+	}
+
+	ExecutionResult process(ExecutionContext &) override
+	{
+		++runs;
+		auto *texture = getInputData<FakeTexture *>("in");
+		lastContents = texture && *texture ? (*texture)->contents : -1;
+		setOutputData("out", static_cast<float>(lastContents));
+		return ExecutionResult::success();
+	}
+
+	int runs = 0;
+	int lastContents = -1;
+};
+
+void registryGenerations()
+{
+	FakeTexture texture;
+	uint64_t first = 0, second = 0, released = 0;
+	check(!PinHasherRegistry::hashResource(&texture, first), "registry: untracked until bumped");
+
+	PinHasherRegistry::bumpGeneration(&texture);
+	check(PinHasherRegistry::hashResource(&texture, first), "registry: hashable once bumped");
+	PinHasherRegistry::bumpGeneration(&texture);
+	check(PinHasherRegistry::hashResource(&texture, second) && second != first,
+	      "registry: a write changes the hash");
+
+	PinHasherRegistry::releaseResource(&texture);
+	check(!PinHasherRegistry::hashResource(&texture, released), "registry: released resources are untracked");
+
+	PinHasherRegistry::bumpGeneration(&texture);
+	check(PinHasherRegistry::hashResource(&texture, released) && released != first && released != second,
+	      "registry: a reused address never repeats an old hash");
+	PinHasherRegistry::releaseResource(&texture);
+}
+
+void addressReuse()
+{
+	NodeExecutionGraph graph;
+	auto writer = std::make_shared<WriterNode>();
+	auto consumer = std::make_shared<ConsumerNode>();
+	graph.addNode(writer);
+	graph.addNode(consumer);
+	check(graph.connectPins("writer", "out", "consumer", "in"), "graph: connected");
+	check(graph.compile(), "graph: compiled");
+
+	uint64_t frame = 0;
+	auto runFrame = [&](WriterNode::Action action) {
+		writer->action = action;
+		ExecutionContext ctx;
+		ctx.frameNumber = frame++;
+		check(graph.execute(ctx), "graph: frame executed");
+	};
+
+	runFrame(WriterNode::Action::Write);
+	check(consumer->runs == 1 && consumer->lastContents == 1, "cache: first write runs the consumer");
+
+	runFrame(WriterNode::Action::None);
+	check(consumer->runs == 1, "cache: unchanged texture hits");
+
+	runFrame(WriterNode::Action::Write);
+	check(consumer->runs == 2 && consumer->lastContents == 2, "cache: bumped texture misses");
+
+	FakeTexture *before = writer->texture();
+	runFrame(WriterNode::Action::Recreate);
+	check(writer->texture() == before, "reuse: recreated at the same address");
+	check(consumer->runs == 3 && consumer->lastContents == 100, "reuse: released address does not hit old entries");
+
+	runFrame(WriterNode::Action::WriteUntracked);
+	check(consumer->runs == 4 && consumer->lastContents == 101, "reuse: uncacheable until the new writer bumps");
+
+	runFrame(WriterNode::Action::Write);
+	check(consumer->runs == 5 && consumer->lastContents == 102, "reuse: tracked again after a bump");
+
+	runFrame(WriterNode::Action::None);
+	check(consumer->runs == 5, "reuse: hits again while unchanged");
+}
+
+} // namespace
+
+int main()
+{
+	registryGenerations();
+	addressReuse();
+
+	std::cout << (g_failures ? "FAILED" : "All resource pin tests passed") << std::endl;
+	return g_failures ? 1 : 0;
+}
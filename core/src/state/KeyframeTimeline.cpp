@@ -0,0 +1,160 @@
+#include "KeyframeTimeline.h"
+#include <algorithm>
+
+namespace NeuralStudio {
+
+KeyframeTimeline::Interpolation KeyframeTimeline::parseInterpolation(std::string_view name)
+{
+	if (name == "step")
+		return Interpolation::Step;
+	if (name == "bezier")
+		return Interpolation::Bezier;
+	return Interpolation::Linear;
+}
+
+void KeyframeTimeline::insert(const Keyframe &kf)
+{
+	auto it = std::lower_bound(timestamps_.begin(), timestamps_.end(), kf.timestampMs);
+	size_t index = static_cast<size_t>(it - timestamps_.begin());
+
+	if (it != timestamps_.end() && *it == kf.timestampMs) {
+		assignAt(index, kf);
+	} else {
+		insertAt(index, kf);
+	}
+}
+
+void KeyframeTimeline::insertMany(const std::vector<Keyframe> &keyframes)
+{
+	if (keyframes.empty())
+		return;
+
+	std::vector<Keyframe> merged;
+	merged.reserve(timestamps_.size() + keyframes.size());
+	for (size_t i = 0; i < timestamps_.size(); ++i) {
+		Keyframe kf;
+		kf.id = ids_[i];
+		kf.timestampMs = timestamps_[i];
+		for (int c = 0; c < ChannelCount; ++c)
+			kf.values[c] = channels_[c][i];
+		kf.interpolation = interpolation_[i];
+		merged.push_back(kf);
+	}
+	merged.insert(merged.end(), keyframes.begin(), keyframes.end());
+
+	// Stable so that, for equal timestamps, the most recently written keyframe comes last and wins
+	std::stable_sort(merged.begin(), merged.end(),
+			 [](const Keyframe &a, const Keyframe &b) { return a.timestampMs < b.timestampMs; });
+
+	timestamps_.clear();
+	ids_.clear();
+	interpolation_.clear();
+	for (auto &channel : channels_)
+		channel.clear();
+
+	for (size_t i = 0; i < merged.size(); ++i) {
+		if (i + 1 < merged.size() && merged[i + 1].timestampMs == merged[i].timestampMs)
+			continue;
+		insertAt(timestamps_.size(), merged[i]);
+	}
+}
+
+bool KeyframeTimeline::remove(uint64_t id)
+{
+	auto it = std::find(ids_.begin(), ids_.end(), id);
+	if (it == ids_.end())
+		return false;
+
+	eraseAt(static_cast<size_t>(it - ids_.begin()));
+	return true;
+}
+
+bool KeyframeTimeline::contains(uint64_t id) const
+{
+	return std::find(ids_.begin(), ids_.end(), id) != ids_.end();
+}
+
+bool KeyframeTimeline::sample(int64_t timeMs, Sample &out) const
+{
+	const size_t count = timestamps_.size();
+	if (count == 0)
+		return false;
+
+	if (timeMs <= timestamps_.front() || count == 1) {
+		for (int c = 0; c < ChannelCount; ++c)
+			out.values[c] = channels_[c].front();
+		return true;
+	}
+	if (timeMs >= timestamps_.back()) {
+		for (int c = 0; c < ChannelCount; ++c)
+			out.values[c] = channels_[c].back();
+		return true;
+	}
+
+	// First keyframe strictly after timeMs; the segment starts one before it
+	auto it = std::upper_bound(timestamps_.begin(), timestamps_.end(), timeMs);
+	const size_t i1 = static_cast<size_t>(it - timestamps_.begin());
+	const size_t i0 = i1 - 1;
+
+	const Interpolation mode = interpolation_[i0];
+	if (mode == Interpolation::Step) {
+		for (int c = 0; c < ChannelCount; ++c)
+			out.values[c] = channels_[c][i0];
+		return true;
+	}
+
+	const float t = static_cast<float>(timeMs - timestamps_[i0]) /
+			static_cast<float>(timestamps_[i1] - timestamps_[i0]);
+
+	if (mode == Interpolation::Linear) {
+		for (int c = 0; c < ChannelCount; ++c) {
+			const float a = channels_[c][i0];
+			const float b = channels_[c][i1];
+			out.values[c] = a + (b - a) * t;
+		}
+		return true;
+	}
+
+	// Bezier: no stored tangents, so use a Catmull-Rom spline through the neighbouring keyframes
+	const size_t im = i0 > 0 ? i0 - 1 : i0;
+	const size_t i2 = i1 + 1 < count ? i1 + 1 : i1;
+	const float t2 = t * t;
+	const float t3 = t2 * t;
+	for (int c = 0; c < ChannelCount; ++c) {
+		const float p0 = channels_[c][im];
+		const float p1 = channels_[c][i0];
+		const float p2 = channels_[c][i1];
+		const float p3 = channels_[c][i2];
+		out.values[c] = 0.5f * ((2.0f * p1) + (-p0 + p2) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+					(-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
+	}
+	return true;
+}
+
+void KeyframeTimeline::insertAt(size_t index, const Keyframe &kf)
+{
+	timestamps_.insert(timestamps_.begin() + index, kf.timestampMs);
+	ids_.insert(ids_.begin() + index, kf.id);
+	interpolation_.insert(interpolation_.begin() + index, kf.interpolation);
+	for (int c = 0; c < ChannelCount; ++c)
+		channels_[c].insert(channels_[c].begin() + index, kf.values[c]);
+}
+
+void KeyframeTimeline::assignAt(size_t index, const Keyframe &kf)
+{
+	ids_[index] = kf.id;
+	interpolation_[index] = kf.interpolation;
+	for (int c = 0; c < ChannelCount; ++c)
+		channels_[c][index] = kf.values[c];
+}
+
+void KeyframeTimeline::eraseAt(size_t index)
+{
+	timestamps_.erase(timestamps_.begin() + index);
+	ids_.erase(ids_.begin() + index);
+	interpolation_.erase(interpolation_.begin() + index);
+	for (int c = 0; c < ChannelCount; ++c)
+		channels_[c].erase(channels_[c].begin() + index);
+}
+
+} // namespace NeuralStudio
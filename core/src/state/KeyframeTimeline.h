@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace NeuralStudio {
+
+/**
+ * KeyframeTimeline - In-memory animation track for one scene object
+ *
+ * Keyframes are stored as sorted structure-of-arrays (timestamps plus one
+ * array per TRS channel) so sampling is a binary search over contiguous
+ * timestamps followed by a single interpolation. Timelines are treated as
+ * immutable once published by StateStore; edits build a modified copy.
+ */
+class KeyframeTimeline {
+public:
+	enum class Interpolation : uint8_t { Linear, Step, Bezier };
+
+	// Channel order inside a sample / per-channel arrays
+	enum Channel { PosX, PosY, PosZ, RotX, RotY, RotZ, ScaleX, ScaleY, ScaleZ, ChannelCount };
+
+	struct Sample {
+		std::array<float, ChannelCount> values{0, 0, 0, 0, 0, 0, 1, 1, 1};
+	};
+
+	struct Keyframe {
+		uint64_t id{0};
+		int64_t timestampMs{0};
+		std::array<float, ChannelCount> values{0, 0, 0, 0, 0, 0, 1, 1, 1};
+		Interpolation interpolation{Interpolation::Linear};
+	};
+
+	static Interpolation parseInterpolation(std::string_view name);
+
+	// Insert or replace (same timestamp) a single keyframe
+	void insert(const Keyframe &kf);
+
+	// Merge many keyframes at once; one sort instead of one shift per insert
+	void insertMany(const std::vector<Keyframe> &keyframes);
+
+	// Remove by database id; returns false if the id isn't on this timeline
+	bool remove(uint64_t id);
+	bool contains(uint64_t id) const;
+
+	// Sample at timeMs (clamped to the first/last keyframe). Returns false if empty.
+	bool sample(int64_t timeMs, Sample &out) const;
+
+	size_t size() const { return timestamps_.size(); }
+	bool empty() const { return timestamps_.empty(); }
+	int64_t startMs() const { return timestamps_.empty() ? 0 : timestamps_.front(); }
+	int64_t endMs() const { return timestamps_.empty() ? 0 : timestamps_.back(); }
+
+private:
+	std::vector<int64_t> timestamps_;
+	std::array<std::vector<float>, ChannelCount> channels_;
+	std::vector<Interpolation> interpolation_;
+	std::vector<uint64_t> ids_;
+
+	void insertAt(size_t index, const Keyframe &kf);
+	void assignAt(size_t index, const Keyframe &kf);
+	void eraseAt(size_t index);
+};
+
+} // namespace NeuralStudio
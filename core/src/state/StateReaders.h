@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <objectbox.h>
+#include "flatbuffers/flatbuffers.h"
+
+namespace NeuralStudio {
+
+/**
+ * Zero-copy readers over stored ObjectBox records
+ *
+ * Each reader wraps the FlatBuffer ObjectBox hands to a visitor and decodes
+ * fields on access, so nothing is copied unless the caller copies it. A
+ * reader (and every string_view it returns) is only valid inside the
+ * visitor call that produced it.
+ *
+ * Field offsets mirror the generated schemas/profile/<Entity>.obx.cpp
+ * (vtable offset = 4 + 2 * (propertyId - 1)); regenerate both together.
+ */
+class FlatRecordReader {
+public:
+	explicit FlatRecordReader(const void *data) : table_(flatbuffers::GetRoot<flatbuffers::Table>(data)) {}
+
+protected:
+	template<typename T> T field(flatbuffers::voffset_t offset) const { return table_->GetField<T>(offset, T{}); }
+
+	bool flag(flatbuffers::voffset_t offset) const { return table_->GetField<uint8_t>(offset, 0) != 0; }
+
+	std::string_view string(flatbuffers::voffset_t offset) const
+	{
+		auto *str = table_->GetPointer<const flatbuffers::String *>(offset);
+		return str ? std::string_view(str->c_str(), str->size()) : std::string_view();
+	}
+
+private:
+	const flatbuffers::Table *table_;
+};
+
+class SceneObjectReader : public FlatRecordReader {
+public:
+	using FlatRecordReader::FlatRecordReader;
+
+	obx_id id() const { return field<obx_id>(4); }
+	std::string_view nodeId() const { return string(6); }
+	std::string_view type() const { return string(8); }
+	std::string_view name() const { return string(10); }
+	float posX() const { return field<float>(12); }
+	float posY() const { return field<float>(14); }
+	float posZ() const { return field<float>(16); }
+	float rotX() const { return field<float>(18); }
+	float rotY() const { return field<float>(20); }
+	float rotZ() const { return field<float>(22); }
+	float scaleX() const { return field<float>(24); }
+	float scaleY() const { return field<float>(26); }
+	float scaleZ() const { return field<float>(28); }
+	bool enabled() const { return flag(30); }
+	std::string_view properties() const { return string(32); }
+};
+
+class AnimationKeyframeReader : public FlatRecordReader {
+public:
+	using FlatRecordReader::FlatRecordReader;
+
+	obx_id id() const { return field<obx_id>(4); }
+	uint64_t objectId() const { return field<uint64_t>(6); }
+	std::string_view nodeId() const { return string(8); }
+	int64_t timestampMs() const { return field<int64_t>(10); }
+	float posX() const { return field<float>(12); }
+	float posY() const { return field<float>(14); }
+	float posZ() const { return field<float>(16); }
+	float rotX() const { return field<float>(18); }
+	float rotY() const { return field<float>(20); }
+	float rotZ() const { return field<float>(22); }
+	float scaleX() const { return field<float>(24); }
+	float scaleY() const { return field<float>(26); }
+	float scaleZ() const { return field<float>(28); }
+	uint64_t scriptId() const { return field<uint64_t>(30); }
+	std::string_view interpolation() const { return string(32); }
+};
+
+class BroadcastSettingsReader : public FlatRecordReader {
+public:
+	using FlatRecordReader::FlatRecordReader;
+
+	obx_id id() const { return field<obx_id>(4); }
+	std::string_view platform() const { return string(6); }
+	std::string_view streamKey() const { return string(8); }
+	std::string_view serverUrl() const { return string(10); }
+	int32_t bitrate() const { return field<int32_t>(12); }
+	std::string_view resolution() const { return string(14); }
+	int32_t framerate() const { return field<int32_t>(16); }
+	std::string_view encoder() const { return string(18); }
+	int32_t audioBitrate() const { return field<int32_t>(20); }
+	int32_t sampleRate() const { return field<int32_t>(22); }
+	bool enabled() const { return flag(24); }
+};
+
+// obx_data_visitor trampoline: wraps each record in Reader and forwards to *userData.
+// The callable returns false to stop visiting.
+template<typename Reader, typename Fn> bool visitWithReader(const void *data, size_t /*size*/, void *userData)
+{
+	return (*static_cast<Fn *>(userData))(Reader(data));
+}
+
+} // namespace NeuralStudio
@@ -1,96 +1,160 @@
 #include "StateStore.h"
+#include "schemas/profile/AnimationKeyframe.obx.hpp"
+#include "schemas/profile/BroadcastSettings.obx.hpp"
+#include "schemas/profile/SceneObject.obx.hpp"
+#include "schemas/profile/objectbox-model.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QDebug>
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include <map>
 
 namespace NeuralStudio {
 
-StateStore::StateStore(QObject *parent) : QObject(parent) {}
+namespace {
 
-StateStore::~StateStore()
+void toEntity(const StateStore::KeyframeData &kf, obx_id id, AnimationKeyframe &out)
 {
-	close();
+	out.id = id;
+	out.object_id = kf.objectId;
+	out.node_id = kf.nodeId;
+	out.timestamp_ms = kf.timestampMs;
+	out.pos_x = kf.posX;
+	out.pos_y = kf.posY;
+	out.pos_z = kf.posZ;
+	out.rot_x = kf.rotX;
+	out.rot_y = kf.rotY;
+	out.rot_z = kf.rotZ;
+	out.scale_x = kf.scaleX;
+	out.scale_y = kf.scaleY;
+	out.scale_z = kf.scaleZ;
+	out.script_id = 0;
+	out.interpolation = kf.interpolation;
 }
 
-void StateStore::createModel()
+void toEntity(const StateStore::SceneObjectData &obj, SceneObject &out)
 {
-	model_ = obx_model();
-	if (!model_) {
-		qCritical() << "Failed to create ObjectBox model";
-		return;
-	}
-
-	createSettingsEntity();
-	createSceneObjectEntity();
-	createKeyframeEntity();
+	out.id = obj.id;
+	out.node_id = obj.nodeId;
+	out.type = obj.type;
+	out.name = obj.name;
+	out.pos_x = obj.posX;
+	out.pos_y = obj.posY;
+	out.pos_z = obj.posZ;
+	out.rot_x = obj.rotX;
+	out.rot_y = obj.rotY;
+	out.rot_z = obj.rotZ;
+	out.scale_x = obj.scaleX;
+	out.scale_y = obj.scaleY;
+	out.scale_z = obj.scaleZ;
+	out.enabled = obj.enabled;
+	out.properties = obj.properties;
 }
 
-bool StateStore::createSettingsEntity()
+void toEntity(const std::string &platform, int bitrate, const std::string &resolution, int framerate,
+	      BroadcastSettings &out)
 {
-	// BroadcastSettings entity
-	obx_model_entity(model_, "BroadcastSettings", settingsEntityId_, 0);
-	obx_model_property(model_, "platform", OBXPropertyType_String, settingsPlatformProp_, 0);
-	obx_model_property_flags(model_, OBXPropertyFlags_INDEXED | OBXPropertyFlags_UNIQUE);
+	out = BroadcastSettings{};
+	out.platform = platform;
+	out.bitrate = bitrate;
+	out.resolution = resolution;
+	out.framerate = framerate;
+	out.enabled = true;
+}
 
-	obx_model_property(model_, "bitrate", OBXPropertyType_Int, settingsBitrateProp_, 0);
-	obx_model_property(model_, "resolution", OBXPropertyType_String, 3, 0);
-	obx_model_property(model_, "framerate", OBXPropertyType_Int, 4, 0);
-	obx_model_property(model_, "encoder", OBXPropertyType_String, 5, 0);
+StateStore::KeyframeData toKeyframeData(const AnimationKeyframeReader &reader)
+{
+	StateStore::KeyframeData kf;
+	kf.id = reader.id();
+	kf.objectId = reader.objectId();
+	kf.nodeId.assign(reader.nodeId());
+	kf.timestampMs = reader.timestampMs();
+	kf.posX = reader.posX();
+	kf.posY = reader.posY();
+	kf.posZ = reader.posZ();
+	kf.rotX = reader.rotX();
+	kf.rotY = reader.rotY();
+	kf.rotZ = reader.rotZ();
+	kf.scaleX = reader.scaleX();
+	kf.scaleY = reader.scaleY();
+	kf.scaleZ = reader.scaleZ();
+	kf.interpolation.assign(reader.interpolation());
+	return kf;
+}
 
-	obx_model_entity_last_property_id(model_, 5, 0);
-	return true;
+StateStore::SceneObjectData toSceneObjectData(const SceneObjectReader &reader)
+{
+	StateStore::SceneObjectData obj;
+	obj.id = reader.id();
+	obj.nodeId.assign(reader.nodeId());
+	obj.type.assign(reader.type());
+	obj.name.assign(reader.name());
+	obj.posX = reader.posX();
+	obj.posY = reader.posY();
+	obj.posZ = reader.posZ();
+	obj.rotX = reader.rotX();
+	obj.rotY = reader.rotY();
+	obj.rotZ = reader.rotZ();
+	obj.scaleX = reader.scaleX();
+	obj.scaleY = reader.scaleY();
+	obj.scaleZ = reader.scaleZ();
+	obj.enabled = reader.enabled();
+	obj.properties.assign(reader.properties());
+	return obj;
 }
 
-bool StateStore::createSceneObjectEntity()
-{
-	// SceneObject entity
-	obx_model_entity(model_, "SceneObject", sceneObjectEntityId_, 0);
-	obx_model_property(model_, "nodeId", OBXPropertyType_String, sceneObjNodeIdProp_, 0);
-	obx_model_property_flags(model_, OBXPropertyFlags_INDEXED | OBXPropertyFlags_UNIQUE);
-
-	obx_model_property(model_, "type", OBXPropertyType_String, sceneObjTypeProp_, 0);
-	obx_model_property(model_, "name", OBXPropertyType_String, 3, 0);
-	obx_model_property(model_, "posX", OBXPropertyType_Float, 4, 0);
-	obx_model_property(model_, "posY", OBXPropertyType_Float, 5, 0);
-	obx_model_property(model_, "posZ", OBXPropertyType_Float, 6, 0);
-	obx_model_property(model_, "rotX", OBXPropertyType_Float, 7, 0);
-	obx_model_property(model_, "rotY", OBXPropertyType_Float, 8, 0);
-	obx_model_property(model_, "rotZ", OBXPropertyType_Float, 9, 0);
-	obx_model_property(model_, "scaleX", OBXPropertyType_Float, 10, 0);
-	obx_model_property(model_, "scaleY", OBXPropertyType_Float, 11, 0);
-	obx_model_property(model_, "scaleZ", OBXPropertyType_Float, 12, 0);
-	obx_model_property(model_, "enabled", OBXPropertyType_Bool, 13, 0);
-	obx_model_property(model_, "properties", OBXPropertyType_String, 14, 0);
-
-	obx_model_entity_last_property_id(model_, 14, 0);
-	return true;
+KeyframeTimeline::Keyframe toTimelineKeyframe(const StateStore::KeyframeData &kf)
+{
+	KeyframeTimeline::Keyframe out;
+	out.id = kf.id;
+	out.timestampMs = kf.timestampMs;
+	out.values = {kf.posX, kf.posY, kf.posZ, kf.rotX, kf.rotY, kf.rotZ, kf.scaleX, kf.scaleY, kf.scaleZ};
+	out.interpolation = KeyframeTimeline::parseInterpolation(kf.interpolation);
+	return out;
 }
 
-bool StateStore::createKeyframeEntity()
+KeyframeTimeline::Keyframe toTimelineKeyframe(const AnimationKeyframeReader &reader)
 {
-	// AnimationKeyframe entity
-	obx_model_entity(model_, "AnimationKeyframe", keyframeEntityId_, 0);
-	obx_model_property(model_, "objectId", OBXPropertyType_Long, keyframeObjIdProp_, 0);
-	obx_model_property_flags(model_, OBXPropertyFlags_INDEXED);
+	KeyframeTimeline::Keyframe out;
+	out.id = reader.id();
+	out.timestampMs = reader.timestampMs();
+	out.values = {reader.posX(), reader.posY(), reader.posZ(),   reader.rotX(),  reader.rotY(),
+		      reader.rotZ(), reader.scaleX(), reader.scaleY(), reader.scaleZ()};
+	out.interpolation = KeyframeTimeline::parseInterpolation(reader.interpolation());
+	return out;
+}
 
-	obx_model_property(model_, "timestampMs", OBXPropertyType_Long, keyframeTimestampProp_, 0);
-	obx_model_property_flags(model_, OBXPropertyFlags_INDEXED);
+} // namespace
+
+StateStore::StateStore(QObject *parent)
+	: QObject(parent),
+	  settingsEntityId_(BroadcastSettings::_OBX_MetaInfo::entityId()),
+	  sceneObjectEntityId_(SceneObject::_OBX_MetaInfo::entityId()),
+	  keyframeEntityId_(AnimationKeyframe::_OBX_MetaInfo::entityId()),
+	  settingsPlatformProp_(BroadcastSettings_::platform.id()),
+	  settingsBitrateProp_(BroadcastSettings_::bitrate.id()),
+	  sceneObjNodeIdProp_(SceneObject_::node_id.id()),
+	  sceneObjTypeProp_(SceneObject_::type.id()),
+	  keyframeObjIdProp_(AnimationKeyframe_::object_id.id()),
+	  keyframeTimestampProp_(AnimationKeyframe_::timestamp_ms.id())
+{
+}
 
-	obx_model_property(model_, "nodeId", OBXPropertyType_String, 3, 0);
-	obx_model_property(model_, "posX", OBXPropertyType_Float, 4, 0);
-	obx_model_property(model_, "posY", OBXPropertyType_Float, 5, 0);
-	obx_model_property(model_, "posZ", OBXPropertyType_Float, 6, 0);
-	obx_model_property(model_, "rotX", OBXPropertyType_Float, 7, 0);
-	obx_model_property(model_, "rotY", OBXPropertyType_Float, 8, 0);
-	obx_model_property(model_, "rotZ", OBXPropertyType_Float, 9, 0);
-	obx_model_property(model_, "scaleX", OBXPropertyType_Float, 10, 0);
-	obx_model_property(model_, "scaleY", OBXPropertyType_Float, 11, 0);
-	obx_model_property(model_, "scaleZ", OBXPropertyType_Float, 12, 0);
-	obx_model_property(model_, "interpolation", OBXPropertyType_String, 13, 0);
+StateStore::~StateStore()
+{
+	close();
+}
 
-	obx_model_entity_last_property_id(model_, 13, 0);
-	return true;
+void StateStore::createModel()
+{
+	// Generated from the .fbs schemas by add_obx_schema; keeps entity/property ids
+	// in sync with the generated FlatBuffer (de)serializers used below.
+	model_ = create_obx_model();
+	if (!model_) {
+		qCritical() << "Failed to create ObjectBox model";
+	}
 }
 
 bool StateStore::initialize(const std::string &dbPath)
@@ -118,18 +182,250 @@ bool StateStore::initialize(const std::string &dbPath)
 		return false;
 	}
 
+	if (!prepareQueries()) {
+		qCritical() << "Failed to prepare ObjectBox queries:" << obx_last_error_message();
+		close();
+		return false;
+	}
+
 	qInfo() << "ObjectBox store initialized at:" << QString::fromStdString(dbPath);
 	return true;
 }
 
 void StateStore::close()
 {
+	// Commit anything still queued while the store is open
+	disableWriteBehind();
+
+	{
+		std::lock_guard<std::mutex> lock(timelinesMutex_);
+		timelines_.clear();
+	}
+
+	closeQueries();
+
 	if (store_) {
 		obx_store_close(store_);
 		store_ = nullptr;
 	}
 }
 
+bool StateStore::prepareQueries()
+{
+	// Conditions are built with placeholder values; the real ones are bound with obx_query_param_*
+	OBX_query_builder *qb = obx_query_builder(store_, sceneObjectEntityId_);
+	allSceneObjectsQuery_ = obx_query(qb);
+	obx_qb_close(qb);
+
+	qb = obx_query_builder(store_, sceneObjectEntityId_);
+	obx_qb_equals_string(qb, sceneObjNodeIdProp_, "", true);
+	sceneObjectByNodeIdQuery_ = obx_query(qb);
+	obx_qb_close(qb);
+
+	qb = obx_query_builder(store_, keyframeEntityId_);
+	obx_qb_equals_int(qb, keyframeObjIdProp_, 0);
+	obx_qb_between_2ints(qb, keyframeTimestampProp_, 0, 0);
+	obx_qb_order(qb, keyframeTimestampProp_, 0);
+	keyframesForObjectQuery_ = obx_query(qb);
+	obx_qb_close(qb);
+
+	qb = obx_query_builder(store_, settingsEntityId_);
+	obx_qb_equals_string(qb, settingsPlatformProp_, "", true);
+	settingsByPlatformQuery_ = obx_query(qb);
+	obx_qb_close(qb);
+
+	return allSceneObjectsQuery_ && sceneObjectByNodeIdQuery_ && keyframesForObjectQuery_ &&
+	       settingsByPlatformQuery_;
+}
+
+void StateStore::closeQueries()
+{
+	std::lock_guard<std::mutex> lock(queryMutex_);
+	for (OBX_query **query : {&allSceneObjectsQuery_, &sceneObjectByNodeIdQuery_, &keyframesForObjectQuery_,
+				  &settingsByPlatformQuery_}) {
+		if (*query) {
+			obx_query_close(*query);
+			*query = nullptr;
+		}
+	}
+}
+
+// === Write-behind ===
+
+void StateStore::enableWriteBehind(const WriteBehindConfig &config)
+{
+	if (journal_)
+		return;
+
+	journal_ = std::make_unique<WriteBehindJournal<PendingWrite>>(
+		[this](std::vector<PendingWrite> &batch) { return commitPendingWrites(batch); }, config);
+	journal_->start();
+}
+
+void StateStore::disableWriteBehind()
+{
+	if (!journal_)
+		return;
+
+	journal_->stop(); // Final flush
+	const WriteBehindMetrics metrics = journal_->getMetrics();
+	if (metrics.queueDepth > 0 || !flush()) {
+		qWarning() << "Write-behind disabled with uncommitted writes";
+	}
+	journal_.reset();
+
+	std::lock_guard<std::mutex> lock(writeMutex_);
+	sceneObjectIds_.clear();
+	settingsIds_.clear();
+}
+
+bool StateStore::flush()
+{
+	return journal_ ? journal_->flush() : true;
+}
+
+WriteBehindMetrics StateStore::getWriteBehindMetrics() const
+{
+	return journal_ ? journal_->getMetrics() : WriteBehindMetrics{};
+}
+
+bool StateStore::commitPendingWrites(std::vector<PendingWrite> &batch)
+{
+	if (!store_)
+		return false;
+
+	// Held until the id caches are updated, so a delete can't land between the lookup and the put
+	std::unique_lock<std::mutex> writeLock(writeMutex_);
+
+	// Resolve existing ids first; the lookups run their own read transactions
+	std::vector<obx_id> ids(batch.size(), 0);
+	for (size_t i = 0; i < batch.size(); ++i) {
+		const PendingWrite &write = batch[i];
+		if (write.kind == PendingWrite::Kind::SceneObject) {
+			ids[i] = write.object.id ? write.object.id : findSceneObjectId(write.object.nodeId);
+		} else {
+			ids[i] = findSettingsId(write.platform);
+		}
+	}
+
+	OBX_txn *txn = obx_txn_write(store_);
+	if (!txn) {
+		qWarning() << "Failed to begin write-behind transaction:" << obx_last_error_message();
+		return false;
+	}
+
+	OBX_cursor *objectCursor = obx_cursor(txn, sceneObjectEntityId_);
+	OBX_cursor *settingsCursor = obx_cursor(txn, settingsEntityId_);
+	bool ok = objectCursor && settingsCursor;
+
+	flatbuffers::FlatBufferBuilder fbb(512);
+	SceneObject object{};
+	BroadcastSettings settings{};
+
+	for (size_t i = 0; ok && i < batch.size(); ++i) {
+		const PendingWrite &write = batch[i];
+		OBX_cursor *cursor = write.kind == PendingWrite::Kind::SceneObject ? objectCursor : settingsCursor;
+
+		obx_id id = ids[i];
+		const bool isNew = id == 0;
+		if (isNew) {
+			id = obx_cursor_id_for_put(cursor, 0);
+			if (!id) {
+				ok = false;
+				break;
+			}
+		}
+
+		if (write.kind == PendingWrite::Kind::SceneObject) {
+			toEntity(write.object, object);
+			object.id = id;
+			SceneObject::_OBX_MetaInfo::toFlatBuffer(fbb, object);
+		} else {
+			toEntity(write.platform, write.bitrate, write.resolution, write.framerate, settings);
+			settings.id = id;
+			BroadcastSettings::_OBX_MetaInfo::toFlatBuffer(fbb, settings);
+		}
+
+		obx_err err = isNew ? obx_cursor_put_new(cursor, id, fbb.GetBufferPointer(), fbb.GetSize())
+				    : obx_cursor_put(cursor, id, fbb.GetBufferPointer(), fbb.GetSize());
+		ok = err == OBX_SUCCESS;
+		ids[i] = id;
+	}
+
+	if (objectCursor)
+		obx_cursor_close(objectCursor);
+	if (settingsCursor)
+		obx_cursor_close(settingsCursor);
+
+	if (ok) {
+		ok = obx_txn_success(txn) == OBX_SUCCESS;
+	} else {
+		obx_txn_close(txn);
+	}
+
+	if (!ok) {
+		qWarning() << "Write-behind commit of" << batch.size() << "writes failed:" << obx_last_error_message();
+		return false;
+	}
+
+	for (size_t i = 0; i < batch.size(); ++i) {
+		const PendingWrite &write = batch[i];
+		if (write.kind == PendingWrite::Kind::SceneObject) {
+			sceneObjectIds_[write.object.nodeId] = ids[i];
+		} else {
+			settingsIds_[write.platform] = ids[i];
+		}
+	}
+	writeLock.unlock();
+
+	// Signals go out once per coalesced record, after the data is readable
+	for (const PendingWrite &write : batch) {
+		if (write.kind == PendingWrite::Kind::SceneObject) {
+			emit sceneObjectChanged(QString::fromStdString(write.object.nodeId));
+		} else {
+			emit settingsChanged(QString::fromStdString(write.platform));
+		}
+	}
+	return true;
+}
+
+obx_id StateStore::findSceneObjectId(const std::string &nodeId)
+{
+	auto cached = sceneObjectIds_.find(nodeId);
+	if (cached != sceneObjectIds_.end())
+		return cached->second;
+
+	obx_id id = 0;
+	auto visitor = [&](const SceneObjectReader &reader) {
+		id = reader.id();
+		return false;
+	};
+
+	std::lock_guard<std::mutex> lock(queryMutex_);
+	obx_query_param_string(sceneObjectByNodeIdQuery_, sceneObjectEntityId_, sceneObjNodeIdProp_, nodeId.c_str());
+	obx_query_visit(sceneObjectByNodeIdQuery_, visitWithReader<SceneObjectReader, decltype(visitor)>, &visitor);
+	return id;
+}
+
+obx_id StateStore::findSettingsId(const std::string &platform)
+{
+	auto cached = settingsIds_.find(platform);
+	if (cached != settingsIds_.end())
+		return cached->second;
+
+	obx_id id = 0;
+	auto visitor = [&](const BroadcastSettingsReader &reader) {
+		id = reader.id();
+		return false;
+	};
+
+	std::lock_guard<std::mutex> lock(queryMutex_);
+	obx_query_param_string(settingsByPlatformQuery_, settingsEntityId_, settingsPlatformProp_, platform.c_str());
+	obx_query_visit(settingsByPlatformQuery_, visitWithReader<BroadcastSettingsReader, decltype(visitor)>,
+			&visitor);
+	return id;
+}
+
 // === Broadcast Settings Implementation ===
 
 obx_id StateStore::putSettings(const std::string &platform, int bitrate, const std::string &resolution, int framerate)
@@ -137,21 +433,61 @@ obx_id StateStore::putSettings(const std::string &platform, int bitrate, const s
 	if (!store_)
 		return 0;
 
-	flatbuffers::FlatBufferBuilder fbb(256);
-
-	auto platformStr = fbb.CreateString(platform);
-	auto resolutionStr = fbb.CreateString(resolution);
-
-	// Simple FlatBuffer construction (manual for now)
-	fbb.Finish(fbb.CreateTable());
+	if (journal_) {
+		PendingWrite write;
+		write.kind = PendingWrite::Kind::Settings;
+		write.key = "s:" + platform;
+		write.platform = platform;
+		write.bitrate = bitrate;
+		write.resolution = resolution;
+		write.framerate = framerate;
+		journal_->push(std::move(write));
+		return 0;
+	}
 
-	OBX_box *box = obx_box(store_, settingsEntityId_);
-	obx_id id = obx_box_put_object(box, (void *)fbb.GetBufferPointer(), fbb.GetSize());
+	// Update the platform's row in place, like commitPendingWrites(): readers return the first match
+	obx_id id = 0;
+	{
+		std::lock_guard<std::mutex> lock(writeMutex_);
+		BroadcastSettings settings;
+		toEntity(platform, bitrate, resolution, framerate, settings);
+		settings.id = findSettingsId(platform);
+
+		flatbuffers::FlatBufferBuilder fbb(256);
+		BroadcastSettings::_OBX_MetaInfo::toFlatBuffer(fbb, settings);
+
+		OBX_box *box = obx_box(store_, settingsEntityId_);
+		id = obx_box_put_object(box, (void *)fbb.GetBufferPointer(), fbb.GetSize());
+		if (!id)
+			return 0;
+		settingsIds_[platform] = id;
+	}
 
 	emit settingsChanged(QString::fromStdString(platform));
 	return id;
 }
 
+bool StateStore::getSettings(const std::string &platform, int &bitrate, std::string &resolution, int &framerate)
+{
+	if (!store_)
+		return false;
+
+	bool found = false;
+	auto visitor = [&](const BroadcastSettingsReader &settings) {
+		bitrate = settings.bitrate();
+		resolution.assign(settings.resolution());
+		framerate = settings.framerate();
+		found = true;
+		return false;
+	};
+
+	std::lock_guard<std::mutex> lock(queryMutex_);
+	obx_query_param_string(settingsByPlatformQuery_, settingsEntityId_, settingsPlatformProp_, platform.c_str());
+	obx_query_visit(settingsByPlatformQuery_, visitWithReader<BroadcastSettingsReader, decltype(visitor)>,
+			&visitor);
+	return found;
+}
+
 // === Scene Object Implementation ===
 
 obx_id StateStore::putSceneObject(const SceneObjectData &obj)
@@ -159,100 +495,349 @@ obx_id StateStore::putSceneObject(const SceneObjectData &obj)
 	if (!store_)
 		return 0;
 
-	flatbuffers::FlatBufferBuilder fbb(512);
-
-	// Build FlatBuffer for SceneObject
-	auto nodeIdStr = fbb.CreateString(obj.nodeId);
-	auto typeStr = fbb.CreateString(obj.type);
-	auto nameStr = fbb.CreateString(obj.name);
-	auto propsStr = fbb.CreateString(obj.properties);
-
-	fbb.Finish(fbb.CreateTable());
+	if (journal_) {
+		PendingWrite write;
+		write.kind = PendingWrite::Kind::SceneObject;
+		write.key = "o:" + obj.nodeId;
+		write.object = obj;
+		journal_->push(std::move(write));
+		return obj.id;
+	}
 
-	OBX_box *box = obx_box(store_, sceneObjectEntityId_);
-	obx_id id = obx_box_put_object(box, (void *)fbb.GetBufferPointer(), fbb.GetSize());
+	obx_id id = 0;
+	{
+		std::lock_guard<std::mutex> lock(writeMutex_);
+		SceneObject entity{};
+		toEntity(obj, entity);
+		if (!entity.id)
+			entity.id = findSceneObjectId(obj.nodeId);
+
+		flatbuffers::FlatBufferBuilder fbb(512);
+		SceneObject::_OBX_MetaInfo::toFlatBuffer(fbb, entity);
+
+		OBX_box *box = obx_box(store_, sceneObjectEntityId_);
+		id = obx_box_put_object(box, (void *)fbb.GetBufferPointer(), fbb.GetSize());
+		if (!id)
+			return 0;
+		sceneObjectIds_[obj.nodeId] = id;
+	}
 
 	emit sceneObjectChanged(QString::fromStdString(obj.nodeId));
 	return id;
 }
 
+bool StateStore::getSceneObject(obx_id id, SceneObjectData &obj)
+{
+	if (!store_)
+		return false;
+
+	OBX_txn *txn = obx_txn_read(store_);
+	if (!txn)
+		return false;
+
+	bool found = false;
+	OBX_cursor *cursor = obx_cursor(txn, sceneObjectEntityId_);
+	if (cursor) {
+		const void *data = nullptr;
+		size_t size = 0;
+		if (obx_cursor_get(cursor, id, &data, &size) == OBX_SUCCESS) {
+			obj = toSceneObjectData(SceneObjectReader(data));
+			found = true;
+		}
+		obx_cursor_close(cursor);
+	}
+
+	obx_txn_close(txn);
+	return found;
+}
+
+bool StateStore::getSceneObjectByNodeId(const std::string &nodeId, SceneObjectData &obj)
+{
+	if (!store_)
+		return false;
+
+	bool found = false;
+	auto visitor = [&](const SceneObjectReader &reader) {
+		obj = toSceneObjectData(reader);
+		found = true;
+		return false;
+	};
+
+	std::lock_guard<std::mutex> lock(queryMutex_);
+	obx_query_param_string(sceneObjectByNodeIdQuery_, sceneObjectEntityId_, sceneObjNodeIdProp_, nodeId.c_str());
+	obx_query_visit(sceneObjectByNodeIdQuery_, visitWithReader<SceneObjectReader, decltype(visitor)>, &visitor);
+	return found;
+}
+
 std::vector<StateStore::SceneObjectData> StateStore::getAllSceneObjects()
 {
 	std::vector<SceneObjectData> result;
 	if (!store_)
 		return result;
 
+	auto visitor = [&](const SceneObjectReader &reader) {
+		result.push_back(toSceneObjectData(reader));
+		return true;
+	};
+
+	std::lock_guard<std::mutex> lock(queryMutex_);
+	uint64_t count = 0;
+	if (obx_query_count(allSceneObjectsQuery_, &count) == OBX_SUCCESS) {
+		result.reserve(count);
+	}
+	obx_query_visit(allSceneObjectsQuery_, visitWithReader<SceneObjectReader, decltype(visitor)>, &visitor);
+	return result;
+}
+
+bool StateStore::visitSceneObjects(const SceneObjectVisitor &visitor)
+{
+	if (!store_)
+		return false;
+
+	std::lock_guard<std::mutex> lock(queryMutex_);
+	return obx_query_visit(allSceneObjectsQuery_, visitWithReader<SceneObjectReader, const SceneObjectVisitor>,
+			       const_cast<SceneObjectVisitor *>(&visitor)) == OBX_SUCCESS;
+}
+
+void StateStore::deleteSceneObject(obx_id id)
+{
+	if (!store_)
+		return;
+
+	// A queued put of this object would otherwise be committed after the remove and bring it back.
+	// Puts queued after this point are newer than the delete and may recreate the object.
+	flush();
+
+	// Not while a commit is between resolving this id and writing to it
+	std::lock_guard<std::mutex> lock(writeMutex_);
 	OBX_box *box = obx_box(store_, sceneObjectEntityId_);
-	OBX_bytes_array *objects = obx_box_get_all(box);
+	if (obx_box_remove(box, id) != OBX_SUCCESS)
+		return;
 
-	if (objects) {
-		for (size_t i = 0; i < objects->count; ++i) {
-			// TODO: Parse FlatBuffer and populate SceneObjectData
-			// For now, return empty vector
+	// The next put of this nodeId creates a new record instead of reusing the removed id
+	for (auto it = sceneObjectIds_.begin(); it != sceneObjectIds_.end(); ++it) {
+		if (it->second == id) {
+			sceneObjectIds_.erase(it);
+			break;
 		}
-		obx_bytes_array_free(objects);
 	}
-
-	return result;
 }
 
 // === Animation Keyframe Implementation ===
 
 obx_id StateStore::putKeyframe(const KeyframeData &kf)
 {
-	if (!store_)
+	std::vector<KeyframeData> single{kf};
+	if (!putKeyframes(single))
 		return 0;
+	return single.front().id;
+}
+
+bool StateStore::putKeyframes(std::vector<KeyframeData> &keyframes)
+{
+	if (!store_)
+		return false;
+	if (keyframes.empty())
+		return true;
+
+	// One keyframe per (object, timestamp), as in the timelines: a keyframe at a
+	// taken timestamp overwrites that record. Lookups run before the write transaction.
+	std::unordered_map<obx_id, std::pair<int64_t, int64_t>> ranges;
+	for (const KeyframeData &kf : keyframes) {
+		auto it = ranges.try_emplace(kf.objectId, kf.timestampMs, kf.timestampMs).first;
+		it->second.first = std::min(it->second.first, kf.timestampMs);
+		it->second.second = std::max(it->second.second, kf.timestampMs);
+	}
+
+	std::map<std::pair<obx_id, int64_t>, obx_id> existing;
+	for (const auto &[objectId, range] : ranges) {
+		visitKeyframesForObject(objectId, range.first, range.second, [&](const AnimationKeyframeReader &reader) {
+			existing[{objectId, reader.timestampMs()}] = reader.id();
+			return true;
+		});
+	}
 
+	OBX_txn *txn = obx_txn_write(store_);
+	if (!txn) {
+		qWarning() << "Failed to begin keyframe transaction:" << obx_last_error_message();
+		return false;
+	}
+
+	OBX_cursor *cursor = obx_cursor(txn, keyframeEntityId_);
+	bool ok = cursor != nullptr;
+
+	std::vector<obx_id> ids(keyframes.size(), 0);
 	flatbuffers::FlatBufferBuilder fbb(256);
+	AnimationKeyframe entity{};
+
+	for (size_t i = 0; ok && i < keyframes.size(); ++i) {
+		// Also covers repeats within the batch: the later one overwrites the earlier
+		obx_id &id = existing[{keyframes[i].objectId, keyframes[i].timestampMs}];
+		const bool isNew = id == 0;
+		if (isNew) {
+			id = obx_cursor_id_for_put(cursor, 0);
+			if (!id) {
+				ok = false;
+				break;
+			}
+		}
 
-	auto nodeIdStr = fbb.CreateString(kf.nodeId);
-	auto interpStr = fbb.CreateString(kf.interpolation);
+		toEntity(keyframes[i], id, entity);
+		AnimationKeyframe::_OBX_MetaInfo::toFlatBuffer(fbb, entity);
+		obx_err err = isNew ? obx_cursor_put_new(cursor, id, fbb.GetBufferPointer(), fbb.GetSize())
+				    : obx_cursor_put(cursor, id, fbb.GetBufferPointer(), fbb.GetSize());
+		ok = err == OBX_SUCCESS;
+		ids[i] = id;
+	}
 
-	fbb.Finish(fbb.CreateTable());
+	if (cursor)
+		obx_cursor_close(cursor);
 
-	OBX_box *box = obx_box(store_, keyframeEntityId_);
-	obx_id id = obx_box_put_object(box, (void *)fbb.GetBufferPointer(), fbb.GetSize());
+	if (ok) {
+		// Commits and closes the transaction
+		ok = obx_txn_success(txn) == OBX_SUCCESS;
+	} else {
+		// Closing without success aborts, so nothing from this batch is written
+		obx_txn_close(txn);
+	}
 
-	emit keyframeAdded(kf.objectId, kf.timestampMs);
-	return id;
+	if (!ok) {
+		qWarning() << "Failed to write" << keyframes.size() << "keyframes:" << obx_last_error_message();
+		return false;
+	}
+
+	// Group by object so each timeline is rebuilt once per batch
+	std::unordered_map<obx_id, std::vector<KeyframeTimeline::Keyframe>> byObject;
+	for (size_t i = 0; i < keyframes.size(); ++i) {
+		keyframes[i].id = ids[i];
+		byObject[keyframes[i].objectId].push_back(toTimelineKeyframe(keyframes[i]));
+	}
+
+	for (const auto &[objectId, objectKeyframes] : byObject) {
+		updateTimeline(objectId, objectKeyframes);
+	}
+
+	if (keyframes.size() == 1) {
+		emit keyframeAdded(keyframes.front().objectId, keyframes.front().timestampMs);
+	} else {
+		for (const auto &[objectId, objectKeyframes] : byObject) {
+			auto [minIt, maxIt] = std::minmax_element(
+				objectKeyframes.begin(), objectKeyframes.end(),
+				[](const auto &a, const auto &b) { return a.timestampMs < b.timestampMs; });
+			emit keyframesAdded(objectId, minIt->timestampMs, maxIt->timestampMs);
+		}
+	}
+	return true;
 }
 
 std::vector<StateStore::KeyframeData> StateStore::getKeyframesForObject(obx_id objectId, int64_t startTimeMs,
 									int64_t endTimeMs)
 {
-
 	std::vector<KeyframeData> result;
+	visitKeyframesForObject(objectId, startTimeMs, endTimeMs, [&](const AnimationKeyframeReader &reader) {
+		result.push_back(toKeyframeData(reader));
+		return true;
+	});
+	return result;
+}
+
+bool StateStore::visitKeyframesForObject(obx_id objectId, int64_t startTimeMs, int64_t endTimeMs,
+					 const KeyframeVisitor &visitor)
+{
 	if (!store_)
-		return result;
+		return false;
 
-	OBX_box *box = obx_box(store_, keyframeEntityId_);
+	// objectId == objectId AND timestampMs BETWEEN start AND end, ordered by timestamp
+	std::lock_guard<std::mutex> lock(queryMutex_);
+	obx_query_param_int(keyframesForObjectQuery_, keyframeEntityId_, keyframeObjIdProp_,
+			    static_cast<int64_t>(objectId));
+	obx_query_param_2ints(keyframesForObjectQuery_, keyframeEntityId_, keyframeTimestampProp_, startTimeMs,
+			      endTimeMs);
+	return obx_query_visit(keyframesForObjectQuery_,
+			       visitWithReader<AnimationKeyframeReader, const KeyframeVisitor>,
+			       const_cast<KeyframeVisitor *>(&visitor)) == OBX_SUCCESS;
+}
 
-	// Build query: objectId == objectId AND timestampMs BETWEEN start AND end
-	OBX_query_builder *qb = obx_query_builder(store_, keyframeEntityId_);
-	obx_qb_int_equal(qb, keyframeObjIdProp_, objectId);
-	obx_qb_int_between(qb, keyframeTimestampProp_, startTimeMs, endTimeMs);
+void StateStore::deleteKeyframe(obx_id id)
+{
+	if (!store_)
+		return;
 
-	OBX_query *query = obx_query(qb);
-	OBX_bytes_array *objects = obx_query_find(query);
+	OBX_box *box = obx_box(store_, keyframeEntityId_);
+	if (obx_box_remove(box, id) != OBX_SUCCESS)
+		return;
 
-	if (objects) {
-		for (size_t i = 0; i < objects->count; ++i) {
-			// TODO: Parse FlatBuffer and populate KeyframeData
+	// Keyframe ids are unique, so at most one loaded timeline holds it
+	std::lock_guard<std::mutex> lock(timelinesMutex_);
+	for (auto &[objectId, timeline] : timelines_) {
+		if (timeline->contains(id)) {
+			auto updated = std::make_shared<KeyframeTimeline>(*timeline);
+			updated->remove(id);
+			timeline = std::move(updated);
+			break;
 		}
-		obx_bytes_array_free(objects);
 	}
-
-	obx_query_close(query);
-	return result;
 }
 
-void StateStore::deleteKeyframe(obx_id id)
+// === Keyframe Timelines ===
+
+bool StateStore::loadTimeline(obx_id objectId)
 {
 	if (!store_)
-		return;
+		return false;
 
-	OBX_box *box = obx_box(store_, keyframeEntityId_);
-	obx_box_remove(box, id);
+	// Straight from the stored FlatBuffers into timeline entries; no intermediate KeyframeData copies
+	std::vector<KeyframeTimeline::Keyframe> entries;
+	bool ok = visitKeyframesForObject(objectId, std::numeric_limits<int64_t>::min(),
+					  std::numeric_limits<int64_t>::max(), [&](const AnimationKeyframeReader &reader) {
+						  entries.push_back(toTimelineKeyframe(reader));
+						  return true;
+					  });
+	if (!ok)
+		return false;
+
+	auto timeline = std::make_shared<KeyframeTimeline>();
+	timeline->insertMany(entries);
+
+	std::lock_guard<std::mutex> lock(timelinesMutex_);
+	timelines_[objectId] = std::move(timeline);
+	return true;
+}
+
+void StateStore::unloadTimeline(obx_id objectId)
+{
+	std::lock_guard<std::mutex> lock(timelinesMutex_);
+	timelines_.erase(objectId);
+}
+
+std::shared_ptr<const KeyframeTimeline> StateStore::getTimeline(obx_id objectId) const
+{
+	std::lock_guard<std::mutex> lock(timelinesMutex_);
+	auto it = timelines_.find(objectId);
+	return it != timelines_.end() ? it->second : nullptr;
+}
+
+bool StateStore::sampleTransform(obx_id objectId, int64_t timeMs, KeyframeTimeline::Sample &out) const
+{
+	auto timeline = getTimeline(objectId);
+	return timeline && timeline->sample(timeMs, out);
+}
+
+void StateStore::updateTimeline(obx_id objectId, const std::vector<KeyframeTimeline::Keyframe> &keyframes)
+{
+	std::lock_guard<std::mutex> lock(timelinesMutex_);
+	auto it = timelines_.find(objectId);
+	if (it == timelines_.end())
+		return; // Not loaded; loadTimeline will read these from the database
+
+	// Copy-on-write: readers still sampling the old timeline keep a valid snapshot
+	auto updated = std::make_shared<KeyframeTimeline>(*it->second);
+	if (keyframes.size() == 1) {
+		updated->insert(keyframes.front());
+	} else {
+		updated->insertMany(keyframes);
+	}
+	it->second = std::move(updated);
 }
 
 } // namespace NeuralStudio
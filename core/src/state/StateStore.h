@@ -3,8 +3,13 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <mutex>
+#include <unordered_map>
 #include <objectbox.h>
 #include <QObject>
+#include "KeyframeTimeline.h"
+#include "StateReaders.h"
+#include "WriteBehindJournal.h"
 
 namespace NeuralStudio {
 
@@ -16,6 +21,16 @@ namespace NeuralStudio {
  * - Animation keyframes (time-series)
  * - 3D scene object state
  * - State sync across Blueprint ↔ Active frames
+ *
+ * Keyframes are mirrored into per-object KeyframeTimeline caches. A timeline
+ * is loaded from the database once (loadTimeline) and then kept current by
+ * every keyframe write/delete before keyframeAdded is emitted, so playback
+ * samples it on the frame path without touching the database.
+ *
+ * With write-behind enabled, putSceneObject/putSettings only enqueue; the
+ * journal coalesces them per nodeId/platform and commits batches on its own
+ * thread, so scrubbing a transform never waits on disk. Reads see queued
+ * writes once they are committed (flush() forces that).
  */
 class StateStore : public QObject {
 	Q_OBJECT
@@ -29,6 +44,7 @@ public:
 	void close();
 
 	// === Broadcast Settings ===
+	// With write-behind enabled, returns 0 and the write is queued
 	obx_id putSettings(const std::string &platform, int bitrate, const std::string &resolution, int framerate);
 	bool getSettings(const std::string &platform, int &bitrate, std::string &resolution, int &framerate);
 
@@ -45,6 +61,7 @@ public:
 		std::string properties; // JSON
 	};
 
+	// With write-behind enabled, returns obj.id (0 for a new object; assigned on commit) and the write is queued
 	obx_id putSceneObject(const SceneObjectData &obj);
 	bool getSceneObject(obx_id id, SceneObjectData &obj);
 	bool getSceneObjectByNodeId(const std::string &nodeId, SceneObjectData &obj);
@@ -63,40 +80,113 @@ public:
 		std::string interpolation{"linear"};
 	};
 
+	// A keyframe at a timestamp the object already has replaces that keyframe (and keeps its id)
 	obx_id putKeyframe(const KeyframeData &kf);
+	// Writes all keyframes in a single transaction and fills in their ids.
+	// All-or-nothing: returns false and writes nothing if any put fails.
+	bool putKeyframes(std::vector<KeyframeData> &keyframes);
 	std::vector<KeyframeData> getKeyframesForObject(obx_id objectId, int64_t startTimeMs, int64_t endTimeMs);
 	void deleteKeyframe(obx_id id);
 
+	// === Write-behind ===
+	// Enable/disable while no puts are in flight. Disabling flushes first.
+	void enableWriteBehind(const WriteBehindConfig &config = {});
+	void disableWriteBehind();
+	bool isWriteBehindEnabled() const { return journal_ != nullptr; }
+	// Save point: commits every queued write on the calling thread; false if the commit failed
+	bool flush();
+	WriteBehindMetrics getWriteBehindMetrics() const;
+
+	// === Zero-copy visitors ===
+	// Records are read in place from ObjectBox memory through prepared queries; a reader is
+	// only valid during its callback. Return false to stop early. Callbacks must not call
+	// back into StateStore reads (the prepared queries are serialized).
+	using SceneObjectVisitor = std::function<bool(const SceneObjectReader &)>;
+	using KeyframeVisitor = std::function<bool(const AnimationKeyframeReader &)>;
+
+	bool visitSceneObjects(const SceneObjectVisitor &visitor);
+	bool visitKeyframesForObject(obx_id objectId, int64_t startTimeMs, int64_t endTimeMs,
+				     const KeyframeVisitor &visitor);
+
+	// === Keyframe Timelines (playback) ===
+	// Reads the object's keyframes from the database into its cached timeline. Call before playback.
+	bool loadTimeline(obx_id objectId);
+	void unloadTimeline(obx_id objectId);
+	// Cached timeline only; never touches the database. Null if not loaded.
+	std::shared_ptr<const KeyframeTimeline> getTimeline(obx_id objectId) const;
+	// Samples the cached timeline; false if it isn't loaded or has no keyframes.
+	bool sampleTransform(obx_id objectId, int64_t timeMs, KeyframeTimeline::Sample &out) const;
+
 signals:
 	void sceneObjectChanged(const QString &nodeId);
 	void keyframeAdded(quint64 objectId, qint64 timestamp);
+	// Emitted once per object by putKeyframes instead of one keyframeAdded per keyframe
+	void keyframesAdded(quint64 objectId, qint64 startTimestamp, qint64 endTimestamp);
 	void settingsChanged(const QString &platform);
 
 private:
 	OBX_store *store_{nullptr};
 	OBX_model *model_{nullptr};
 
-	// Entity IDs
-	obx_schema_id settingsEntityId_{1};
-	obx_schema_id sceneObjectEntityId_{2};
-	obx_schema_id keyframeEntityId_{3};
+	// Entity and property IDs come from the generated model (schemas/profile)
+	obx_schema_id settingsEntityId_;
+	obx_schema_id sceneObjectEntityId_;
+	obx_schema_id keyframeEntityId_;
 
 	// Property IDs for BroadcastSettings
-	obx_schema_id settingsPlatformProp_{1};
-	obx_schema_id settingsBitrateProp_{2};
+	obx_schema_id settingsPlatformProp_;
+	obx_schema_id settingsBitrateProp_;
 
 	// Property IDs for SceneObject
-	obx_schema_id sceneObjNodeIdProp_{1};
-	obx_schema_id sceneObjTypeProp_{2};
+	obx_schema_id sceneObjNodeIdProp_;
+	obx_schema_id sceneObjTypeProp_;
 
 	// Property IDs for AnimationKeyframe
-	obx_schema_id keyframeObjIdProp_{1};
-	obx_schema_id keyframeTimestampProp_{2};
+	obx_schema_id keyframeObjIdProp_;
+	obx_schema_id keyframeTimestampProp_;
+
+	// Compiled once when the store opens; parameters are rebound per call under queryMutex_
+	std::mutex queryMutex_;
+	OBX_query *allSceneObjectsQuery_{nullptr};
+	OBX_query *sceneObjectByNodeIdQuery_{nullptr};
+	OBX_query *keyframesForObjectQuery_{nullptr};
+	OBX_query *settingsByPlatformQuery_{nullptr};
+
+	// Queued mutation; coalesced on key ("o:" + nodeId or "s:" + platform)
+	struct PendingWrite {
+		enum class Kind : uint8_t { SceneObject, Settings };
+		Kind kind{Kind::SceneObject};
+		std::string key;
+		SceneObjectData object;
+		std::string platform;
+		int bitrate{0};
+		std::string resolution;
+		int framerate{0};
+
+		const std::string &coalesceKey() const { return key; }
+	};
+
+	std::unique_ptr<WriteBehindJournal<PendingWrite>> journal_;
+	// Serializes everything that resolves or changes scene object / settings ids (direct puts,
+	// write-behind commits, deletes) and guards the id caches below. Taken before queryMutex_;
+	// never held while signals are emitted.
+	std::mutex writeMutex_;
+	// Ids of records already written, by nodeId / platform
+	std::unordered_map<std::string, obx_id> sceneObjectIds_;
+	std::unordered_map<std::string, obx_id> settingsIds_;
+
+	// Loaded timelines; published copy-on-write so readers can sample without holding the lock
+	mutable std::mutex timelinesMutex_;
+	std::unordered_map<obx_id, std::shared_ptr<const KeyframeTimeline>> timelines_;
 
 	void createModel();
-	bool createSettingsEntity();
-	bool createSceneObjectEntity();
-	bool createKeyframeEntity();
+	bool commitPendingWrites(std::vector<PendingWrite> &batch);
+	// Cached id, else a query; the caller holds writeMutex_
+	obx_id findSceneObjectId(const std::string &nodeId);
+	obx_id findSettingsId(const std::string &platform);
+	bool prepareQueries();
+	void closeQueries();
+	void updateTimeline(obx_id objectId, const std::vector<KeyframeTimeline::Keyframe> &keyframes);
 };
 
 } // namespace NeuralStudio
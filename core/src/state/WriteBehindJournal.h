@@ -0,0 +1,244 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace NeuralStudio {
+
+struct WriteBehindConfig {
+	std::chrono::milliseconds flushInterval{50};
+	size_t maxBatch = 1024; // Wake the flush thread early at this queue depth
+};
+
+struct WriteBehindMetrics {
+	size_t queueDepth = 0;  // Pushed but not yet drained
+	uint64_t enqueued = 0;  // Total pushes
+	uint64_t coalesced = 0; // Pushes superseded by a newer entry with the same key
+	uint64_t committed = 0; // Entries written
+	uint64_t commits = 0;   // Successful batches
+	uint64_t failedCommits = 0;
+	double lastCommitMs = 0.0;
+	double maxCommitMs = 0.0;
+	double avgCommitMs = 0.0;
+};
+
+/**
+ * WriteBehindJournal - Coalescing write-behind queue for StateStore
+ *
+ * Producers push entries from any thread without locking (Vyukov MPSC
+ * queue). A background thread drains the queue every flushInterval, or
+ * sooner once maxBatch entries are waiting, keeps only the newest entry per
+ * coalesceKey() (last writer wins) and hands the batch to the commit
+ * callback, which is expected to write it in one transaction.
+ *
+ * flush() drains and commits everything pushed before the call on the
+ * calling thread, for save points. A failed commit keeps its batch and
+ * retries it with the next drain.
+ *
+ * Entry must be default-constructible, movable and provide
+ * `const std::string &coalesceKey() const`.
+ */
+template<typename Entry> class WriteBehindJournal {
+public:
+	using Config = WriteBehindConfig;
+	using Metrics = WriteBehindMetrics;
+
+	// Returns false if the batch couldn't be written; it is retried with the next drain
+	using CommitFn = std::function<bool(std::vector<Entry> &batch)>;
+
+	explicit WriteBehindJournal(CommitFn commit, Config config = {})
+		: commit_(std::move(commit)), config_(config), head_(&stub_), tail_(&stub_)
+	{
+	}
+
+	~WriteBehindJournal()
+	{
+		stop();
+		Entry discarded;
+		while (pop(discarded)) {
+		}
+		if (tail_ != &stub_)
+			delete tail_;
+	}
+
+	WriteBehindJournal(const WriteBehindJournal &) = delete;
+	WriteBehindJournal &operator=(const WriteBehindJournal &) = delete;
+
+	void start()
+	{
+		if (running_.exchange(true))
+			return;
+		thread_ = std::thread([this] { run(); });
+	}
+
+	// Stops the flush thread after a final flush
+	void stop()
+	{
+		if (!running_.exchange(false))
+			return;
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex_);
+			wakeRequested_ = true;
+		}
+		wakeCv_.notify_one();
+		thread_.join();
+		flush();
+	}
+
+	// Lock-free; safe from any thread
+	void push(Entry entry)
+	{
+		Node *node = new Node;
+		node->entry = std::move(entry);
+		Node *prev = head_.exchange(node, std::memory_order_acq_rel);
+		prev->next.store(node, std::memory_order_release);
+
+		uint64_t pushed = enqueued_.fetch_add(1, std::memory_order_release) + 1;
+		if (pushed - drained_.load(std::memory_order_relaxed) >= config_.maxBatch &&
+		    !wakeRequested_.load(std::memory_order_relaxed)) {
+			{
+				std::lock_guard<std::mutex> lock(wakeMutex_);
+				wakeRequested_ = true;
+			}
+			wakeCv_.notify_one();
+		}
+	}
+
+	// Commits everything pushed before this call; returns false if the commit failed
+	bool flush()
+	{
+		const uint64_t target = enqueued_.load(std::memory_order_acquire);
+		std::lock_guard<std::mutex> lock(consumerMutex_);
+		return drainAndCommit(target);
+	}
+
+	Metrics getMetrics() const
+	{
+		std::lock_guard<std::mutex> lock(metricsMutex_);
+		Metrics metrics = metrics_;
+		metrics.enqueued = enqueued_.load(std::memory_order_relaxed);
+		metrics.queueDepth = static_cast<size_t>(metrics.enqueued - drained_.load(std::memory_order_relaxed));
+		return metrics;
+	}
+
+private:
+	struct Node {
+		std::atomic<Node *> next{nullptr};
+		Entry entry;
+	};
+
+	// Single consumer (guarded by consumerMutex_). The node after tail_ holds the next entry;
+	// once taken it becomes the new stub and the old tail is freed.
+	bool pop(Entry &out)
+	{
+		Node *tail = tail_;
+		Node *next = tail->next.load(std::memory_order_acquire);
+		if (!next)
+			return false;
+
+		out = std::move(next->entry);
+		tail_ = next;
+		if (tail != &stub_)
+			delete tail;
+		drained_.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Drains until at least `target` entries have been taken, then commits the coalesced batch
+	bool drainAndCommit(uint64_t target)
+	{
+		Entry entry;
+		uint64_t coalesced = 0;
+		for (;;) {
+			while (pop(entry)) {
+				auto [it, inserted] = pendingIndex_.try_emplace(entry.coalesceKey(), pending_.size());
+				if (inserted) {
+					pending_.push_back(std::move(entry));
+				} else {
+					pending_[it->second] = std::move(entry);
+					++coalesced;
+				}
+			}
+			// A producer may have swapped head_ but not yet linked its node; wait for it
+			if (drained_.load(std::memory_order_relaxed) >= target)
+				break;
+			std::this_thread::yield();
+		}
+
+		if (pending_.empty()) {
+			std::lock_guard<std::mutex> lock(metricsMutex_);
+			metrics_.coalesced += coalesced;
+			return true;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		bool ok = commit_(pending_);
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::lock_guard<std::mutex> lock(metricsMutex_);
+		metrics_.coalesced += coalesced;
+		if (!ok) {
+			++metrics_.failedCommits;
+			return false;
+		}
+
+		++metrics_.commits;
+		metrics_.committed += pending_.size();
+		metrics_.lastCommitMs = ms;
+		metrics_.maxCommitMs = std::max(metrics_.maxCommitMs, ms);
+		metrics_.avgCommitMs += (ms - metrics_.avgCommitMs) / static_cast<double>(metrics_.commits);
+
+		pending_.clear();
+		pendingIndex_.clear();
+		return true;
+	}
+
+	void run()
+	{
+		while (running_.load(std::memory_order_acquire)) {
+			{
+				std::unique_lock<std::mutex> lock(wakeMutex_);
+				wakeCv_.wait_for(lock, config_.flushInterval, [this] { return wakeRequested_.load(); });
+				wakeRequested_ = false;
+			}
+
+			std::lock_guard<std::mutex> lock(consumerMutex_);
+			drainAndCommit(0);
+		}
+	}
+
+	CommitFn commit_;
+	Config config_;
+
+	// MPSC queue
+	Node stub_;
+	std::atomic<Node *> head_;
+	Node *tail_;
+	std::atomic<uint64_t> enqueued_{0};
+	std::atomic<uint64_t> drained_{0};
+
+	// Consumer state
+	std::mutex consumerMutex_;
+	std::vector<Entry> pending_;
+	std::unordered_map<std::string, size_t> pendingIndex_;
+
+	// Flush thread
+	std::thread thread_;
+	std::atomic<bool> running_{false};
+	std::atomic<bool> wakeRequested_{false};
+	std::mutex wakeMutex_;
+	std::condition_variable wakeCv_;
+
+	mutable std::mutex metricsMutex_;
+	Metrics metrics_;
+};
+
+} // namespace NeuralStudio
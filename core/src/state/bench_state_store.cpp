@@ -0,0 +1,267 @@
+#include "StateStore.h"
+#include "schemas/profile/SceneObject.obx.hpp"
+#include "schemas/profile/objectbox-model.h"
+#include <QDir>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+// Counts every heap allocation in the process so the read paths can be compared by allocations as well as time
+namespace {
+std::atomic<uint64_t> g_allocations {0};
+std::atomic<uint64_t> g_allocatedBytes {0};
+} // namespace
+
+void *operator new(size_t size)
+{
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+	g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	if (void *ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+using namespace NeuralStudio;
+
+namespace {
+
+struct BenchOptions {
+	int objects = 100000;
+	int lookups = 1000;
+	std::string dbPath = QDir::tempPath().toStdString() + "/neural-studio-state-bench";
+};
+
+struct Measurement {
+	const char *name;
+	double ms = 0.0;
+	uint64_t allocations = 0;
+	uint64_t bytes = 0;
+	size_t results = 0;
+};
+
+template<typename Fn> Measurement measure(const char *name, Fn &&fn)
+{
+	Measurement m{name};
+	uint64_t allocationsBefore = g_allocations.load();
+	uint64_t bytesBefore = g_allocatedBytes.load();
+	auto start = std::chrono::steady_clock::now();
+
+	m.results = fn();
+
+	m.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	m.allocations = g_allocations.load() - allocationsBefore;
+	m.bytes = g_allocatedBytes.load() - bytesBefore;
+	return m;
+}
+
+void printMeasurement(const Measurement &m)
+{
+	std::cout << std::left << std::setw(34) << m.name << std::right << std::setw(12) << m.ms << std::setw(12)
+		  << m.allocations << std::setw(14) << m.bytes / 1024 << std::setw(10) << m.results << std::endl;
+}
+
+std::string nodeIdFor(int i)
+{
+	return "node-" + std::to_string(i);
+}
+
+// Writes the scene straight through the C API in one transaction so setup time doesn't dominate
+bool populate(OBX_store *store, int objects)
+{
+	OBX_txn *txn = obx_txn_write(store);
+	OBX_cursor *cursor = txn ? obx_cursor(txn, SceneObject::_OBX_MetaInfo::entityId()) : nullptr;
+	if (!cursor) {
+		if (txn)
+			obx_txn_close(txn);
+		return false;
+	}
+
+	flatbuffers::FlatBufferBuilder fbb(512);
+	SceneObject object{};
+	object.type = "mesh";
+	object.properties = R"({"material":"default","castShadows":true})";
+	object.scale_x = object.scale_y = object.scale_z = 1.0f;
+	object.enabled = true;
+
+	bool ok = true;
+	for (int i = 0; ok && i < objects; ++i) {
+		object.id = obx_cursor_id_for_put(cursor, 0);
+		object.node_id = nodeIdFor(i);
+		object.name = "Object " + std::to_string(i);
+		object.pos_x = static_cast<float>(i % 100);
+		object.pos_y = static_cast<float>((i / 100) % 100);
+		object.pos_z = static_cast<float>(i / 10000);
+		SceneObject::_OBX_MetaInfo::toFlatBuffer(fbb, object);
+		ok = object.id && obx_cursor_put_new(cursor, object.id, fbb.GetBufferPointer(), fbb.GetSize()) == OBX_SUCCESS;
+	}
+
+	obx_cursor_close(cursor);
+	if (!ok) {
+		obx_txn_close(txn);
+		return false;
+	}
+	return obx_txn_success(txn) == OBX_SUCCESS;
+}
+
+// The pre-reader path: copy every record into an OBX_bytes_array, then decode each through the generated type
+StateStore::SceneObjectData decodeLegacy(const OBX_bytes &bytes)
+{
+	SceneObject entity = SceneObject::_OBX_MetaInfo::fromFlatBuffer(bytes.data, bytes.size);
+	StateStore::SceneObjectData obj;
+	obj.id = entity.id;
+	obj.nodeId = entity.node_id;
+	obj.type = entity.type;
+	obj.name = entity.name;
+	obj.posX = entity.pos_x;
+	obj.posY = entity.pos_y;
+	obj.posZ = entity.pos_z;
+	obj.rotX = entity.rot_x;
+	obj.rotY = entity.rot_y;
+	obj.rotZ = entity.rot_z;
+	obj.scaleX = entity.scale_x;
+	obj.scaleY = entity.scale_y;
+	obj.scaleZ = entity.scale_z;
+	obj.enabled = entity.enabled;
+	obj.properties = entity.properties;
+	return obj;
+}
+
+void printUsage(const char *program)
+{
+	std::cout << "Usage: " << program << " [options]\n"
+		  << "  --objects N   scene objects to load (default: 100000)\n"
+		  << "  --lookups N   nodeId lookups per lookup measurement (default: 1000)\n"
+		  << "  --db PATH     scratch database directory, wiped first (default: <tmp>/neural-studio-state-bench)\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	BenchOptions options;
+	for (int i = 1; i < argc; ++i) {
+		const char *arg = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (!std::strcmp(arg, "--objects") && value) {
+			options.objects = std::max(1, std::atoi(value));
+		} else if (!std::strcmp(arg, "--lookups") && value) {
+			options.lookups = std::max(1, std::atoi(value));
+		} else if (!std::strcmp(arg, "--db") && value) {
+			options.dbPath = value;
+		} else {
+			printUsage(argv[0]);
+			return !std::strcmp(arg, "--help") ? 0 : 2;
+		}
+		++i;
+	}
+
+	QDir(QString::fromStdString(options.dbPath)).removeRecursively();
+	QDir().mkpath(QString::fromStdString(options.dbPath));
+
+	std::cout << "=== StateStore Load Benchmark ===" << std::endl;
+	std::cout << "objects: " << options.objects << ", lookups: " << options.lookups << std::endl;
+	std::cout << std::left << std::setw(34) << "path" << std::right << std::setw(12) << "ms" << std::setw(12)
+		  << "allocs" << std::setw(14) << "allocKiB" << std::setw(10) << "results" << std::endl;
+	std::cout << std::fixed << std::setprecision(2);
+
+	// Phase 1: populate and measure the legacy copy-then-parse paths on a raw store.
+	// The same directory can't be open twice in one process, so StateStore opens it afterwards.
+	{
+		OBX_store_options *storeOptions = obx_opt();
+		obx_opt_directory(storeOptions, options.dbPath.c_str());
+		obx_opt_model(storeOptions, create_obx_model());
+		OBX_store *store = obx_store_open(storeOptions);
+		if (!store || !populate(store, options.objects)) {
+			std::cerr << "Failed to populate store: " << obx_last_error_message() << std::endl;
+			if (store)
+				obx_store_close(store);
+			return 1;
+		}
+
+		printMeasurement(measure("legacy get_all + fromFlatBuffer", [&] {
+			std::vector<StateStore::SceneObjectData> result;
+			OBX_bytes_array *objects = obx_box_get_all(obx_box(store, SceneObject::_OBX_MetaInfo::entityId()));
+			if (objects) {
+				for (size_t i = 0; i < objects->count; ++i) {
+					result.push_back(decodeLegacy(objects->bytes[i]));
+				}
+				obx_bytes_array_free(objects);
+			}
+			return result.size();
+		}));
+
+		printMeasurement(measure("legacy per-call query by nodeId", [&] {
+			size_t found = 0;
+			for (int i = 0; i < options.lookups; ++i) {
+				std::string nodeId = nodeIdFor((i * 7919) % options.objects);
+				OBX_query_builder *qb = obx_query_builder(store, SceneObject::_OBX_MetaInfo::entityId());
+				obx_qb_equals_string(qb, SceneObject_::node_id.id(), nodeId.c_str(), true);
+				OBX_query *query = obx_query(qb);
+				obx_qb_close(qb);
+				OBX_bytes_array *objects = obx_query_find(query);
+				if (objects) {
+					for (size_t j = 0; j < objects->count; ++j) {
+						decodeLegacy(objects->bytes[j]);
+						++found;
+					}
+					obx_bytes_array_free(objects);
+				}
+				obx_query_close(query);
+			}
+			return found;
+		}));
+
+		obx_store_close(store);
+	}
+
+	// Phase 2: the prepared-query / zero-copy reader paths
+	StateStore stateStore;
+	if (!stateStore.initialize(options.dbPath)) {
+		std::cerr << "Failed to open StateStore" << std::endl;
+		return 1;
+	}
+
+	printMeasurement(
+		measure("getAllSceneObjects (visitor)", [&] { return stateStore.getAllSceneObjects().size(); }));
+
+	printMeasurement(measure("visitSceneObjects (zero-copy)", [&] {
+		size_t enabled = 0;
+		float extent = 0.0f;
+		stateStore.visitSceneObjects([&](const SceneObjectReader &reader) {
+			extent = std::max(extent, reader.posX() + reader.posY() + reader.posZ());
+			enabled += reader.enabled() ? 1 : 0;
+			return true;
+		});
+		return enabled;
+	}));
+
+	printMeasurement(measure("prepared query by nodeId", [&] {
+		size_t found = 0;
+		StateStore::SceneObjectData obj;
+		for (int i = 0; i < options.lookups; ++i) {
+			found += stateStore.getSceneObjectByNodeId(nodeIdFor((i * 7919) % options.objects), obj) ? 1 : 0;
+		}
+		return found;
+	}));
+
+	stateStore.close();
+	QDir(QString::fromStdString(options.dbPath)).removeRecursively();
+	return 0;
+}
@@ -0,0 +1,145 @@
+#include "KeyframeTimeline.h"
+#include <cmath>
+#include <iostream>
+#include <string>
+
+// Samples small hand-built timelines and checks every interpolation mode,
+// clamping outside the keyed range and keyframes written twice at one timestamp.
+
+using namespace NeuralStudio;
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool condition, const std::string &what)
+{
+	if (!condition) {
+		std::cerr << "FAILED: " << what << std::endl;
+		++g_failures;
+	}
+}
+
+bool near(float a, float b)
+{
+	return std::fabs(a - b) < 1e-5f;
+}
+
+KeyframeTimeline::Keyframe makeKeyframe(uint64_t id, int64_t timestampMs, float posX,
+					KeyframeTimeline::Interpolation mode = KeyframeTimeline::Interpolation::Linear)
+{
+	KeyframeTimeline::Keyframe kf;
+	kf.id = id;
+	kf.timestampMs = timestampMs;
+	kf.values[KeyframeTimeline::PosX] = posX;
+	kf.values[KeyframeTimeline::RotY] = posX * 2.0f;
+	kf.interpolation = mode;
+	return kf;
+}
+
+float sampleX(const KeyframeTimeline &timeline, int64_t timeMs)
+{
+	KeyframeTimeline::Sample sample;
+	if (!timeline.sample(timeMs, sample))
+		return NAN;
+	return sample.values[KeyframeTimeline::PosX];
+}
+
+void linearMidpoint()
+{
+	KeyframeTimeline timeline;
+	timeline.insert(makeKeyframe(1, 0, 0.0f));
+	timeline.insert(makeKeyframe(2, 100, 10.0f));
+
+	KeyframeTimeline::Sample sample;
+	check(timeline.sample(50, sample), "linear: sampled");
+	check(near(sample.values[KeyframeTimeline::PosX], 5.0f), "linear: midpoint");
+	check(near(sample.values[KeyframeTimeline::RotY], 10.0f), "linear: every channel interpolated");
+	check(near(sample.values[KeyframeTimeline::ScaleX], 1.0f), "linear: untouched channel keeps its value");
+	check(near(sampleX(timeline, 25), 2.5f), "linear: quarter point");
+}
+
+void step()
+{
+	KeyframeTimeline timeline;
+	timeline.insert(makeKeyframe(1, 0, 1.0f, KeyframeTimeline::Interpolation::Step));
+	timeline.insert(makeKeyframe(2, 100, 3.0f, KeyframeTimeline::Interpolation::Step));
+
+	check(near(sampleX(timeline, 50), 1.0f), "step: holds the earlier key");
+	check(near(sampleX(timeline, 99), 1.0f), "step: holds until the next key");
+	check(near(sampleX(timeline, 100), 3.0f), "step: jumps at the next key");
+}
+
+void catmullRom()
+{
+	const auto bezier = KeyframeTimeline::Interpolation::Bezier;
+	check(KeyframeTimeline::parseInterpolation("bezier") == bezier, "bezier: parsed");
+
+	// Evenly spaced collinear keys: the spline reproduces the line
+	KeyframeTimeline line;
+	for (int i = 0; i < 4; ++i)
+		line.insert(makeKeyframe(i + 1, i * 100, static_cast<float>(i), bezier));
+	check(near(sampleX(line, 150), 1.5f), "bezier: collinear keys stay on the line");
+
+	// A peak: the curve passes through the keys and bulges between them, with
+	// the first segment's missing neighbour clamped to its start key
+	KeyframeTimeline peak;
+	peak.insert(makeKeyframe(1, 0, 0.0f, bezier));
+	peak.insert(makeKeyframe(2, 100, 1.0f, bezier));
+	peak.insert(makeKeyframe(3, 200, 0.0f, bezier));
+	check(near(sampleX(peak, 100), 1.0f), "bezier: passes through the key");
+	check(near(sampleX(peak, 50), 0.5625f), "bezier: Catmull-Rom value in the first segment");
+	check(near(sampleX(peak, 150), 0.5625f), "bezier: symmetric in the last segment");
+}
+
+void clamping()
+{
+	KeyframeTimeline timeline;
+	KeyframeTimeline::Sample sample;
+	check(!timeline.sample(0, sample), "clamp: empty timeline has no sample");
+
+	timeline.insert(makeKeyframe(1, 100, 2.0f));
+	check(near(sampleX(timeline, -1000), 2.0f) && near(sampleX(timeline, 1000), 2.0f),
+	      "clamp: a single key holds everywhere");
+
+	timeline.insert(makeKeyframe(2, 200, 4.0f));
+	check(near(sampleX(timeline, 0), 2.0f), "clamp: before the first key");
+	check(near(sampleX(timeline, 100), 2.0f), "clamp: at the first key");
+	check(near(sampleX(timeline, 200), 4.0f), "clamp: at the last key");
+	check(near(sampleX(timeline, 5000), 4.0f), "clamp: after the last key");
+}
+
+void duplicateTimestamp()
+{
+	KeyframeTimeline timeline;
+	timeline.insert(makeKeyframe(1, 0, 0.0f));
+	timeline.insert(makeKeyframe(2, 100, 10.0f));
+	timeline.insert(makeKeyframe(3, 100, 20.0f));
+
+	check(timeline.size() == 2, "duplicate: replaced, not added");
+	check(timeline.contains(3) && !timeline.contains(2), "duplicate: the newer id owns the timestamp");
+	check(near(sampleX(timeline, 100), 20.0f), "duplicate: the newer value is sampled");
+	check(near(sampleX(timeline, 50), 10.0f), "duplicate: segments use the newer value");
+
+	// Batches collapse the same way, the last keyframe at a timestamp wins
+	timeline.insertMany({makeKeyframe(4, 50, 1.0f), makeKeyframe(5, 50, 2.0f), makeKeyframe(6, 100, 30.0f)});
+	check(timeline.size() == 3, "duplicate: one entry per timestamp after a batch");
+	check(timeline.contains(5) && !timeline.contains(4) && timeline.contains(6) && !timeline.contains(3),
+	      "duplicate: batch winners kept");
+	check(near(sampleX(timeline, 50), 2.0f) && near(sampleX(timeline, 100), 30.0f),
+	      "duplicate: batch winners sampled");
+}
+
+} // namespace
+
+int main()
+{
+	linearMidpoint();
+	step();
+	catmullRom();
+	clamping();
+	duplicateTimestamp();
+
+	std::cout << (g_failures ? "FAILED" : "OK") << std::endl;
+	return g_failures ? 1 : 0;
+}
@@ -0,0 +1,301 @@
+#include "StateStore.h"
+#include <QDir>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Updates the same settings and scene object twice, directly and through the
+// write-behind journal, and checks every read sees the latest value in one row.
+// Also checks keyframes at a taken timestamp and deleted scene objects keep the
+// database and the caches in step, that the journal coalesces writes per key, and
+// that producers racing flush()/deleteSceneObject() still leave one row per key.
+
+using namespace NeuralStudio;
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool condition, const std::string &what)
+{
+	if (!condition) {
+		std::cerr << "FAILED: " << what << std::endl;
+		++g_failures;
+	}
+}
+
+size_t countSceneObjects(StateStore &store, const std::string &nodeId)
+{
+	size_t count = 0;
+	for (const auto &obj : store.getAllSceneObjects())
+		count += obj.nodeId == nodeId;
+	return count;
+}
+
+void updateTwice(StateStore &store, const std::string &mode)
+{
+	const std::string platform = "platform-" + mode;
+	const std::string nodeId = "node-" + mode;
+
+	StateStore::SceneObjectData obj;
+	obj.nodeId = nodeId;
+	obj.type = "VideoNode";
+
+	for (int pass = 1; pass <= 2; ++pass) {
+		store.putSettings(platform, 1000 * pass, pass == 1 ? "1280x720" : "1920x1080", 30 * pass);
+		obj.name = "pass " + std::to_string(pass);
+		obj.posX = static_cast<float>(pass);
+		store.putSceneObject(obj);
+		check(store.flush(), mode + ": flush");
+	}
+
+	int bitrate = 0, framerate = 0;
+	std::string resolution;
+	check(store.getSettings(platform, bitrate, resolution, framerate), mode + ": settings found");
+	check(bitrate == 2000 && resolution == "1920x1080" && framerate == 60, mode + ": settings read the update");
+
+	StateStore::SceneObjectData read;
+	check(store.getSceneObjectByNodeId(nodeId, read), mode + ": scene object found");
+	check(read.name == "pass 2" && read.posX == 2.0f, mode + ": scene object reads the update");
+	check(countSceneObjects(store, nodeId) == 1, mode + ": one scene object row");
+}
+
+StateStore::KeyframeData makeKeyframe(obx_id objectId, int64_t timestampMs, float posX)
+{
+	StateStore::KeyframeData kf{};
+	kf.objectId = objectId;
+	kf.nodeId = "node-keyframes";
+	kf.timestampMs = timestampMs;
+	kf.posX = posX;
+	kf.scaleX = kf.scaleY = kf.scaleZ = 1.0f;
+	kf.interpolation = "linear";
+	return kf;
+}
+
+size_t countKeyframes(StateStore &store, obx_id objectId)
+{
+	return store.getKeyframesForObject(objectId, 0, 1000000).size();
+}
+
+void keyframesAtSameTimestamp(StateStore &store)
+{
+	const obx_id objectId = 4242;
+	check(store.loadTimeline(objectId), "keyframes: timeline loaded");
+
+	const obx_id first = store.putKeyframe(makeKeyframe(objectId, 100, 1.0f));
+	const obx_id second = store.putKeyframe(makeKeyframe(objectId, 100, 2.0f));
+	check(first && first == second, "keyframes: same timestamp keeps the id");
+	check(countKeyframes(store, objectId) == 1, "keyframes: one row per timestamp");
+
+	// Repeats inside one batch collapse the same way; the last one wins
+	std::vector<StateStore::KeyframeData> batch{makeKeyframe(objectId, 200, 3.0f), makeKeyframe(objectId, 200, 4.0f),
+						    makeKeyframe(objectId, 100, 5.0f)};
+	check(store.putKeyframes(batch), "keyframes: batch written");
+	check(batch[0].id == batch[1].id && batch[2].id == first, "keyframes: batch reuses ids");
+	check(countKeyframes(store, objectId) == 2, "keyframes: two rows after the batch");
+
+	auto timeline = store.getTimeline(objectId);
+	KeyframeTimeline::Sample sample;
+	check(timeline && timeline->size() == 2, "keyframes: timeline matches the rows");
+	check(store.sampleTransform(objectId, 200, sample) && sample.values[KeyframeTimeline::PosX] == 4.0f,
+	      "keyframes: batch winner sampled");
+
+	// Removing the keyframe leaves nothing behind in either place
+	store.deleteKeyframe(first);
+	check(countKeyframes(store, objectId) == 1, "keyframes: row removed");
+	timeline = store.getTimeline(objectId);
+	check(timeline && timeline->size() == 1 && !timeline->contains(first), "keyframes: timeline entry removed");
+
+	store.deleteKeyframe(batch[0].id);
+	store.unloadTimeline(objectId);
+}
+
+void deleteAndRecreate(StateStore &store, const std::string &mode)
+{
+	StateStore::SceneObjectData obj;
+	obj.nodeId = "node-deleted-" + mode;
+	obj.type = "VideoNode";
+	obj.name = "before";
+	store.putSceneObject(obj);
+	check(store.flush(), mode + ": flush before delete");
+
+	StateStore::SceneObjectData read;
+	check(store.getSceneObjectByNodeId(obj.nodeId, read), mode + ": object to delete found");
+	store.deleteSceneObject(read.id);
+	check(countSceneObjects(store, obj.nodeId) == 0, mode + ": object deleted");
+
+	// The cached id is gone, so this is a new record rather than a put to the removed id
+	obj.name = "after";
+	store.putSceneObject(obj);
+	check(store.flush(), mode + ": flush after recreate");
+	StateStore::SceneObjectData recreated;
+	check(store.getSceneObjectByNodeId(obj.nodeId, recreated) && recreated.name == "after",
+	      mode + ": recreated object found");
+	check(recreated.id != read.id, mode + ": recreated object has a new id");
+	check(countSceneObjects(store, obj.nodeId) == 1, mode + ": one row after recreate");
+}
+
+void coalescing(StateStore &store)
+{
+	// Nothing commits on its own while the test queues
+	WriteBehindConfig config;
+	config.flushInterval = std::chrono::hours(1);
+	config.maxBatch = 1 << 20;
+	store.enableWriteBehind(config);
+
+	StateStore::SceneObjectData obj;
+	obj.nodeId = "node-coalesced";
+	obj.type = "VideoNode";
+	for (int pass = 1; pass <= 10; ++pass) {
+		obj.posX = static_cast<float>(pass);
+		store.putSceneObject(obj);
+		store.putSettings("platform-coalesced", pass, "1920x1080", 60);
+	}
+
+	const WriteBehindMetrics queued = store.getWriteBehindMetrics();
+	check(queued.queueDepth == 20 && queued.commits == 0, "coalescing: writes wait for the flush");
+	check(store.flush(), "coalescing: flush");
+
+	const WriteBehindMetrics flushed = store.getWriteBehindMetrics();
+	check(flushed.queueDepth == 0, "coalescing: queue drained");
+	check(flushed.coalesced == 18, "coalescing: superseded writes dropped");
+	check(flushed.committed == 2 && flushed.commits == 1, "coalescing: one record per key in one commit");
+
+	StateStore::SceneObjectData read;
+	int bitrate = 0, framerate = 0;
+	std::string resolution;
+	check(store.getSceneObjectByNodeId(obj.nodeId, read) && read.posX == 10.0f,
+	      "coalescing: last object write wins");
+	check(store.getSettings("platform-coalesced", bitrate, resolution, framerate) && bitrate == 10,
+	      "coalescing: last settings write wins");
+	check(countSceneObjects(store, obj.nodeId) == 1, "coalescing: one scene object row");
+
+	store.disableWriteBehind();
+}
+
+void concurrentProducers(StateStore &store)
+{
+	// Commit often so background commits overlap the flushes and deletes below
+	WriteBehindConfig config;
+	config.flushInterval = std::chrono::milliseconds(1);
+	config.maxBatch = 16;
+	store.enableWriteBehind(config);
+
+	constexpr int kProducers = 4;
+	constexpr int kWrites = 2000;
+	constexpr int kNodes = 8; // Per producer; kWrites is a multiple
+	const std::string victimId = "node-concurrent-victim";
+
+	std::vector<std::thread> producers;
+	for (int p = 0; p < kProducers; ++p) {
+		producers.emplace_back([&store, &victimId, p] {
+			StateStore::SceneObjectData obj;
+			obj.type = "VideoNode";
+			for (int i = 0; i < kWrites; ++i) {
+				obj.nodeId = "node-concurrent-" + std::to_string(p) + "-" + std::to_string(i % kNodes);
+				obj.posX = static_cast<float>(i);
+				store.putSceneObject(obj);
+
+				obj.nodeId = victimId;
+				store.putSceneObject(obj);
+
+				store.putSettings("platform-concurrent-" + std::to_string(p), i, "1920x1080", 60);
+			}
+		});
+	}
+
+	std::atomic<bool> producing{true};
+	int deletes = 0;
+	std::thread deleter([&] {
+		while (producing.load()) {
+			store.flush();
+			StateStore::SceneObjectData victim;
+			if (store.getSceneObjectByNodeId(victimId, victim)) {
+				store.deleteSceneObject(victim.id);
+				++deletes;
+			}
+		}
+	});
+
+	for (auto &producer : producers)
+		producer.join();
+	producing = false;
+	deleter.join();
+	check(store.flush(), "concurrent: final flush");
+	std::cout << "Concurrent producers: " << deletes << " deletes during the run" << std::endl;
+
+	for (int p = 0; p < kProducers; ++p) {
+		for (int n = 0; n < kNodes; ++n) {
+			const std::string nodeId = "node-concurrent-" + std::to_string(p) + "-" + std::to_string(n);
+			const float lastPosX = static_cast<float>(kWrites - kNodes + n);
+			StateStore::SceneObjectData read;
+			check(countSceneObjects(store, nodeId) == 1, "concurrent: one row for " + nodeId);
+			check(store.getSceneObjectByNodeId(nodeId, read) && read.posX == lastPosX,
+			      "concurrent: last write wins for " + nodeId);
+		}
+
+		int bitrate = 0, framerate = 0;
+		std::string resolution;
+		check(store.getSettings("platform-concurrent-" + std::to_string(p), bitrate, resolution, framerate) &&
+			      bitrate == kWrites - 1,
+		      "concurrent: last settings write wins");
+	}
+
+	// Whatever order the deletes and puts landed in, the cache and the rows agree
+	check(countSceneObjects(store, victimId) <= 1, "concurrent: at most one victim row");
+	StateStore::SceneObjectData victim;
+	victim.nodeId = victimId;
+	victim.type = "VideoNode";
+	victim.name = "final";
+	store.putSceneObject(victim);
+	check(store.flush(), "concurrent: flush after the run");
+	StateStore::SceneObjectData read;
+	check(store.getSceneObjectByNodeId(victimId, read) && read.name == "final",
+	      "concurrent: victim writable again");
+	check(countSceneObjects(store, victimId) == 1, "concurrent: one victim row");
+
+	store.disableWriteBehind();
+}
+
+} // namespace
+
+int main()
+{
+	const std::string dbPath = QDir::tempPath().toStdString() + "/neural-studio-state-test";
+	QDir(QString::fromStdString(dbPath)).removeRecursively();
+
+	{
+		StateStore store;
+		if (!store.initialize(dbPath)) {
+			std::cerr << "Could not open " << dbPath << std::endl;
+			return 1;
+		}
+
+		updateTwice(store, "direct");
+		deleteAndRecreate(store, "direct");
+		keyframesAtSameTimestamp(store);
+
+		store.enableWriteBehind();
+		updateTwice(store, "write-behind");
+		deleteAndRecreate(store, "write-behind");
+
+		// Switching modes keeps updating the rows the other mode wrote
+		store.disableWriteBehind();
+		updateTwice(store, "write-behind");
+		store.enableWriteBehind();
+		updateTwice(store, "direct");
+		store.disableWriteBehind();
+
+		coalescing(store);
+		concurrentProducers(store);
+
+		store.close();
+	}
+
+	QDir(QString::fromStdString(dbPath)).removeRecursively();
+	std::cout << (g_failures ? "FAILED" : "OK") << std::endl;
+	return g_failures ? 1 : 0;
+}
@@ -27,12 +27,37 @@ extern bool mp_media_eof(mp_media_t *m);
 extern void mp_media_next_video(mp_media_t *m, bool preload);
 extern void mp_media_next_audio(mp_media_t *m);
 extern bool mp_media_reset(mp_media_t *m);
+extern bool mp_media_prepare_scaling(mp_media_t *m);
+extern void mp_media_free_packet(mp_media_t *m, AVPacket *pkt);
+extern int64_t mp_media_packet_ts(mp_media_t *m, const AVPacket *pkt);
 
 static bool mp_cache_reset(mp_cache_t *c);
 
 static int64_t base_sys_ts = 0;
 
-#define v_eof(c) (c->cur_v_idx == c->video_frames.num)
+/* files that would take more than this decoded are cached compressed */
+#define MAX_RAW_CACHE_SIZE (1024LL * 1024 * 1024)
+
+/* presentation order entries this close to the demux position can still
+ * move when a reordered packet comes in */
+#define REORDER_MARGIN 16
+
+static inline size_t v_count(mp_cache_t *c)
+{
+	return c->v_index.pts.num;
+}
+
+static inline int64_t v_ts(mp_cache_t *c, size_t idx)
+{
+	return c->v_index.pts.array[idx];
+}
+
+static inline int64_t a_ts(mp_cache_t *c, size_t idx)
+{
+	return c->a_index.pts.array[idx];
+}
+
+#define v_eof(c) (c->cur_v_idx == v_count(c))
 #define a_eof(c) (c->cur_a_idx == c->audio_segments.num)
 
 static inline int64_t mp_cache_get_next_min_pts(mp_cache_t *c)
@@ -140,56 +165,307 @@ fail:
 	return success;
 }
 
-static void seek_to(mp_cache_t *c, int64_t pos)
+/* ------------------------------------------------------------------------- */
+/* compressed mode                                                           */
+
+static inline size_t v_ready(mp_cache_t *c)
 {
-	size_t new_v_idx = 0;
-	size_t new_a_idx = 0;
+	if (c->demux_done)
+		return v_count(c);
+	return v_count(c) > REORDER_MARGIN ? v_count(c) - REORDER_MARGIN : 0;
+}
 
-	if (pos > c->media_duration) {
-		blog(LOG_WARNING, "MP: Invalid seek position");
+static AVPacket *get_packet(mp_media_t *m)
+{
+	AVPacket **const cached = da_end(m->packet_pool);
+	if (cached) {
+		AVPacket *pkt = *cached;
+		da_pop_back(m->packet_pool);
+		return pkt;
+	}
+
+	return av_packet_alloc();
+}
+
+static void cache_video_packet(mp_cache_t *c, AVPacket *pkt)
+{
+	size_t pkt_idx = c->v_packets.num;
+	int64_t ts;
+
+	if (pkt->pts == AV_NOPTS_VALUE && pkt->dts == AV_NOPTS_VALUE && pkt_idx) {
+		const AVPacket *prev = c->v_packets.array[pkt_idx - 1];
+		pkt->dts = (prev->dts != AV_NOPTS_VALUE ? prev->dts : prev->pts) + (prev->duration ? prev->duration : 1);
+	}
+	ts = mp_media_packet_ts(&c->m, pkt);
+
+	if (pkt->flags & AV_PKT_FLAG_KEY)
+		mp_ts_index_add_keyframe(&c->v_index, ts, (int64_t)pkt_idx);
+	mp_ts_index_insert(&c->v_index, ts);
+
+	da_push_back(c->v_packets, &pkt);
+	c->packet_bytes += pkt->size;
+}
+
+static void decode_audio(mp_cache_t *c)
+{
+	mp_media_t *m = &c->m;
+
+	for (;;) {
+		mp_decode_next(&m->a);
+		if (!m->a.frame_ready)
+			break;
+		mp_media_next_audio(m);
+	}
+}
+
+static void finish_demux(mp_cache_t *c)
+{
+	mp_media_t *m = &c->m;
+	size_t num = v_count(c);
+
+	c->demux_done = true;
+
+	if (c->has_audio) {
+		m->eof = true;
+		decode_audio(c);
+		m->eof = false;
+	}
+
+	if (num > 1)
+		c->final_v_duration = v_ts(c, num - 1) - v_ts(c, num - 2);
+
+	blog(LOG_INFO, "MP: Cached %zu video packets (%.1f MiB) for '%s'", c->v_packets.num,
+	     (double)c->packet_bytes / (1024.0 * 1024.0), m->path);
+}
+
+static void demux_next(mp_cache_t *c)
+{
+	mp_media_t *m = &c->m;
+	AVPacket *pkt = get_packet(m);
+
+	int ret = av_read_frame(m->fmt, pkt);
+	if (ret < 0) {
+		da_push_back(m->packet_pool, &pkt);
+		if (ret != AVERROR_EOF)
+			blog(LOG_WARNING, "MP: av_read_frame failed: %s (%d)", av_err2str(ret), ret);
+
+		/* play whatever could be read */
+		finish_demux(c);
 		return;
 	}
 
-	if (c->has_video) {
-		struct obs_source_frame *v;
+	if (c->has_video && pkt->stream_index == m->v.stream->index && pkt->size) {
+		cache_video_packet(c, pkt);
+	} else if (c->has_audio && pkt->stream_index == m->a.stream->index && pkt->size) {
+		mp_decode_push_packet(&m->a, pkt);
+		decode_audio(c);
+	} else {
+		mp_media_free_packet(m, pkt);
+	}
+}
 
-		for (size_t i = 0; i < c->video_frames.num; i++) {
-			v = &c->video_frames.array[i];
-			new_v_idx = i;
-			if ((int64_t)v->timestamp >= pos) {
-				break;
-			}
+/* keeps the timeline demuxed past the frames playback reads next */
+static void demux_ahead(mp_cache_t *c)
+{
+	while (!c->demux_done) {
+		bool v_ok = !c->has_video || v_ready(c) > c->next_v_idx + 1;
+		bool a_ok = !c->has_audio || c->audio_segments.num > c->next_a_idx + 1;
+		if (v_ok && a_ok)
+			break;
+
+		demux_next(c);
+	}
+}
+
+static void demux_until(mp_cache_t *c, int64_t ts)
+{
+	while (!c->demux_done) {
+		size_t v_num = v_ready(c);
+		size_t a_num = c->audio_segments.num;
+		bool v_ok = !c->has_video || (v_num && v_ts(c, v_num - 1) >= ts);
+		bool a_ok = !c->has_audio || (a_num && a_ts(c, a_num - 1) >= ts);
+		if (v_ok && a_ok)
+			break;
+
+		demux_next(c);
+	}
+}
+
+static bool mp_cache_demux_start(mp_cache_t *c)
+{
+	c->start_time = c->m.fmt->start_time;
+	if (c->start_time == AV_NOPTS_VALUE)
+		c->start_time = 0;
+
+	demux_ahead(c);
+
+	if (!v_count(c)) {
+		blog(LOG_WARNING, "MP: No video packets in '%s'", c->m.path);
+		return false;
+	}
+	return true;
+}
+
+static struct obs_source_frame *find_ring_frame(mp_cache_t *c, int64_t ts, int64_t end_ts)
+{
+	for (size_t i = 0; i < MP_CACHE_RING_SIZE; i++) {
+		int64_t frame_ts = c->ring_pts[i];
+		if (c->ring[i] && frame_ts >= ts && frame_ts < end_ts)
+			return c->ring[i];
+	}
+
+	return NULL;
+}
+
+/* decodes forward to the first frame at or after ts, which lands in the
+ * ring; earlier frames are dropped without being converted */
+static struct obs_source_frame *decode_video(mp_cache_t *c, int64_t ts)
+{
+	mp_media_t *m = &c->m;
+	struct mp_decode *d = &m->v;
+
+	for (;;) {
+		bool last = c->dec_next_pkt == c->v_packets.num;
+		if (last && !c->demux_done) {
+			demux_next(c);
+			continue;
 		}
 
-		size_t next_idx = new_v_idx + 1;
-		if (next_idx == c->video_frames.num) {
-			c->next_v_ts = (int64_t)v->timestamp + c->final_v_duration;
-		} else {
-			struct obs_source_frame *next = &c->video_frames.array[next_idx];
-			c->next_v_ts = (int64_t)next->timestamp;
+		if (!last && !d->packets.size) {
+			AVPacket *pkt = get_packet(m);
+			av_packet_ref(pkt, c->v_packets.array[c->dec_next_pkt++]);
+			mp_decode_push_packet(d, pkt);
 		}
-	}
-	if (c->has_audio) {
-		struct obs_source_audio *a;
-		for (size_t i = 0; i < c->audio_segments.num; i++) {
-			a = &c->audio_segments.array[i];
-			new_a_idx = i;
-			if ((int64_t)a->timestamp >= pos) {
-				break;
-			}
+
+		/* drains the decoder once every packet went in */
+		m->eof = last;
+		mp_decode_next(d);
+		m->eof = false;
+
+		if (!d->frame_ready) {
+			if (last)
+				return NULL;
+			continue;
+		}
+
+		c->dec_last_pts = d->frame_pts;
+		c->dec_started = true;
+		if (d->frame_pts < ts) {
+			d->frame_ready = false;
+			continue;
 		}
 
-		size_t next_idx = new_a_idx + 1;
+		if (!mp_media_prepare_scaling(m))
+			return NULL;
+
+		c->ring_filled = NULL;
+		mp_media_next_video(m, false);
+		return c->ring_filled;
+	}
+}
+
+static struct obs_source_frame *get_video_frame(mp_cache_t *c, size_t idx)
+{
+	if (!c->compressed)
+		return c->video_frames.array[idx];
+
+	int64_t ts = v_ts(c, idx);
+	int64_t end_ts = idx + 1 < v_count(c) ? v_ts(c, idx + 1) : INT64_MAX;
+
+	struct obs_source_frame *frame = find_ring_frame(c, ts, end_ts);
+	if (frame)
+		return frame;
+
+	/* jump to the keyframe unless decoding on from here is shorter */
+	const struct mp_ts_keyframe *kf = mp_ts_index_find_keyframe(&c->v_index, ts);
+	size_t keyframe = kf ? (size_t)kf->pos : 0;
+	if (!c->dec_started || c->dec_last_pts >= ts || keyframe > c->dec_next_pkt) {
+		mp_decode_flush(&c->m.v);
+		c->dec_next_pkt = keyframe;
+		c->dec_started = false;
+	}
+
+	return decode_video(c, ts);
+}
+
+/* decodes the next frame while waiting for the current one's deadline */
+static void prefetch_video(mp_cache_t *c)
+{
+	demux_ahead(c);
+	if (c->next_v_idx < v_count(c))
+		get_video_frame(c, c->next_v_idx);
+}
+
+static inline size_t clamp_idx(size_t idx, size_t num)
+{
+	return idx < num ? idx : (num ? num - 1 : 0);
+}
+
+static void set_position(mp_cache_t *c, size_t v_idx, size_t a_idx)
+{
+	if (c->has_video && v_count(c)) {
+		size_t next_idx = v_idx + 1;
+		if (next_idx == v_count(c)) {
+			c->next_v_ts = v_ts(c, v_idx) + c->final_v_duration;
+		} else {
+			c->next_v_ts = v_ts(c, next_idx);
+		}
+	}
+	if (c->has_audio && c->audio_segments.num) {
+		size_t next_idx = a_idx + 1;
 		if (next_idx == c->audio_segments.num) {
-			c->next_a_ts = (int64_t)a->timestamp + c->final_a_duration;
+			c->next_a_ts = a_ts(c, a_idx) + c->final_a_duration;
 		} else {
-			struct obs_source_audio *next = &c->audio_segments.array[next_idx];
-			c->next_a_ts = (int64_t)next->timestamp;
+			c->next_a_ts = a_ts(c, next_idx);
 		}
 	}
 
-	c->cur_v_idx = c->next_v_idx = new_v_idx;
-	c->cur_a_idx = c->next_a_idx = new_a_idx;
+	c->cur_v_idx = c->next_v_idx = c->last_v_idx = v_idx;
+	c->cur_a_idx = c->next_a_idx = a_idx;
+
+	if (c->compressed)
+		demux_ahead(c);
+}
+
+static void seek_to(mp_cache_t *c, int64_t pos)
+{
+	if (pos > c->media_duration) {
+		blog(LOG_WARNING, "MP: Invalid seek position");
+		return;
+	}
+
+	if (c->compressed)
+		demux_until(c, pos);
+
+	size_t v_idx = clamp_idx(mp_ts_index_lower_bound(&c->v_index, pos), v_count(c));
+	size_t a_idx = clamp_idx(mp_ts_index_lower_bound(&c->a_index, pos), c->audio_segments.num);
+	set_position(c, v_idx, a_idx);
+}
+
+/* frame-accurate: positions on the frame that is on screen at pts */
+static void seek_to_pts(mp_cache_t *c, int64_t pts)
+{
+	if (c->compressed)
+		demux_until(c, pts);
+
+	set_position(c, mp_ts_index_floor(&c->v_index, pts), mp_ts_index_floor(&c->a_index, pts));
+}
+
+static void step_frames(mp_cache_t *c, int count)
+{
+	size_t idx = c->last_v_idx;
+
+	if (count < 0) {
+		size_t back = (size_t)-(int64_t)count;
+		idx = back > idx ? 0 : idx - back;
+	} else {
+		idx += (size_t)count;
+		while (c->compressed && !c->demux_done && v_ready(c) <= idx + 1)
+			demux_next(c);
+	}
+
+	if (v_count(c))
+		seek_to_pts(c, v_ts(c, clamp_idx(idx, v_count(c))));
 }
 
 /* maximum timestamp variance in nanoseconds */
@@ -205,12 +481,11 @@ static inline bool mp_media_can_play_audio(mp_cache_t *c)
 	return !a_eof(c) && (c->next_a_ts <= c->next_pts_ns || (c->next_a_ts - c->next_pts_ns > MAX_TS_VAR));
 }
 
-static inline void calc_next_v_ts(mp_cache_t *c, struct obs_source_frame *frame)
+static inline void calc_next_v_ts(mp_cache_t *c, int64_t ts)
 {
 	int64_t offset;
-	if (c->next_v_idx < c->video_frames.num) {
-		struct obs_source_frame *next = &c->video_frames.array[c->next_v_idx];
-		offset = (int64_t)(next->timestamp - frame->timestamp);
+	if (c->next_v_idx < v_count(c)) {
+		offset = v_ts(c, c->next_v_idx) - ts;
 	} else {
 		offset = c->final_v_duration;
 	}
@@ -218,12 +493,11 @@ static inline void calc_next_v_ts(mp_cache_t *c, struct obs_source_frame *frame)
 	c->next_v_ts += offset;
 }
 
-static inline void calc_next_a_ts(mp_cache_t *c, struct obs_source_audio *audio)
+static inline void calc_next_a_ts(mp_cache_t *c, int64_t ts)
 {
 	int64_t offset;
 	if (c->next_a_idx < c->audio_segments.num) {
-		struct obs_source_audio *next = &c->audio_segments.array[c->next_a_idx];
-		offset = (int64_t)(next->timestamp - audio->timestamp);
+		offset = a_ts(c, c->next_a_idx) - ts;
 	} else {
 		offset = c->final_a_duration;
 	}
@@ -234,33 +508,36 @@ static inline void calc_next_a_ts(mp_cache_t *c, struct obs_source_audio *audio)
 static void mp_cache_next_video(mp_cache_t *c, bool preload)
 {
 	/* eof check */
-	if (c->next_v_idx == c->video_frames.num) {
+	if (c->next_v_idx == v_count(c)) {
 		if (mp_media_can_play_video(c))
 			c->cur_v_idx = c->next_v_idx;
 		return;
 	}
 
-	struct obs_source_frame *frame = &c->video_frames.array[c->next_v_idx];
-	struct obs_source_frame dup = *frame;
+	if (!preload && !mp_media_can_play_video(c))
+		return;
 
-	dup.timestamp = c->base_ts + dup.timestamp - c->start_ts + c->play_sys_ts - base_sys_ts;
+	int64_t ts = v_ts(c, c->next_v_idx);
+	struct obs_source_frame *frame = get_video_frame(c, c->next_v_idx);
 
-	if (!preload) {
-		if (!mp_media_can_play_video(c))
-			return;
+	if (frame) {
+		frame->timestamp = c->base_ts + ts - c->start_ts + c->play_sys_ts - base_sys_ts;
+		c->last_v_idx = c->next_v_idx;
+	}
 
-		if (c->v_cb)
-			c->v_cb(c->opaque, &dup);
+	if (!preload) {
+		if (frame && c->v_cb)
+			c->v_cb(c->opaque, frame);
 
 		if (c->cur_v_idx < c->next_v_idx)
 			++c->cur_v_idx;
 		++c->next_v_idx;
-		calc_next_v_ts(c, frame);
-	} else {
+		calc_next_v_ts(c, ts);
+	} else if (frame) {
 		if (c->seek_next_ts && c->v_seek_cb) {
-			c->v_seek_cb(c->opaque, &dup);
+			c->v_seek_cb(c->opaque, frame);
 		} else if (!c->request_preload) {
-			c->v_preload_cb(c->opaque, &dup);
+			c->v_preload_cb(c->opaque, frame);
 		}
 	}
 }
@@ -277,17 +554,17 @@ static void mp_cache_next_audio(mp_cache_t *c)
 	if (!mp_media_can_play_audio(c))
 		return;
 
-	struct obs_source_audio *audio = &c->audio_segments.array[c->next_a_idx];
-	struct obs_source_audio dup = *audio;
+	struct obs_source_audio *audio = c->audio_segments.array[c->next_a_idx];
+	int64_t ts = a_ts(c, c->next_a_idx);
 
-	dup.timestamp = c->base_ts + dup.timestamp - c->start_ts + c->play_sys_ts - base_sys_ts;
+	audio->timestamp = c->base_ts + ts - c->start_ts + c->play_sys_ts - base_sys_ts;
 	if (c->a_cb)
-		c->a_cb(c->opaque, &dup);
+		c->a_cb(c->opaque, audio);
 
 	if (c->cur_a_idx < c->next_a_idx)
 		++c->cur_a_idx;
 	++c->next_a_idx;
-	calc_next_a_ts(c, audio);
+	calc_next_a_ts(c, ts);
 }
 
 static bool mp_cache_reset(mp_cache_t *c)
@@ -312,14 +589,14 @@ static bool mp_cache_reset(mp_cache_t *c)
 	pthread_mutex_unlock(&c->mutex);
 
 	if (c->has_video) {
-		size_t next_idx = c->video_frames.num > 1 ? 1 : 0;
+		size_t next_idx = v_count(c) > 1 ? 1 : 0;
 		c->cur_v_idx = c->next_v_idx = 0;
-		c->next_v_ts = c->video_frames.array[next_idx].timestamp;
+		c->next_v_ts = v_ts(c, next_idx);
 	}
 	if (c->has_audio) {
 		size_t next_idx = c->audio_segments.num > 1 ? 1 : 0;
 		c->cur_a_idx = c->next_a_idx = 0;
-		c->next_a_ts = c->audio_segments.array[next_idx].timestamp;
+		c->next_a_ts = a_ts(c, next_idx);
 	}
 
 	if (active) {
@@ -369,13 +646,17 @@ static inline bool mp_cache_thread(mp_cache_t *c)
 {
 	os_set_thread_name("mp_cache_thread");
 
-	if (!mp_cache_decode(c)) {
+	if (c->compressed) {
+		if (!mp_cache_demux_start(c))
+			return false;
+	} else if (!mp_cache_decode(c)) {
 		return false;
 	}
 
 	for (;;) {
-		bool reset, kill, is_active, seek, pause, reset_time, preload_frame;
+		bool reset, kill, is_active, seek, seek_exact, pause, reset_time, preload_frame;
 		int64_t seek_pos;
+		int step;
 		bool timeout = false;
 
 		pthread_mutex_lock(&c->mutex);
@@ -403,9 +684,13 @@ static inline bool mp_cache_thread(mp_cache_t *c)
 		pause = c->pause;
 		seek_pos = c->seek_pos;
 		seek = c->seek;
+		seek_exact = c->seek_exact;
+		step = c->step_frames;
 		reset_time = c->reset_ts;
 		c->preload_frame = false;
 		c->seek = false;
+		c->seek_exact = false;
+		c->step_frames = 0;
 		c->reset_ts = false;
 
 		pthread_mutex_unlock(&c->mutex);
@@ -418,9 +703,18 @@ static inline bool mp_cache_thread(mp_cache_t *c)
 			continue;
 		}
 
-		if (seek) {
+		if (seek || step) {
 			c->seek_next_ts = true;
-			seek_to(c, seek_pos);
+			if (seek && seek_exact)
+				seek_to_pts(c, seek_pos);
+			else if (seek)
+				seek_to(c, seek_pos);
+			if (step)
+				step_frames(c, step);
+
+			/* scrubbing while paused shows the frame right away */
+			if ((seek_exact || step) && pause && c->has_video && c->v_seek_cb)
+				mp_cache_next_video(c, true);
 			continue;
 		}
 
@@ -432,11 +726,21 @@ static inline bool mp_cache_thread(mp_cache_t *c)
 		if (pause)
 			continue;
 
-		if (preload_frame)
-			c->v_preload_cb(c->opaque, &c->video_frames.array[0]);
+		if (preload_frame) {
+			struct obs_source_frame *frame = get_video_frame(c, 0);
+			if (frame) {
+				frame->timestamp = v_ts(c, 0);
+				c->v_preload_cb(c->opaque, frame);
+			}
+		}
 
 		/* frames are ready */
 		if (is_active && !timeout) {
+			size_t v_idx = c->next_v_idx;
+
+			if (c->compressed)
+				demux_ahead(c);
+
 			if (c->has_video)
 				mp_cache_next_video(c, false);
 			if (c->has_audio)
@@ -445,6 +749,9 @@ static inline bool mp_cache_thread(mp_cache_t *c)
 			if (mp_cache_eof(c))
 				continue;
 
+			if (c->compressed && c->next_v_idx != v_idx)
+				prefetch_video(c);
+
 			mp_cache_calc_next_ns(c);
 		}
 	}
@@ -468,45 +775,40 @@ static void *mp_cache_thread_start(void *opaque)
 static void fill_video(void *data, struct obs_source_frame *frame)
 {
 	mp_cache_t *c = data;
-	struct obs_source_frame dup;
-
-	obs_source_frame_init(&dup, frame->format, frame->width, frame->height);
-	obs_source_frame_copy(&dup, frame);
-
-	dup.timestamp = frame->timestamp;
+	struct obs_source_frame *dup = mp_frame_pool_dup_video(c->pool, frame);
 
 	c->final_v_duration = c->m.v.last_duration;
 
 	da_push_back(c->video_frames, &dup);
+	mp_ts_index_push(&c->v_index, (int64_t)dup->timestamp);
 }
 
-static void fill_audio(void *data, struct obs_source_audio *audio)
+static void fill_ring(void *data, struct obs_source_frame *frame)
 {
 	mp_cache_t *c = data;
-	struct obs_source_audio dup = *audio;
+	size_t i = c->ring_next;
 
-	size_t size = get_total_audio_size(dup.format, dup.speakers, dup.frames);
-	dup.data[0] = bmalloc(size);
+	/* a slot the consumer still holds isn't overwritten: releasing it
+	 * only gives it back to the pool once the consumer is done too */
+	mp_frame_release(c->ring[i]);
+	struct obs_source_frame *slot = mp_frame_pool_dup_video(c->pool, frame);
 
-	size_t planes = get_audio_planes(dup.format, dup.speakers);
-	if (planes > 1) {
-		size = get_audio_bytes_per_channel(dup.format) * dup.frames;
-		uint8_t *out = (uint8_t *)dup.data[0];
+	c->ring[i] = slot;
+	c->ring_pts[i] = (int64_t)frame->timestamp;
 
-		for (size_t i = 0; i < planes; i++) {
-			if (i > 0)
-				dup.data[i] = out;
+	c->ring_next = (i + 1) % MP_CACHE_RING_SIZE;
+	c->ring_filled = slot;
+}
 
-			memcpy(out, audio->data[i], size);
-			out += size;
-		}
-	} else {
-		memcpy((uint8_t *)dup.data[0], audio->data[0], size);
-	}
+static void fill_audio(void *data, struct obs_source_audio *audio)
+{
+	mp_cache_t *c = data;
+	struct obs_source_audio *dup = mp_frame_pool_dup_audio(c->pool, audio);
 
 	c->final_a_duration = c->m.a.last_duration;
 
 	da_push_back(c->audio_segments, &dup);
+	mp_ts_index_push(&c->a_index, (int64_t)dup->timestamp);
 }
 
 static inline bool mp_cache_init_internal(mp_cache_t *c, const struct mp_media_info *info)
@@ -532,6 +834,14 @@ static inline bool mp_cache_init_internal(mp_cache_t *c, const struct mp_media_i
 	return true;
 }
 
+/* what decoding everything up front would take, at the smallest
+ * (4:2:0) format frames end up in */
+static int64_t estimate_raw_size(mp_media_t *m)
+{
+	const AVCodecParameters *par = m->v.stream->codecpar;
+	return mp_media_get_frames(m) * par->width * par->height * 3 / 2;
+}
+
 bool mp_cache_init(mp_cache_t *c, const struct mp_media_info *info)
 {
 	struct mp_media_info info2 = *info;
@@ -543,11 +853,18 @@ bool mp_cache_init(mp_cache_t *c, const struct mp_media_info *info)
 	info2.v_seek_cb = NULL;
 	info2.stop_cb = NULL;
 	info2.full_decode = true;
+	info2.pooled_frames = false;
 
 	mp_media_t *m = &c->m;
 
 	pthread_mutex_init_value(&c->mutex);
 
+	c->pool = mp_frame_pool_create();
+	if (!c->pool) {
+		mp_cache_free(c);
+		return false;
+	}
+
 	if (!mp_media_init(m, &info2)) {
 		mp_cache_free(c);
 		return false;
@@ -571,6 +888,10 @@ bool mp_cache_init(mp_cache_t *c, const struct mp_media_info *info)
 	c->has_video = m->has_video;
 	c->has_audio = m->has_audio;
 
+	c->compressed = c->has_video && (info->compressed_cache || estimate_raw_size(m) > MAX_RAW_CACHE_SIZE);
+	if (c->compressed)
+		m->v_cb = fill_ring;
+
 	if (!base_sys_ts)
 		base_sys_ts = (int64_t)os_gettime_ns();
 
@@ -605,17 +926,22 @@ void mp_cache_free(mp_cache_t *c)
 	if (c->m.fmt)
 		mp_media_free(&c->m);
 
-	for (size_t i = 0; i < c->video_frames.num; i++) {
-		struct obs_source_frame *f = &c->video_frames.array[i];
-		obs_source_frame_free(f);
-	}
-	for (size_t i = 0; i < c->audio_segments.num; i++) {
-		struct obs_source_audio *a = &c->audio_segments.array[i];
-		bfree((void *)a->data[0]);
-	}
+	for (size_t i = 0; i < c->video_frames.num; i++)
+		mp_frame_release(c->video_frames.array[i]);
+	for (size_t i = 0; i < c->audio_segments.num; i++)
+		mp_audio_release(c->audio_segments.array[i]);
 	da_free(c->video_frames);
 	da_free(c->audio_segments);
 
+	for (size_t i = 0; i < c->v_packets.num; i++)
+		av_packet_free(&c->v_packets.array[i]);
+	for (size_t i = 0; i < MP_CACHE_RING_SIZE; i++)
+		mp_frame_release(c->ring[i]);
+	da_free(c->v_packets);
+	mp_ts_index_free(&c->v_index);
+	mp_ts_index_free(&c->a_index);
+	mp_frame_pool_destroy(c->pool);
+
 	bfree(c->path);
 	bfree(c->format_name);
 	pthread_mutex_destroy(&c->mutex);
@@ -683,6 +1009,7 @@ void mp_cache_seek(mp_cache_t *c, int64_t pos)
 	pthread_mutex_lock(&c->mutex);
 	if (c->active) {
 		c->seek = true;
+		c->seek_exact = false;
 		c->seek_pos = pos * 1000;
 	}
 	pthread_mutex_unlock(&c->mutex);
@@ -690,9 +1017,35 @@ void mp_cache_seek(mp_cache_t *c, int64_t pos)
 	os_sem_post(c->sem);
 }
 
+void mp_cache_seek_pts(mp_cache_t *c, int64_t pts)
+{
+	pthread_mutex_lock(&c->mutex);
+	if (c->active) {
+		c->seek = true;
+		c->seek_exact = true;
+		c->seek_pos = pts;
+		c->step_frames = 0;
+	}
+	pthread_mutex_unlock(&c->mutex);
+
+	os_sem_post(c->sem);
+}
+
+void mp_cache_step_frame(mp_cache_t *c, int frames)
+{
+	pthread_mutex_lock(&c->mutex);
+	if (c->active)
+		c->step_frames += frames;
+	pthread_mutex_unlock(&c->mutex);
+
+	os_sem_post(c->sem);
+}
+
 int64_t mp_cache_get_frames(mp_cache_t *c)
 {
-	return c->video_frames.num;
+	if (c->compressed && !c->demux_done)
+		return mp_media_get_frames(&c->m);
+	return v_count(c);
 }
 
 int64_t mp_cache_get_duration(mp_cache_t *c)
@@ -21,6 +21,11 @@
 #include <obs.h>
 
 #include "media.h"
+#include "ts-index.h"
+#include "frame-pool.h"
+
+/* decoded frames kept around in compressed mode */
+#define MP_CACHE_RING_SIZE 4
 
 struct mp_cache {
 	mp_video_cb v_preload_cb;
@@ -51,13 +56,34 @@ struct mp_cache {
 	bool thread_valid;
 	pthread_t thread;
 
-	DARRAY(struct obs_source_frame) video_frames;
-	DARRAY(struct obs_source_audio) audio_segments;
+	/* frames and segments are pool buffers, handed to v_cb/a_cb as is */
+	struct mp_frame_pool *pool;
+	DARRAY(struct obs_source_frame *) video_frames;
+	DARRAY(struct obs_source_audio *) audio_segments;
+	struct mp_ts_index v_index; /* presentation order timeline */
+	struct mp_ts_index a_index;
+
+	/* compressed mode: video stays as demuxed packets and is decoded on
+	 * demand into a small ring, audio is decoded as it is demuxed */
+	bool compressed;
+	bool demux_done;
+	DARRAY(AVPacket *) v_packets; /* decode order, v_index keyframes point here */
+	uint64_t packet_bytes;
+
+	size_t dec_next_pkt;
+	int64_t dec_last_pts;
+	bool dec_started;
+
+	struct obs_source_frame *ring[MP_CACHE_RING_SIZE];
+	int64_t ring_pts[MP_CACHE_RING_SIZE]; /* frame timestamps get rewritten on delivery */
+	size_t ring_next;
+	struct obs_source_frame *ring_filled;
 
 	size_t cur_v_idx;
 	size_t cur_a_idx;
 	size_t next_v_idx;
 	size_t next_a_idx;
+	size_t last_v_idx; /* frame on screen, where stepping starts */
 	int64_t next_v_ts;
 	int64_t next_a_ts;
 
@@ -74,8 +100,10 @@ struct mp_cache {
 	bool reset_ts;
 	bool seek;
 	bool seek_next_ts;
+	bool seek_exact;
 	bool eof;
 	int64_t seek_pos;
+	int step_frames;
 	int64_t start_time;
 	int64_t media_duration;
 
@@ -93,5 +121,7 @@ extern void mp_cache_stop(mp_cache_t *c);
 extern void mp_cache_preload_frame(mp_cache_t *c);
 extern int64_t mp_cache_get_current_time(mp_cache_t *c);
 extern void mp_cache_seek(mp_cache_t *c, int64_t pos);
+extern void mp_cache_seek_pts(mp_cache_t *c, int64_t pts);
+extern void mp_cache_step_frame(mp_cache_t *c, int frames);
 extern int64_t mp_cache_get_frames(mp_cache_t *c);
 extern int64_t mp_cache_get_duration(mp_cache_t *c);
@@ -0,0 +1,375 @@
+/*
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <util/threading.h>
+#include <util/platform.h>
+#include <util/darray.h>
+#include <util/bmem.h>
+
+#include "decode-service.h"
+#include "media.h"
+
+extern bool mp_media_service_open(mp_media_t *m);
+extern bool mp_media_service_state(mp_media_t *m, uint64_t *next_ns, int64_t *frame_ns);
+extern bool mp_media_service_run(mp_media_t *m, bool woke_idle, bool present);
+
+/* longest a worker sleeps without looking at the clips again */
+#define MAX_WAIT_NS 100000000ULL
+
+/* scheduling slack before a frame counts as late */
+#define LATE_NS 4000000LL
+
+struct mp_decode_clip {
+	mp_media_t *m;
+	enum mp_decode_priority priority;
+	int decode_ahead;
+
+	bool opened;
+	bool failed;
+	bool removed;
+	bool running;
+	bool woken;
+	bool active; /* playing, otherwise it waits for a command */
+	uint64_t due_ns;
+
+	struct mp_decode_stats stats;
+	int64_t total_lag_ns;
+};
+
+struct mp_decode_service {
+	pthread_mutex_t mutex;
+	pthread_cond_t clip_done;
+	os_event_t *event;
+	bool stop;
+
+	DARRAY(struct mp_decode_clip *) clips;
+	DARRAY(pthread_t) workers;
+};
+
+static struct mp_decode_clip *find_clip(struct mp_decode_service *svc, mp_media_t *m)
+{
+	for (size_t i = 0; i < svc->clips.num; i++) {
+		if (svc->clips.array[i]->m == m)
+			return svc->clips.array[i];
+	}
+	return NULL;
+}
+
+/* commands and clips that haven't been opened go first, then due visible
+ * clips, then due hidden ones; earliest deadline first within each */
+static struct mp_decode_clip *pick_clip(struct mp_decode_service *svc, uint64_t now, uint64_t *wait_ns)
+{
+	struct mp_decode_clip *best = NULL;
+	int best_class = 0;
+	uint64_t best_due = 0;
+
+	for (size_t i = 0; i < svc->clips.num; i++) {
+		struct mp_decode_clip *clip = svc->clips.array[i];
+		int class;
+		uint64_t due;
+
+		if (clip->running || clip->failed || clip->removed)
+			continue;
+
+		if (!clip->opened || clip->woken) {
+			class = 0;
+			due = 0;
+		} else if (clip->active && clip->priority != MP_DECODE_PAUSED) {
+			if (clip->due_ns > now) {
+				if (clip->due_ns - now < *wait_ns)
+					*wait_ns = clip->due_ns - now;
+				continue;
+			}
+			class = clip->priority == MP_DECODE_VISIBLE ? 1 : 2;
+			due = clip->due_ns;
+		} else {
+			continue;
+		}
+
+		if (!best || class < best_class || (class == best_class && due < best_due)) {
+			best = clip;
+			best_class = class;
+			best_due = due;
+		}
+	}
+
+	return best;
+}
+
+static void record_lag(struct mp_decode_clip *clip, int64_t lag)
+{
+	struct mp_decode_stats *stats = &clip->stats;
+
+	if (lag < 0)
+		lag = 0;
+
+	stats->lag_ns = lag;
+	if (lag > stats->max_lag_ns)
+		stats->max_lag_ns = lag;
+	if (lag > LATE_NS)
+		stats->late_frames++;
+
+	stats->frames++;
+	clip->total_lag_ns += lag;
+	stats->avg_lag_ns = clip->total_lag_ns / (int64_t)stats->frames;
+}
+
+/* runs without the service lock; only this worker touches the clip's media
+ * while clip->running is set */
+static void run_clip(struct mp_decode_service *svc, struct mp_decode_clip *clip, bool woke_idle, bool present,
+		     uint64_t now)
+{
+	mp_media_t *m = clip->m;
+	uint64_t next_ns;
+	int64_t frame_ns;
+	int64_t lag = 0;
+	bool ok;
+
+	if (!clip->opened) {
+		ok = mp_media_service_open(m);
+		clip->opened = true;
+	} else {
+		if (present) {
+			mp_media_service_state(m, &next_ns, &frame_ns);
+			if (next_ns)
+				lag = (int64_t)(now - next_ns);
+		}
+
+		ok = mp_media_service_run(m, woke_idle, present);
+	}
+
+	if (!ok) {
+		if (m->stop_cb)
+			m->stop_cb(m->opaque);
+
+		pthread_mutex_lock(&svc->mutex);
+		clip->failed = true;
+		pthread_mutex_unlock(&svc->mutex);
+		return;
+	}
+
+	bool active = mp_media_service_state(m, &next_ns, &frame_ns);
+
+	pthread_mutex_lock(&svc->mutex);
+	if (present)
+		record_lag(clip, lag);
+
+	uint64_t lead = clip->decode_ahead > 0 && frame_ns > 0 ? (uint64_t)clip->decode_ahead * (uint64_t)frame_ns : 0;
+	clip->active = active;
+	clip->due_ns = next_ns > lead ? next_ns - lead : 0;
+	pthread_mutex_unlock(&svc->mutex);
+}
+
+static void *worker_thread(void *data)
+{
+	struct mp_decode_service *svc = data;
+
+	os_set_thread_name("mp_decode_worker");
+
+	pthread_mutex_lock(&svc->mutex);
+
+	while (!svc->stop) {
+		uint64_t now = os_gettime_ns();
+		uint64_t wait_ns = MAX_WAIT_NS;
+
+		/* signals from here on wake the wait below */
+		os_event_reset(svc->event);
+
+		struct mp_decode_clip *clip = pick_clip(svc, now, &wait_ns);
+		if (!clip) {
+			pthread_mutex_unlock(&svc->mutex);
+			os_event_timedwait(svc->event, (unsigned long)((wait_ns + 999999) / 1000000));
+			pthread_mutex_lock(&svc->mutex);
+			continue;
+		}
+
+		bool woke_idle = clip->woken && !clip->active;
+		bool present = clip->opened && clip->active && clip->priority != MP_DECODE_PAUSED && clip->due_ns <= now;
+		clip->woken = false;
+		clip->running = true;
+		pthread_mutex_unlock(&svc->mutex);
+
+		run_clip(svc, clip, woke_idle, present, now);
+
+		pthread_mutex_lock(&svc->mutex);
+		clip->running = false;
+		pthread_cond_broadcast(&svc->clip_done);
+
+		/* the clip's new deadline may be earlier than what sleeping
+		 * workers are waiting for */
+		os_event_signal(svc->event);
+	}
+
+	pthread_mutex_unlock(&svc->mutex);
+	return NULL;
+}
+
+struct mp_decode_service *mp_decode_service_create(size_t workers)
+{
+	struct mp_decode_service *svc = bzalloc(sizeof(*svc));
+
+	if (!workers) {
+		workers = (size_t)os_get_logical_cores() / 2;
+		if (!workers)
+			workers = 1;
+	}
+
+	if (pthread_mutex_init(&svc->mutex, NULL) != 0) {
+		blog(LOG_WARNING, "MP: Failed to init decode service mutex");
+		bfree(svc);
+		return NULL;
+	}
+	if (pthread_cond_init(&svc->clip_done, NULL) != 0) {
+		blog(LOG_WARNING, "MP: Failed to init decode service condition");
+		pthread_mutex_destroy(&svc->mutex);
+		bfree(svc);
+		return NULL;
+	}
+	if (os_event_init(&svc->event, OS_EVENT_TYPE_MANUAL) != 0) {
+		blog(LOG_WARNING, "MP: Failed to init decode service event");
+		pthread_cond_destroy(&svc->clip_done);
+		pthread_mutex_destroy(&svc->mutex);
+		bfree(svc);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < workers; i++) {
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, worker_thread, svc) != 0) {
+			blog(LOG_WARNING, "MP: Could not create decode worker");
+			break;
+		}
+		da_push_back(svc->workers, &thread);
+	}
+
+	if (!svc->workers.num) {
+		mp_decode_service_destroy(svc);
+		return NULL;
+	}
+
+	blog(LOG_INFO, "MP: Decode service started with %zu workers", svc->workers.num);
+	return svc;
+}
+
+void mp_decode_service_destroy(struct mp_decode_service *svc)
+{
+	if (!svc)
+		return;
+
+	pthread_mutex_lock(&svc->mutex);
+	if (svc->clips.num)
+		blog(LOG_WARNING, "MP: Decode service destroyed with %zu clips left", svc->clips.num);
+	svc->stop = true;
+	pthread_mutex_unlock(&svc->mutex);
+	os_event_signal(svc->event);
+
+	for (size_t i = 0; i < svc->workers.num; i++)
+		pthread_join(svc->workers.array[i], NULL);
+
+	for (size_t i = 0; i < svc->clips.num; i++)
+		bfree(svc->clips.array[i]);
+	da_free(svc->clips);
+	da_free(svc->workers);
+
+	os_event_destroy(svc->event);
+	pthread_cond_destroy(&svc->clip_done);
+	pthread_mutex_destroy(&svc->mutex);
+	bfree(svc);
+}
+
+bool mp_decode_service_add(struct mp_decode_service *svc, mp_media_t *m, int decode_ahead)
+{
+	struct mp_decode_clip *clip = bzalloc(sizeof(*clip));
+
+	clip->m = m;
+	clip->priority = MP_DECODE_VISIBLE;
+	clip->decode_ahead = decode_ahead > 0 ? decode_ahead : 0;
+
+	pthread_mutex_lock(&svc->mutex);
+	da_push_back(svc->clips, &clip);
+	pthread_mutex_unlock(&svc->mutex);
+
+	os_event_signal(svc->event);
+	return true;
+}
+
+void mp_decode_service_remove(struct mp_decode_service *svc, mp_media_t *m)
+{
+	pthread_mutex_lock(&svc->mutex);
+
+	struct mp_decode_clip *clip = find_clip(svc, m);
+	if (clip) {
+		clip->removed = true;
+		while (clip->running)
+			pthread_cond_wait(&svc->clip_done, &svc->mutex);
+
+		da_erase_item(svc->clips, &clip);
+		bfree(clip);
+	}
+
+	pthread_mutex_unlock(&svc->mutex);
+}
+
+void mp_decode_service_wake(struct mp_decode_service *svc, mp_media_t *m)
+{
+	pthread_mutex_lock(&svc->mutex);
+	struct mp_decode_clip *clip = find_clip(svc, m);
+	if (clip)
+		clip->woken = true;
+	pthread_mutex_unlock(&svc->mutex);
+
+	os_event_signal(svc->event);
+}
+
+void mp_decode_service_set_priority(struct mp_decode_service *svc, mp_media_t *m, enum mp_decode_priority priority)
+{
+	bool resume = false;
+
+	pthread_mutex_lock(&svc->mutex);
+	struct mp_decode_clip *clip = find_clip(svc, m);
+	if (clip) {
+		resume = clip->priority == MP_DECODE_PAUSED && priority != MP_DECODE_PAUSED;
+		clip->priority = priority;
+	}
+	pthread_mutex_unlock(&svc->mutex);
+
+	/* restart the clock rather than racing through the time it sat out */
+	if (resume) {
+		pthread_mutex_lock(&m->mutex);
+		if (m->active)
+			m->reset_ts = true;
+		pthread_mutex_unlock(&m->mutex);
+		mp_decode_service_wake(svc, m);
+	}
+}
+
+void mp_decode_service_set_decode_ahead(struct mp_decode_service *svc, mp_media_t *m, int frames)
+{
+	pthread_mutex_lock(&svc->mutex);
+	struct mp_decode_clip *clip = find_clip(svc, m);
+	if (clip)
+		clip->decode_ahead = frames > 0 ? frames : 0;
+	pthread_mutex_unlock(&svc->mutex);
+}
+
+bool mp_decode_service_get_stats(struct mp_decode_service *svc, mp_media_t *m, struct mp_decode_stats *stats)
+{
+	pthread_mutex_lock(&svc->mutex);
+	struct mp_decode_clip *clip = find_clip(svc, m);
+	if (clip)
+		*stats = clip->stats;
+	pthread_mutex_unlock(&svc->mutex);
+
+	return clip != NULL;
+}
@@ -0,0 +1,69 @@
+/*
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Shared decode service: clips created with mp_media_info.decode_service
+ * don't get a thread of their own, a bounded pool of workers runs all of
+ * them instead. Workers pick the clip whose next frame is due first; feeds
+ * that aren't in the active layout only get a worker once every visible
+ * feed is served (MP_DECODE_HIDDEN), or not at all (MP_DECODE_PAUSED).
+ *
+ * A clip with a decode-ahead depth of n is run up to n frame durations
+ * before its frames are due, so a late worker doesn't make it miss a
+ * frame. Frames keep their timestamps; consumers present them by
+ * timestamp, not on arrival. */
+struct mp_decode_service;
+struct mp_media;
+
+enum mp_decode_priority {
+	MP_DECODE_VISIBLE,
+	MP_DECODE_HIDDEN,
+	MP_DECODE_PAUSED,
+};
+
+struct mp_decode_stats {
+	int64_t lag_ns;     /* how late the last frame was handed out */
+	int64_t max_lag_ns;
+	int64_t avg_lag_ns;
+	uint64_t frames;
+	uint64_t late_frames;
+};
+
+/* workers = 0 picks half the logical cores */
+extern struct mp_decode_service *mp_decode_service_create(size_t workers);
+/* every clip has to be freed first */
+extern void mp_decode_service_destroy(struct mp_decode_service *svc);
+
+extern bool mp_decode_service_add(struct mp_decode_service *svc, struct mp_media *m, int decode_ahead);
+extern void mp_decode_service_remove(struct mp_decode_service *svc, struct mp_media *m);
+extern void mp_decode_service_wake(struct mp_decode_service *svc, struct mp_media *m);
+
+extern void mp_decode_service_set_priority(struct mp_decode_service *svc, struct mp_media *m,
+					   enum mp_decode_priority priority);
+extern void mp_decode_service_set_decode_ahead(struct mp_decode_service *svc, struct mp_media *m, int frames);
+extern bool mp_decode_service_get_stats(struct mp_decode_service *svc, struct mp_media *m,
+					struct mp_decode_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,294 @@
+/*
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <media-io/audio-io.h>
+#include <util/threading.h>
+#include <util/darray.h>
+#include <util/bmem.h>
+
+#include "frame-pool.h"
+
+/* returned buffers kept per kind; beyond this they are freed */
+#define MAX_FREE_ENTRIES 32
+
+struct pool_entry {
+	/* first, so frame/audio pointers convert back to the entry */
+	union {
+		struct obs_source_frame frame;
+		struct obs_source_audio audio;
+	};
+
+	struct mp_frame_pool *pool;
+	volatile long refs;
+	bool is_audio;
+
+	int format;
+	uint32_t width; /* speakers for audio */
+	uint32_t height; /* frames for audio */
+
+	/* planes as allocated, callers may move the frame's pointers */
+	uint8_t *data[MAX_AV_PLANES];
+	uint32_t linesize[MAX_AV_PLANES];
+};
+
+struct mp_frame_pool {
+	pthread_mutex_t mutex;
+	DARRAY(struct pool_entry *) free_video;
+	DARRAY(struct pool_entry *) free_audio;
+	volatile long refs; /* the owner's plus one per referenced buffer */
+	bool destroyed;
+
+	long allocations;
+	long reuses;
+	long outstanding;
+};
+
+struct mp_frame_pool *mp_frame_pool_create(void)
+{
+	struct mp_frame_pool *pool = bzalloc(sizeof(*pool));
+
+	if (pthread_mutex_init(&pool->mutex, NULL) != 0) {
+		blog(LOG_WARNING, "MP: Failed to init frame pool mutex");
+		bfree(pool);
+		return NULL;
+	}
+
+	pool->refs = 1;
+	return pool;
+}
+
+static void free_entry(struct pool_entry *e)
+{
+	if (e->is_audio) {
+		bfree(e->data[0]);
+	} else {
+		e->frame.data[0] = e->data[0];
+		obs_source_frame_free(&e->frame);
+	}
+	bfree(e);
+}
+
+static void pool_release(struct mp_frame_pool *pool)
+{
+	if (os_atomic_dec_long(&pool->refs) != 0)
+		return;
+
+	for (size_t i = 0; i < pool->free_video.num; i++)
+		free_entry(pool->free_video.array[i]);
+	for (size_t i = 0; i < pool->free_audio.num; i++)
+		free_entry(pool->free_audio.array[i]);
+	da_free(pool->free_video);
+	da_free(pool->free_audio);
+
+	pthread_mutex_destroy(&pool->mutex);
+	bfree(pool);
+}
+
+void mp_frame_pool_destroy(struct mp_frame_pool *pool)
+{
+	if (!pool)
+		return;
+
+	pthread_mutex_lock(&pool->mutex);
+	pool->destroyed = true;
+	pthread_mutex_unlock(&pool->mutex);
+
+	pool_release(pool);
+}
+
+static struct pool_entry *take_free(struct mp_frame_pool *pool, bool is_audio, int format, uint32_t width,
+				    uint32_t height)
+{
+	struct pool_entry *e = NULL;
+
+	pthread_mutex_lock(&pool->mutex);
+
+	if (is_audio) {
+		for (size_t i = 0; i < pool->free_audio.num; i++) {
+			struct pool_entry *cur = pool->free_audio.array[i];
+			if (cur->format == format && cur->width == width && cur->height == height) {
+				e = cur;
+				da_erase(pool->free_audio, i);
+				break;
+			}
+		}
+	} else {
+		for (size_t i = 0; i < pool->free_video.num; i++) {
+			struct pool_entry *cur = pool->free_video.array[i];
+			if (cur->format == format && cur->width == width && cur->height == height) {
+				e = cur;
+				da_erase(pool->free_video, i);
+				break;
+			}
+		}
+	}
+
+	if (e)
+		pool->reuses++;
+	else
+		pool->allocations++;
+	pool->outstanding++;
+
+	pthread_mutex_unlock(&pool->mutex);
+
+	os_atomic_inc_long(&pool->refs);
+	return e;
+}
+
+struct obs_source_frame *mp_frame_pool_get_video(struct mp_frame_pool *pool, enum video_format format,
+						 uint32_t width, uint32_t height)
+{
+	struct pool_entry *e = take_free(pool, false, format, width, height);
+
+	if (!e) {
+		e = bzalloc(sizeof(*e));
+		e->format = format;
+		e->width = width;
+		e->height = height;
+
+		obs_source_frame_init(&e->frame, format, width, height);
+		memcpy(e->data, e->frame.data, sizeof(e->data));
+		memcpy(e->linesize, e->frame.linesize, sizeof(e->linesize));
+	} else {
+		memset(&e->frame, 0, sizeof(e->frame));
+		memcpy(e->frame.data, e->data, sizeof(e->data));
+		memcpy(e->frame.linesize, e->linesize, sizeof(e->linesize));
+		e->frame.format = format;
+		e->frame.width = width;
+		e->frame.height = height;
+	}
+
+	e->pool = pool;
+	e->refs = 1;
+	return &e->frame;
+}
+
+struct obs_source_audio *mp_frame_pool_get_audio(struct mp_frame_pool *pool, enum audio_format format,
+						enum speaker_layout speakers, uint32_t frames)
+{
+	struct pool_entry *e = take_free(pool, true, format, speakers, frames);
+
+	if (!e) {
+		size_t planes = get_audio_planes(format, speakers);
+		size_t plane_size = get_audio_bytes_per_channel(format) * frames;
+
+		e = bzalloc(sizeof(*e));
+		e->is_audio = true;
+		e->format = format;
+		e->width = speakers;
+		e->height = frames;
+
+		e->data[0] = bmalloc(get_total_audio_size(format, speakers, frames));
+		for (size_t i = 1; i < planes; i++)
+			e->data[i] = e->data[0] + plane_size * i;
+	}
+
+	memset(&e->audio, 0, sizeof(e->audio));
+	memcpy((void *)e->audio.data, e->data, sizeof(e->audio.data));
+	e->audio.format = format;
+	e->audio.speakers = speakers;
+	e->audio.frames = frames;
+
+	e->pool = pool;
+	e->refs = 1;
+	return &e->audio;
+}
+
+struct obs_source_frame *mp_frame_pool_dup_video(struct mp_frame_pool *pool, const struct obs_source_frame *frame)
+{
+	struct obs_source_frame *dup = mp_frame_pool_get_video(pool, frame->format, frame->width, frame->height);
+
+	obs_source_frame_copy(dup, frame);
+	dup->timestamp = frame->timestamp;
+	return dup;
+}
+
+struct obs_source_audio *mp_frame_pool_dup_audio(struct mp_frame_pool *pool, const struct obs_source_audio *audio)
+{
+	struct obs_source_audio *dup = mp_frame_pool_get_audio(pool, audio->format, audio->speakers, audio->frames);
+
+	dup->samples_per_sec = audio->samples_per_sec;
+	dup->timestamp = audio->timestamp;
+
+	size_t planes = get_audio_planes(audio->format, audio->speakers);
+	if (planes > 1) {
+		size_t size = get_audio_bytes_per_channel(audio->format) * audio->frames;
+
+		for (size_t i = 0; i < planes; i++)
+			memcpy((uint8_t *)dup->data[i], audio->data[i], size);
+	} else {
+		memcpy((uint8_t *)dup->data[0], audio->data[0],
+		       get_total_audio_size(audio->format, audio->speakers, audio->frames));
+	}
+
+	return dup;
+}
+
+static void entry_release(struct pool_entry *e)
+{
+	struct mp_frame_pool *pool = e->pool;
+	bool keep;
+
+	if (os_atomic_dec_long(&e->refs) != 0)
+		return;
+
+	pthread_mutex_lock(&pool->mutex);
+	pool->outstanding--;
+	if (e->is_audio) {
+		keep = !pool->destroyed && pool->free_audio.num < MAX_FREE_ENTRIES;
+		if (keep)
+			da_push_back(pool->free_audio, &e);
+	} else {
+		keep = !pool->destroyed && pool->free_video.num < MAX_FREE_ENTRIES;
+		if (keep)
+			da_push_back(pool->free_video, &e);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+
+	if (!keep)
+		free_entry(e);
+
+	pool_release(pool);
+}
+
+void mp_frame_addref(struct obs_source_frame *frame)
+{
+	os_atomic_inc_long(&((struct pool_entry *)frame)->refs);
+}
+
+void mp_frame_release(struct obs_source_frame *frame)
+{
+	if (frame)
+		entry_release((struct pool_entry *)frame);
+}
+
+void mp_audio_addref(struct obs_source_audio *audio)
+{
+	os_atomic_inc_long(&((struct pool_entry *)audio)->refs);
+}
+
+void mp_audio_release(struct obs_source_audio *audio)
+{
+	if (audio)
+		entry_release((struct pool_entry *)audio);
+}
+
+void mp_frame_pool_get_stats(struct mp_frame_pool *pool, struct mp_frame_pool_stats *stats)
+{
+	pthread_mutex_lock(&pool->mutex);
+	stats->allocations = pool->allocations;
+	stats->reuses = pool->reuses;
+	stats->outstanding = pool->outstanding;
+	pthread_mutex_unlock(&pool->mutex);
+}
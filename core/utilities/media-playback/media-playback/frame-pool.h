@@ -0,0 +1,65 @@
+/*
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#pragma once
+
+#include <obs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Recycled video frame and audio buffers, keyed on (format, width, height)
+ * and (format, speakers, frames). Buffers are refcounted: the last
+ * mp_frame_release() / mp_audio_release() hands the memory back to the pool
+ * for the next request with the same key, so steady-state playback stops
+ * allocating once every buffer in flight has been created.
+ *
+ * Frame data stays valid while a reference is held. The other fields are
+ * only meaningful during the callback the frame was passed to, playback may
+ * update them (timestamps) for the next delivery of the same buffer. */
+struct mp_frame_pool;
+
+struct mp_frame_pool_stats {
+	long allocations; /* buffers created */
+	long reuses;      /* requests served with a returned buffer */
+	long outstanding; /* buffers referenced right now */
+};
+
+extern struct mp_frame_pool *mp_frame_pool_create(void);
+/* buffers still referenced stay valid and are freed on their last release */
+extern void mp_frame_pool_destroy(struct mp_frame_pool *pool);
+
+extern struct obs_source_frame *mp_frame_pool_get_video(struct mp_frame_pool *pool, enum video_format format,
+							 uint32_t width, uint32_t height);
+extern struct obs_source_audio *mp_frame_pool_get_audio(struct mp_frame_pool *pool, enum audio_format format,
+							enum speaker_layout speakers, uint32_t frames);
+
+/* pool buffers holding a copy of the data and metadata */
+extern struct obs_source_frame *mp_frame_pool_dup_video(struct mp_frame_pool *pool,
+							 const struct obs_source_frame *frame);
+extern struct obs_source_audio *mp_frame_pool_dup_audio(struct mp_frame_pool *pool,
+							const struct obs_source_audio *audio);
+
+/* only valid for buffers from a pool */
+extern void mp_frame_addref(struct obs_source_frame *frame);
+extern void mp_frame_release(struct obs_source_frame *frame);
+extern void mp_audio_addref(struct obs_source_audio *audio);
+extern void mp_audio_release(struct obs_source_audio *audio);
+
+extern void mp_frame_pool_get_stats(struct mp_frame_pool *pool, struct mp_frame_pool_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
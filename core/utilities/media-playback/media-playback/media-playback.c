@@ -131,6 +131,28 @@ void media_playback_seek(media_playback_t *mp, int64_t pos)
 		mp_media_seek(&mp->media, pos);
 }
 
+void media_playback_seek_pts(media_playback_t *mp, int64_t pts)
+{
+	if (!mp)
+		return;
+
+	if (mp->is_cached)
+		mp_cache_seek_pts(&mp->cache, pts);
+	else
+		mp_media_seek_pts(&mp->media, pts);
+}
+
+void media_playback_step_frame(media_playback_t *mp, int frames)
+{
+	if (!mp)
+		return;
+
+	if (mp->is_cached)
+		mp_cache_step_frame(&mp->cache, frames);
+	else
+		mp_media_step_frame(&mp->media, frames);
+}
+
 int64_t media_playback_get_frames(media_playback_t *mp)
 {
 	if (!mp)
@@ -174,3 +196,36 @@ bool media_playback_has_audio(media_playback_t *mp)
 	else
 		return mp->media.has_audio;
 }
+
+void media_playback_get_frame_pool_stats(media_playback_t *mp, struct mp_frame_pool_stats *stats)
+{
+	struct mp_frame_pool *pool = NULL;
+
+	memset(stats, 0, sizeof(*stats));
+	if (!mp)
+		return;
+
+	pool = mp->is_cached ? mp->cache.pool : mp->media.frame_pool;
+	if (pool)
+		mp_frame_pool_get_stats(pool, stats);
+}
+
+void media_playback_set_decode_priority(media_playback_t *mp, enum mp_decode_priority priority)
+{
+	if (mp && !mp->is_cached && mp->media.service)
+		mp_decode_service_set_priority(mp->media.service, &mp->media, priority);
+}
+
+void media_playback_set_decode_ahead(media_playback_t *mp, int frames)
+{
+	if (mp && !mp->is_cached && mp->media.service)
+		mp_decode_service_set_decode_ahead(mp->media.service, &mp->media, frames);
+}
+
+bool media_playback_get_decode_stats(media_playback_t *mp, struct mp_decode_stats *stats)
+{
+	if (!mp || mp->is_cached || !mp->media.service)
+		return false;
+
+	return mp_decode_service_get_stats(mp->media.service, &mp->media, stats);
+}
@@ -18,6 +18,9 @@
 
 #include <obs.h>
 
+#include "frame-pool.h"
+#include "decode-service.h"
+
 struct media_playback;
 typedef struct media_playback media_playback_t;
 
@@ -46,6 +49,19 @@ struct mp_media_info {
 	bool reconnecting;
 	bool request_preload;
 	bool full_decode;
+	bool compressed_cache;
+
+	/* frames and audio passed to the callbacks are refcounted pool buffers
+	 * (see frame-pool.h): call mp_frame_addref()/mp_audio_addref() in the
+	 * callback to keep one past it. Cached playback (full_decode) always
+	 * hands out pool buffers. */
+	bool pooled_frames;
+
+	/* run on a shared decode service instead of a thread of its own (not
+	 * for full_decode), handing frames out up to decode_ahead frame
+	 * durations before they're due (see decode-service.h) */
+	struct mp_decode_service *decode_service;
+	int decode_ahead;
 };
 
 extern media_playback_t *media_playback_create(const struct mp_media_info *info);
@@ -59,7 +75,22 @@ extern void media_playback_set_is_linear_alpha(media_playback_t *mp, bool is_lin
 extern void media_playback_preload_frame(media_playback_t *mp);
 extern int64_t media_playback_get_current_time(media_playback_t *mp);
 extern void media_playback_seek(media_playback_t *mp, int64_t pos);
+
+/* Frame-accurate scrubbing. pts is in nanoseconds on the media's own
+ * timeline (the timestamps frames are decoded with); the frame on screen at
+ * that time is shown, through v_seek_cb while paused. Stepping moves by
+ * whole frames from the one on screen. */
+extern void media_playback_seek_pts(media_playback_t *mp, int64_t pts);
+extern void media_playback_step_frame(media_playback_t *mp, int frames);
 extern int64_t media_playback_get_frames(media_playback_t *mp);
 extern int64_t media_playback_get_duration(media_playback_t *mp);
 extern bool media_playback_has_video(media_playback_t *mp);
 extern bool media_playback_has_audio(media_playback_t *mp);
+
+/* only for clips on a decode service; get_decode_stats is false otherwise */
+extern void media_playback_set_decode_priority(media_playback_t *mp, enum mp_decode_priority priority);
+extern void media_playback_set_decode_ahead(media_playback_t *mp, int frames);
+extern bool media_playback_get_decode_stats(media_playback_t *mp, struct mp_decode_stats *stats);
+
+/* zeroed stats when frames aren't pooled (see pooled_frames) */
+extern void media_playback_get_frame_pool_stats(media_playback_t *mp, struct mp_frame_pool_stats *stats);
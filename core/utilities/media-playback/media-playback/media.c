@@ -164,6 +164,59 @@ void mp_media_free_packet(struct mp_media *media, AVPacket *pkt)
 	da_push_back(media->packet_pool, &pkt);
 }
 
+/* pts in ns as frames are decoded with it, see mp_decode_next() */
+int64_t mp_media_packet_ts(mp_media_t *m, const AVPacket *pkt)
+{
+	int64_t ts = pkt->pts != AV_NOPTS_VALUE ? pkt->pts : pkt->dts;
+
+	ts = av_rescale_q(ts, m->v.stream->time_base, (AVRational){1, 1000000000});
+	if (m->speed != 100)
+		ts = av_rescale_q(ts, (AVRational){1, m->speed}, (AVRational){1, 100});
+	return ts;
+}
+
+static inline int64_t media_ts_from_pts(mp_media_t *m, int64_t pts)
+{
+	if (m->speed != 100)
+		pts = av_rescale_q(pts, (AVRational){1, 100}, (AVRational){1, m->speed});
+	return pts;
+}
+
+static void index_video_packet(mp_media_t *m, const AVPacket *pkt)
+{
+	if (pkt->pts == AV_NOPTS_VALUE)
+		return;
+
+	int64_t ts = mp_media_packet_ts(m, pkt);
+	mp_ts_index_insert(&m->v_index, ts);
+	if (pkt->flags & AV_PKT_FLAG_KEY)
+		mp_ts_index_add_keyframe(&m->v_index, ts, pkt->pts);
+
+	/* the first packet after a seek starts a new span */
+	struct mp_ts_span *span = m->v_span_open ? da_end(m->v_spans) : NULL;
+	if (!span) {
+		span = da_push_back_new(m->v_spans);
+		span->start = span->end = ts;
+		m->v_span_open = true;
+	} else if (ts < span->start) {
+		span->start = ts;
+	} else if (ts > span->end) {
+		span->end = ts;
+	}
+}
+
+/* everything from the keyframe up to pts has been demuxed in one go */
+static bool v_index_covers(const mp_media_t *m, int64_t keyframe_ts, int64_t pts)
+{
+	for (size_t i = 0; i < m->v_spans.num; i++) {
+		const struct mp_ts_span *span = &m->v_spans.array[i];
+		if (span->start <= keyframe_ts && pts <= span->end)
+			return true;
+	}
+
+	return false;
+}
+
 static int mp_media_next_packet(mp_media_t *media)
 {
 	AVPacket *pkt;
@@ -184,6 +237,8 @@ static int mp_media_next_packet(mp_media_t *media)
 
 	struct mp_decode *d = get_packet_decoder(media, pkt);
 	if (d && pkt->size) {
+		if (d == &media->v && media->is_local_file)
+			index_video_packet(media, pkt);
 		mp_decode_push_packet(d, pkt);
 	} else {
 		mp_media_free_packet(media, pkt);
@@ -233,6 +288,31 @@ static inline int get_sws_range(enum AVColorRange r)
 	return r == AVCOL_RANGE_JPEG ? 1 : 0;
 }
 
+/* drops what decodes before the target of a frame-accurate seek; the frame
+ * kept is the one on screen at the target */
+static inline void mp_media_skip_to_target(mp_media_t *m)
+{
+	if (!m->skip_to_target)
+		return;
+
+	if (m->has_audio && m->a.frame_ready && m->a.next_pts <= m->target_pts)
+		m->a.frame_ready = false;
+
+	if (m->has_video) {
+		if (!m->v.frame_ready) {
+			if (m->v.eof)
+				m->skip_to_target = false;
+			return;
+		}
+		if (m->v.next_pts <= m->target_pts) {
+			m->v.frame_ready = false;
+			return;
+		}
+	}
+
+	m->skip_to_target = false;
+}
+
 #define FIXED_1_0 (1 << 16)
 
 static bool mp_media_init_scaling(mp_media_t *m)
@@ -261,6 +341,20 @@ static bool mp_media_init_scaling(mp_media_t *m)
 	return true;
 }
 
+bool mp_media_prepare_scaling(mp_media_t *m)
+{
+	if (m->has_video && m->v.frame_ready && !m->swscale) {
+		m->scale_format = closest_format(m->v.frame->format);
+		if (m->scale_format != m->v.frame->format) {
+			if (!mp_media_init_scaling(m)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 bool mp_media_prepare_frames(mp_media_t *m)
 {
 	bool actively_seeking = m->seek_next_ts && m->pause;
@@ -291,18 +385,11 @@ bool mp_media_prepare_frames(mp_media_t *m)
 			return false;
 		if (m->has_audio && !mp_decode_frame(&m->a))
 			return false;
-	}
 
-	if (m->has_video && m->v.frame_ready && !m->swscale) {
-		m->scale_format = closest_format(m->v.frame->format);
-		if (m->scale_format != m->v.frame->format) {
-			if (!mp_media_init_scaling(m)) {
-				return false;
-			}
-		}
+		mp_media_skip_to_target(m);
 	}
 
-	return true;
+	return mp_media_prepare_scaling(m);
 }
 
 static inline int64_t mp_media_get_next_min_pts(mp_media_t *m)
@@ -343,6 +430,30 @@ static inline bool mp_media_can_play_frame(mp_media_t *m, struct mp_decode *d)
 	return d->frame_ready && (d->frame_pts <= m->next_pts_ns || (d->frame_pts - m->next_pts_ns > MAX_TS_VAR));
 }
 
+static void output_video(mp_media_t *m, mp_video_cb cb, struct obs_source_frame *frame)
+{
+	if (!m->frame_pool) {
+		cb(m->opaque, frame);
+		return;
+	}
+
+	struct obs_source_frame *dup = mp_frame_pool_dup_video(m->frame_pool, frame);
+	cb(m->opaque, dup);
+	mp_frame_release(dup);
+}
+
+static void output_audio(mp_media_t *m, struct obs_source_audio *audio)
+{
+	if (!m->frame_pool) {
+		m->a_cb(m->opaque, audio);
+		return;
+	}
+
+	struct obs_source_audio *dup = mp_frame_pool_dup_audio(m->frame_pool, audio);
+	m->a_cb(m->opaque, dup);
+	mp_audio_release(dup);
+}
+
 void mp_media_next_audio(mp_media_t *m)
 {
 	struct mp_decode *d = &m->a;
@@ -369,7 +480,7 @@ void mp_media_next_audio(mp_media_t *m)
 	if (audio.format == AUDIO_FORMAT_UNKNOWN)
 		return;
 
-	m->a_cb(m->opaque, &audio);
+	output_audio(m, &audio);
 }
 
 void mp_media_next_video(mp_media_t *m, bool preload)
@@ -453,6 +564,8 @@ void mp_media_next_video(mp_media_t *m, bool preload)
 	frame->timestamp = m->full_decode ? d->frame_pts
 					  : (m->base_ts + d->frame_pts - m->start_ts + m->play_sys_ts - base_sys_ts);
 
+	m->last_v_pts = d->frame_pts;
+
 	frame->width = f->width;
 	frame->height = f->height;
 	frame->max_luminance = d->max_luminance;
@@ -486,12 +599,12 @@ void mp_media_next_video(mp_media_t *m, bool preload)
 
 	if (preload) {
 		if (m->seek_next_ts && m->v_seek_cb) {
-			m->v_seek_cb(m->opaque, frame);
+			output_video(m, m->v_seek_cb, frame);
 		} else if (!m->request_preload) {
-			m->v_preload_cb(m->opaque, frame);
+			output_video(m, m->v_preload_cb, frame);
 		}
 	} else {
-		m->v_cb(m->opaque, frame);
+		output_video(m, m->v_cb, frame);
 	}
 }
 
@@ -528,6 +641,8 @@ static void seek_to(mp_media_t *m, int64_t pos)
 	else
 		seek_flags = AVSEEK_FLAG_BACKWARD;
 
+	m->skip_to_target = false;
+
 	int64_t seek_target = seek_flags == AVSEEK_FLAG_BACKWARD
 				      ? av_rescale_q(seek_pos, AV_TIME_BASE_Q, stream->time_base)
 				      : seek_pos;
@@ -537,6 +652,7 @@ static void seek_to(mp_media_t *m, int64_t pos)
 		if (ret < 0) {
 			blog(LOG_WARNING, "MP: Failed to seek: %s", av_err2str(ret));
 		}
+		m->v_span_open = false;
 	}
 
 	if (m->has_video && m->is_local_file) {
@@ -548,6 +664,78 @@ static void seek_to(mp_media_t *m, int64_t pos)
 		mp_decode_flush(&m->a);
 }
 
+static void seek_to_pts(mp_media_t *m, int64_t pts)
+{
+	if (!m->has_video || !m->is_local_file) {
+		seek_to(m, media_ts_from_pts(m, pts) / 1000);
+		return;
+	}
+
+	/* land on the keyframe directly when it has been demuxed before, but
+	 * only if the index reaches pts from it: past the indexed range or in a
+	 * gap left by an earlier seek, the last known keyframe can be far behind
+	 * and everything up to pts would be decoded for nothing */
+	const struct mp_ts_keyframe *keyframe = mp_ts_index_find_keyframe(&m->v_index, pts);
+	if (keyframe && !v_index_covers(m, keyframe->ts, pts))
+		keyframe = NULL;
+	AVStream *stream = m->v.stream;
+	int64_t seek_target = keyframe ? keyframe->pos
+				       : av_rescale_q(media_ts_from_pts(m, pts), (AVRational){1, 1000000000},
+						      stream->time_base);
+
+	int ret = av_seek_frame(m->fmt, stream->index, seek_target, AVSEEK_FLAG_BACKWARD);
+	if (ret < 0) {
+		blog(LOG_WARNING, "MP: Failed to seek: %s", av_err2str(ret));
+	}
+	m->v_span_open = false;
+
+	mp_decode_flush(&m->v);
+	if (m->has_audio)
+		mp_decode_flush(&m->a);
+
+	m->eof = false;
+	m->skip_to_target = true;
+	m->target_pts = pts;
+
+	if (m->seek_next_ts && m->pause && m->v_seek_cb && mp_media_prepare_frames(m))
+		mp_media_next_video(m, true);
+}
+
+static void step_frames(mp_media_t *m, int count)
+{
+	size_t num = m->v_index.pts.num;
+	if (!m->has_video || !num)
+		return;
+
+	size_t idx = mp_ts_index_floor(&m->v_index, m->last_v_pts);
+	if (count < 0) {
+		size_t back = (size_t)-(int64_t)count;
+		idx = back > idx ? 0 : idx - back;
+	} else {
+		idx += (size_t)count;
+		if (idx >= num)
+			idx = num - 1;
+	}
+
+	int64_t pts = m->v_index.pts.array[idx];
+	if (pts == m->last_v_pts)
+		return;
+
+	/* forward within the same GOP: decode on instead of seeking back */
+	const struct mp_ts_keyframe *keyframe = mp_ts_index_find_keyframe(&m->v_index, pts);
+	if (pts > m->last_v_pts && (!keyframe || keyframe->ts <= m->last_v_pts)) {
+		m->v.frame_ready = false;
+		m->skip_to_target = true;
+		m->target_pts = pts;
+
+		if (m->pause && m->v_seek_cb && mp_media_prepare_frames(m))
+			mp_media_next_video(m, true);
+		return;
+	}
+
+	seek_to_pts(m, pts);
+}
+
 bool mp_media_reset(mp_media_t *m)
 {
 	bool stopping;
@@ -737,6 +925,87 @@ bool mp_media_init2(mp_media_t *m)
 	return true;
 }
 
+/* one pass of the playback loop, once woken by a command or the next
+ * frame's time; *kill is set when the loop should end */
+static bool mp_media_run_once(mp_media_t *m, bool is_active, bool timeout, bool *kill)
+{
+	bool reset, seek, seek_exact, pause, reset_time, preload_frame;
+	int64_t seek_pos;
+	int step;
+
+	pthread_mutex_lock(&m->mutex);
+
+	reset = m->reset;
+	*kill = m->kill;
+	m->reset = false;
+	m->kill = false;
+
+	preload_frame = m->preload_frame;
+	pause = m->pause;
+	seek_pos = m->seek_pos;
+	seek = m->seek;
+	seek_exact = m->seek_exact;
+	step = m->step_frames;
+	reset_time = m->reset_ts;
+	m->preload_frame = false;
+	m->seek = false;
+	m->seek_exact = false;
+	m->step_frames = 0;
+	m->reset_ts = false;
+
+	pthread_mutex_unlock(&m->mutex);
+
+	if (*kill) {
+		return true;
+	}
+	if (reset) {
+		mp_media_reset(m);
+		return true;
+	}
+
+	if (seek || step) {
+		m->seek_next_ts = true;
+		if (seek && seek_exact)
+			seek_to_pts(m, seek_pos);
+		else if (seek)
+			seek_to(m, seek_pos);
+		if (step)
+			step_frames(m, step);
+		return true;
+	}
+
+	if (reset_time) {
+		reset_ts(m);
+		return true;
+	}
+
+	if (pause)
+		return true;
+
+	/* see note in mp_media_prepare_frames() for context on the
+	 * pointer check */
+	if (preload_frame && m->obsframe.data[0] && !is_active) {
+		output_video(m, m->v_preload_cb, &m->obsframe);
+	}
+
+	/* frames are ready */
+	if (is_active && !timeout) {
+		if (m->has_video)
+			mp_media_next_video(m, false);
+		if (m->has_audio)
+			mp_media_next_audio(m);
+
+		if (!mp_media_prepare_frames(m))
+			return false;
+		if (mp_media_eof(m))
+			return true;
+
+		mp_media_calc_next_ns(m);
+	}
+
+	return true;
+}
+
 static inline bool mp_media_thread(mp_media_t *m)
 {
 	os_set_thread_name("mp_media_thread");
@@ -749,8 +1018,7 @@ static inline bool mp_media_thread(mp_media_t *m)
 	}
 
 	for (;;) {
-		bool reset, kill, is_active, seek, pause, reset_time, preload_frame;
-		int64_t seek_pos;
+		bool is_active, pause, kill;
 		bool timeout = false;
 
 		pthread_mutex_lock(&m->mutex);
@@ -767,69 +1035,55 @@ static inline bool mp_media_thread(mp_media_t *m)
 			timeout = mp_media_sleep(m);
 		}
 
-		pthread_mutex_lock(&m->mutex);
-
-		reset = m->reset;
-		kill = m->kill;
-		m->reset = false;
-		m->kill = false;
+		if (!mp_media_run_once(m, is_active, timeout, &kill))
+			return false;
+		if (kill)
+			break;
+	}
 
-		preload_frame = m->preload_frame;
-		pause = m->pause;
-		seek_pos = m->seek_pos;
-		seek = m->seek;
-		reset_time = m->reset_ts;
-		m->preload_frame = false;
-		m->seek = false;
-		m->reset_ts = false;
+	return true;
+}
 
-		pthread_mutex_unlock(&m->mutex);
+/* ------------------------------------------------------------------------- */
+/* playback driven by a shared decode service instead of its own thread      */
 
-		if (kill) {
-			break;
-		}
-		if (reset) {
-			mp_media_reset(m);
-			continue;
-		}
-
-		if (seek) {
-			m->seek_next_ts = true;
-			seek_to(m, seek_pos);
-			continue;
-		}
+bool mp_media_service_open(mp_media_t *m)
+{
+	return mp_media_init2(m) && mp_media_reset(m);
+}
 
-		if (reset_time) {
-			reset_ts(m);
-			continue;
-		}
+/* false while waiting for a command (stopped or paused); otherwise next_ns
+ * is when the next frame is due, 0 for right away */
+bool mp_media_service_state(mp_media_t *m, uint64_t *next_ns, int64_t *frame_ns)
+{
+	bool waiting;
 
-		if (pause)
-			continue;
+	pthread_mutex_lock(&m->mutex);
+	waiting = !m->active || m->pause;
+	pthread_mutex_unlock(&m->mutex);
 
-		/* see note in mp_media_prepare_frames() for context on the
-		 * pointer check */
-		if (preload_frame && m->obsframe.data[0] && !is_active) {
-			m->v_preload_cb(m->opaque, &m->obsframe);
-		}
+	*next_ns = m->next_ns;
+	*frame_ns = m->has_video ? m->v.last_duration : 0;
+	return !waiting;
+}
 
-		/* frames are ready */
-		if (is_active && !timeout) {
-			if (m->has_video)
-				mp_media_next_video(m, false);
-			if (m->has_audio)
-				mp_media_next_audio(m);
+/* the service's counterpart of one thread loop iteration: woke_idle after
+ * waiting for a command, present once the next frame is due */
+bool mp_media_service_run(mp_media_t *m, bool woke_idle, bool present)
+{
+	bool is_active, pause, kill;
 
-			if (!mp_media_prepare_frames(m))
-				return false;
-			if (mp_media_eof(m))
-				continue;
+	pthread_mutex_lock(&m->mutex);
+	is_active = m->active;
+	pause = m->pause;
+	pthread_mutex_unlock(&m->mutex);
 
-			mp_media_calc_next_ns(m);
-		}
-	}
+	if (woke_idle && pause)
+		reset_ts(m);
+	if (present && !m->next_ns)
+		m->next_ns = os_gettime_ns();
 
-	return true;
+	return mp_media_run_once(m, is_active, !present, &kill);
 }
 
 static void *mp_media_thread_start(void *opaque)
@@ -863,6 +1117,9 @@ static inline bool mp_media_init_internal(mp_media_t *m, const struct mp_media_i
 	if (info->full_decode)
 		return true;
 
+	if (m->service)
+		return mp_decode_service_add(m->service, m, info->decode_ahead);
+
 	if (pthread_create(&m->thread, NULL, mp_media_thread_start, m) != 0) {
 		blog(LOG_WARNING, "MP: Could not create media thread");
 		return false;
@@ -891,6 +1148,11 @@ bool mp_media_init(mp_media_t *media, const struct mp_media_info *info)
 	media->is_local_file = info->is_local_file;
 	da_init(media->packet_pool);
 
+	if (info->pooled_frames)
+		media->frame_pool = mp_frame_pool_create();
+	if (!info->full_decode)
+		media->service = info->decode_service;
+
 	if (!info->is_local_file || media->speed < 1 || media->speed > 200)
 		media->speed = 100;
 
@@ -930,9 +1192,14 @@ void mp_media_free(mp_media_t *media)
 		return;
 
 	mp_media_stop(media);
+	if (media->service)
+		mp_decode_service_remove(media->service, media);
 	mp_kill_thread(media);
 	mp_decode_free(&media->v);
 	mp_decode_free(&media->a);
+	mp_ts_index_free(&media->v_index);
+	da_free(media->v_spans);
+	mp_frame_pool_destroy(media->frame_pool);
 	for (size_t i = 0; i < media->packet_pool.num; i++)
 		av_packet_free(&media->packet_pool.array[i]);
 	da_free(media->packet_pool);
@@ -947,6 +1214,14 @@ void mp_media_free(mp_media_t *media)
 	pthread_mutex_init_value(&media->mutex);
 }
 
+static inline void mp_media_wake(mp_media_t *m)
+{
+	if (m->service)
+		mp_decode_service_wake(m->service, m);
+	else
+		os_sem_post(m->sem);
+}
+
 void mp_media_play(mp_media_t *m, bool loop, bool reconnecting)
 {
 	pthread_mutex_lock(&m->mutex);
@@ -960,7 +1235,7 @@ void mp_media_play(mp_media_t *m, bool loop, bool reconnecting)
 
 	pthread_mutex_unlock(&m->mutex);
 
-	os_sem_post(m->sem);
+	mp_media_wake(m);
 }
 
 void mp_media_play_pause(mp_media_t *m, bool pause)
@@ -972,16 +1247,16 @@ void mp_media_play_pause(mp_media_t *m, bool pause)
 	}
 	pthread_mutex_unlock(&m->mutex);
 
-	os_sem_post(m->sem);
+	mp_media_wake(m);
 }
 
 void mp_media_preload_frame(mp_media_t *m)
 {
-	if (m->request_preload && m->thread_valid && m->v_preload_cb) {
+	if (m->request_preload && (m->thread_valid || m->service) && m->v_preload_cb) {
 		pthread_mutex_lock(&m->mutex);
 		m->preload_frame = true;
 		pthread_mutex_unlock(&m->mutex);
-		os_sem_post(m->sem);
+		mp_media_wake(m);
 	}
 }
 
@@ -995,7 +1270,7 @@ void mp_media_stop(mp_media_t *m)
 	}
 	pthread_mutex_unlock(&m->mutex);
 
-	os_sem_post(m->sem);
+	mp_media_wake(m);
 }
 
 int64_t mp_media_get_current_time(mp_media_t *m)
@@ -1044,9 +1319,34 @@ void mp_media_seek(mp_media_t *m, int64_t pos)
 	pthread_mutex_lock(&m->mutex);
 	if (m->active) {
 		m->seek = true;
+		m->seek_exact = false;
 		m->seek_pos = pos * 1000;
 	}
 	pthread_mutex_unlock(&m->mutex);
 
-	os_sem_post(m->sem);
+	mp_media_wake(m);
+}
+
+void mp_media_seek_pts(mp_media_t *m, int64_t pts)
+{
+	pthread_mutex_lock(&m->mutex);
+	if (m->active) {
+		m->seek = true;
+		m->seek_exact = true;
+		m->seek_pos = pts;
+		m->step_frames = 0;
+	}
+	pthread_mutex_unlock(&m->mutex);
+
+	mp_media_wake(m);
+}
+
+void mp_media_step_frame(mp_media_t *m, int frames)
+{
+	pthread_mutex_lock(&m->mutex);
+	if (m->active)
+		m->step_frames += frames;
+	pthread_mutex_unlock(&m->mutex);
+
+	mp_media_wake(m);
 }
@@ -18,6 +18,9 @@
 
 #include <obs.h>
 #include "decode.h"
+#include "ts-index.h"
+#include "frame-pool.h"
+#include "decode-service.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,6 +41,12 @@ extern "C" {
 #pragma warning(pop)
 #endif
 
+/* stretch of the video timeline demuxed without a seek in between */
+struct mp_ts_span {
+	int64_t start;
+	int64_t end;
+};
+
 struct mp_media {
 	AVFormatContext *fmt;
 
@@ -62,6 +71,9 @@ struct mp_media {
 	DARRAY(AVPacket *) packet_pool;
 	struct mp_decode v;
 	struct mp_decode a;
+	struct mp_ts_index v_index; /* video packets demuxed so far, local files */
+	DARRAY(struct mp_ts_span) v_spans; /* parts of v_index with no gaps */
+	bool v_span_open;
 	bool request_preload;
 	bool is_local_file;
 	bool reconnecting;
@@ -72,6 +84,8 @@ struct mp_media {
 	bool hw;
 
 	struct obs_source_frame obsframe;
+	struct mp_frame_pool *frame_pool; /* callbacks get pool copies if set */
+	struct mp_decode_service *service; /* runs the playback loop instead of a thread */
 	enum video_colorspace cur_space;
 	enum video_range_type cur_range;
 	enum video_range_type force_range;
@@ -102,7 +116,14 @@ struct mp_media {
 	bool reset_ts;
 	bool seek;
 	bool seek_next_ts;
+	bool seek_exact;
 	int64_t seek_pos;
+	int step_frames;
+
+	/* frame-accurate seeking decodes up to the target before showing */
+	bool skip_to_target;
+	int64_t target_pts;
+	int64_t last_v_pts;
 };
 
 typedef struct mp_media mp_media_t;
@@ -118,6 +139,8 @@ extern int64_t mp_media_get_current_time(mp_media_t *m);
 extern int64_t mp_media_get_frames(mp_media_t *m);
 extern int64_t mp_media_get_duration(mp_media_t *m);
 extern void mp_media_seek(mp_media_t *m, int64_t pos);
+extern void mp_media_seek_pts(mp_media_t *m, int64_t pts);
+extern void mp_media_step_frame(mp_media_t *m, int frames);
 
 /* #define DETAILED_DEBUG_INFO */
 
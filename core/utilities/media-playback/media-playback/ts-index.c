@@ -0,0 +1,106 @@
+/*
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "ts-index.h"
+
+void mp_ts_index_free(struct mp_ts_index *index)
+{
+	da_free(index->pts);
+	da_free(index->keyframes);
+}
+
+void mp_ts_index_clear(struct mp_ts_index *index)
+{
+	da_resize(index->pts, 0);
+	da_resize(index->keyframes, 0);
+}
+
+void mp_ts_index_push(struct mp_ts_index *index, int64_t ts)
+{
+	da_push_back(index->pts, &ts);
+}
+
+size_t mp_ts_index_lower_bound(const struct mp_ts_index *index, int64_t ts)
+{
+	size_t lo = 0;
+	size_t hi = index->pts.num;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (index->pts.array[mid] < ts)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+size_t mp_ts_index_floor(const struct mp_ts_index *index, int64_t ts)
+{
+	size_t idx = mp_ts_index_lower_bound(index, ts);
+	if (idx < index->pts.num && index->pts.array[idx] == ts)
+		return idx;
+
+	return idx ? idx - 1 : 0;
+}
+
+size_t mp_ts_index_insert(struct mp_ts_index *index, int64_t ts)
+{
+	size_t idx = index->pts.num;
+
+	/* demuxers mostly hand out timestamps in order, or close to it */
+	if (idx && index->pts.array[idx - 1] >= ts) {
+		idx = mp_ts_index_lower_bound(index, ts);
+		if (index->pts.array[idx] == ts)
+			return idx;
+	}
+
+	da_insert(index->pts, idx, &ts);
+	return idx;
+}
+
+/* first keyframe after ts */
+static size_t keyframe_upper_bound(const struct mp_ts_index *index, int64_t ts)
+{
+	size_t lo = 0;
+	size_t hi = index->keyframes.num;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (index->keyframes.array[mid].ts <= ts)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+void mp_ts_index_add_keyframe(struct mp_ts_index *index, int64_t ts, int64_t pos)
+{
+	struct mp_ts_keyframe keyframe = {ts, pos};
+	size_t idx = keyframe_upper_bound(index, ts);
+
+	if (idx && index->keyframes.array[idx - 1].ts == ts)
+		return;
+
+	da_insert(index->keyframes, idx, &keyframe);
+}
+
+const struct mp_ts_keyframe *mp_ts_index_find_keyframe(const struct mp_ts_index *index, int64_t ts)
+{
+	size_t idx = keyframe_upper_bound(index, ts);
+	return idx ? &index->keyframes.array[idx - 1] : NULL;
+}
@@ -0,0 +1,55 @@
+/*
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#pragma once
+
+#include <util/darray.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct mp_ts_keyframe {
+	int64_t ts;
+	int64_t pos; /* owner-defined: packet index, stream timestamp, ... */
+};
+
+/* Sorted presentation timestamps (ns) of a stream and the keyframes among
+ * them, so seeking and frame stepping are binary searches instead of scans.
+ * Used by the cache for its frame timeline and by mp_media for the part of
+ * the file it has demuxed so far. */
+struct mp_ts_index {
+	DARRAY(int64_t) pts;
+	DARRAY(struct mp_ts_keyframe) keyframes;
+};
+
+extern void mp_ts_index_free(struct mp_ts_index *index);
+extern void mp_ts_index_clear(struct mp_ts_index *index);
+
+/* appends a timestamp the caller knows is in order */
+extern void mp_ts_index_push(struct mp_ts_index *index, int64_t ts);
+/* inserts in order, skipping timestamps already indexed */
+extern size_t mp_ts_index_insert(struct mp_ts_index *index, int64_t ts);
+extern void mp_ts_index_add_keyframe(struct mp_ts_index *index, int64_t ts, int64_t pos);
+
+/* first entry at or after ts, pts.num if there is none */
+extern size_t mp_ts_index_lower_bound(const struct mp_ts_index *index, int64_t ts);
+/* entry on screen at ts: the last one at or before it (0 before the first) */
+extern size_t mp_ts_index_floor(const struct mp_ts_index *index, int64_t ts);
+/* last keyframe at or before ts, NULL if there is none */
+extern const struct mp_ts_keyframe *mp_ts_index_find_keyframe(const struct mp_ts_index *index, int64_t ts);
+
+#ifdef __cplusplus
+}
+#endif
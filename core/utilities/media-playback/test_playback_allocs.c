@@ -0,0 +1,339 @@
+/*
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/* Plays a synthetic clip in each playback mode (and on a shared decode
+ * service) with a consumer that holds on to frames past the callback, and
+ * measures heap allocations per second once playback reached steady state. Fails if the frame pool still
+ * allocates or if a frame sized allocation happens in the cached modes
+ * (direct playback demuxes every packet, which FFmpeg allocates). */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libavformat/avformat.h>
+#include <util/threading.h>
+#include <util/platform.h>
+#include <media-playback/media-playback.h>
+
+#define WIDTH 320
+#define HEIGHT 240
+#define FPS 30
+#define SECONDS 4
+#define SAMPLE_RATE 48000
+#define AUDIO_PACKET_FRAMES 1600
+
+#define WARMUP_MS 1500
+#define MEASURE_MS 3000
+
+/* anything this size is a frame buffer */
+#define LARGE_ALLOC (64 * 1024)
+
+static volatile long allocs;
+static volatile long large_allocs;
+
+#if defined(__GLIBC__)
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t num, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+static inline void count_alloc(size_t size)
+{
+	os_atomic_inc_long(&allocs);
+	if (size >= LARGE_ALLOC)
+		os_atomic_inc_long(&large_allocs);
+}
+
+void *malloc(size_t size)
+{
+	count_alloc(size);
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t num, size_t size)
+{
+	count_alloc(num * size);
+	return __libc_calloc(num, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	count_alloc(size);
+	return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+	count_alloc(size);
+	return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+	count_alloc(size);
+	return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+	count_alloc(size);
+	*ptr = __libc_memalign(alignment, size);
+	return *ptr ? 0 : ENOMEM;
+}
+#define COUNTS_ALLOCS true
+#else
+#define COUNTS_ALLOCS false
+#endif
+
+/* ------------------------------------------------------------------------- */
+/* synthetic clip: raw I420 video with a moving bar and s16 stereo audio     */
+
+static bool write_clip(const char *path)
+{
+	AVFormatContext *oc = NULL;
+	AVPacket *pkt = av_packet_alloc();
+	bool success = false;
+
+	if (avformat_alloc_output_context2(&oc, NULL, "nut", path) < 0)
+		goto fail;
+
+	AVStream *vs = avformat_new_stream(oc, NULL);
+	vs->time_base = (AVRational){1, FPS};
+	vs->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+	vs->codecpar->codec_id = AV_CODEC_ID_RAWVIDEO;
+	vs->codecpar->format = AV_PIX_FMT_YUV420P;
+	vs->codecpar->width = WIDTH;
+	vs->codecpar->height = HEIGHT;
+
+	AVStream *as = avformat_new_stream(oc, NULL);
+	as->time_base = (AVRational){1, SAMPLE_RATE};
+	as->codecpar->codec_type = AVMEDIA_TYPE_AUDIO;
+	as->codecpar->codec_id = AV_CODEC_ID_PCM_S16LE;
+	as->codecpar->format = AV_SAMPLE_FMT_S16;
+	as->codecpar->sample_rate = SAMPLE_RATE;
+	av_channel_layout_default(&as->codecpar->ch_layout, 2);
+
+	if (avio_open(&oc->pb, path, AVIO_FLAG_WRITE) < 0)
+		goto fail;
+	if (avformat_write_header(oc, NULL) < 0)
+		goto fail;
+
+	const int frame_size = WIDTH * HEIGHT * 3 / 2;
+	const int audio_size = AUDIO_PACKET_FRAMES * 2 * 2;
+	const int audio_per_frame = SAMPLE_RATE / FPS;
+	int64_t audio_pts = 0;
+
+	for (int i = 0; i < FPS * SECONDS; i++) {
+		if (av_new_packet(pkt, frame_size) < 0)
+			goto fail;
+		memset(pkt->data, 128, frame_size);
+		for (int y = 0; y < HEIGHT; y++)
+			memset(pkt->data + y * WIDTH + (i * 4) % WIDTH, 235, 4);
+		pkt->stream_index = vs->index;
+		pkt->pts = pkt->dts = av_rescale_q(i, (AVRational){1, FPS}, vs->time_base);
+		pkt->flags |= AV_PKT_FLAG_KEY;
+		if (av_interleaved_write_frame(oc, pkt) < 0)
+			goto fail;
+
+		while (audio_pts < (int64_t)(i + 1) * audio_per_frame) {
+			if (av_new_packet(pkt, audio_size) < 0)
+				goto fail;
+			memset(pkt->data, 0, audio_size);
+			pkt->stream_index = as->index;
+			pkt->pts = pkt->dts = audio_pts;
+			pkt->duration = AUDIO_PACKET_FRAMES;
+			pkt->flags |= AV_PKT_FLAG_KEY;
+			if (av_interleaved_write_frame(oc, pkt) < 0)
+				goto fail;
+			audio_pts += AUDIO_PACKET_FRAMES;
+		}
+	}
+
+	success = av_write_trailer(oc) == 0;
+
+fail:
+	if (oc && oc->pb)
+		avio_closep(&oc->pb);
+	avformat_free_context(oc);
+	av_packet_free(&pkt);
+	return success;
+}
+
+/* ------------------------------------------------------------------------- */
+/* consumer that keeps the last few frames, like a render queue would        */
+
+#define HELD_FRAMES 2
+
+struct consumer {
+	pthread_mutex_t mutex;
+	struct obs_source_frame *held[HELD_FRAMES];
+	size_t next;
+	struct obs_source_audio *held_audio;
+	volatile long frames;
+	volatile long segments;
+};
+
+static void video_cb(void *opaque, struct obs_source_frame *frame)
+{
+	struct consumer *c = opaque;
+
+	mp_frame_addref(frame);
+
+	pthread_mutex_lock(&c->mutex);
+	mp_frame_release(c->held[c->next]);
+	c->held[c->next] = frame;
+	c->next = (c->next + 1) % HELD_FRAMES;
+	pthread_mutex_unlock(&c->mutex);
+
+	os_atomic_inc_long(&c->frames);
+}
+
+static void audio_cb(void *opaque, struct obs_source_audio *audio)
+{
+	struct consumer *c = opaque;
+
+	mp_audio_addref(audio);
+
+	pthread_mutex_lock(&c->mutex);
+	mp_audio_release(c->held_audio);
+	c->held_audio = audio;
+	pthread_mutex_unlock(&c->mutex);
+
+	os_atomic_inc_long(&c->segments);
+}
+
+static void consumer_release(struct consumer *c)
+{
+	pthread_mutex_lock(&c->mutex);
+	for (size_t i = 0; i < HELD_FRAMES; i++) {
+		mp_frame_release(c->held[i]);
+		c->held[i] = NULL;
+	}
+	mp_audio_release(c->held_audio);
+	c->held_audio = NULL;
+	pthread_mutex_unlock(&c->mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+
+struct mode {
+	const char *name;
+	bool full_decode;
+	bool compressed_cache;
+	bool frame_sized_allocs_ok;
+	bool on_service;
+};
+
+static struct mp_decode_service *service;
+
+static bool run(const char *path, const struct mode *mode)
+{
+	struct consumer c = {0};
+	struct mp_media_info info = {0};
+	struct mp_frame_pool_stats warm, end;
+
+	pthread_mutex_init(&c.mutex, NULL);
+
+	info.opaque = &c;
+	info.v_cb = video_cb;
+	info.a_cb = audio_cb;
+	info.path = path;
+	info.speed = 100;
+	info.is_local_file = true;
+	info.full_decode = mode->full_decode;
+	info.compressed_cache = mode->compressed_cache;
+	info.pooled_frames = true;
+	if (mode->on_service) {
+		info.decode_service = service;
+		info.decode_ahead = 2;
+	}
+
+	media_playback_t *mp = media_playback_create(&info);
+	if (!mp) {
+		printf("%-12s could not open %s\n", mode->name, path);
+		return false;
+	}
+
+	media_playback_play(mp, true, false);
+	os_sleep_ms(WARMUP_MS);
+
+	media_playback_get_frame_pool_stats(mp, &warm);
+	long frames = c.frames;
+	long allocs_start = allocs;
+	long large_start = large_allocs;
+
+	os_sleep_ms(MEASURE_MS);
+
+	media_playback_get_frame_pool_stats(mp, &end);
+	struct mp_decode_stats decode;
+	bool has_decode_stats = media_playback_get_decode_stats(mp, &decode);
+	frames = c.frames - frames;
+	long alloc_count = allocs - allocs_start;
+	long large_count = large_allocs - large_start;
+
+	media_playback_stop(mp);
+	media_playback_destroy(mp);
+	consumer_release(&c);
+	pthread_mutex_destroy(&c.mutex);
+
+	double secs = MEASURE_MS / 1000.0;
+	printf("%-12s %5.1f fps  pool: %ld created (%ld during measurement), %ld reused  "
+	       "heap: %.1f allocs/s, %.1f frame sized/s\n",
+	       mode->name, frames / secs, end.allocations, end.allocations - warm.allocations,
+	       end.reuses - warm.reuses, alloc_count / secs, large_count / secs);
+
+	bool ok = frames > 0 && end.allocations == warm.allocations;
+	if (COUNTS_ALLOCS && !mode->frame_sized_allocs_ok)
+		ok = ok && large_count == 0;
+	if (has_decode_stats)
+		printf("%-12s decode lag: %.2f ms avg, %.2f ms max, %llu late of %llu\n", mode->name,
+		       decode.avg_lag_ns / 1000000.0, decode.max_lag_ns / 1000000.0,
+		       (unsigned long long)decode.late_frames, (unsigned long long)decode.frames);
+	if (!ok)
+		printf("%-12s FAILED\n", mode->name);
+	return ok;
+}
+
+int main(void)
+{
+	char path[512];
+	snprintf(path, sizeof(path), "%s/nstudio-playback-allocs-%llu.nut", getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp",
+		 (unsigned long long)os_gettime_ns());
+
+	if (!write_clip(path)) {
+		printf("could not write synthetic clip to %s\n", path);
+		return 1;
+	}
+
+	if (!COUNTS_ALLOCS)
+		printf("heap counting needs glibc, only checking the frame pool\n");
+
+	const struct mode modes[] = {
+		{"direct", false, false, true, false},
+		{"cached", true, false, false, false},
+		{"compressed", true, true, false, false},
+		{"service", false, false, true, true},
+	};
+
+	service = mp_decode_service_create(1);
+
+	bool ok = true;
+	for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+		ok = run(path, &modes[i]) && ok;
+
+	mp_decode_service_destroy(service);
+	os_unlink(path);
+	return ok ? 0 : 1;
+}
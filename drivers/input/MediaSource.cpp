@@ -1,4 +1,4 @@
-#include "libvr/MediaSource.h"
+#include "media/MediaSource.h"
 #include <iostream>
 #include <cstring> 
 
@@ -7,12 +7,9 @@ extern "C" {
 #include "media.h" 
 }
 
-namespace libvr {
+namespace neural_studio {
 
 // callbacks
-static void v_cb(void *opaque, struct obs_source_frame *frame) {
-    // Callback when a frame is ready
-}
 static void v_preload_cb(void *opaque, struct obs_source_frame *frame) {}
 static void v_seek_cb(void *opaque, struct obs_source_frame *frame) {}
 static void a_cb(void *opaque, struct obs_source_audio *audio) {}
@@ -22,6 +19,17 @@ MediaSource::MediaSource() {
     media = (mp_media_t*)calloc(1, sizeof(mp_media_t));
 }
 
+// Decoder thread: keep the newest frame, the pool recycles the one it replaces
+void MediaSource::OnVideoFrame(void *opaque, struct obs_source_frame *frame) {
+    MediaSource *self = static_cast<MediaSource*>(opaque);
+
+    mp_frame_addref(frame);
+
+    std::lock_guard<std::mutex> lock(self->frameMutex);
+    mp_frame_release(self->latestFrame);
+    self->latestFrame = frame;
+}
+
 MediaSource::~MediaSource() {
     Unload();
     free(media);
@@ -39,8 +47,9 @@ bool MediaSource::Load(const std::string& path) {
     info.force_range = VIDEO_RANGE_DEFAULT;
     info.hardware_decoding = false;
     info.is_local_file = true;
+    info.pooled_frames = true; // Frames outlive the callback, see GetFrame()
     
-    info.v_cb = v_cb;
+    info.v_cb = OnVideoFrame;
     info.v_preload_cb = v_preload_cb;
     info.v_seek_cb = v_seek_cb;
     info.a_cb = a_cb;
@@ -59,10 +68,16 @@ bool MediaSource::Load(const std::string& path) {
 
 void MediaSource::Unload() {
     if (media && currentPath.length() > 0) {
-        mp_media_free(media);
+        mp_media_free(media); // Joins the decoder thread, no more callbacks
         memset(media, 0, sizeof(mp_media_t)); // reset
         currentPath = "";
     }
+
+    std::lock_guard<std::mutex> lock(frameMutex);
+    mp_frame_release(latestFrame);
+    mp_frame_release(heldFrame);
+    latestFrame = nullptr;
+    heldFrame = nullptr;
 }
 
 void MediaSource::Update() {
@@ -72,19 +87,27 @@ void MediaSource::Update() {
 
 bool MediaSource::GetFrame(GPUFrameView& outFrame) {
     if (!media || currentPath.empty()) return false;
-    
-    struct obs_source_frame* f = &media->obsframe;
-    if (!f->data[0]) return false;
+
+    // The previous view stays valid until here; hand its buffer back
+    std::lock_guard<std::mutex> lock(frameMutex);
+    if (latestFrame) {
+        mp_frame_release(heldFrame);
+        heldFrame = latestFrame;
+        latestFrame = nullptr;
+    }
+
+    struct obs_source_frame* f = heldFrame;
+    if (!f || !f->data[0]) return false;
 
     // Populate simplified view
     outFrame.width = f->width;
     outFrame.height = f->height;
-    // outFrame.stride = f->linesize[0]; // Not always linear, but good enough guess for planar Y
-    // outFrame.format/textureId do not exist in GPUFrameView.
-    // handle is void*.
-    outFrame.handle = f->data[0]; // Point handle to CPU buffer for now (unsafe but verifies flow)
+    outFrame.stride = f->linesize[0]; // Plane 0 only for planar formats
+    outFrame.timestamp = f->timestamp;
+    outFrame.handle = f->data[0];
+    outFrame.user_data = f;
     
     return true;
 }
 
-} // namespace libvr
+} // namespace neural_studio
@@ -544,6 +544,20 @@ static void get_nb_frames(void *data, calldata_t *cd)
 	calldata_set_int(cd, "num_frames", frames);
 }
 
+static void seek_pts_proc(void *data, calldata_t *cd)
+{
+	struct ffmpeg_source *s = data;
+	if (s->media)
+		media_playback_seek_pts(s->media, calldata_int(cd, "pts"));
+}
+
+static void step_frame_proc(void *data, calldata_t *cd)
+{
+	struct ffmpeg_source *s = data;
+	if (s->media)
+		media_playback_step_frame(s->media, (int)calldata_int(cd, "frames"));
+}
+
 static bool ffmpeg_source_play_hotkey(void *data, obs_hotkey_pair_id id, obs_hotkey_t *hotkey, bool pressed)
 {
 	UNUSED_PARAMETER(id);
@@ -627,6 +641,8 @@ static void *ffmpeg_source_create(obs_data_t *settings, obs_source_t *source)
 	proc_handler_add(ph, "void preload_first_frame()", preload_first_frame_proc, s);
 	proc_handler_add(ph, "void get_duration(out int duration)", get_duration, s);
 	proc_handler_add(ph, "void get_nb_frames(out int num_frames)", get_nb_frames, s);
+	proc_handler_add(ph, "void seek_pts(in int pts)", seek_pts_proc, s);
+	proc_handler_add(ph, "void step_frame(in int frames)", step_frame_proc, s);
 
 	ffmpeg_source_update(s, settings);
 	return s;
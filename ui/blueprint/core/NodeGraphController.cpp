@@ -31,11 +31,13 @@ NodeGraphController::NodeGraphController(QObject *parent) : QObject(parent)
 {
 	// Initialize the backend graph directly
 	m_backendGraph = std::make_shared<SceneGraph::NodeExecutionGraph>();
+	m_runner = std::make_unique<SceneGraph::GraphRunner>(m_backendGraph);
 }
 
 NodeGraphController::~NodeGraphController()
 {
-	// NodeExecutionGraph doesn't require explicit cleanup
+	// Join the engine thread before the nodes go away
+	m_runner.reset();
 }
 
 QString NodeGraphController::createNode(const QString &nodeType, float x, float y, float z)
@@ -100,16 +102,17 @@ void NodeGraphController::compileAndRun()
 	if (!m_backendGraph)
 		return;
 
+	// Compiling only publishes a new snapshot; the engine thread switches to
+	// it at its next frame, so a running graph is never stopped for an edit
 	bool success = m_backendGraph->compile();
 	emit isCompiledChanged();
 
 	if (success) {
-		// Execute one frame with a context
-		SceneGraph::ExecutionContext ctx;
-		ctx.deltaTime = 0.016f; // 60fps
-		ctx.frameNumber = 0;
-		m_backendGraph->execute(ctx);
-		emit executionFinished(true, "Graph executed successfully");
+		if (!m_runner->isRunning()) {
+			m_runner->start(SceneGraph::ExecutionContext());
+			emit isRunningChanged();
+		}
+		emit executionFinished(true, "Graph compiled and running");
 	} else {
 		emit executionFinished(false, "Compilation failed (Cycle or Type mismatch)");
 	}
@@ -131,6 +134,8 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 	// Currently, backend nodes expose setters for specific properties
 	// We need to cast to specific node types to call their setters
 	// This is a simplified approach; a more robust solution would use reflection/metadata
+	// Setters go through postNodeEdit(): the engine thread reads the same
+	// fields in process()
 
 	std::string nodeType = node->getNodeType();
 	std::string propName = propertyName.toStdString();
@@ -140,7 +145,9 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 		auto threeDNode = std::dynamic_pointer_cast<SceneGraph::ThreeDModelNode>(node);
 		if (threeDNode) {
 			if (propName == "modelPath") {
-				threeDNode->setModelPath(value.toString().toStdString());
+				postNodeEdit(nodeId, [threeDNode, v = value.toString().toStdString()] {
+					threeDNode->setModelPath(v);
+				});
 				qDebug() << "Set modelPath on node" << nodeId << "to" << value.toString();
 				return;
 			}
@@ -152,7 +159,9 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 		auto cameraNode = std::dynamic_pointer_cast<SceneGraph::CameraNode>(node);
 		if (cameraNode) {
 			if (propName == "deviceId") {
-				cameraNode->setDeviceId(value.toString().toStdString());
+				postNodeEdit(nodeId, [cameraNode, v = value.toString().toStdString()] {
+					cameraNode->setDeviceId(v);
+				});
 				qDebug() << "Set deviceId on node" << nodeId << "to" << value.toString();
 				return;
 			}
@@ -164,11 +173,13 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 		auto videoNode = std::dynamic_pointer_cast<SceneGraph::VideoNode>(node);
 		if (videoNode) {
 			if (propName == "videoPath") {
-				videoNode->setVideoPath(value.toString().toStdString());
+				postNodeEdit(nodeId, [videoNode, v = value.toString().toStdString()] {
+					videoNode->setVideoPath(v);
+				});
 				qDebug() << "Set videoPath on node" << nodeId << "to" << value.toString();
 				return;
 			} else if (propName == "loop") {
-				videoNode->setLoop(value.toBool());
+				postNodeEdit(nodeId, [videoNode, v = value.toBool()] { videoNode->setLoop(v); });
 				qDebug() << "Set loop on node" << nodeId << "to" << value.toBool();
 				return;
 			}
@@ -180,11 +191,15 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 		auto imageNode = std::dynamic_pointer_cast<SceneGraph::ImageNode>(node);
 		if (imageNode) {
 			if (propName == "imagePath") {
-				imageNode->setImagePath(value.toString().toStdString());
+				postNodeEdit(nodeId, [imageNode, v = value.toString().toStdString()] {
+					imageNode->setImagePath(v);
+				});
 				qDebug() << "Set imagePath on node" << nodeId << "to" << value.toString();
 				return;
 			} else if (propName == "filterMode") {
-				imageNode->setFilterMode(value.toString().toStdString());
+				postNodeEdit(nodeId, [imageNode, v = value.toString().toStdString()] {
+					imageNode->setFilterMode(v);
+				});
 				qDebug() << "Set filterMode on node" << nodeId << "to" << value.toString();
 				return;
 			}
@@ -196,15 +211,17 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 		auto audioNode = std::dynamic_pointer_cast<SceneGraph::AudioNode>(node);
 		if (audioNode) {
 			if (propName == "audioPath") {
-				audioNode->setAudioPath(value.toString().toStdString());
+				postNodeEdit(nodeId, [audioNode, v = value.toString().toStdString()] {
+					audioNode->setAudioPath(v);
+				});
 				qDebug() << "Set audioPath on node" << nodeId << "to" << value.toString();
 				return;
 			} else if (propName == "loop") {
-				audioNode->setLoop(value.toBool());
+				postNodeEdit(nodeId, [audioNode, v = value.toBool()] { audioNode->setLoop(v); });
 				qDebug() << "Set loop on node" << nodeId << "to" << value.toBool();
 				return;
 			} else if (propName == "volume") {
-				audioNode->setVolume(value.toFloat());
+				postNodeEdit(nodeId, [audioNode, v = value.toFloat()] { audioNode->setVolume(v); });
 				qDebug() << "Set volume on node" << nodeId << "to" << value.toFloat();
 				return;
 			}
@@ -215,7 +232,9 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 	if (nodeType == "FontNode") {
 		auto fontNode = std::dynamic_pointer_cast<SceneGraph::FontNode>(node);
 		if (fontNode && propName == "fontPath") {
-			fontNode->setFontPath(value.toString().toStdString());
+			postNodeEdit(nodeId, [fontNode, v = value.toString().toStdString()] {
+				fontNode->setFontPath(v);
+			});
 			qDebug() << "Set fontPath on node" << nodeId;
 			return;
 		}
@@ -225,7 +244,9 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 	if (nodeType == "ShaderNode") {
 		auto shaderNode = std::dynamic_pointer_cast<SceneGraph::ShaderNode>(node);
 		if (shaderNode && propName == "shaderPath") {
-			shaderNode->setShaderPath(value.toString().toStdString());
+			postNodeEdit(nodeId, [shaderNode, v = value.toString().toStdString()] {
+				shaderNode->setShaderPath(v);
+			});
 			qDebug() << "Set shaderPath on node" << nodeId;
 			return;
 		}
@@ -235,7 +256,9 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 	if (nodeType == "TextureNode") {
 		auto textureNode = std::dynamic_pointer_cast<SceneGraph::TextureNode>(node);
 		if (textureNode && propName == "texturePath") {
-			textureNode->setTexturePath(value.toString().toStdString());
+			postNodeEdit(nodeId, [textureNode, v = value.toString().toStdString()] {
+				textureNode->setTexturePath(v);
+			});
 			qDebug() << "Set texturePath on node" << nodeId;
 			return;
 		}
@@ -245,7 +268,9 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 	if (nodeType == "EffectNode") {
 		auto effectNode = std::dynamic_pointer_cast<SceneGraph::EffectNode>(node);
 		if (effectNode && propName == "effectPath") {
-			effectNode->setEffectPath(value.toString().toStdString());
+			postNodeEdit(nodeId, [effectNode, v = value.toString().toStdString()] {
+				effectNode->setEffectPath(v);
+			});
 			qDebug() << "Set effectPath on node" << nodeId;
 			return;
 		}
@@ -256,11 +281,15 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 		auto scriptNode = std::dynamic_pointer_cast<SceneGraph::ScriptNode>(node);
 		if (scriptNode) {
 			if (propName == "scriptPath") {
-				scriptNode->setScriptPath(value.toString().toStdString());
+				postNodeEdit(nodeId, [scriptNode, v = value.toString().toStdString()] {
+					scriptNode->setScriptPath(v);
+				});
 				qDebug() << "Set scriptPath on node" << nodeId;
 				return;
 			} else if (propName == "scriptLanguage") {
-				scriptNode->setScriptLanguage(value.toString().toStdString());
+				postNodeEdit(nodeId, [scriptNode, v = value.toString().toStdString()] {
+					scriptNode->setScriptLanguage(v);
+				});
 				qDebug() << "Set scriptLanguage on node" << nodeId;
 				return;
 			}
@@ -271,7 +300,7 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 	if (nodeType == "MLNode") {
 		auto mlNode = std::dynamic_pointer_cast<SceneGraph::MLNode>(node);
 		if (mlNode && propName == "modelPath") {
-			mlNode->setModelPath(value.toString().toStdString());
+			postNodeEdit(nodeId, [mlNode, v = value.toString().toStdString()] { mlNode->setModelPath(v); });
 			qDebug() << "Set modelPath on node" << nodeId;
 			return;
 		}
@@ -282,11 +311,15 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 		auto llmNode = std::dynamic_pointer_cast<SceneGraph::LLMNode>(node);
 		if (llmNode) {
 			if (propName == "prompt") {
-				llmNode->setPrompt(value.toString().toStdString());
+				postNodeEdit(nodeId, [llmNode, v = value.toString().toStdString()] {
+					llmNode->setPrompt(v);
+				});
 				qDebug() << "Set prompt on node" << nodeId;
 				return;
 			} else if (propName == "model") {
-				llmNode->setModel(value.toString().toStdString());
+				postNodeEdit(nodeId, [llmNode, v = value.toString().toStdString()] {
+					llmNode->setModel(v);
+				});
 				qDebug() << "Set model on node" << nodeId;
 				return;
 			}
@@ -303,11 +336,34 @@ void NodeGraphController::setNodeProperty(const QString &nodeId, const QString &
 		   << QString::fromStdString(nodeType);
 }
 
+void NodeGraphController::postNodeEdit(const QString &nodeId, std::function<void()> edit)
+{
+	// Flag the node once the edit has landed: the output cache and demand mode
+	// only see changes that come through its inputs otherwise
+	m_runner->post([graph = m_backendGraph, id = nodeId.toStdString(), edit = std::move(edit)] {
+		edit();
+		graph->markDirty(id);
+	});
+}
+
+void NodeGraphController::stopGraph()
+{
+	if (m_runner->isRunning()) {
+		m_runner->stop();
+		emit isRunningChanged();
+	}
+}
+
 bool NodeGraphController::isCompiled() const
 {
 	return m_backendGraph->isCompiled();
 }
 
+bool NodeGraphController::isRunning() const
+{
+	return m_runner->isRunning();
+}
+
 QVector3D NodeGraphController::getNodePosition(const QString &nodeId) const
 {
 	auto it = m_nodePositions.find(nodeId);
@@ -363,10 +419,10 @@ bool NodeGraphController::saveGraph(const QString &filePath)
 	auto connections = m_backendGraph->getConnections();
 	for (const auto &conn : connections) {
 		QJsonObject connObj;
-		connObj["sourceNode"] = QString::fromStdString(conn.sourceNodeId);
-		connObj["sourcePin"] = QString::fromStdString(conn.sourcePinId);
-		connObj["targetNode"] = QString::fromStdString(conn.targetNodeId);
-		connObj["targetPin"] = QString::fromStdString(conn.targetPinId);
+		connObj["sourceNode"] = QString::fromStdString(conn.sourceNodeId());
+		connObj["sourcePin"] = QString::fromStdString(conn.sourcePinId());
+		connObj["targetNode"] = QString::fromStdString(conn.targetNodeId());
+		connObj["targetPin"] = QString::fromStdString(conn.targetPinId());
 		connectionsArray.append(connObj);
 	}
 
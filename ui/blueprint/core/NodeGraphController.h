@@ -7,8 +7,10 @@
 #include <QVector3D>
 #include <vector>
 #include <memory>
+#include <functional>
 #include "../../../core/src/scene-graph/NodeExecutionGraph.h"
 #include "../../../core/src/scene-graph/NodeFactory.h"
+#include "../../../core/src/scene-graph/GraphRunner.h"
 
 namespace NeuralStudio {
     namespace UI {
@@ -19,6 +21,7 @@ namespace NeuralStudio {
         {
             Q_OBJECT
             Q_PROPERTY(bool isCompiled READ isCompiled NOTIFY isCompiledChanged)
+            Q_PROPERTY(bool isRunning READ isRunning NOTIFY isRunningChanged)
             QML_ELEMENT
             QML_UNCREATABLE("Controller is managed by C++ backend or instantiated once")
 
@@ -32,16 +35,22 @@ namespace NeuralStudio {
             Q_INVOKABLE bool connectPins(const QString &sourceNodeId, const QString &sourcePinId,
                                          const QString &targetNodeId, const QString &targetPinId);
             Q_INVOKABLE void disconnectPins(const QString &targetNodeId, const QString &targetPinId);
-            Q_INVOKABLE void compileAndRun();
+            Q_INVOKABLE void compileAndRun();  // Publishes the graph and starts the engine thread
+            Q_INVOKABLE void stopGraph();
             Q_INVOKABLE void setNodeProperty(const QString &nodeId, const QString &propertyName, const QVariant &value);
 
             bool isCompiled() const;
+            bool isRunning() const;
 
             // Access to backend graph
             std::shared_ptr<SceneGraph::NodeExecutionGraph> getBackendGraph() const;
 
+            // Node state edits (setters, pin data) run between engine frames and mark the node dirty
+            void postNodeEdit(const QString &nodeId, std::function<void()> edit);
+
               signals:
             void isCompiledChanged();
+            void isRunningChanged();
             void nodeCreated(const QString &nodeId, const QString &nodeType, float x, float y, float z);
             void nodeDeleted(const QString &nodeId);
             void connectionCreated(const QString &sourceNodeId, const QString &sourcePinId, const QString &targetNodeId,
@@ -51,6 +60,8 @@ namespace NeuralStudio {
 
               private:
             std::shared_ptr<SceneGraph::NodeExecutionGraph> m_backendGraph;
+            // Executes published snapshots off the UI thread; edits here never block it
+            std::unique_ptr<SceneGraph::GraphRunner> m_runner;
             // UI State: Store node positions alongside backend creation
             // VR: Using QVector3D to support Z-axis
             std::map<QString, QVector3D> m_nodePositions;
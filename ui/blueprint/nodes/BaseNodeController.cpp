@@ -91,7 +91,11 @@ void BaseNodeController::updateProperty(const QString &name, const QVariant &val
 			data = value.toString().toStdString();
 
 		if (data.has_value()) {
-			backend->setPinData(name.toStdString(), data);
+			auto edit = [backend, pin = name.toStdString(), data] { backend->setPinData(pin, data); };
+			if (m_graphController)
+				m_graphController->postNodeEdit(QString::fromStdString(backend->getNodeId()), edit);
+			else
+				edit();
 		}
 	}
 }
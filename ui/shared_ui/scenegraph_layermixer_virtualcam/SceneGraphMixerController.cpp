@@ -203,6 +203,7 @@ void SceneGraphMixerController::setLayerOpacity(const QString &nodeId, float opa
 			if (node) {
 				// Push to backend
 				node->setPinData("opacity", opacity);
+				m_manager->markDirty(node->getNodeId());
 			}
 		}
 		// Trigger immediate UI refresh (speculative execution)
@@ -257,6 +258,7 @@ void SceneGraphMixerController::toggleLayerVisibility(const QString &nodeId)
 					}
 				}
 				node->setPinData("active", !current);
+				m_manager->markDirty(node->getNodeId());
 			}
 		}
 		forceUpdate();